@@ -1,5 +1,3 @@
-group "Dependencies/Unused By Engine"
-
 project "zstd"
 	location(GetDependenciesLocation())
 
@@ -11,6 +9,9 @@ project "zstd"
 
 	defines { "ZSTD_MULTITHREAD=1" }
 
-	SetupConfigMap()
+	filter { "system:linux" }
+		buildoptions { "-fPIC" }
 
-group "Dependencies"
+	filter {}
+
+	SetupConfigMap()
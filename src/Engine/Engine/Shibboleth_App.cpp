@@ -132,6 +132,23 @@ void App::destroy(void)
 	_job_pool.waitForAllJobsToFinish(thread_id);
 	_job_pool.destroy();
 
+	// Report frame allocator usage so that app_frame_allocator_size can be tuned.
+	FrameAllocatorStats frame_stats[64];
+	const int32_t num_frame_stats = GetFrameAllocatorStats(frame_stats, static_cast<int32_t>(ARRAY_SIZE(frame_stats)));
+
+	for (int32_t i = 0; i < num_frame_stats; ++i) {
+		const FrameAllocatorStats& stats = frame_stats[i];
+
+		LogInfoDefault(
+			"Frame Allocator [Thread %zu]: Used %zu/%zu bytes. Overflowed %zu times, peak overflow of %zu bytes in a frame.",
+			static_cast<size_t>(stats.thread_id),
+			stats.high_water_mark,
+			stats.arena_size,
+			stats.num_overflow_allocations,
+			stats.overflow_high_water_mark
+		);
+	}
+
 	for (const auto& entry : _manager_map) {
 		entry.second->destroyThread((uintptr_t)&thread_id);
 	}
@@ -268,6 +285,11 @@ JobPool& App::getJobPool(void)
 	return _job_pool;
 }
 
+IMainLoop* App::getMainLoop(void)
+{
+	return _main_loop;
+}
+
 //FileWatcherManager& App::getFileWatcherManager(void)
 //{
 //	return _file_watcher_mgr;
@@ -338,13 +360,46 @@ bool App::initInternal(void)
 
 	EA::Thread::SetAllocator(&_thread_allocator);
 
-	if (!_log_mgr.init(log_file_with_time.data())) {
+	const int32_t log_flush_interval_ms = _configs.getObject(k_config_app_log_flush_interval_ms).getInt32(k_config_app_default_log_flush_interval_ms);
+	const int32_t log_flush_bytes = _configs.getObject(k_config_app_log_flush_bytes).getInt32(k_config_app_default_log_flush_bytes);
+
+	if (!_log_mgr.init(log_file_with_time.data(), log_flush_interval_ms, log_flush_bytes)) {
 		return false;
 	}
 
+#ifdef SHIB_RUNTIME_VAR_ENABLED
+	_log_mgr.setRuntimeVarManager(&_runtime_var_mgr);
+#endif
+
+	const Gaff::JSON log_channel_levels = _configs.getObject(k_config_app_log_channel_levels);
+
+	if (log_channel_levels.isObject()) {
+		log_channel_levels.forEachInObject([&](const char8_t* channel, const Gaff::JSON& value) -> bool {
+			const char8_t* const level_name = value.getString(u8"");
+			LogType level = k_log_default_level;
+
+			if (GetLogType(level_name, level)) {
+				_log_mgr.setChannelLogLevel(Gaff::FNV1aHash32String(channel), level);
+			} else {
+				LogWarningDefault("'%s' config option has an invalid log level '%s' for channel '%s'.", k_config_app_log_channel_levels, level_name, channel);
+			}
+
+			return false;
+		});
+
+	} else if (!log_channel_levels.isNull()) {
+		LogErrorDefault("'%s' config option is not an object of channel names to log levels.", k_config_app_log_channel_levels);
+	}
+
 	LogInfoDefault("Initializing...");
 
-	if (!_job_pool.init(static_cast<int32_t>(Gaff::GetNumberOfCores()), App::ThreadInit, App::ThreadShutdown)) {
+	// Needs to be set before any thread uses the frame allocator. Defaults to whatever the frame allocator was built with.
+	const uint64_t frame_allocator_size = _configs.getObject(k_config_app_frame_allocator_size).getUInt64(GetFrameAllocatorArenaSize());
+	SetFrameAllocatorArenaSize(static_cast<size_t>(frame_allocator_size));
+
+	const bool work_stealing = _configs.getObject(k_config_app_job_pool_work_stealing).getBool(true);
+
+	if (!_job_pool.init(static_cast<int32_t>(Gaff::GetNumberOfCores()), App::ThreadInit, App::ThreadShutdown, work_stealing)) {
 		LogErrorDefault("Failed to initialize thread pool.");
 		return false;
 	}
@@ -429,7 +484,7 @@ bool App::loadFileSystem(void)
 	} else {
 		LogInfoDefault("Defaulting to loose file system.", fs.data());
 
-		_fs.file_system = SHIB_ALLOCT(LooseFileSystem, GetAllocator());
+		_fs.file_system = SHIB_ALLOCT(LooseFileSystem, GetAllocator(), &_job_pool);
 
 		if (!_fs.file_system) {
 			LogErrorDefault("Failed to create loose file system.");
@@ -0,0 +1,263 @@
+/************************************************************************************
+Copyright (C) 2022 by Nicholas LaCroix
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+************************************************************************************/
+
+#include "Shibboleth_BinarySerialize.h"
+#include "Shibboleth_IReflectionDefinition.h"
+#include "Shibboleth_IReflection.h"
+#include "Shibboleth_LogManager.h"
+#include "Shibboleth_Utilities.h"
+#include "Shibboleth_IApp.h"
+
+NS_SHIBBOLETH
+
+BinarySerializeWriter::BinarySerializeWriter(const ProxyAllocator& allocator):
+	_buffer(allocator)
+{
+}
+
+void BinarySerializeWriter::writeFileHeader(void)
+{
+	write(BinaryFileHeader());
+}
+
+void BinarySerializeWriter::write(const void* data, size_t size)
+{
+	const size_t offset = _buffer.size();
+	_buffer.resize(offset + size);
+
+	memcpy(_buffer.data() + offset, data, size);
+}
+
+const uint8_t* BinarySerializeWriter::getBuffer(void) const
+{
+	return _buffer.data();
+}
+
+size_t BinarySerializeWriter::size(void) const
+{
+	return _buffer.size();
+}
+
+void BinarySerializeWriter::clear(void)
+{
+	_buffer.clear();
+}
+
+
+
+BinarySerializeReader::BinarySerializeReader(const void* buffer, size_t size):
+	_cursor(reinterpret_cast<const uint8_t*>(buffer)),
+	_end(reinterpret_cast<const uint8_t*>(buffer) + size)
+{
+}
+
+bool BinarySerializeReader::readFileHeader(void)
+{
+	BinaryFileHeader header;
+
+	if (!read(header)) {
+		return false;
+	}
+
+	if (header.magic != k_binary_magic || header.format_version != k_binary_format_version) {
+		_failed = true;
+		return false;
+	}
+
+	return true;
+}
+
+bool BinarySerializeReader::read(void* out, size_t size)
+{
+	const uint8_t* const data = _cursor;
+
+	if (!skip(size)) {
+		return false;
+	}
+
+	memcpy(out, data, size);
+	return true;
+}
+
+bool BinarySerializeReader::skip(size_t size)
+{
+	if (_failed || static_cast<size_t>(_end - _cursor) < size) {
+		_failed = true;
+		return false;
+	}
+
+	_cursor += size;
+	return true;
+}
+
+BinarySerializeReader BinarySerializeReader::split(size_t size)
+{
+	const uint8_t* const data = _cursor;
+
+	if (!skip(size)) {
+		BinarySerializeReader reader(nullptr, 0);
+		reader._failed = true;
+
+		return reader;
+	}
+
+	return BinarySerializeReader(data, size);
+}
+
+const uint8_t* BinarySerializeReader::getCursor(void) const
+{
+	return _cursor;
+}
+
+size_t BinarySerializeReader::getRemaining(void) const
+{
+	return static_cast<size_t>(_end - _cursor);
+}
+
+bool BinarySerializeReader::hasFailed(void) const
+{
+	return _failed;
+}
+
+
+
+bool LoadBinaryMessagePack(BinarySerializeReader& reader, const Refl::IReflectionDefinition& ref_def, void* object)
+{
+	BinaryObjectHeader header;
+
+	if (!reader.read(header)) {
+		return false;
+	}
+
+	if (header.type_hash != ref_def.getReflectionInstance().getHash().getHash() || header.type != BinaryObjectType::MessagePack) {
+		reader.skip(header.size);
+		return false;
+	}
+
+	return reader.readMessagePack(header.size, [&](const ISerializeReader& mpack_reader) -> bool
+	{
+		return ref_def.load(mpack_reader, object);
+	});
+}
+
+void SaveBinaryMessagePack(BinarySerializeWriter& writer, const Refl::IReflectionDefinition& ref_def, const void* object)
+{
+	BinaryObjectHeader header;
+	header.type_hash = ref_def.getReflectionInstance().getHash().getHash();
+	header.layout_hash = ref_def.getReflectionInstance().getVersion().getHash();
+	header.type = BinaryObjectType::MessagePack;
+
+	const size_t header_offset = writer.reserve<BinaryObjectHeader>();
+
+	writer.writeMessagePack([&](ISerializeWriter& mpack_writer) -> void
+	{
+		ref_def.save(mpack_writer, object);
+	});
+
+	header.size = static_cast<uint32_t>(writer.size() - header_offset - sizeof(BinaryObjectHeader));
+	writer.writeAt(header_offset, header);
+}
+
+bool LoadBinaryCopy(BinarySerializeReader& reader, const Refl::IReflectionDefinition& ref_def, void* object, size_t size)
+{
+	BinaryObjectHeader header;
+
+	if (!reader.read(header)) {
+		return false;
+	}
+
+	BinarySerializeReader object_reader = reader.split(header.size);
+
+	if (header.type_hash != ref_def.getReflectionInstance().getHash().getHash() || header.type != BinaryObjectType::Fields) {
+		return false;
+	}
+
+	uint32_t copy_count = 0;
+	uint32_t copy_size = 0;
+
+	if (!object_reader.read(copy_count) || !object_reader.read(copy_size)) {
+		return false;
+	}
+
+	if (copy_count != 1 || copy_size != size) {
+		return false;
+	}
+
+	return object_reader.skip(sizeof(BinaryCopyField)) && object_reader.read(object, size);
+}
+
+void SaveBinaryCopy(BinarySerializeWriter& writer, const Refl::IReflectionDefinition& ref_def, const void* object, size_t size)
+{
+	BinaryObjectHeader header;
+	header.type_hash = ref_def.getReflectionInstance().getHash().getHash();
+	header.layout_hash = ref_def.getReflectionInstance().getVersion().getHash();
+	header.type = BinaryObjectType::Fields;
+	header.size = static_cast<uint32_t>(sizeof(uint32_t) * 3 + sizeof(BinaryCopyField) + size);
+
+	BinaryCopyField field;
+	field.type_hash = header.type_hash;
+	field.size = static_cast<uint32_t>(size);
+
+	writer.write(header);
+	writer.write(uint32_t(1));
+	writer.write(static_cast<uint32_t>(size));
+	writer.write(field);
+	writer.write(object, size);
+	writer.write(uint32_t(0));
+}
+
+bool SkipBinaryObject(BinarySerializeReader& reader)
+{
+	BinaryObjectHeader header;
+	return reader.read(header) && reader.skip(header.size);
+}
+
+void SaveBinaryFile(BinarySerializeWriter& writer, const Refl::IReflectionDefinition& ref_def, const void* object)
+{
+	writer.writeFileHeader();
+	ref_def.saveBinary(writer, object);
+}
+
+bool LoadBinaryFile(const void* buffer, size_t size, const Refl::IReflectionDefinition& ref_def, void* object)
+{
+	BinarySerializeReader reader(buffer, size);
+	if (!reader.readFileHeader()) {
+		LogBinaryLoadError(ref_def, u8"Not a binary file, or it was written by a different format version.");
+		return false;
+	}
+
+	return ref_def.loadBinary(reader, object);
+}
+
+void LogBinaryLoadError(const Refl::IReflectionDefinition& ref_def, const char8_t* format, ...)
+{
+	U8String reason;
+
+	va_list vl;
+	va_start(vl, format);
+	reason.sprintf_va_list(format, vl);
+	va_end(vl);
+
+	LogErrorDefault("Failed to load binary object of type '%s'. %s", ref_def.getReflectionInstance().getName(), reason.data());
+}
+
+NS_END
@@ -21,40 +21,167 @@ THE SOFTWARE.
 ************************************************************************************/
 
 #include "Shibboleth_LogManager.h"
+#include "Shibboleth_RuntimeVarManager.h"
 #include <Shibboleth_Utilities.h>
 #include "Shibboleth_IApp.h"
+#include <eathread/eathread.h>
 #include <EASTL/algorithm.h>
 #include <Gaff_Utils.h>
 #include <Gaff_JSON.h>
+#include <cstdarg>
 
 NS_SHIBBOLETH
 
+#ifdef SHIB_RUNTIME_VAR_ENABLED
+class LogLevelRuntimeVar final : public IRuntimeVar
+{
+public:
+	LogLevelRuntimeVar(Gaff::Hash64 name, int32_t& level):
+		IRuntimeVar(name), _level(level)
+	{
+	}
+
+	const Refl::IReflection& getReflection(void) const override
+	{
+		return Refl::Reflection<int32_t>::GetInstance();
+	}
+
+	void* getValue(void) override
+	{
+		return &_level;
+	}
+
+private:
+	int32_t& _level;
+};
+#endif
+
+static constexpr const char8_t* const k_log_type_names[] = {
+	u8"debug",
+	u8"info",
+	u8"warning",
+	u8"error"
+};
+
+static_assert(ARRAY_SIZE(k_log_type_names) == static_cast<size_t>(LogType::Error) + 1, "k_log_type_names is out of sync with LogType.");
+
+bool GetLogType(const char8_t* name, LogType& out_type)
+{
+	for (int32_t i = 0; i < static_cast<int32_t>(ARRAY_SIZE(k_log_type_names)); ++i) {
+		if (!strcmp(reinterpret_cast<const char*>(name), reinterpret_cast<const char*>(k_log_type_names[i]))) {
+			out_type = static_cast<LogType>(i);
+			return true;
+		}
+	}
+
+	return false;
+}
+
 intptr_t LogManager::LogThread(void* args)
 {
 	LogManager& lm = *reinterpret_cast<LogManager*>(args);
 
-	while (!lm._shutdown) {
-		lm._log_lock.Wait();
+	// Each batch is coalesced into one write per channel file.
+	VectorMap<FILE*, U8String> pending_writes{ ProxyAllocator("Log") };
+	Vector<FILE*> unflushed_files{ ProxyAllocator("Log") };
 
-		lm._log_queue_lock.Lock();
+	EA::Thread::ThreadTime last_flush = EA::Thread::GetThreadTime();
+	int32_t unflushed_bytes = 0;
 
-		if (!lm._logs.empty()) {
-			LogTask task = std::move(lm._logs.front());
-			lm._logs.pop();
+	for (;;) {
+		bool flush_now = false;
+		int32_t num_records = 0;
 
-			lm._log_queue_lock.Unlock();
+		{
+			const EA::Thread::AutoMutex lock(lm._log_callback_lock);
 
-			Gaff::File file(task.file);
-			file.writeString(task.message.data());
-			file.writeChar(u8'\n');
-			file.flush();
-			file.release(); // We don't want to close the file.
+			const auto read_record = [&](LogRecord& record) -> void
+			{
+				U8String& buffer = pending_writes[record.file];
+				buffer.append(record.getMessage(), record.getMessage() + record.length);
+				buffer.push_back(u8'\n');
 
-			lm.notifyLogCallbacks(task.message.data(), task.type);
+				for (auto& callback : lm._log_callbacks) {
+					callback.second(record.getMessage(), record.type);
+				}
+
+				if (record.type == LogType::Error) {
+					flush_now = true;
+				}
+
+				if (record.overflow) {
+					SHIB_FREE(record.overflow, lm._allocator);
+					record.overflow = nullptr;
+				}
+			};
+
+			while (num_records < k_max_batch_size && lm._records.tryPop(read_record)) {
+				++num_records;
+			}
+		}
+
+		for (auto& write : pending_writes) {
+			if (write.second.empty()) {
+				continue;
+			}
+
+			fwrite(write.second.data(), sizeof(char8_t), write.second.size(), write.first);
+			unflushed_bytes += static_cast<int32_t>(write.second.size());
+			write.second.clear();
+
+			if (eastl::find(unflushed_files.begin(), unflushed_files.end(), write.first) == unflushed_files.end()) {
+				unflushed_files.push_back(write.first);
+			}
+		}
+
+		const EA::Thread::ThreadTime now = EA::Thread::GetThreadTime();
+
+		if (!unflushed_files.empty()) {
+			const bool interval_elapsed = (now - last_flush) >= EA::Thread::ThreadTime(lm._flush_interval_ms);
+
+			if (flush_now || interval_elapsed || unflushed_bytes >= lm._flush_bytes || lm._shutdown) {
+				for (FILE* file : unflushed_files) {
+					fflush(file);
+				}
+
+				unflushed_files.clear();
+				unflushed_bytes = 0;
+				last_flush = now;
+			}
 
 		} else {
-			lm._log_queue_lock.Unlock();
+			last_flush = now;
+		}
+
+		// Still have records to process.
+		if (num_records == k_max_batch_size) {
+			continue;
 		}
+
+		if (lm._shutdown) {
+			if (lm._records.empty()) {
+				break;
+			}
+
+			continue;
+		}
+
+		lm._log_thread_sleeping = true;
+
+		// A producer may have pushed before seeing the flag.
+		if (!lm._records.empty()) {
+			lm._log_thread_sleeping = false;
+			continue;
+		}
+
+		// Wake up in time for the next timed flush if anything is unflushed.
+		if (unflushed_files.empty()) {
+			lm._log_lock.Wait();
+		} else {
+			lm._log_lock.Wait(last_flush + EA::Thread::ThreadTime(lm._flush_interval_ms));
+		}
+
+		lm._log_thread_sleeping = false;
 	}
 
 	return 0;
@@ -70,9 +197,11 @@ LogManager::~LogManager(void)
 	destroy();
 }
 
-bool LogManager::init(const char8_t* log_dir)
+bool LogManager::init(const char8_t* log_dir, int32_t flush_interval_ms, int32_t flush_bytes)
 {
 	_log_dir = log_dir;
+	_flush_interval_ms = eastl::max(flush_interval_ms, 0);
+	_flush_bytes = eastl::max(flush_bytes, 0);
 
 	addChannel(HashStringView32<>(k_log_channel_name_default));
 
@@ -97,10 +226,49 @@ void LogManager::destroy(void)
 		_log_thread.WaitForEnd();
 	}
 
+	// Anything logged after the log thread exited never made it to a file.
+	while (_records.tryPop([&](LogRecord& record) -> void
+	{
+		if (record.overflow) {
+			SHIB_FREE(record.overflow, _allocator);
+			record.overflow = nullptr;
+		}
+	})) {
+	}
+
 	_shutdown = false;
 
 	_log_callbacks.clear();
-	_channels.clear();
+
+	const EA::Thread::AutoMutex lock(_channel_lock);
+
+	for (Channel& channel : _channels) {
+		if (!channel.in_use) {
+			continue;
+		}
+
+	#ifdef SHIB_RUNTIME_VAR_ENABLED
+		if (channel.runtime_var) {
+			if (_runtime_var_mgr) {
+				_runtime_var_mgr->removeRuntimeVar(*channel.runtime_var);
+			}
+
+			SHIB_FREET(channel.runtime_var, _allocator);
+			channel.runtime_var = nullptr;
+		}
+	#endif
+
+		channel.in_use = false;
+		channel.file.close();
+		channel.name = HashString32<>(ProxyAllocator("Log"));
+		channel.level = static_cast<int32_t>(k_log_default_level);
+	}
+
+	_channel_levels.clear();
+
+#ifdef SHIB_RUNTIME_VAR_ENABLED
+	_runtime_var_mgr = nullptr;
+#endif
 }
 
 int32_t LogManager::addLogCallback(const LogCallback& callback)
@@ -136,83 +304,253 @@ bool LogManager::removeLogCallback(int32_t id)
 
 void LogManager::addChannel(HashStringView32<> channel)
 {
-	auto it = Gaff::Find(_channels, channel);
+	const EA::Thread::AutoMutex lock(_channel_lock);
 
-	if (it == _channels.end()) {
-		const U8String file_name(U8String::CtorSprintf(), u8"%s/%sLog.txt", _log_dir.data(), channel.getBuffer());
-		auto pair = eastl::make_pair<HashString32<>, Gaff::File>(HashString32<>(channel), Gaff::File());
+	if (findChannel(channel.getHash())) {
+		return;
+	}
 
-		if (pair.second.open(file_name.data(), Gaff::File::OpenMode::/*Write*/Append)) {
-			_channels.insert(std::move(pair));
+	const uint32_t start = channel.getHash().getHash() & (k_max_channels - 1);
+	Channel* entry = nullptr;
 
-		} else {
-			// If this is not the channel added in the constructor, then log the error in that channel.
-			if (channel.getHash() != k_log_channel_default) {
-				logMessage(
-					LogType::Error,
-					k_log_channel_default,
-					u8"Failed to create channel '%s'! Failed to open file '%s'!",
-					channel.getBuffer(),
-					file_name.data()
-				);
-			}
+	for (uint32_t i = 0; i < static_cast<uint32_t>(k_max_channels); ++i) {
+		Channel& candidate = _channels[(start + i) & (k_max_channels - 1)];
+
+		if (!candidate.in_use) {
+			entry = &candidate;
+			break;
 		}
 	}
+
+	if (!entry) {
+		logMessage(
+			LogType::Error,
+			k_log_channel_default,
+			u8"Failed to create channel '%s'! Exceeded the maximum of %i channels!",
+			channel.getBuffer(),
+			k_max_channels
+		);
+
+		return;
+	}
+
+	const U8String file_name(U8String::CtorSprintf(), u8"%s/%sLog.txt", _log_dir.data(), channel.getBuffer());
+
+	if (!entry->file.open(file_name.data(), Gaff::File::OpenMode::/*Write*/Append)) {
+		// If this is not the channel added in the constructor, then log the error in that channel.
+		if (channel.getHash() != k_log_channel_default) {
+			logMessage(
+				LogType::Error,
+				k_log_channel_default,
+				u8"Failed to create channel '%s'! Failed to open file '%s'!",
+				channel.getBuffer(),
+				file_name.data()
+			);
+		}
+
+		return;
+	}
+
+	const auto level_it = _channel_levels.find(channel.getHash());
+
+	entry->name = HashString32<>(channel, ProxyAllocator("Log"));
+	entry->level = (level_it != _channel_levels.end()) ? level_it->second : static_cast<int32_t>(k_log_default_level);
+
+#ifdef SHIB_RUNTIME_VAR_ENABLED
+	addRuntimeVar(*entry);
+#endif
+
+	entry->in_use.store(true, eastl::memory_order_release);
 }
 
 void LogManager::logMessage(LogType type, Gaff::Hash32 channel, const char8_t* format, ...)
 {
+	const Channel* const entry = findChannel(channel);
+
+	// Check the level before doing any work.
+	if (!isLogEnabled(type, entry)) {
+		return;
+	}
+
+	va_list vl;
+	va_start(vl, format);
+
+	logMessageToChannel(type, channel, entry, format, vl);
+
+	va_end(vl);
+}
+
+void LogManager::logMessage(LogType type, Gaff::Hash32 channel_hash, const Channel* channel, const char8_t* format, ...)
+{
+	if (!isLogEnabled(type, channel)) {
+		return;
+	}
+
 	va_list vl;
 	va_start(vl, format);
 
-	if (!logMessageHelper(type, channel, format, vl) && channel != k_log_channel_default) {
+	logMessageToChannel(type, channel_hash, channel, format, vl);
+
+	va_end(vl);
+}
+
+void LogManager::setChannelLogLevel(Gaff::Hash32 channel, LogType level)
+{
+	const EA::Thread::AutoMutex lock(_channel_lock);
+	_channel_levels[channel] = static_cast<int32_t>(level);
+
+	if (Channel* const entry = findChannel(channel)) {
+		entry->level = static_cast<int32_t>(level);
+	}
+}
+
+LogType LogManager::getChannelLogLevel(Gaff::Hash32 channel) const
+{
+	const Channel* const entry = findChannel(channel);
+
+	if (entry) {
+		return static_cast<LogType>(eastl::clamp(entry->level, static_cast<int32_t>(LogType::Debug), static_cast<int32_t>(LogType::Error)));
+	}
+
+	const EA::Thread::AutoMutex lock(const_cast<EA::Thread::Mutex&>(_channel_lock));
+	const auto it = _channel_levels.find(channel);
+
+	return (it != _channel_levels.end()) ? static_cast<LogType>(it->second) : k_log_default_level;
+}
+
+#ifdef SHIB_RUNTIME_VAR_ENABLED
+void LogManager::setRuntimeVarManager(RuntimeVarManager* runtime_var_mgr)
+{
+	const EA::Thread::AutoMutex lock(_channel_lock);
+
+	for (Channel& channel : _channels) {
+		if (channel.in_use && channel.runtime_var) {
+			if (_runtime_var_mgr) {
+				_runtime_var_mgr->removeRuntimeVar(*channel.runtime_var);
+			}
+
+			SHIB_FREET(channel.runtime_var, _allocator);
+			channel.runtime_var = nullptr;
+		}
+	}
+
+	_runtime_var_mgr = runtime_var_mgr;
+
+	for (Channel& channel : _channels) {
+		if (channel.in_use) {
+			addRuntimeVar(channel);
+		}
+	}
+}
+
+void LogManager::addRuntimeVar(Channel& channel)
+{
+	if (!_runtime_var_mgr) {
+		return;
+	}
+
+	const U8String var_name(U8String::CtorSprintf(), u8"log_level_%s", channel.name.getBuffer());
+	channel.runtime_var = SHIB_ALLOCT(LogLevelRuntimeVar, _allocator, Gaff::FNV1aHash64String(var_name.data()), channel.level);
+
+	_runtime_var_mgr->addRuntimeVar(*channel.runtime_var);
+}
+#endif
+
+void LogManager::logMessageToChannel(LogType type, Gaff::Hash32 channel_hash, const Channel* channel, const char8_t* format, va_list& vl)
+{
+	if (channel) {
+		logMessageHelper(type, *channel, format, vl);
+
+	} else if (channel_hash != k_log_channel_default) {
 		logMessage(
 			LogType::Error,
 			k_log_channel_default,
 			u8"Failed to find channel with hash '%u'!",
-			channel
+			channel_hash.getHash()
 		);
 
 		// Log the message to the default channel.
-		logMessageHelper(type, k_log_channel_default, format, vl);
-	}
+		channel = findChannel(k_log_channel_default);
 
-	va_end(vl);
+		if (channel && channel->isLogEnabled(type)) {
+			logMessageHelper(type, *channel, format, vl);
+		}
+	}
 }
 
-bool LogManager::logMessageHelper(LogType type, Gaff::Hash32 channel, const char8_t* format, va_list& vl)
+void LogManager::logMessageHelper(LogType type, const Channel& channel, const char8_t* format, va_list& vl)
 {
-	char8_t time_string[64] = { 0 };
-	Gaff::GetCurrentTimeString(time_string, ARRAY_SIZE(time_string), u8"[%H-%M-%S] ");
+	// Format on the stack first, so a slot in the queue is only held for a copy.
+	char8_t message[LogRecord::k_inline_size];
+	Gaff::GetCurrentTimeString(message, ARRAY_SIZE(message), u8"[%H-%M-%S] ");
+
+	const int32_t time_length = static_cast<int32_t>(eastl::CharStrlen(message));
+	char8_t* overflow = nullptr;
+
+	va_list args;
+	va_copy(args, vl);
+	int32_t length = eastl::Vsnprintf(message + time_length, ARRAY_SIZE(message) - static_cast<size_t>(time_length), format, args);
+	va_end(args);
+
+	if (length < 0) {
+		message[time_length] = 0;
+		length = time_length;
 
-	U8String message;
-	message.sprintf_va_list(format, vl);
+	} else if (time_length + length >= LogRecord::k_inline_size) {
+		const size_t size = static_cast<size_t>(time_length + length + 1);
+		overflow = SHIB_ALLOC_CAST(char8_t*, size, _allocator);
 
-	auto it = Gaff::Find(_channels, channel);
+		memcpy(overflow, message, static_cast<size_t>(time_length));
 
-	if (it == _channels.end()) {
-		return false;
+		va_copy(args, vl);
+		eastl::Vsnprintf(overflow + time_length, size - static_cast<size_t>(time_length), format, args);
+		va_end(args);
+
+		length += time_length;
+
+	} else {
+		length += time_length;
 	}
 
+	const char8_t* const final_message = (overflow) ? overflow : message;
+	Gaff::DebugPrintf(u8"[%s] %s\n", channel.name.getBuffer(), final_message + time_length);
+
+	// Channel files are only closed in destroy(), after the log thread has exited.
+	FILE* const file = const_cast<Gaff::File&>(channel.file).getFile();
+
+	const auto write_record = [&](LogRecord& record) -> void
 	{
-		const EA::Thread::AutoMutex lock(_log_queue_lock);
-		_logs.emplace(LogTask{ it->second.getFile(), U8String(time_string) + message, type});
-	}
+		record.file = file;
+		record.overflow = overflow;
+		record.length = length;
+		record.type = type;
 
-	_log_lock.Post();
+		if (!overflow) {
+			memcpy(record.message, message, static_cast<size_t>(length + 1));
+		}
+	};
 
-	const U8String debug_msg(U8String::CtorSprintf(), u8"[%s] %s\n", it->first.getBuffer(), message.data());
-	Gaff::DebugPrintf(debug_msg.data());
+	while (!_records.tryPush(write_record)) {
+		// Queue is full. If we are the log thread, nobody is going to drain it.
+		if (EA::Thread::GetThreadId() == _log_thread.GetId()) {
+			if (overflow) {
+				SHIB_FREE(overflow, _allocator);
+			}
 
-	return true;
+			return;
+		}
+
+		wakeLogThread();
+		EA::Thread::ThreadSleep();
+	}
+
+	wakeLogThread();
 }
 
-void LogManager::notifyLogCallbacks(const char8_t* message, LogType type)
+void LogManager::wakeLogThread(void)
 {
-	const EA::Thread::AutoMutex lock(_log_callback_lock);
-
-	for (auto it = _log_callbacks.begin(); it != _log_callbacks.end(); ++it) {
-		it->second(message, type);
+	if (_log_thread_sleeping.exchange(false)) {
+		_log_lock.Post();
 	}
 }
 
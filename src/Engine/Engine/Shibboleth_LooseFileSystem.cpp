@@ -21,6 +21,8 @@ THE SOFTWARE.
 ************************************************************************************/
 
 #include "Shibboleth_LooseFileSystem.h"
+#include "Shibboleth_AppConfigs.h"
+#include "Shibboleth_JobPool.h"
 #include "Shibboleth_String.h"
 #include <Gaff_Utils.h>
 #include <Gaff_File.h>
@@ -55,89 +57,123 @@ int8_t* LooseFile::getBuffer(void)
 }
 
 
-LooseFileSystem::LooseFileSystem(void)
+namespace
 {
+	static constexpr Gaff::Hash32 k_read_file_pool = Gaff::FNV1aHash32StringConst(Shibboleth::k_config_app_read_file_pool_name);
+}
+
+LooseFileSystem::LooseFileSystem(JobPool* job_pool):
+	_job_pool(job_pool)
+{
+	// If io_uring isn't available, openFileAsync() falls back to the job pool.
+	_async_reader.init();
 }
 
 LooseFileSystem::~LooseFileSystem(void)
 {
-	for (auto it = _files.begin(); it != _files.end(); ++it) {
-		SHIB_FREET(it->file, GetAllocator());
+	// Wait for outstanding reads before tearing down the file table.
+	_async_reader.destroy();
+
+	for (FileShard& shard : _shards) {
+		for (auto& entry : shard.files) {
+			SHIB_FREET(entry.second.file, GetAllocator());
+		}
 	}
 }
 
 IFile* LooseFileSystem::openFile(const char8_t* file_name)
 {
 	GAFF_ASSERT(file_name && eastl::CharStrlen(file_name));
-	const EA::Thread::AutoMutex lock(_file_lock);
 
-	auto it = Gaff::Find(_files, file_name,
-	[](const FileData& lhs, const char8_t* rhs) -> bool
-	{
-		return lhs.name == rhs;
-	});
+	const Gaff::Hash64 name_hash = Gaff::FNV1aHash64String(file_name);
 
-	if (it != _files.end()) {
-		++it->count;
-		return it->file;
+	if (IFile* const file = findFile(name_hash, file_name)) {
+		return file;
 	}
 
-	const U8String name = U8String(u8"./") + file_name; // Pre-pend './' to name
-	Gaff::File loose_file;
+	// Read outside of the lock so loading different files doesn't serialize.
+	LooseFile* const file = readFile(file_name);
 
-	if (!loose_file.open(name.data(), Gaff::File::OpenMode::ReadBinary)) {
+	if (!file) {
 		return nullptr;
 	}
 
-	LooseFile* const file = SHIB_ALLOCT(LooseFile, GetAllocator());
+	return addFile(name_hash, file_name, file);
+}
 
-	// Should probably log that the allocation failed
-	if (!file) {
-		return nullptr;
-	}
+void LooseFileSystem::closeFile(const IFile* file)
+{
+	GAFF_ASSERT(file);
 
-	file->_file_size= loose_file.getFileSize();
-	file->_file_buffer = SHIB_ALLOC_CAST(int8_t*, file->_file_size + 1, GetAllocator());
+	const LooseFile* const loose_file = static_cast<const LooseFile*>(file);
+	FileShard& shard = getShard(loose_file->_name_hash);
+	LooseFile* file_to_free = nullptr;
 
-	if (!file->_file_buffer) {
-		SHIB_FREET(it->file, GetAllocator());
-		return nullptr;
-	}
+	{
+		const EA::Thread::AutoMutex lock(shard.lock);
+		const auto range = shard.files.equal_range(loose_file->_name_hash);
+		auto it = range.first;
 
-	if (!loose_file.readEntireFile(reinterpret_cast<char*>(file->_file_buffer))) {
-		SHIB_FREET(it->file, GetAllocator());
-		return nullptr;
-	}
+		while (it != range.second && it->second.file != loose_file) {
+			++it;
+		}
 
-	file->_file_buffer[file->_file_size] = 0;
+		if (it == range.second) {
+			// $TODO: Log error.
+			return;
+		}
 
-	FileData file_data;
-	file_data.name = file_name;
-	file_data.file = file;
-	file_data.count = 1;
+		if (!--it->second.count) {
+			file_to_free = it->second.file;
+			shard.files.erase(it);
+		}
+	}
 
-	_files.emplace_back(std::move(file_data));
-	return file;
+	if (file_to_free) {
+		SHIB_FREET(file_to_free, GetAllocator());
+	}
 }
 
-void LooseFileSystem::closeFile(const IFile* file)
+void LooseFileSystem::openFileAsync(const char8_t* file_name, const OpenFileCallback& callback)
 {
-	GAFF_ASSERT(file);
-	const EA::Thread::AutoMutex lock(_file_lock);
+	GAFF_ASSERT(file_name && eastl::CharStrlen(file_name));
 
-	auto it = Gaff::Find(_files, file,
-	[](const FileData& lhs, const IFile* rhs) -> bool
-	{
-		return lhs.file == rhs;
-	});
+	const Gaff::Hash64 name_hash = Gaff::FNV1aHash64String(file_name);
 
-	if (it != _files.end()) {
-		int32_t new_count = --it->count;
+	if (IFile* const file = findFile(name_hash, file_name)) {
+		callback(file);
+		return;
+	}
 
-		if (!new_count) {
-			SHIB_FREET(it->file, GetAllocator());
-			_files.erase_unsorted(it);
+	if (!_async_reader.isValid() && !_job_pool) {
+		callback(openFile(file_name));
+		return;
+	}
+
+	AsyncOpenRequest* const request = SHIB_ALLOCT(AsyncOpenRequest, GetAllocator());
+	request->allocate = AsyncOpenAllocate;
+	request->complete = AsyncOpenComplete;
+	request->file_system = this;
+	request->callback = callback;
+	request->name = file_name;
+	request->name_hash = name_hash;
+
+	if (_async_reader.isValid()) {
+		request->path = U8String(u8"./") + file_name; // Pre-pend './' to name
+
+		if (_async_reader.read(request->path.data(), *request)) {
+			return;
 		}
+
+		// The ring is full. Let the blocking path sort it out.
+	}
+
+	if (_job_pool) {
+		const Gaff::JobData job_data = { AsyncOpenJob, request };
+		_job_pool->addJobs(&job_data, 1, nullptr, k_read_file_pool);
+
+	} else {
+		AsyncOpenJob(0, request);
 	}
 }
 
@@ -188,4 +224,144 @@ bool LooseFileSystem::forEachFile(const char8_t* directory, eastl::function<bool
 	return forEachFile(directory, callback, nullptr, recursive);
 }
 
+int8_t* LooseFileSystem::AsyncOpenAllocate(Gaff::AsyncFileReader::Request& request, size_t size)
+{
+	AsyncOpenRequest& open_request = static_cast<AsyncOpenRequest&>(request);
+	LooseFile* const file = SHIB_ALLOCT(LooseFile, GetAllocator());
+
+	if (!file) {
+		return nullptr;
+	}
+
+	// Leave room for the null terminator.
+	file->_file_buffer = SHIB_ALLOC_CAST(int8_t*, size + 1, GetAllocator());
+	file->_file_size = size;
+
+	if (!file->_file_buffer) {
+		SHIB_FREET(file, GetAllocator());
+		return nullptr;
+	}
+
+	open_request.file = file;
+	return file->_file_buffer;
+}
+
+void LooseFileSystem::AsyncOpenComplete(Gaff::AsyncFileReader::Request& request, int32_t result)
+{
+	AsyncOpenRequest* const open_request = static_cast<AsyncOpenRequest*>(&request);
+	IFile* file = nullptr;
+
+	if (result < 0) {
+		// $TODO: Log error.
+		// Failed opens never got as far as allocating.
+		if (open_request->file) {
+			SHIB_FREET(open_request->file, GetAllocator());
+		}
+
+	} else {
+		open_request->file->_file_buffer[open_request->file->_file_size] = 0;
+		file = open_request->file_system->addFile(open_request->name_hash, open_request->name.data(), open_request->file);
+	}
+
+	open_request->callback(file);
+	SHIB_FREET(open_request, GetAllocator());
+}
+
+void LooseFileSystem::AsyncOpenJob(uintptr_t /*thread_id_int*/, void* data)
+{
+	AsyncOpenRequest* const open_request = reinterpret_cast<AsyncOpenRequest*>(data);
+
+	open_request->callback(open_request->file_system->openFile(open_request->name.data()));
+	SHIB_FREET(open_request, GetAllocator());
+}
+
+LooseFileSystem::FileMap::iterator LooseFileSystem::FindFileData(FileMap& files, Gaff::Hash64 name_hash, const char8_t* file_name)
+{
+	const auto range = files.equal_range(name_hash);
+
+	for (auto it = range.first; it != range.second; ++it) {
+		if (it->second.name == file_name) {
+			return it;
+		}
+	}
+
+	return files.end();
+}
+
+LooseFileSystem::FileShard& LooseFileSystem::getShard(Gaff::Hash64 name_hash)
+{
+	return _shards[name_hash.getHash() % k_num_shards];
+}
+
+IFile* LooseFileSystem::findFile(Gaff::Hash64 name_hash, const char8_t* file_name)
+{
+	FileShard& shard = getShard(name_hash);
+	const EA::Thread::AutoMutex lock(shard.lock);
+	const auto it = FindFileData(shard.files, name_hash, file_name);
+
+	if (it == shard.files.end()) {
+		return nullptr;
+	}
+
+	++it->second.count;
+	return it->second.file;
+}
+
+IFile* LooseFileSystem::addFile(Gaff::Hash64 name_hash, const char8_t* file_name, LooseFile* file)
+{
+	file->_name_hash = name_hash;
+
+	FileShard& shard = getShard(name_hash);
+	const EA::Thread::AutoMutex lock(shard.lock);
+	const auto it = FindFileData(shard.files, name_hash, file_name);
+
+	// Another thread opened the same file while we were reading it.
+	if (it != shard.files.end()) {
+		SHIB_FREET(file, GetAllocator());
+
+		++it->second.count;
+		return it->second.file;
+	}
+
+	FileData& file_data = shard.files.insert(name_hash)->second;
+	file_data.name = file_name;
+	file_data.file = file;
+	file_data.count = 1;
+
+	return file;
+}
+
+LooseFile* LooseFileSystem::readFile(const char8_t* file_name)
+{
+	const U8String name = U8String(u8"./") + file_name; // Pre-pend './' to name
+	Gaff::File loose_file;
+
+	if (!loose_file.open(name.data(), Gaff::File::OpenMode::ReadBinary)) {
+		return nullptr;
+	}
+
+	LooseFile* const file = SHIB_ALLOCT(LooseFile, GetAllocator());
+
+	// Should probably log that the allocation failed
+	if (!file) {
+		return nullptr;
+	}
+
+	file->_file_size = loose_file.getFileSize();
+	file->_file_buffer = SHIB_ALLOC_CAST(int8_t*, file->_file_size + 1, GetAllocator());
+
+	if (!file->_file_buffer) {
+		SHIB_FREET(file, GetAllocator());
+		return nullptr;
+	}
+
+	if (!loose_file.readEntireFile(reinterpret_cast<char*>(file->_file_buffer))) {
+		SHIB_FREET(file, GetAllocator());
+		return nullptr;
+	}
+
+	file->_file_buffer[file->_file_size] = 0;
+	return file;
+}
+
 NS_END
@@ -25,22 +25,38 @@ THE SOFTWARE.
 NS_SHIBBOLETH
 
 static ProxyAllocator g_global_proxy;
+static ProxyAllocator g_frame_proxy(GetFrameAllocator(), "Frame Allocator");
 
 ProxyAllocator& ProxyAllocator::GetGlobal(void)
 {
 	return g_global_proxy;
 }
 
+ProxyAllocator& ProxyAllocator::GetFrame(void)
+{
+	return g_frame_proxy;
+}
+
+ProxyAllocator::ProxyAllocator(Shibboleth::IAllocator& allocator, const char* pool_tag):
+	_allocator(&allocator),
+	_pool_tag(pool_tag)
+{
+	if (_pool_tag) {
+		_pool_index = _allocator->getPoolIndex(_pool_tag);
+	}
+}
+
 ProxyAllocator::ProxyAllocator(const char* pool_tag):
 	_pool_tag(pool_tag)
 {
 	if (_pool_tag) {
-		_pool_index = _allocator.getPoolIndex(_pool_tag);
+		_pool_index = _allocator->getPoolIndex(_pool_tag);
 	}
 }
 
 const ProxyAllocator& ProxyAllocator::operator=(const ProxyAllocator& rhs)
 {
+	_allocator = rhs._allocator;
 	_pool_tag = rhs._pool_tag;
 	_pool_index = rhs._pool_index;
 	return *this;
@@ -48,47 +64,47 @@ const ProxyAllocator& ProxyAllocator::operator=(const ProxyAllocator& rhs)
 
 bool ProxyAllocator::operator==(const ProxyAllocator& rhs) const
 {
-	return _pool_index == rhs._pool_index;
+	return _allocator == rhs._allocator && _pool_index == rhs._pool_index;
 }
 
 void* ProxyAllocator::alloc(size_t size_bytes, size_t alignment, const char* file, int line)
 {
-	return _allocator.alloc(size_bytes, alignment, _pool_index, file, line);
+	return _allocator->alloc(size_bytes, alignment, _pool_index, file, line);
 }
 
 void* ProxyAllocator::alloc(size_t size_bytes, const char* file, int line)
 {
-	return _allocator.alloc(size_bytes, _pool_index, file, line);
+	return _allocator->alloc(size_bytes, _pool_index, file, line);
 }
 
 void ProxyAllocator::free(void* data)
 {
-	_allocator.free(data);
+	_allocator->free(data);
 }
 
 void* ProxyAllocator::realloc(void* old_ptr, size_t new_size, size_t alignment, const char* file, int line)
 {
-	return _allocator.realloc(old_ptr, new_size, alignment, _pool_index, file, line);
+	return _allocator->realloc(old_ptr, new_size, alignment, _pool_index, file, line);
 }
 
 void* ProxyAllocator::realloc(void* old_ptr, size_t new_size, const char* file, int line)
 {
-	return _allocator.realloc(old_ptr, new_size, _pool_index, file, line);
+	return _allocator->realloc(old_ptr, new_size, _pool_index, file, line);
 }
 
 void* ProxyAllocator::calloc(size_t num_members, size_t member_size, size_t alignment, const char* file, int line)
 {
-	return _allocator.calloc(num_members, member_size, alignment, file, line);
+	return _allocator->calloc(num_members, member_size, alignment, file, line);
 }
 
 void* ProxyAllocator::calloc(size_t num_members, size_t member_size, const char* file, int line)
 {
-	return _allocator.calloc(num_members, member_size, file, line);
+	return _allocator->calloc(num_members, member_size, file, line);
 }
 
 size_t ProxyAllocator::getUsableSize(const void* data) const
 {
-	return _allocator.getUsableSize(data);
+	return _allocator->getUsableSize(data);
 }
 
 // For EASTL support.
@@ -50,6 +50,22 @@ void RuntimeVarManager::addRuntimeVar(IRuntimeVar& runtime_var)
 	_runtime_vars.insert(it, &runtime_var);
 }
 
+bool RuntimeVarManager::removeRuntimeVar(const IRuntimeVar& runtime_var)
+{
+	const auto it = Gaff::LowerBound(
+		_runtime_vars,
+		runtime_var.getName(),
+		[](IRuntimeVar* const lhs, Gaff::Hash64 rhs) -> bool { return lhs->getName() < rhs; }
+	);
+
+	if (it != _runtime_vars.end() && *it == &runtime_var) {
+		_runtime_vars.erase(it);
+		return true;
+	}
+
+	return false;
+}
+
 IRuntimeVar* RuntimeVarManager::getRuntimeVar(Gaff::Hash64 name) const
 {
 	const auto it = Gaff::LowerBound(
@@ -70,6 +70,8 @@ public:
 	LogManager& getLogManager(void) override;
 	JobPool& getJobPool(void) override;
 
+	IMainLoop* getMainLoop(void) override;
+
 	//FileWatcherManager& getFileWatcherManager(void) override;
 	DynamicLoader& getDynamicLoader(void) override;
 
@@ -30,18 +30,27 @@ NS_SHIBBOLETH
 // App
 constexpr const char8_t* const k_config_app_working_dir = u8"app_working_dir";
 constexpr const char8_t* const k_config_app_log_dir = u8"app_log_dir";
+constexpr const char8_t* const k_config_app_log_flush_interval_ms = u8"app_log_flush_interval_ms";
+constexpr const char8_t* const k_config_app_log_flush_bytes = u8"app_log_flush_bytes";
+constexpr const char8_t* const k_config_app_log_channel_levels = u8"app_log_channel_levels";
 constexpr const char8_t* const k_config_app_editor_mode = u8"app_editor_mode";
 constexpr const char8_t* const k_config_app_hot_reload_modules = u8"app_hot_reload_modules";
 constexpr const char8_t* const k_config_app_read_file_threads = u8"app_read_file_threads";
+constexpr const char8_t* const k_config_app_job_pool_work_stealing = u8"app_job_pool_work_stealing";
+constexpr const char8_t* const k_config_app_frame_allocator_size = u8"app_frame_allocator_size";
 constexpr const char8_t* const k_config_app_file_system = u8"app_file_system";
+constexpr const char8_t* const k_config_app_pack_file = u8"app_pack_file";
 constexpr const char8_t* const k_config_app_no_load_modules = u8"app_no_load_modules";
 constexpr const char8_t* const k_config_app_no_managers = u8"app_no_managers";
 constexpr const char8_t* const k_config_app_no_main_loop = u8"app_no_main_loop";
 constexpr const char8_t* const k_config_app_main_loop = u8"app_main_loop";
 
 constexpr const char8_t* const k_config_app_default_log_dir = u8"./logs";
+constexpr int32_t k_config_app_default_log_flush_interval_ms = 250;
+constexpr int32_t k_config_app_default_log_flush_bytes = 64 * 1024;
 constexpr const char8_t* const k_config_app_read_file_pool_name = u8"Read File";
 constexpr int32_t k_config_app_default_read_file_threads = 1;
+constexpr const char8_t* const k_config_app_default_pack_file = u8"Resources.pack";
 
 // Modules
 constexpr const char8_t* const k_config_module_unload_order = u8"module_unload_order";
@@ -0,0 +1,245 @@
+/************************************************************************************
+Copyright (C) 2022 by Nicholas LaCroix
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+************************************************************************************/
+
+#pragma once
+
+#include "Shibboleth_MessagePackSerializeWriter.h"
+#include "Shibboleth_ReflectionDefines.h"
+#include "Shibboleth_SerializeReader.h"
+#include "Shibboleth_Vector.h"
+#include <Gaff_MessagePack.h>
+#include <Gaff_Hash.h>
+
+NS_REFLECTION
+	class IReflectionDefinition;
+NS_END
+
+NS_SHIBBOLETH
+
+// Compact binary format for reflected objects. All values are in native byte order.
+//
+// File:
+//		BinaryFileHeader
+//		Object
+//
+// Object:
+//		BinaryObjectHeader
+//		uint32_t copy_count
+//		uint32_t copy_size
+//		BinaryCopyField[copy_count]		Describes the block below. Skipped when the layout hash matches.
+//		uint8_t[copy_size]				Trivially copyable vars, back to back.
+//		uint32_t field_count
+//		{ BinaryField, uint8_t[size] }[field_count]
+//
+// Objects that use a custom serialize function are stored as a MessagePack blob instead.
+//
+// Resources don't look for .sbr files yet. Their loaders still read the JSON or MessagePack source, so .sbr
+// files written by ReflectionBinaryConverter are only used by code that calls LoadBinaryFile() itself.
+
+constexpr uint32_t k_binary_magic = 0x46524253; // "SBRF"
+constexpr uint32_t k_binary_format_version = 1;
+
+enum class BinaryObjectType : uint32_t
+{
+	Fields,
+	MessagePack
+};
+
+enum class BinaryFieldType : uint32_t
+{
+	Object,
+	MessagePack
+};
+
+struct BinaryFileHeader final
+{
+	uint32_t magic = k_binary_magic;
+	uint32_t format_version = k_binary_format_version;
+};
+
+struct BinaryObjectHeader final
+{
+	uint64_t type_hash = 0;
+	uint64_t layout_hash = 0;
+	BinaryObjectType type = BinaryObjectType::Fields;
+	uint32_t size = 0; // Size of everything after this header.
+};
+
+struct BinaryCopyField final
+{
+	uint64_t type_hash = 0;
+	uint32_t name_hash = 0;
+	uint32_t size = 0;
+};
+
+struct BinaryField final
+{
+	uint32_t name_hash = 0;
+	BinaryFieldType type = BinaryFieldType::MessagePack;
+	uint32_t size = 0;
+};
+
+// Types that can be written to the binary format by copying their bytes.
+// Specialize for trivially copyable types that don't contain pointers.
+template <class T>
+struct IsBinaryCopyable final
+{
+	static constexpr bool value = std::is_arithmetic<T>::value || std::is_enum<T>::value;
+};
+
+#define SHIB_BINARY_COPYABLE(type) \
+	NS_SHIBBOLETH \
+		template <> \
+		struct IsBinaryCopyable<type> final \
+		{ \
+			static_assert(std::is_trivially_copyable<type>::value, #type " is not trivially copyable."); \
+			static constexpr bool value = true; \
+		}; \
+	NS_END
+
+class BinarySerializeWriter final
+{
+public:
+	BinarySerializeWriter(const ProxyAllocator& allocator = ProxyAllocator("Reflection"));
+
+	void writeFileHeader(void);
+	void write(const void* data, size_t size);
+
+	template <class T>
+	void write(const T& value)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "Type is not trivially copyable.");
+		write(&value, sizeof(T));
+	}
+
+	// Reserves space for a value that is filled in later with writeAt().
+	template <class T>
+	size_t reserve(void)
+	{
+		const size_t offset = _buffer.size();
+		_buffer.resize(offset + sizeof(T));
+		return offset;
+	}
+
+	template <class T>
+	void writeAt(size_t offset, const T& value)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "Type is not trivially copyable.");
+		GAFF_ASSERT((offset + sizeof(T)) <= _buffer.size());
+		memcpy(_buffer.data() + offset, &value, sizeof(T));
+	}
+
+	// Writes whatever save_func writes to a MessagePack writer. Used for values that have no binary layout.
+	template <class Func>
+	void writeMessagePack(Func&& save_func)
+	{
+		MessagePackSerializeWriter writer;
+		char* buffer = nullptr;
+		size_t size = 0;
+
+		writer.init(&buffer, &size);
+		save_func(static_cast<ISerializeWriter&>(writer));
+		writer.finish();
+
+		if (buffer) {
+			write(buffer, size);
+			MPACK_FREE(buffer);
+		}
+	}
+
+	const uint8_t* getBuffer(void) const;
+	size_t size(void) const;
+
+	void clear(void);
+
+private:
+	Vector<uint8_t> _buffer;
+};
+
+class BinarySerializeReader final
+{
+public:
+	BinarySerializeReader(const void* buffer, size_t size);
+
+	bool readFileHeader(void);
+	bool read(void* out, size_t size);
+	bool skip(size_t size);
+
+	template <class T>
+	bool read(T& out)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "Type is not trivially copyable.");
+		return read(&out, sizeof(T));
+	}
+
+	// Returns a reader over the next size bytes and moves this reader past them.
+	BinarySerializeReader split(size_t size);
+
+	// Reads the next size bytes as MessagePack and passes a reader for its root to load_func.
+	template <class Func>
+	bool readMessagePack(size_t size, Func&& load_func)
+	{
+		const uint8_t* const data = _cursor;
+
+		if (!skip(size)) {
+			return false;
+		}
+
+		Gaff::MessagePackReader mpack;
+
+		if (!mpack.parse(reinterpret_cast<const char*>(data), size)) {
+			return false;
+		}
+
+		const SerializeReader<Gaff::MessagePackNode> reader(mpack.getRoot());
+		return load_func(static_cast<const ISerializeReader&>(reader));
+	}
+
+	const uint8_t* getCursor(void) const;
+	size_t getRemaining(void) const;
+	bool hasFailed(void) const;
+
+private:
+	const uint8_t* _cursor = nullptr;
+	const uint8_t* _end = nullptr;
+	bool _failed = false;
+};
+
+// Stores the whole object using its regular load/save functions.
+bool LoadBinaryMessagePack(BinarySerializeReader& reader, const Refl::IReflectionDefinition& ref_def, void* object);
+void SaveBinaryMessagePack(BinarySerializeWriter& writer, const Refl::IReflectionDefinition& ref_def, const void* object);
+
+// Stores the whole object as a single copied block. Used for built-in types.
+bool LoadBinaryCopy(BinarySerializeReader& reader, const Refl::IReflectionDefinition& ref_def, void* object, size_t size);
+void SaveBinaryCopy(BinarySerializeWriter& writer, const Refl::IReflectionDefinition& ref_def, const void* object, size_t size);
+
+// Skips over an object, such as one whose type is not known.
+bool SkipBinaryObject(BinarySerializeReader& reader);
+
+// Writes a file header followed by object.
+void SaveBinaryFile(BinarySerializeWriter& writer, const Refl::IReflectionDefinition& ref_def, const void* object);
+bool LoadBinaryFile(const void* buffer, size_t size, const Refl::IReflectionDefinition& ref_def, void* object);
+
+// Logs why an object of ref_def's type failed to load. Keeps the log manager out of the reflection headers.
+void LogBinaryLoadError(const Refl::IReflectionDefinition& ref_def, const char8_t* format, ...);
+
+NS_END
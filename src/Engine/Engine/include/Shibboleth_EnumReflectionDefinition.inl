@@ -51,8 +51,12 @@ void EnumReflectionDefinition<Enum>::save(Shibboleth::ISerializeWriter& writer,
 template <class Enum>
 bool EnumReflectionDefinition<Enum>::load(const Shibboleth::ISerializeReader& reader, Enum& value) const
 {
-	const char8_t* const name = reader.readString();
-	const int32_t intValue = getEntryValue(name);
+	if (!reader.isString()) {
+		return false;
+	}
+
+	const eastl::u8string_view name = reader.readStringView();
+	const int32_t intValue = getEntryValue(Gaff::FNV1aHash32(reinterpret_cast<const char*>(name.data()), name.size()));
 
 	if (intValue == std::numeric_limits<int32_t>::min()) {
 		return false;
@@ -42,6 +42,7 @@ NS_SHIBBOLETH
 class ReflectionManager;
 class IFileSystem;
 class LogManager;
+class IMainLoop;
 class IManager;
 
 class IApp
@@ -63,6 +64,9 @@ public:
 	virtual LogManager& getLogManager(void) = 0;
 	virtual JobPool& getJobPool(void) = 0;
 
+	// Null if the app was started without a main loop.
+	virtual IMainLoop* getMainLoop(void) = 0;
+
 	//virtual FileWatcherManager& getFileWatcherManager(void) = 0;
 	virtual DynamicLoader& getDynamicLoader(void) = 0;
 
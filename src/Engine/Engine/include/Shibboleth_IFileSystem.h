@@ -47,12 +47,19 @@ class IFileSystem
 public:
 	//enum OpenMode { OT_READ = 0, OT_WRITE };
 
+	// Called with the opened file, or nullptr if it failed to open.
+	using OpenFileCallback = eastl::function<void (IFile*)>;
+
 	IFileSystem(void) {}
 	virtual ~IFileSystem(void) {}
 
 	virtual IFile* openFile(const char8_t* file_name/*, OpenMode mode*/) = 0;
 	virtual void closeFile(const IFile* file) = 0;
 
+	// Queues a file to be opened without blocking the calling thread. Close the file with closeFile() as usual.
+	// callback may be called on any thread, including the calling thread if the file is already open.
+	virtual void openFileAsync(const char8_t* file_name, const OpenFileCallback& callback) = 0;
+
 	// This function circumvents the file cache. If a file is already open, it will open it again and allocate another buffer.
 	// Should be used during initialization/loading phases only.
 	virtual bool forEachFile(const char8_t* directory, eastl::function<bool(const char8_t*, IFile*)>& callback, const char8_t* extension, bool recursive = false) = 0;
@@ -22,10 +22,44 @@ THE SOFTWARE.
 
 #pragma once
 
+#include "Shibboleth_Vector.h"
 #include <Shibboleth_Defines.h>
 
 NS_SHIBBOLETH
 
+// Summary of a rolling window of recent samples.
+struct TimingStats final
+{
+	int64_t min_ns = 0;
+	int64_t avg_ns = 0;
+	int64_t max_ns = 0;
+	int64_t p99_ns = 0;
+	int32_t num_samples = 0;
+};
+
+struct SystemTimingStats final
+{
+	// Owned by the system's reflection definition.
+	const char8_t* name = nullptr;
+	int32_t block = 0;
+	int32_t row = 0;
+
+	// Time spent in ISystem::update().
+	TimingStats update;
+
+	// Time from the block starting to this system starting. This is waiting on dependencies and for a free thread.
+	TimingStats wait;
+};
+
+struct BlockTimingStats final
+{
+	// Time from the block starting to its last system finishing.
+	TimingStats run;
+
+	// Time from the block finishing to it starting again, while it waits for the blocks around it to catch up.
+	TimingStats stall;
+};
+
 class IMainLoop : public Refl::IReflectionObject
 {
 public:
@@ -34,6 +68,10 @@ public:
 	virtual bool init(void) = 0;
 	virtual void destroy(void) = 0;
 	virtual void update(void) = 0;
+
+	// Safe to call from any thread. Main loops that don't track timings return nothing.
+	virtual void getSystemTimings(Vector<SystemTimingStats>& out) const { out.clear(); }
+	virtual void getBlockTimings(Vector<BlockTimingStats>& out) const { out.clear(); }
 };
 
 NS_END
@@ -30,6 +30,8 @@ THE SOFTWARE.
 #include <Gaff_Hash.h>
 
 NS_SHIBBOLETH
+	class BinarySerializeReader;
+	class BinarySerializeWriter;
 	class ISerializeReader;
 	class ISerializeWriter;
 NS_END
@@ -592,6 +594,9 @@ public:
 	virtual bool load(const Shibboleth::ISerializeReader& reader, void* object, bool refl_load = false) const = 0;
 	virtual void save(Shibboleth::ISerializeWriter& writer, const void* object, bool refl_save = false) const = 0;
 
+	virtual bool loadBinary(Shibboleth::BinarySerializeReader& reader, void* object) const = 0;
+	virtual void saveBinary(Shibboleth::BinarySerializeWriter& writer, const void* object) const = 0;
+
 	virtual Gaff::Hash64 getInstanceHash(const void* object, Gaff::Hash64 init = Gaff::k_init_hash64) const = 0;
 
 	virtual const void* getInterface(Gaff::Hash64 class_id, const void* object) const = 0;
@@ -22,36 +22,63 @@ THE SOFTWARE.
 
 #pragma once
 
+#include "Shibboleth_RuntimeVarManagerFwd.h"
 #include "Shibboleth_AppConfigs.h"
 #include "Shibboleth_HashString.h"
 #include "Shibboleth_VectorMap.h"
 #include "Shibboleth_Vector.h"
 #include "Shibboleth_String.h"
-#include "Shibboleth_Queue.h"
+#include <Gaff_MPSCQueue.h>
 #include <Gaff_File.h>
 #include <eathread/eathread_semaphore.h>
 #include <eathread/eathread_thread.h>
 #include <eathread/eathread_mutex.h>
 #include <EASTL/functional.h>
 
+// Log statements below this level are compiled out entirely. Matches the values of LogType.
+#ifndef SHIB_LOG_MIN_LEVEL
+	#ifdef DEBUG
+		#define SHIB_LOG_MIN_LEVEL 0
+	#else
+		#define SHIB_LOG_MIN_LEVEL 1
+	#endif
+#endif
+
 NS_SHIBBOLETH
 
 enum class LogType
 {
-	Info = 0,
+	Debug = 0,
+	Info,
 	Warning,
 	Error
 };
 
+static_assert(SHIB_LOG_MIN_LEVEL >= static_cast<int32_t>(LogType::Debug) && SHIB_LOG_MIN_LEVEL <= static_cast<int32_t>(LogType::Error), "SHIB_LOG_MIN_LEVEL is not a valid LogType.");
+
+static constexpr LogType k_log_default_level = static_cast<LogType>(SHIB_LOG_MIN_LEVEL);
+
+bool GetLogType(const char8_t* name, LogType& out_type);
+
 class LogManager final
 {
+private:
+	struct Channel;
+
 public:
 	using LogCallback = eastl::function<void (const char8_t*, LogType)>;
 
 	LogManager(void);
 	~LogManager(void);
 
-	bool init(const char8_t* log_dir);
+	// Files are flushed when flush_interval_ms has passed or flush_bytes have been written since the last flush,
+	// whichever comes first. Errors are always flushed right away.
+	bool init(
+		const char8_t* log_dir,
+		int32_t flush_interval_ms = k_config_app_default_log_flush_interval_ms,
+		int32_t flush_bytes = k_config_app_default_log_flush_bytes
+	);
+
 	void destroy(void);
 
 	int32_t addLogCallback(const LogCallback& callback);
@@ -61,33 +88,138 @@ public:
 	void addChannel(HashStringView32<> channel);
 	void logMessage(LogType type, Gaff::Hash32 channel, const char8_t* format, ...);
 
+	// Same as above, but with a channel already looked up by getChannel(). Saves the log macros a second lookup.
+	void logMessage(LogType type, Gaff::Hash32 channel_hash, const Channel* channel, const char8_t* format, ...);
+
+	// Returns nullptr if the channel hasn't been added.
+	const Channel* getChannel(Gaff::Hash32 channel) const { return findChannel(channel); }
+
+	// Messages below the channel's level are dropped before any formatting is done.
+	// Levels set before the channel is added are applied when it is added.
+	void setChannelLogLevel(Gaff::Hash32 channel, LogType level);
+	LogType getChannelLogLevel(Gaff::Hash32 channel) const;
+
+	bool isLogEnabled(LogType type, const Channel* channel) const
+	{
+		// Messages to unknown channels go to the default channel, along with an error.
+		return !channel || channel->isLogEnabled(type);
+	}
+
+	bool isLogEnabled(LogType type, Gaff::Hash32 channel) const
+	{
+		return isLogEnabled(type, findChannel(channel));
+	}
+
+#ifdef SHIB_RUNTIME_VAR_ENABLED
+	// Exposes each channel's level as a runtime variable named "log_level_<channel>".
+	void setRuntimeVarManager(RuntimeVarManager* runtime_var_mgr);
+#endif
+
 private:
-	struct LogTask
+	struct Channel final
 	{
-		FILE* const file;
-		U8String message;
-		LogType type;
+		HashString32<> name{ ProxyAllocator("Log") };
+		Gaff::File file;
+
+		// Plain int32_t so it can be edited as a runtime variable. Only ever a single aligned read or write.
+		int32_t level = static_cast<int32_t>(k_log_default_level);
+
+#ifdef SHIB_RUNTIME_VAR_ENABLED
+		IRuntimeVar* runtime_var = nullptr;
+#endif
+
+		// Set last when adding a channel, so readers never see a partially constructed entry.
+		eastl::atomic<bool> in_use = false;
+
+		bool isLogEnabled(LogType type) const { return static_cast<int32_t>(type) >= level; }
 	};
 
+	// Fully formatted message, including the timestamp.
+	struct LogRecord final
+	{
+		static constexpr int32_t k_inline_size = 480;
+
+		FILE* file = nullptr;
+
+		// Messages that don't fit inline are allocated separately and freed by the log thread.
+		char8_t* overflow = nullptr;
+
+		int32_t length = 0;
+		LogType type = LogType::Info;
+
+		char8_t message[k_inline_size];
+
+		const char8_t* getMessage(void) const { return (overflow) ? overflow : message; }
+	};
+
+	static constexpr int64_t k_log_queue_capacity = 1024;
+	static constexpr int32_t k_max_batch_size = 256;
+	static constexpr int32_t k_max_channels = 64; // Must be a power of two.
+
+	static_assert((k_max_channels & (k_max_channels - 1)) == 0, "k_max_channels must be a power of two.");
+
 	bool _shutdown;
 	EA::Thread::Semaphore _log_lock;
 
-	VectorMap<HashString32<>, Gaff::File> _channels{ ProxyAllocator("Log") };
+	// Producers only post _log_lock when the log thread is about to sleep, instead of once per message.
+	eastl::atomic<bool> _log_thread_sleeping = false;
+
+	// Open addressed on the channel hash. Entries are never removed until destroy().
+	Channel _channels[k_max_channels];
+	VectorMap<Gaff::Hash32, int32_t> _channel_levels{ ProxyAllocator("Log") };
+	EA::Thread::Mutex _channel_lock;
+
+#ifdef SHIB_RUNTIME_VAR_ENABLED
+	RuntimeVarManager* _runtime_var_mgr = nullptr;
+#endif
+
 	VectorMap<int32_t, LogCallback> _log_callbacks{ ProxyAllocator("Log") };
-	Queue<LogTask> _logs{ ProxyAllocator("Log") };
+	Gaff::MPSCQueue<LogRecord, ProxyAllocator> _records{ k_log_queue_capacity, ProxyAllocator("Log") };
 
+	ProxyAllocator _allocator{ "Log" };
+
+	int32_t _flush_interval_ms = k_config_app_default_log_flush_interval_ms;
+	int32_t _flush_bytes = k_config_app_default_log_flush_bytes;
 	int32_t _next_id = 0;
 
 	EA::Thread::Mutex _log_callback_lock;
-	EA::Thread::Mutex _log_queue_lock;
 
 	EA::Thread::Thread _log_thread;
 
 	U8String _log_dir{ k_config_app_default_log_dir, ProxyAllocator("Log") };
 
 
-	bool logMessageHelper(LogType type, Gaff::Hash32 channel, const char8_t* format, va_list& vl);
-	void notifyLogCallbacks(const char8_t* message, LogType type);
+	const Channel* findChannel(Gaff::Hash32 channel) const
+	{
+		const uint32_t start = channel.getHash() & (k_max_channels - 1);
+
+		for (uint32_t i = 0; i < static_cast<uint32_t>(k_max_channels); ++i) {
+			const Channel& entry = _channels[(start + i) & (k_max_channels - 1)];
+
+			if (!entry.in_use.load(eastl::memory_order_acquire)) {
+				return nullptr;
+			}
+
+			if (entry.name.getHash() == channel) {
+				return &entry;
+			}
+		}
+
+		return nullptr;
+	}
+
+	Channel* findChannel(Gaff::Hash32 channel)
+	{
+		return const_cast<Channel*>(const_cast<const LogManager*>(this)->findChannel(channel));
+	}
+
+	void logMessageToChannel(LogType type, Gaff::Hash32 channel_hash, const Channel* channel, const char8_t* format, va_list& vl);
+	void logMessageHelper(LogType type, const Channel& channel, const char8_t* format, va_list& vl);
+	void wakeLogThread(void);
+
+#ifdef SHIB_RUNTIME_VAR_ENABLED
+	void addRuntimeVar(Channel& channel);
+#endif
 
 	static intptr_t LogThread(void* args);
 
@@ -100,17 +232,46 @@ static constexpr Gaff::Hash32 k_log_channel_default = Gaff::FNV1aHash32StringCon
 
 NS_END
 
-#define LogWithApp(app, type, channel, message, ...) app.getLogManager().logMessage(type, channel, u8##message, ##__VA_ARGS__)
+// The level check happens before the arguments are evaluated, so disabled log statements are just a lookup.
+// The channel found by the check is handed to logMessage(), so it isn't looked up again.
+#define LogWithApp(app, type, channel, message, ...) \
+	do { \
+		Shibboleth::LogManager& shib_log_mgr = (app).getLogManager(); \
+		const auto* const shib_log_channel = shib_log_mgr.getChannel(channel); \
+		if (shib_log_mgr.isLogEnabled(type, shib_log_channel)) { \
+			shib_log_mgr.logMessage(type, channel, shib_log_channel, u8##message, ##__VA_ARGS__); \
+		} \
+	} while (false)
 
 #define LogType(type, channel, message, ...) LogWithApp(Shibboleth::GetApp(), type, channel, u8##message, ##__VA_ARGS__)
 #define LogError(channel, message, ...) LogWithApp(Shibboleth::GetApp(), Shibboleth::LogType::Error, channel, "[ERROR] " u8##message, ##__VA_ARGS__)
-#define LogWarning(channel, message, ...) LogWithApp(Shibboleth::GetApp(), Shibboleth::LogType::Warning, channel, "[WARNING] " u8##message, ##__VA_ARGS__)
-#define LogInfo(channel, message, ...) LogWithApp(Shibboleth::GetApp(), Shibboleth::LogType::Info, channel, message, ##__VA_ARGS__)
 #define LogErrorDefault(message, ...) LogWithApp(Shibboleth::GetApp(), Shibboleth::LogType::Error, Shibboleth::k_log_channel_default, "[ERROR] " u8##message, ##__VA_ARGS__)
-#define LogWarningDefault(message, ...) LogWithApp(Shibboleth::GetApp(), Shibboleth::LogType::Warning, Shibboleth::k_log_channel_default, "[WARNING] " u8##message, ##__VA_ARGS__)
-#define LogInfoDefault(message, ...) LogWithApp(Shibboleth::GetApp(), Shibboleth::LogType::Info, Shibboleth::k_log_channel_default, message, ##__VA_ARGS__)
 #define LogDefault(type, message, ...) LogWithApp(Shibboleth::GetApp(), type, Shibboleth::k_log_channel_default, message, ##__VA_ARGS__)
 
+#if SHIB_LOG_MIN_LEVEL <= 2
+	#define LogWarning(channel, message, ...) LogWithApp(Shibboleth::GetApp(), Shibboleth::LogType::Warning, channel, "[WARNING] " u8##message, ##__VA_ARGS__)
+	#define LogWarningDefault(message, ...) LogWithApp(Shibboleth::GetApp(), Shibboleth::LogType::Warning, Shibboleth::k_log_channel_default, "[WARNING] " u8##message, ##__VA_ARGS__)
+#else
+	#define LogWarning(channel, message, ...) do {} while (false)
+	#define LogWarningDefault(message, ...) do {} while (false)
+#endif
+
+#if SHIB_LOG_MIN_LEVEL <= 1
+	#define LogInfo(channel, message, ...) LogWithApp(Shibboleth::GetApp(), Shibboleth::LogType::Info, channel, message, ##__VA_ARGS__)
+	#define LogInfoDefault(message, ...) LogWithApp(Shibboleth::GetApp(), Shibboleth::LogType::Info, Shibboleth::k_log_channel_default, message, ##__VA_ARGS__)
+#else
+	#define LogInfo(channel, message, ...) do {} while (false)
+	#define LogInfoDefault(message, ...) do {} while (false)
+#endif
+
+#if SHIB_LOG_MIN_LEVEL <= 0
+	#define LogDebug(channel, message, ...) LogWithApp(Shibboleth::GetApp(), Shibboleth::LogType::Debug, channel, "[DEBUG] " u8##message, ##__VA_ARGS__)
+	#define LogDebugDefault(message, ...) LogWithApp(Shibboleth::GetApp(), Shibboleth::LogType::Debug, Shibboleth::k_log_channel_default, "[DEBUG] " u8##message, ##__VA_ARGS__)
+#else
+	#define LogDebug(channel, message, ...) do {} while (false)
+	#define LogDebugDefault(message, ...) do {} while (false)
+#endif
+
 #define LogAndReturn(return_value, type, channel, message, ...) LogWithApp(Shibboleth::GetApp(), type, channel, message, ##__VA_ARGS__); return return_value
 #define LogErrorAndReturn(return_value, channel, message, ...) LogWithApp(Shibboleth::GetApp(), Shibboleth::LogType::Error, channel, message, ##__VA_ARGS__); return return_value
 #define LogWarningAndReturn(return_value, channel, message, ...) LogWithApp(Shibboleth::GetApp(), Shibboleth::LogType::Warning, channel, message, ##__VA_ARGS__); return return_value
@@ -22,11 +22,14 @@ THE SOFTWARE.
 
 #pragma once
 
+#include "Shibboleth_ProxyAllocator.h"
 #include "Shibboleth_IFileSystem.h"
+#include "Shibboleth_JobPoolFwd.h"
 #include "Shibboleth_String.h"
-#include "Shibboleth_Vector.h"
-#include <Gaff_IncludeEASTLAtomic.h>
 #include <eathread/eathread_mutex.h>
+#include <Gaff_AsyncFileReader.h>
+#include <EASTL/hash_map.h>
+#include <Gaff_Hash.h>
 
 NS_SHIBBOLETH
 
@@ -42,8 +45,9 @@ public:
 	int8_t* getBuffer(void);
 
 private:
-	int8_t* _file_buffer;
-	size_t _file_size;
+	int8_t* _file_buffer = nullptr;
+	size_t _file_size = 0;
+	Gaff::Hash64 _name_hash = Gaff::k_init_hash64;
 
 	friend class LooseFileSystem;
 };
@@ -51,57 +55,69 @@ private:
 class LooseFileSystem : public IFileSystem
 {
 public:
-	LooseFileSystem(void);
+	// Asynchronous opens that can't go through io_uring are run on job_pool's read file pool.
+	// Without a job pool, they are opened on the calling thread.
+	LooseFileSystem(JobPool* job_pool = nullptr);
 	~LooseFileSystem(void);
 
 	IFile* openFile(const char8_t* file_name) override;
 	void closeFile(const IFile* file) override;
 
+	void openFileAsync(const char8_t* file_name, const OpenFileCallback& callback) override;
+
 	bool forEachFile(const char8_t* directory, eastl::function<bool(const char8_t*, IFile*)>& callback, const char8_t* extension, bool recursive = false) override;
 	bool forEachFile(const char8_t* directory, eastl::function<bool(const char8_t*, IFile*)>& callback, bool recursive = false) override;
 
 private:
-	struct FileData
+	struct FileData final
+	{
+		U8String name;
+		LooseFile* file = nullptr;
+		int32_t count = 0;
+	};
+
+	struct NameHash final
+	{
+		size_t operator()(Gaff::Hash64 name_hash) const { return static_cast<size_t>(name_hash.getHash()); }
+	};
+
+	// Different paths can hash to the same value, so entries sharing a hash are chained and told apart by name.
+	using FileMap = eastl::hash_multimap<Gaff::Hash64, FileData, NameHash, eastl::equal_to<Gaff::Hash64>, ProxyAllocator>;
+
+	// Open files are split across shards by path hash, so opening and closing different files rarely contend.
+	struct alignas(64) FileShard final
 	{
-		FileData(void) = default;
-
-		FileData(const FileData& rhs):
-			name(rhs.name),
-			file(rhs.file),
-			count(static_cast<int32_t>(rhs.count))
-		{
-		}
-
-		FileData(FileData&& rhs):
-			name(std::move(rhs.name)),
-			file(rhs.file),
-			count(static_cast<int32_t>(rhs.count))
-		{
-		}
-
-		FileData& operator=(const FileData& rhs)
-		{
-			name = rhs.name;
-			file = rhs.file;
-			count = static_cast<int32_t>(rhs.count);
-			return *this;
-		}
-
-		FileData& operator=(FileData&& rhs)
-		{
-			name = std::move(rhs.name);
-			file = rhs.file;
-			count = static_cast<int32_t>(rhs.count);
-			return *this;
-		}
+		FileMap files;
+		EA::Thread::Mutex lock;
+	};
 
+	struct AsyncOpenRequest final : public Gaff::AsyncFileReader::Request
+	{
+		LooseFileSystem* file_system = nullptr;
+		LooseFile* file = nullptr;
+		OpenFileCallback callback;
 		U8String name;
-		IFile* file;
-		eastl::atomic<int32_t> count;
+		U8String path; // Has to outlive the read, which opens the file asynchronously.
+		Gaff::Hash64 name_hash = Gaff::k_init_hash64;
 	};
 
-	Vector<FileData> _files;
-	EA::Thread::Mutex _file_lock;
+	static constexpr int32_t k_num_shards = 16;
+
+	FileShard _shards[k_num_shards];
+
+	Gaff::AsyncFileReader _async_reader;
+	JobPool* _job_pool = nullptr;
+
+	static int8_t* AsyncOpenAllocate(Gaff::AsyncFileReader::Request& request, size_t size);
+	static void AsyncOpenComplete(Gaff::AsyncFileReader::Request& request, int32_t result);
+	static void AsyncOpenJob(uintptr_t thread_id_int, void* data);
+
+	static FileMap::iterator FindFileData(FileMap& files, Gaff::Hash64 name_hash, const char8_t* file_name);
+
+	FileShard& getShard(Gaff::Hash64 name_hash);
+	IFile* findFile(Gaff::Hash64 name_hash, const char8_t* file_name);
+	IFile* addFile(Gaff::Hash64 name_hash, const char8_t* file_name, LooseFile* file);
+	LooseFile* readFile(const char8_t* file_name);
 };
 
 NS_END
@@ -36,3 +36,8 @@ SHIB_REFLECTION_DECLARE(Gleam::Vec2)
 SHIB_REFLECTION_DECLARE(Gleam::Transform)
 SHIB_REFLECTION_DECLARE(Gleam::Plane)
 SHIB_REFLECTION_DECLARE(Gleam::AABB)
+
+SHIB_BINARY_COPYABLE(Gleam::Quat)
+SHIB_BINARY_COPYABLE(Gleam::Vec4)
+SHIB_BINARY_COPYABLE(Gleam::Vec3)
+SHIB_BINARY_COPYABLE(Gleam::Vec2)
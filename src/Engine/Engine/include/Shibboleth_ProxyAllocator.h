@@ -32,6 +32,10 @@ class ProxyAllocator final : public Gaff::IAllocator
 public:
 	static ProxyAllocator& GetGlobal(void);
 
+	// Memory is reclaimed at frame boundaries, frees are a no-op. Only use for data that doesn't outlive the frame.
+	static ProxyAllocator& GetFrame(void);
+
+	ProxyAllocator(Shibboleth::IAllocator& allocator, const char* pool_tag);
 	explicit ProxyAllocator(const char* pool_tag);
 
 	ProxyAllocator(void) = default;
@@ -64,7 +68,7 @@ public:
 	void set_name(const char* pName) override;
 
 private:
-	Shibboleth::IAllocator& _allocator = GetAllocator();
+	Shibboleth::IAllocator* _allocator = &GetAllocator();
 	const char* _pool_tag = nullptr;
 	int32_t _pool_index = 0;
 };
@@ -58,9 +58,8 @@ static bool LoadHashString(const Shibboleth::ISerializeReader& reader, Gaff::Has
 		return false;
 	}
 
-	const char8_t* const str = reader.readString();
-	out = str;
-	reader.freeString(str);
+	const eastl::u8string_view str = reader.readStringView();
+	out = Gaff::HashString<T, HashType, HashingFunc, Allocator, true>(str.data(), str.size(), out.getString().get_allocator());
 
 	return true;
 }
@@ -73,9 +72,8 @@ static bool LoadHashString(const Shibboleth::ISerializeReader& reader, Gaff::Has
 	}
 
 	if (reader.isString()) {
-		const char8_t* const str = reader.readString();
-		out = str;
-		reader.freeString(str);
+		const eastl::u8string_view str = reader.readStringView();
+		out = Gaff::HashString<T, HashType, HashingFunc, Allocator, false>(str.data(), str.size());
 
 	} else {
 		if constexpr (std::is_same<HashType, Gaff::Hash32>::value) {
@@ -139,9 +137,8 @@ static bool LoadString(const Shibboleth::ISerializeReader& reader, Gaff::U8Strin
 		return false;
 	}
 
-	const char8_t* const str = reader.readString();
-	out = str;
-	reader.freeString(str);
+	const eastl::u8string_view str = reader.readStringView();
+	out.assign(str.data(), str.size());
 
 	return true;
 }
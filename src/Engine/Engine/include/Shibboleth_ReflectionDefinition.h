@@ -24,11 +24,13 @@ THE SOFTWARE.
 
 #include "Shibboleth_IReflectionDefinition.h"
 #include "Shibboleth_SerializeInterfaces.h"
+#include "Shibboleth_BinarySerialize.h"
 #include "Shibboleth_IReflection.h"
 #include "Shibboleth_AppConfigs.h"
 #include "Shibboleth_SmartPtrs.h"
 #include "Shibboleth_Utilities.h"
 #include "Shibboleth_String.h"
+#include <EASTL/fixed_vector.h>
 #include <Gaff_JSON.h>
 #include <Gaff_Ops.h>
 
@@ -90,6 +92,16 @@ public:
 
 		virtual bool load(const Shibboleth::ISerializeReader& reader, T& object) = 0;
 		virtual void save(Shibboleth::ISerializeWriter& writer, const T& object) = 0;
+
+		// Trivially copyable vars are copied straight to/from their offset in T.
+		virtual bool isBinaryCopyable(void) const { return false; }
+		virtual ptrdiff_t getBinaryOffset(void) const { return 0; }
+		virtual int32_t getBinarySize(void) const { return 0; }
+
+		// Everything else is written as a field. Defaults to a MessagePack blob using load()/save().
+		virtual Shibboleth::BinaryFieldType getBinaryFieldType(void) const { return Shibboleth::BinaryFieldType::MessagePack; }
+		virtual bool loadBinary(Shibboleth::BinarySerializeReader& reader, T& object);
+		virtual void saveBinary(Shibboleth::BinarySerializeWriter& writer, const T& object);
 	};
 
 	GAFF_STRUCTORS_DEFAULT(ReflectionDefinition);
@@ -108,6 +120,11 @@ public:
 	bool load(const Shibboleth::ISerializeReader& reader, T& object, bool refl_load = false) const;
 	void save(Shibboleth::ISerializeWriter& writer, const T& object, bool refl_save = false) const;
 
+	bool loadBinary(Shibboleth::BinarySerializeReader& reader, void* object) const override;
+	void saveBinary(Shibboleth::BinarySerializeWriter& writer, const void* object) const override;
+	bool loadBinary(Shibboleth::BinarySerializeReader& reader, T& object) const;
+	void saveBinary(Shibboleth::BinarySerializeWriter& writer, const T& object) const;
+
 	Gaff::Hash64 getInstanceHash(const void* object, Gaff::Hash64 init = Gaff::k_init_hash64) const override;
 	Gaff::Hash64 getInstanceHash(const T& object, Gaff::Hash64 init = Gaff::k_init_hash64) const;
 	ReflectionDefinition& setInstanceHash(InstanceHashFunc hash_func);
@@ -363,6 +380,14 @@ private:
 		bool load(const Shibboleth::ISerializeReader& reader, T& object) override;
 		void save(Shibboleth::ISerializeWriter& writer, const T& object) override;
 
+		bool isBinaryCopyable(void) const override;
+		ptrdiff_t getBinaryOffset(void) const override;
+		int32_t getBinarySize(void) const override;
+
+		Shibboleth::BinaryFieldType getBinaryFieldType(void) const override;
+		bool loadBinary(Shibboleth::BinarySerializeReader& reader, T& object) override;
+		void saveBinary(Shibboleth::BinarySerializeWriter& writer, const T& object) override;
+
 		bool isFlags(void) const override;
 
 		void setFlagValue(void* object, int32_t flag_index, bool value) override;
@@ -507,6 +532,14 @@ private:
 		bool load(const Shibboleth::ISerializeReader& reader, T& object) override;
 		void save(Shibboleth::ISerializeWriter& writer, const T& object) override;
 
+		bool isBinaryCopyable(void) const override;
+		ptrdiff_t getBinaryOffset(void) const override;
+		int32_t getBinarySize(void) const override;
+
+		Shibboleth::BinaryFieldType getBinaryFieldType(void) const override;
+		bool loadBinary(Shibboleth::BinarySerializeReader& reader, T& object) override;
+		void saveBinary(Shibboleth::BinarySerializeWriter& writer, const T& object) override;
+
 	private:
 		typename ReflectionDefinition<Base>::IVar* _base_var;
 	};
@@ -874,6 +907,18 @@ private:
 
 	Shibboleth::U8String _friendly_name;
 
+	struct BinaryCopyVar final
+	{
+		Shibboleth::BinaryCopyField field;
+		ptrdiff_t offset = 0;
+	};
+
+	// Built in finish(). Order matches the copy block written by saveBinary().
+	Shibboleth::Vector<BinaryCopyVar> _binary_copy_vars{ Shibboleth::ProxyAllocator("Reflection") };
+	Shibboleth::Vector<int32_t> _binary_copy_index{ Shibboleth::ProxyAllocator("Reflection") }; // Per entry in _vars. -1 if not copied.
+	Gaff::Hash64 _binary_layout_hash = Gaff::k_init_hash64;
+	uint32_t _binary_copy_size = 0;
+
 	InstanceHashFunc _instance_hash = nullptr;
 	LoadFunc _serialize_load = nullptr;
 	SaveFunc _serialize_save = nullptr;
@@ -886,6 +931,8 @@ private:
 	template <class Base>
 	static void RegisterBaseVariables(void);
 
+	void buildBinaryLayout(void);
+
 	// Variables
 	template <class Var, class First, class... Rest>
 	ReflectionDefinition& addAttributes(IReflectionVar* ref_var, Var T::*var, Shibboleth::Vector<IAttributePtr>& attrs, const First& first, const Rest&... rest);
@@ -979,6 +1026,8 @@ T* FactoryFuncImpl(Gaff::IAllocator& allocator, Args&&... args);
 			return true; \
 		} \
 		void save(Shibboleth::ISerializeWriter& writer, const class_type& value, bool refl_save = false) const { GAFF_REF(refl_save); writer.write##serialize_type(value); } \
+		bool loadBinary(Shibboleth::BinarySerializeReader& reader, void* object) const override { return Shibboleth::LoadBinaryCopy(reader, *this, object, sizeof(class_type)); } \
+		void saveBinary(Shibboleth::BinarySerializeWriter& writer, const void* object) const override { Shibboleth::SaveBinaryCopy(writer, *this, object, sizeof(class_type)); } \
 		Gaff::Hash64 getInstanceHash(const void* object, Gaff::Hash64 init = Gaff::k_init_hash64) const override { return Gaff::FNV1aHash64(reinterpret_cast<const char*>(object), sizeof(class_type), init); } \
 		const void* getInterface(Gaff::Hash64, const void*) const override { return nullptr; } \
 		void* getInterface(Gaff::Hash64, void*) const override { return nullptr; } \
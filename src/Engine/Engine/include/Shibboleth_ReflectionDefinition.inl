@@ -165,6 +165,24 @@ void ReflectionDefinition<T>::IVar::setElementMoveT(T& object, int32_t index, Da
 	setElementMove(&object, index, &data);
 }
 
+template <class T>
+bool ReflectionDefinition<T>::IVar::loadBinary(Shibboleth::BinarySerializeReader& reader, T& object)
+{
+	return reader.readMessagePack(reader.getRemaining(), [&](const Shibboleth::ISerializeReader& mpack_reader) -> bool
+	{
+		return load(mpack_reader, object);
+	});
+}
+
+template <class T>
+void ReflectionDefinition<T>::IVar::saveBinary(Shibboleth::BinarySerializeWriter& writer, const T& object)
+{
+	writer.writeMessagePack([&](Shibboleth::ISerializeWriter& mpack_writer) -> void
+	{
+		save(mpack_writer, object);
+	});
+}
+
 
 
 // VarPtr
@@ -291,6 +309,60 @@ void ReflectionDefinition<T>::VarPtr<Var>::save(Shibboleth::ISerializeWriter& wr
 	}
 }
 
+template <class T>
+template <class Var>
+bool ReflectionDefinition<T>::VarPtr<Var>::isBinaryCopyable(void) const
+{
+	return Shibboleth::IsBinaryCopyable<Var>::value;
+}
+
+template <class T>
+template <class Var>
+ptrdiff_t ReflectionDefinition<T>::VarPtr<Var>::getBinaryOffset(void) const
+{
+	return Gaff::OffsetOfMember(_ptr);
+}
+
+template <class T>
+template <class Var>
+int32_t ReflectionDefinition<T>::VarPtr<Var>::getBinarySize(void) const
+{
+	return static_cast<int32_t>(sizeof(Var));
+}
+
+template <class T>
+template <class Var>
+Shibboleth::BinaryFieldType ReflectionDefinition<T>::VarPtr<Var>::getBinaryFieldType(void) const
+{
+	if constexpr (Gaff::IsFlags<Var>() || std::is_enum<Var>::value) {
+		return Shibboleth::BinaryFieldType::MessagePack;
+	} else {
+		return Shibboleth::BinaryFieldType::Object;
+	}
+}
+
+template <class T>
+template <class Var>
+bool ReflectionDefinition<T>::VarPtr<Var>::loadBinary(Shibboleth::BinarySerializeReader& reader, T& object)
+{
+	if constexpr (Gaff::IsFlags<Var>() || std::is_enum<Var>::value) {
+		return IVar::loadBinary(reader, object);
+	} else {
+		return Reflection<Var>::GetReflectionDefinition().loadBinary(reader, &(object.*_ptr));
+	}
+}
+
+template <class T>
+template <class Var>
+void ReflectionDefinition<T>::VarPtr<Var>::saveBinary(Shibboleth::BinarySerializeWriter& writer, const T& object)
+{
+	if constexpr (Gaff::IsFlags<Var>() || std::is_enum<Var>::value) {
+		IVar::saveBinary(writer, object);
+	} else {
+		Reflection<Var>::GetReflectionDefinition().saveBinary(writer, &(object.*_ptr));
+	}
+}
+
 template <class T>
 template <class Var>
 bool ReflectionDefinition<T>::VarPtr<Var>::isFlags(void) const
@@ -852,6 +924,48 @@ void ReflectionDefinition<T>::BaseVarPtr<Base>::save(Shibboleth::ISerializeWrite
 	_base_var->save(writer, object);
 }
 
+template <class T>
+template <class Base>
+bool ReflectionDefinition<T>::BaseVarPtr<Base>::isBinaryCopyable(void) const
+{
+	return _base_var->isBinaryCopyable();
+}
+
+template <class T>
+template <class Base>
+ptrdiff_t ReflectionDefinition<T>::BaseVarPtr<Base>::getBinaryOffset(void) const
+{
+	return Gaff::OffsetOfClass<T, Base>() + _base_var->getBinaryOffset();
+}
+
+template <class T>
+template <class Base>
+int32_t ReflectionDefinition<T>::BaseVarPtr<Base>::getBinarySize(void) const
+{
+	return _base_var->getBinarySize();
+}
+
+template <class T>
+template <class Base>
+Shibboleth::BinaryFieldType ReflectionDefinition<T>::BaseVarPtr<Base>::getBinaryFieldType(void) const
+{
+	return _base_var->getBinaryFieldType();
+}
+
+template <class T>
+template <class Base>
+bool ReflectionDefinition<T>::BaseVarPtr<Base>::loadBinary(Shibboleth::BinarySerializeReader& reader, T& object)
+{
+	return _base_var->loadBinary(reader, object);
+}
+
+template <class T>
+template <class Base>
+void ReflectionDefinition<T>::BaseVarPtr<Base>::saveBinary(Shibboleth::BinarySerializeWriter& writer, const T& object)
+{
+	_base_var->saveBinary(writer, object);
+}
+
 
 
 // ArrayPtr
@@ -1696,23 +1810,44 @@ bool ReflectionDefinition<T>::load(const Shibboleth::ISerializeReader& reader, T
 		return _serialize_load(reader, object);
 
 	} else {
-		for (auto& entry : _vars) {
-			if (entry.second->canSerialize()) {
-				const char8_t* const name = entry.first.getBuffer();
+		// One bit per entry in _vars, set when that var is read.
+		constexpr int32_t k_bits_per_word = 64;
+		const int32_t num_vars = static_cast<int32_t>(_vars.size());
+		eastl::fixed_vector<uint64_t, 4, true> loaded_vars(static_cast<size_t>((num_vars + k_bits_per_word - 1) / k_bits_per_word), 0);
+
+		// Walk the serialized keys once and look each one up, instead of searching the object for every var.
+		// Anything that isn't an object has no keys, which is fine as long as every var is optional.
+		const int32_t num_keys = (reader.isObject()) ? reader.size() : 0;
+
+		for (int32_t i = 0; i < num_keys; ++i) {
+			const eastl::u8string_view key = reader.getKeyView(i);
+			const Gaff::Hash32 key_hash = Gaff::DefaultHashFunc<Gaff::Hash32>(reinterpret_cast<const char*>(key.data()), key.size());
+			const auto it = _vars.find(key_hash);
+
+			// Keys that aren't vars, such as "version", are ignored.
+			if (it == _vars.end() || !it->second->canSerialize()) {
+				continue;
+			}
 
-				if (!reader.exists(name)) {
-					// Skip over optional variables.
-					if (entry.second->isOptional()) {
-						continue;
+			const int32_t var_index = static_cast<int32_t>(eastl::distance(_vars.begin(), it));
+			loaded_vars[var_index / k_bits_per_word] |= uint64_t(1) << (var_index % k_bits_per_word);
 
-					} else {
-						// $TODO: Log error.
-						return false;
-					}
-				}
+			reader.enterMember(i);
+			it->second->load(reader, object);
+			reader.exitElement();
+		}
 
-				Shibboleth::ScopeGuard scope = reader.enterElementGuard(name);
-				entry.second->load(reader, object);
+		for (int32_t i = 0; i < num_vars; ++i) {
+			if (loaded_vars[i / k_bits_per_word] & (uint64_t(1) << (i % k_bits_per_word))) {
+				continue;
+			}
+
+			const IVar* const var = (_vars.begin() + i)->second.get();
+
+			// Skip over optional variables.
+			if (var->canSerialize() && !var->isOptional()) {
+				// $TODO: Log error.
+				return false;
 			}
 		}
 	}
@@ -1753,6 +1888,234 @@ void ReflectionDefinition<T>::save(Shibboleth::ISerializeWriter& writer, const T
 	}
 }
 
+template <class T>
+bool ReflectionDefinition<T>::loadBinary(Shibboleth::BinarySerializeReader& reader, void* object) const
+{
+	return loadBinary(reader, *reinterpret_cast<T*>(object));
+}
+
+template <class T>
+void ReflectionDefinition<T>::saveBinary(Shibboleth::BinarySerializeWriter& writer, const void* object) const
+{
+	saveBinary(writer, *reinterpret_cast<const T*>(object));
+}
+
+template <class T>
+bool ReflectionDefinition<T>::loadBinary(Shibboleth::BinarySerializeReader& reader, T& object) const
+{
+	if (_serialize_load) {
+		return Shibboleth::LoadBinaryMessagePack(reader, *this, &object);
+	}
+
+	Shibboleth::BinaryObjectHeader header;
+
+	if (!reader.read(header)) {
+		Shibboleth::LogBinaryLoadError(*this, u8"Failed to read the object header.");
+		return false;
+	}
+
+	Shibboleth::BinarySerializeReader object_reader = reader.split(header.size);
+
+	if (header.type_hash != getReflectionInstance().getHash().getHash() || header.type != Shibboleth::BinaryObjectType::Fields) {
+		Shibboleth::LogBinaryLoadError(*this, u8"Object header is for a different type.");
+		return false;
+	}
+
+	uint32_t copy_count = 0;
+	uint32_t copy_size = 0;
+
+	if (!object_reader.read(copy_count) || !object_reader.read(copy_size)) {
+		Shibboleth::LogBinaryLoadError(*this, u8"Failed to read the copy block size.");
+		return false;
+	}
+
+	// One bit per copy var followed by one bit per entry in _vars, set when that var is read.
+	constexpr int32_t k_bits_per_word = 64;
+	const int32_t num_copy_vars = static_cast<int32_t>(_binary_copy_vars.size());
+	const int32_t num_vars = static_cast<int32_t>(_vars.size());
+	const int32_t num_bits = num_copy_vars + num_vars;
+	eastl::fixed_vector<uint64_t, 4, true> loaded_vars(static_cast<size_t>((num_bits + k_bits_per_word - 1) / k_bits_per_word), 0);
+
+	const auto mark_loaded = [&](int32_t bit) -> void
+	{
+		loaded_vars[bit / k_bits_per_word] |= uint64_t(1) << (bit % k_bits_per_word);
+	};
+
+	if (header.layout_hash == _binary_layout_hash.getHash() && copy_count == static_cast<uint32_t>(num_copy_vars) && copy_size == _binary_copy_size) {
+		// Same layout as when it was written. The copy block lines up with our copy vars, so skip the table.
+		object_reader.skip(sizeof(Shibboleth::BinaryCopyField) * copy_count);
+
+		const uint8_t* data = object_reader.getCursor();
+
+		if (!object_reader.skip(copy_size)) {
+			Shibboleth::LogBinaryLoadError(*this, u8"Copy block is truncated.");
+			return false;
+		}
+
+		for (int32_t i = 0; i < num_copy_vars; ++i) {
+			const BinaryCopyVar& copy_var = _binary_copy_vars[i];
+
+			memcpy(reinterpret_cast<uint8_t*>(&object) + copy_var.offset, data, copy_var.field.size);
+			data += copy_var.field.size;
+
+			mark_loaded(i);
+		}
+
+	} else {
+		// Layout changed. Match each copied value to a var by name and only take it if the type and size still agree.
+		Shibboleth::BinarySerializeReader table_reader = object_reader.split(sizeof(Shibboleth::BinaryCopyField) * copy_count);
+		Shibboleth::BinarySerializeReader copy_reader = object_reader.split(copy_size);
+
+		for (uint32_t i = 0; i < copy_count; ++i) {
+			Shibboleth::BinaryCopyField field;
+
+			if (!table_reader.read(field)) {
+				Shibboleth::LogBinaryLoadError(*this, u8"Copy field table is truncated.");
+				return false;
+			}
+
+			const uint8_t* const data = copy_reader.getCursor();
+
+			if (!copy_reader.skip(field.size)) {
+				Shibboleth::LogBinaryLoadError(*this, u8"Copy block is truncated.");
+				return false;
+			}
+
+			const auto it = _vars.find(Gaff::Hash32(field.name_hash));
+
+			if (it == _vars.end()) {
+				continue;
+			}
+
+			const int32_t copy_index = _binary_copy_index[eastl::distance(_vars.begin(), it)];
+
+			if (copy_index < 0) {
+				continue;
+			}
+
+			const BinaryCopyVar& copy_var = _binary_copy_vars[copy_index];
+
+			if (copy_var.field.type_hash != field.type_hash || copy_var.field.size != field.size) {
+				continue;
+			}
+
+			memcpy(reinterpret_cast<uint8_t*>(&object) + copy_var.offset, data, field.size);
+			mark_loaded(copy_index);
+		}
+	}
+
+	uint32_t field_count = 0;
+
+	if (!object_reader.read(field_count)) {
+		Shibboleth::LogBinaryLoadError(*this, u8"Failed to read the field count.");
+		return false;
+	}
+
+	for (uint32_t i = 0; i < field_count; ++i) {
+		Shibboleth::BinaryField field;
+
+		if (!object_reader.read(field)) {
+			Shibboleth::LogBinaryLoadError(*this, u8"Failed to read the header for field %u.", i);
+			return false;
+		}
+
+		Shibboleth::BinarySerializeReader field_reader = object_reader.split(field.size);
+
+		if (field_reader.hasFailed()) {
+			Shibboleth::LogBinaryLoadError(*this, u8"Field %u is truncated.", i);
+			return false;
+		}
+
+		const auto it = _vars.find(Gaff::Hash32(field.name_hash));
+
+		// Fields that aren't vars anymore, or have changed how they are stored, are ignored.
+		if (it == _vars.end() || !it->second->canSerialize() || it->second->isBinaryCopyable() || it->second->getBinaryFieldType() != field.type) {
+			continue;
+		}
+
+		const int32_t var_index = static_cast<int32_t>(eastl::distance(_vars.begin(), it));
+		mark_loaded(num_copy_vars + var_index);
+
+		it->second->loadBinary(field_reader, object);
+	}
+
+	for (int32_t i = 0; i < num_vars; ++i) {
+		const IVar* const var = (_vars.begin() + i)->second.get();
+		const int32_t copy_index = _binary_copy_index[i];
+		const int32_t bit = (copy_index > -1) ? copy_index : num_copy_vars + i;
+
+		if (loaded_vars[bit / k_bits_per_word] & (uint64_t(1) << (bit % k_bits_per_word))) {
+			continue;
+		}
+
+		// Skip over optional variables.
+		if (var->canSerialize() && !var->isOptional()) {
+			Shibboleth::LogBinaryLoadError(*this, u8"Missing required var '%s'.", (_vars.begin() + i)->first.getBuffer());
+			return false;
+		}
+	}
+
+	if (object_reader.hasFailed()) {
+		Shibboleth::LogBinaryLoadError(*this, u8"Object data is truncated.");
+		return false;
+	}
+
+	return true;
+}
+
+template <class T>
+void ReflectionDefinition<T>::saveBinary(Shibboleth::BinarySerializeWriter& writer, const T& object) const
+{
+	if (_serialize_save) {
+		Shibboleth::SaveBinaryMessagePack(writer, *this, &object);
+		return;
+	}
+
+	Shibboleth::BinaryObjectHeader header;
+	header.type_hash = getReflectionInstance().getHash().getHash();
+	header.layout_hash = _binary_layout_hash.getHash();
+	header.type = Shibboleth::BinaryObjectType::Fields;
+
+	const size_t header_offset = writer.reserve<Shibboleth::BinaryObjectHeader>();
+
+	writer.write(static_cast<uint32_t>(_binary_copy_vars.size()));
+	writer.write(_binary_copy_size);
+
+	for (const BinaryCopyVar& copy_var : _binary_copy_vars) {
+		writer.write(copy_var.field);
+	}
+
+	for (const BinaryCopyVar& copy_var : _binary_copy_vars) {
+		writer.write(reinterpret_cast<const uint8_t*>(&object) + copy_var.offset, copy_var.field.size);
+	}
+
+	const size_t field_count_offset = writer.reserve<uint32_t>();
+	uint32_t field_count = 0;
+
+	for (auto& entry : _vars) {
+		if (!entry.second->canSerialize() || entry.second->isBinaryCopyable()) {
+			continue;
+		}
+
+		Shibboleth::BinaryField field;
+		field.name_hash = entry.first.getHash().getHash();
+		field.type = entry.second->getBinaryFieldType();
+
+		const size_t field_offset = writer.reserve<Shibboleth::BinaryField>();
+		entry.second->saveBinary(writer, object);
+
+		field.size = static_cast<uint32_t>(writer.size() - field_offset - sizeof(Shibboleth::BinaryField));
+		writer.writeAt(field_offset, field);
+
+		++field_count;
+	}
+
+	writer.writeAt(field_count_offset, field_count);
+
+	header.size = static_cast<uint32_t>(writer.size() - header_offset - sizeof(Shibboleth::BinaryObjectHeader));
+	writer.writeAt(header_offset, header);
+}
+
 template <class T>
 Gaff::Hash64 ReflectionDefinition<T>::getInstanceHash(const void* object, Gaff::Hash64 init) const
 {
@@ -3393,6 +3756,55 @@ void ReflectionDefinition<T>::finish(void)
 		if (_friendly_name.empty()) {
 			_friendly_name = getReflectionInstance().getName();
 		}
+
+		buildBinaryLayout();
+	}
+}
+
+template <class T>
+void ReflectionDefinition<T>::buildBinaryLayout(void)
+{
+	_binary_copy_vars.clear();
+	_binary_copy_index.clear();
+	_binary_copy_size = 0;
+
+	// The version hash covers var names, but not their types, so mix in the layout of the copy block as well.
+	_binary_layout_hash = getReflectionInstance().getVersion();
+	_binary_copy_index.reserve(_vars.size());
+
+	for (const auto& entry : _vars) {
+		const IVar* const var = entry.second.get();
+		int32_t copy_index = -1;
+
+		if (var->canSerialize() && var->isBinaryCopyable()) {
+			const ptrdiff_t offset = var->getBinaryOffset();
+			const int32_t size = var->getBinarySize();
+
+			// Aliases of the same memory, such as Vec3 x/r/s, are only stored once.
+			for (int32_t i = 0; i < static_cast<int32_t>(_binary_copy_vars.size()); ++i) {
+				if (_binary_copy_vars[i].offset == offset && _binary_copy_vars[i].field.size == static_cast<uint32_t>(size)) {
+					copy_index = i;
+					break;
+				}
+			}
+
+			if (copy_index == -1) {
+				BinaryCopyVar copy_var;
+				copy_var.field.type_hash = var->getReflection().getHash().getHash();
+				copy_var.field.name_hash = entry.first.getHash().getHash();
+				copy_var.field.size = static_cast<uint32_t>(size);
+				copy_var.offset = offset;
+
+				_binary_layout_hash = Gaff::FNV1aHash64T(copy_var.field, _binary_layout_hash);
+				_binary_layout_hash = Gaff::FNV1aHash64T(offset, _binary_layout_hash);
+				_binary_copy_size += copy_var.field.size;
+
+				copy_index = static_cast<int32_t>(_binary_copy_vars.size());
+				_binary_copy_vars.emplace_back(copy_var);
+			}
+		}
+
+		_binary_copy_index.emplace_back(copy_index);
 	}
 }
 
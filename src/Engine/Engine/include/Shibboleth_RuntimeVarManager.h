@@ -185,6 +185,7 @@ public:
 	}
 
 	void addRuntimeVar(IRuntimeVar& runtime_var);
+	bool removeRuntimeVar(const IRuntimeVar& runtime_var);
 
 	IRuntimeVar* getRuntimeVar(Gaff::Hash64 name) const;
 	IRuntimeVar* getRuntimeVar(const char* name) const;
@@ -23,6 +23,7 @@ THE SOFTWARE.
 #pragma once
 
 #include "Shibboleth_Defines.h"
+#include <EASTL/string_view.h>
 #include <Gaff_Assert.h>
 
 NS_SHIBBOLETH
@@ -40,8 +41,9 @@ public:
 		char8_t key[256] = {};
 
 		for (int32_t i = 0; i < len; ++i) {
+			// Enter by index, so we don't search for the key we just read.
 			getKey(key, ARRAY_SIZE(key), i);
-			enterElement(key);
+			enterMember(i);
 
 			if (callback(key)) {
 				exitElement();
@@ -101,6 +103,10 @@ public:
 	virtual void enterElement(int32_t index)  const = 0;
 	virtual void exitElement(void)  const = 0;
 
+	// Enters the value of the object member at index, the same index getKey() and getKeyView() take.
+	// Leave with exitElement(). enterElement(int32_t) is for arrays only.
+	virtual void enterMember(int32_t index) const = 0;
+
 	virtual ScopeGuard enterElementGuard(const char8_t* key) const = 0;
 	virtual ScopeGuard enterElementGuard(const char* key) const = 0;
 	virtual ScopeGuard enterElementGuard(int32_t index) const = 0;
@@ -114,6 +120,13 @@ public:
 	virtual const char8_t* getKey(char8_t* buffer, size_t buf_size, int32_t index) const = 0;
 	virtual const char8_t* getKey(int32_t index) const = 0;
 
+	// Points into the reader's data. Not null terminated. Only valid while the reader is.
+	virtual eastl::u8string_view getKeyView(int32_t index) const = 0;
+
+	// Same lifetime rules as getKeyView(). No allocation, and no need to call freeString().
+	virtual eastl::u8string_view readStringView(eastl::u8string_view default_value) const = 0;
+	virtual eastl::u8string_view readStringView(void) const = 0;
+
 	virtual const char8_t* readString(char8_t* buffer, size_t buf_size, const char8_t* default_value) const = 0;
 	virtual const char8_t* readString(const char8_t* default_value) const = 0;
 	virtual int8_t readInt8(int8_t default_value) const = 0;
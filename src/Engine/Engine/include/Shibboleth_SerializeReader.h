@@ -78,6 +78,12 @@ public:
 		_stack.push_back(node);
 	}
 
+	void enterMember(int32_t index) const override
+	{
+		Node node = _stack.back().getValue(index);
+		_stack.push_back(node);
+	}
+
 	void exitElement(void) const override
 	{
 		GAFF_ASSERT(_stack.size() > 1);
@@ -90,6 +96,9 @@ public:
 
 	const char8_t* getKey(char8_t* buffer, size_t buf_size, int32_t index) const override { return _stack.back().getKey(buffer, buf_size, index); }
 	const char8_t* getKey(int32_t index) const override { return _stack.back().getKey(index); }
+	eastl::u8string_view getKeyView(int32_t index) const override { return _stack.back().getKeyView(index); }
+	eastl::u8string_view readStringView(eastl::u8string_view default_value) const override { return _stack.back().getStringView(default_value); }
+	eastl::u8string_view readStringView(void) const override { return _stack.back().getStringView(); }
 
 	void freeString(const char8_t* str) const override { if (isString()) _stack.back().freeString(str); }
 	int32_t size(void) const override { return _stack.back().size(); }
@@ -30,6 +30,7 @@ THE SOFTWARE.
 #include <Gaff_Utils.h>
 #include <Gaff_File.h>
 #include <EASTL/algorithm.h>
+#include <eathread/eathread_spinlock.h>
 #include <mimalloc.h>
 
 MSVC_DISABLE_WARNING_PUSH(4324)
@@ -44,21 +45,31 @@ NS_SHIBBOLETH
 // Should we change this to being a footer? If the data comes at the end of the data,
 // then we don't have to ensure the header/footer data is aligned.
 
+static constexpr uint16_t k_header_flag_tracking = 1 << 0;
+static constexpr uint16_t k_header_flag_free_callbacks = 1 << 1;
+
+// Always sits directly in front of the returned pointer, regardless of header mode.
 // Enforce the header being 16-byte aligned so that data falls on 16-byte boundary.
 struct alignas(16) AllocationHeader
 {
+	const char* file;
 	size_t alloc_size;
-	size_t pool_index;
+	int32_t line;
+	int16_t pool_index;
+	uint16_t flags;
+};
+
+// Only present in tracking mode. Sits in front of the AllocationHeader.
+struct alignas(16) AllocationTrackingData
+{
 	char file[256] = { 0 };
-	int line = 0;
 
 	// Not a huge fan of adding this to the header data.
-	static constexpr int32_t k_num_free_callbacks = 4;
-	Allocator::OnFreeCallback free_callbacks[k_num_free_callbacks] = { nullptr };
+	Allocator::OnFreeCallback free_callbacks[Allocator::k_num_free_callbacks] = { nullptr };
 
 #if REQUIRES_HEADER_LIST
-	AllocationHeader* next = nullptr;
-	AllocationHeader* prev = nullptr;
+	AllocationTrackingData* next = nullptr;
+	AllocationTrackingData* prev = nullptr;
 #endif
 
 #ifdef GATHER_ALLOCATION_STACKTRACE
@@ -66,14 +77,139 @@ struct alignas(16) AllocationHeader
 #endif
 };
 
+static_assert(sizeof(AllocationHeader) == 32, "AllocationHeader is expected to be 32 bytes.");
+
+static constexpr size_t GetHeaderSize(AllocationHeaderMode mode)
+{
+	return (mode == AllocationHeaderMode::Tracking) ?
+		sizeof(AllocationTrackingData) + sizeof(AllocationHeader) :
+		sizeof(AllocationHeader);
+}
+
+static AllocationHeader* GetHeader(void* data)
+{
+	return reinterpret_cast<AllocationHeader*>(reinterpret_cast<int8_t*>(data) - sizeof(AllocationHeader));
+}
+
+static const AllocationHeader* GetHeader(const void* data)
+{
+	return reinterpret_cast<const AllocationHeader*>(reinterpret_cast<const int8_t*>(data) - sizeof(AllocationHeader));
+}
+
+static AllocationHeader* GetHeader(AllocationTrackingData* tracking_data)
+{
+	return reinterpret_cast<AllocationHeader*>(reinterpret_cast<int8_t*>(tracking_data) + sizeof(AllocationTrackingData));
+}
+
+static AllocationTrackingData* GetTrackingData(AllocationHeader* header)
+{
+	GAFF_ASSERT(header->flags & k_header_flag_tracking);
+	return reinterpret_cast<AllocationTrackingData*>(reinterpret_cast<int8_t*>(header) - sizeof(AllocationTrackingData));
+}
+
+// Start of the block that was returned by mimalloc.
+static const void* GetAllocationStart(const AllocationHeader* header)
+{
+	return (header->flags & k_header_flag_tracking) ?
+		reinterpret_cast<const int8_t*>(header) - sizeof(AllocationTrackingData) :
+		reinterpret_cast<const int8_t*>(header);
+}
+
+static void* GetAllocationStart(AllocationHeader* header)
+{
+	return const_cast<void*>(GetAllocationStart(const_cast<const AllocationHeader*>(header)));
+}
+
+// Hands each live thread the lowest free ordinal, which picks its stats shard. Ordinals are given back
+// when a thread exits, so threads that come and go don't end up piling onto the same shards.
+class ThreadOrdinals final
+{
+public:
+	int32_t acquire(void)
+	{
+		const EA::Thread::AutoSpinLock lock(_lock);
+
+		for (int32_t i = 0; i < static_cast<int32_t>(ARRAY_SIZE(_used)); ++i) {
+			if (_used[i] == UINT64_MAX) {
+				continue;
+			}
+
+			for (int32_t bit = 0; bit < 64; ++bit) {
+				const uint64_t mask = uint64_t(1) << bit;
+
+				if (!(_used[i] & mask)) {
+					_used[i] |= mask;
+					return i * 64 + bit;
+				}
+			}
+		}
+
+		// More live threads than shards. Doubling up is unavoidable now.
+		return Allocator::k_max_stat_shards + (_overflow++ % Allocator::k_max_stat_shards);
+	}
+
+	void release(int32_t ordinal)
+	{
+		if (ordinal >= Allocator::k_max_stat_shards) {
+			return;
+		}
+
+		const EA::Thread::AutoSpinLock lock(_lock);
+		_used[ordinal / 64] &= ~(uint64_t(1) << (ordinal % 64));
+	}
+
+private:
+	EA::Thread::SpinLock _lock;
+	uint64_t _used[Allocator::k_max_stat_shards / 64] = { 0 };
+	int32_t _overflow = 0;
+};
+
+struct ThreadStatShard final
+{
+	~ThreadStatShard(void);
+
+	int32_t ordinal = -1;
+};
+
+static ThreadOrdinals g_thread_ordinals;
+
+// Memory is a single module, so a thread_local here is shared by everyone calling into the allocator.
+// Needs a destructor, so THREAD_LOCAL won't do.
+static thread_local ThreadStatShard g_stat_shard;
+
+ThreadStatShard::~ThreadStatShard(void)
+{
+	if (ordinal > -1) {
+		g_thread_ordinals.release(ordinal);
+	}
+}
+
 
 Allocator::Allocator(void)
 {
-	MemoryPoolInfo& mem_pool_info = _tagged_pools[0];
-	mem_pool_info.total_bytes_allocated = 0;
-	mem_pool_info.num_allocations = 0;
-	mem_pool_info.num_frees = 0;
-	strncpy(mem_pool_info.pool_name, "Untagged", POOL_NAME_SIZE - 1);
+#if FORCE_TRACKING_ALLOCATION_HEADER || !defined(USE_RELEASE_ALLOCATION_HEADER)
+	_header_mode = AllocationHeaderMode::Tracking;
+#else
+	_header_mode = AllocationHeaderMode::Release;
+#endif
+
+	// Leave headroom for hyperthreading and the handful of threads that aren't job pool workers.
+	const int32_t wanted_shards = static_cast<int32_t>(Gaff::GetNumberOfCores()) * 2;
+	_num_stat_shards = k_min_stat_shards;
+
+	while (_num_stat_shards < wanted_shards && _num_stat_shards < k_max_stat_shards) {
+		_num_stat_shards *= 2;
+	}
+
+	// Straight from mimalloc, as we are the allocator. Never freed, as frees from other static destructors
+	// can still land after ours.
+	_stat_shards = reinterpret_cast<StatShard*>(mi_malloc_aligned(sizeof(StatShard) * static_cast<size_t>(_num_stat_shards), alignof(StatShard)));
+
+	for (int32_t i = 0; i < _num_stat_shards; ++i) {
+		new(_stat_shards + i) StatShard();
+	}
+
+	strncpy(_tagged_pools[0].pool_name, "Untagged", POOL_NAME_SIZE - 1);
 
 	_tag_ids.push_back(Gaff::FNV1aHash32Const("Untagged"));
 }
@@ -112,12 +248,28 @@ void Allocator::set_name(const char*)
 
 void Allocator::addOnFreeCallback(OnFreeCallback callback, void* data)
 {
-	AllocationHeader* const header = reinterpret_cast<AllocationHeader*>(reinterpret_cast<int8_t*>(data) - sizeof(AllocationHeader));
+	AllocationHeader* const header = GetHeader(data);
+	header->flags |= k_header_flag_free_callbacks;
 
-	for (int32_t i = 0; i < AllocationHeader::k_num_free_callbacks; ++i) {
-		if (!header->free_callbacks[i]) {
-			header->free_callbacks[i] = callback;
-			return;
+	if (header->flags & k_header_flag_tracking) {
+		AllocationTrackingData* const tracking_data = GetTrackingData(header);
+
+		for (int32_t i = 0; i < k_num_free_callbacks; ++i) {
+			if (!tracking_data->free_callbacks[i]) {
+				tracking_data->free_callbacks[i] = callback;
+				return;
+			}
+		}
+
+	} else {
+		const EA::Thread::AutoSpinLock lock(_free_callback_lock);
+		FreeCallbacks& free_callbacks = _free_callbacks[data];
+
+		for (int32_t i = 0; i < k_num_free_callbacks; ++i) {
+			if (!free_callbacks.callbacks[i]) {
+				free_callbacks.callbacks[i] = callback;
+				return;
+			}
 		}
 	}
 
@@ -126,12 +278,33 @@ void Allocator::addOnFreeCallback(OnFreeCallback callback, void* data)
 
 void Allocator::removeOnFreeCallback(OnFreeCallback callback, void* data)
 {
-	AllocationHeader* const header = reinterpret_cast<AllocationHeader*>(reinterpret_cast<int8_t*>(data) - sizeof(AllocationHeader));
+	AllocationHeader* const header = GetHeader(data);
 
-	for (int32_t i = 0; i < AllocationHeader::k_num_free_callbacks; ++i) {
-		if (header->free_callbacks[i] == callback) {
-			header->free_callbacks[i] = nullptr;
-			break;
+	if (!(header->flags & k_header_flag_free_callbacks)) {
+		return;
+	}
+
+	if (header->flags & k_header_flag_tracking) {
+		AllocationTrackingData* const tracking_data = GetTrackingData(header);
+
+		for (int32_t i = 0; i < k_num_free_callbacks; ++i) {
+			if (tracking_data->free_callbacks[i] == callback) {
+				tracking_data->free_callbacks[i] = nullptr;
+				break;
+			}
+		}
+
+	} else {
+		const EA::Thread::AutoSpinLock lock(_free_callback_lock);
+		const auto it = _free_callbacks.find(data);
+
+		if (it != _free_callbacks.end()) {
+			for (int32_t i = 0; i < k_num_free_callbacks; ++i) {
+				if (it->second.callbacks[i] == callback) {
+					it->second.callbacks[i] = nullptr;
+					break;
+				}
+			}
 		}
 	}
 }
@@ -156,25 +329,27 @@ int32_t Allocator::getPoolIndex(const char* pool_name)
 
 size_t Allocator::getUsableSize(const void* data) const
 {
-	const AllocationHeader* const header = reinterpret_cast<const AllocationHeader*>(reinterpret_cast<const int8_t*>(data) - sizeof(AllocationHeader));
-	return mi_usable_size(header);
+	const AllocationHeader* const header = GetHeader(data);
+	const void* const start = GetAllocationStart(header);
+
+	return mi_usable_size(start) - static_cast<size_t>(reinterpret_cast<const int8_t*>(data) - reinterpret_cast<const int8_t*>(start));
 }
 
 void* Allocator::alloc(size_t size_bytes, size_t alignment, int32_t pool_index, const char* file, int line)
 {
-	void* data = mi_malloc_aligned(size_bytes + sizeof(AllocationHeader), alignment);
+	const AllocationHeaderMode mode = _header_mode.load(std::memory_order_relaxed);
+	void* data = mi_malloc_aligned(size_bytes + GetHeaderSize(mode), alignment);
 	TracyAllocN(data, size_bytes, getPoolName(pool_index));
 
 	if (data) {
-		setHeaderData(
-			reinterpret_cast<AllocationHeader*>(data),
+		return setHeaderData(
+			data,
+			mode,
 			pool_index,
 			size_bytes,
 			file,
 			line
 		);
-
-		return reinterpret_cast<int8_t*>(data) + sizeof(AllocationHeader);
 	}
 
 	return nullptr;
@@ -182,19 +357,19 @@ void* Allocator::alloc(size_t size_bytes, size_t alignment, int32_t pool_index,
 
 void* Allocator::alloc(size_t size_bytes, int32_t pool_index, const char* file, int line)
 {
-	void* data = mi_malloc(size_bytes + sizeof(AllocationHeader));
+	const AllocationHeaderMode mode = _header_mode.load(std::memory_order_relaxed);
+	void* data = mi_malloc(size_bytes + GetHeaderSize(mode));
 	TracyAllocN(data, size_bytes, getPoolName(pool_index));
 
 	if (data) {
-		setHeaderData(
-			reinterpret_cast<AllocationHeader*>(data),
+		return setHeaderData(
+			data,
+			mode,
 			pool_index,
 			size_bytes,
 			file,
 			line
 		);
-
-		return reinterpret_cast<int8_t*>(data) + sizeof(AllocationHeader);
 	}
 
 	return nullptr;
@@ -219,20 +394,21 @@ void Allocator::free(void* data)
 #if defined(CHECK_FOR_MISALIGNED_POINTER)
 	AllocationHeader* header = nullptr;
 #else
-	AllocationHeader* const header = reinterpret_cast<AllocationHeader*>(reinterpret_cast<int8_t*>(data) - sizeof(AllocationHeader));
+	AllocationHeader* const header = GetHeader(data);
 #endif
 
-#if REQUIRES_HEADER_LIST
+#if FORCE_TRACKING_ALLOCATION_HEADER
 	_alloc_lock.Lock();
 
 	#ifdef CHECK_FOR_MISALIGNED_POINTER
 	// Looping over the alloc list is a terrible way of determining if a call to delete is valid.
-	for (AllocationHeader* list = _list_head; list; list = list->next) {
-		// Checking data range because we could be requesting a free from an interface pointer.
-		if (data >= reinterpret_cast<int8_t*>(list) + sizeof(AllocationHeader) &&
-			data < reinterpret_cast<int8_t*>(list) + list->alloc_size + sizeof(AllocationHeader)) {
+	for (AllocationTrackingData* list = _list_head; list; list = list->next) {
+		AllocationHeader* const list_header = GetHeader(list);
+		const int8_t* const list_data = reinterpret_cast<int8_t*>(list_header) + sizeof(AllocationHeader);
 
-			header = list;
+		// Checking data range because we could be requesting a free from an interface pointer.
+		if (data >= list_data && data < list_data + list_header->alloc_size) {
+			header = list_header;
 			break;
 		}
 	}
@@ -242,52 +418,73 @@ void Allocator::free(void* data)
 	#endif
 
 	// Check if we did not free on header boundary.
-	const AllocationHeader* const header_from_pointer = reinterpret_cast<AllocationHeader*>(reinterpret_cast<int8_t*>(data) - sizeof(AllocationHeader));
-	GAFF_ASSERT(header == header_from_pointer);
+	GAFF_ASSERT(header == GetHeader(data));
 
 	#elif defined(CHECK_FOR_DOUBLE_FREE)
 	bool found = false;
 
 	// Looping over the alloc list is a terrible way of determining if a call to delete is valid.
-	for (AllocationHeader* list = _list_head; list; list = list->next) {
-		if (list == header) {
+	for (AllocationTrackingData* list = _list_head; list; list = list->next) {
+		if (GetHeader(list) == header) {
 			found = true;
 			break;
 		}
 	}
 
 	GAFF_ASSERT(found);
-#endif
+	#endif
 
-	// Process the free.
-	if (header->prev) {
-		header->prev->next = header->next;
-	}
+	removeFromAllocationList(GetTrackingData(header));
+	_alloc_lock.Unlock();
 
-	if (header->next) {
-		header->next->prev = header->prev;
+#elif REQUIRES_HEADER_LIST
+	// Release headers are never added to the list.
+	if (header->flags & k_header_flag_tracking) {
+		_alloc_lock.Lock();
+		removeFromAllocationList(GetTrackingData(header));
+		_alloc_lock.Unlock();
 	}
+#endif
 
-	if (header == _list_head) {
-		_list_head = header->next;
-	}
+	PoolStats& pool_stats = getThreadPoolStats(header->pool_index);
+	pool_stats.curr_bytes_allocated.fetch_sub(header->alloc_size, std::memory_order_relaxed);
+	pool_stats.num_frees.fetch_add(1, std::memory_order_relaxed);
 
-	_alloc_lock.Unlock();
-#endif
+	if (header->flags & k_header_flag_free_callbacks) {
+		if (header->flags & k_header_flag_tracking) {
+			for (OnFreeCallback callback : GetTrackingData(header)->free_callbacks) {
+				if (callback) {
+					callback(data);
+				}
+			}
+
+		} else {
+			FreeCallbacks free_callbacks;
+
+			_free_callback_lock.Lock();
+
+			const auto it = _free_callbacks.find(data);
 
-	MemoryPoolInfo& mem_pool_info = _tagged_pools[header->pool_index];
-	mem_pool_info.curr_bytes_allocated -= header->alloc_size;
-	++mem_pool_info.num_frees;
+			if (it != _free_callbacks.end()) {
+				free_callbacks = it->second;
+				_free_callbacks.erase(it);
+			}
 
-	for (OnFreeCallback callback : header->free_callbacks) {
-		if (callback) {
-			callback(data);
+			_free_callback_lock.Unlock();
+
+			for (OnFreeCallback callback : free_callbacks.callbacks) {
+				if (callback) {
+					callback(data);
+				}
+			}
 		}
 	}
 
-	mi_free(header);
+	void* const start = GetAllocationStart(header);
 
-	TracyFreeN(header, mem_pool_info.pool_name);
+	// Report the free before the memory can be handed out again.
+	TracyFreeN(start, getPoolName(header->pool_index));
+	mi_free(start);
 }
 
 void* Allocator::calloc(size_t num_members, size_t member_size, size_t alignment, int32_t pool_index, const char* file, int line)
@@ -324,7 +521,7 @@ void* Allocator::realloc(void* old_ptr, size_t new_size, size_t alignment, int32
 		return alloc(new_size, alignment, pool_index, file, line);
 	}
 
-	AllocationHeader* const header = reinterpret_cast<AllocationHeader*>(reinterpret_cast<int8_t*>(old_ptr) - sizeof(AllocationHeader));
+	const AllocationHeader* const header = GetHeader(old_ptr);
 
 	if (header->alloc_size >= new_size) {
 		return old_ptr;
@@ -348,7 +545,7 @@ void* Allocator::realloc(void* old_ptr, size_t new_size, int32_t pool_index, con
 		return alloc(new_size, pool_index, file, line);
 	}
 
-	AllocationHeader* const header = reinterpret_cast<AllocationHeader*>(reinterpret_cast<int8_t*>(old_ptr) - sizeof(AllocationHeader));
+	const AllocationHeader* const header = GetHeader(old_ptr);
 
 	if (header->alloc_size >= new_size) {
 		return old_ptr;
@@ -368,17 +565,23 @@ void* Allocator::realloc(void* old_ptr, size_t new_size, const char* file, int l
 
 size_t Allocator::getTotalBytesAllocated(size_t pool_index) const
 {
-	return _tagged_pools[pool_index].total_bytes_allocated;
+	MemoryPoolStats stats;
+	getPoolStats(static_cast<int32_t>(pool_index), stats);
+	return stats.total_bytes_allocated;
 }
 
 size_t Allocator::getNumAllocations(size_t pool_index) const
 {
-	return _tagged_pools[pool_index].num_allocations;
+	MemoryPoolStats stats;
+	getPoolStats(static_cast<int32_t>(pool_index), stats);
+	return stats.num_allocations;
 }
 
 size_t Allocator::getNumFrees(size_t pool_index) const
 {
-	return _tagged_pools[pool_index].num_frees;
+	MemoryPoolStats stats;
+	getPoolStats(static_cast<int32_t>(pool_index), stats);
+	return stats.num_frees;
 }
 
 const char* Allocator::getPoolName(int32_t pool_index) const
@@ -386,6 +589,41 @@ const char* Allocator::getPoolName(int32_t pool_index) const
 	return _tagged_pools[pool_index].pool_name;
 }
 
+int32_t Allocator::getNumPools(void) const
+{
+	return static_cast<int32_t>(_tag_ids.size());
+}
+
+int32_t Allocator::getPoolStats(MemoryPoolStats* out_stats, int32_t max_pools) const
+{
+	const int32_t num_pools = eastl::min(getNumPools(), max_pools);
+
+	for (int32_t i = 0; i < num_pools; ++i) {
+		getPoolStats(i, out_stats[i]);
+	}
+
+	return num_pools;
+}
+
+void Allocator::getPoolStats(int32_t pool_index, MemoryPoolStats& out_stats) const
+{
+	GAFF_ASSERT(pool_index >= 0 && pool_index < getNumPools());
+
+	out_stats.pool_name = _tagged_pools[pool_index].pool_name;
+	out_stats.total_bytes_allocated = 0;
+	out_stats.curr_bytes_allocated = 0;
+	out_stats.num_allocations = 0;
+	out_stats.num_frees = 0;
+
+	for (int32_t i = 0; i < _num_stat_shards; ++i) {
+		const PoolStats& pool_stats = _stat_shards[i].pools[pool_index];
+		out_stats.total_bytes_allocated += pool_stats.total_bytes_allocated.load(std::memory_order_relaxed);
+		out_stats.curr_bytes_allocated += pool_stats.curr_bytes_allocated.load(std::memory_order_relaxed);
+		out_stats.num_allocations += pool_stats.num_allocations.load(std::memory_order_relaxed);
+		out_stats.num_frees += pool_stats.num_frees.load(std::memory_order_relaxed);
+	}
+}
+
 void Allocator::setLogDir(const char8_t* log_dir)
 {
 	const size_t in_len = eastl::CharStrlen(log_dir) + 1;
@@ -396,49 +634,107 @@ void Allocator::setLogDir(const char8_t* log_dir)
 	_log_dir[len - 1] = 0;
 }
 
-void Allocator::setHeaderData(
-	AllocationHeader* header,
+void Allocator::setHeaderMode(AllocationHeaderMode mode)
+{
+#if FORCE_TRACKING_ALLOCATION_HEADER
+	GAFF_REF(mode);
+#else
+	_header_mode = mode;
+#endif
+}
+
+AllocationHeaderMode Allocator::getHeaderMode(void) const
+{
+	return _header_mode;
+}
+
+size_t Allocator::getHeaderSize(void) const
+{
+	return GetHeaderSize(_header_mode);
+}
+
+void* Allocator::setHeaderData(
+	void* data,
+	AllocationHeaderMode mode,
 	int32_t pool_index,
 	size_t size_bytes,
 	const char* file,
 	int line)
 {
 	// Add the allocation statistics.
-	MemoryPoolInfo& mem_pool_info = _tagged_pools[pool_index];
-	mem_pool_info.total_bytes_allocated += size_bytes;
-	mem_pool_info.curr_bytes_allocated += size_bytes;
-	++mem_pool_info.num_allocations;
+	PoolStats& pool_stats = getThreadPoolStats(pool_index);
+	pool_stats.total_bytes_allocated.fetch_add(size_bytes, std::memory_order_relaxed);
+	pool_stats.curr_bytes_allocated.fetch_add(size_bytes, std::memory_order_relaxed);
+	pool_stats.num_allocations.fetch_add(1, std::memory_order_relaxed);
 
-	// Set the header data.
-	header->alloc_size = size_bytes;
-	header->pool_index = pool_index;
-	strncpy(header->file, file, ARRAY_SIZE(header->file) - 1);
-	header->pool_index = pool_index;
-	header->line = line;
-	memset(header->free_callbacks, 0, sizeof(AllocationHeader::free_callbacks));
+	AllocationHeader* header = nullptr;
 
-#if REQUIRES_HEADER_LIST
-	header->next = header->prev = nullptr;
-#endif
+	if (mode == AllocationHeaderMode::Tracking) {
+		AllocationTrackingData* const tracking_data = reinterpret_cast<AllocationTrackingData*>(data);
+		header = GetHeader(tracking_data);
+
+		strncpy(tracking_data->file, file, ARRAY_SIZE(tracking_data->file) - 1);
+		memset(tracking_data->free_callbacks, 0, sizeof(AllocationTrackingData::free_callbacks));
 
 #ifdef GATHER_ALLOCATION_STACKTRACE
-	header->trace.captureStack("", 16, 3);
+		tracking_data->trace.captureStack("", 16, 3);
 #endif
 
 #if REQUIRES_HEADER_LIST
-	// Add to the leak list.
-	_alloc_lock.Lock();
+		tracking_data->next = tracking_data->prev = nullptr;
+
+		// Add to the leak list.
+		_alloc_lock.Lock();
+
+		tracking_data->next = _list_head;
 
-	header->next = _list_head;
+		if (_list_head) {
+			_list_head->prev = tracking_data;
+		}
+
+		_list_head = tracking_data;
+
+		_alloc_lock.Unlock();
+#endif
 
-	if (_list_head) {
-		_list_head->prev = header;
+	} else {
+		header = reinterpret_cast<AllocationHeader*>(data);
 	}
 
-	_list_head = header;
+	// Set the header data.
+	header->file = file;
+	header->alloc_size = size_bytes;
+	header->line = line;
+	header->pool_index = static_cast<int16_t>(pool_index);
+	header->flags = (mode == AllocationHeaderMode::Tracking) ? k_header_flag_tracking : 0;
 
-	_alloc_lock.Unlock();
+	return reinterpret_cast<int8_t*>(header) + sizeof(AllocationHeader);
+}
+
+#if REQUIRES_HEADER_LIST
+void Allocator::removeFromAllocationList(AllocationTrackingData* tracking_data)
+{
+	if (tracking_data->prev) {
+		tracking_data->prev->next = tracking_data->next;
+	}
+
+	if (tracking_data->next) {
+		tracking_data->next->prev = tracking_data->prev;
+	}
+
+	if (tracking_data == _list_head) {
+		_list_head = tracking_data->next;
+	}
+}
 #endif
+
+Allocator::PoolStats& Allocator::getThreadPoolStats(int32_t pool_index)
+{
+	if (g_stat_shard.ordinal < 0) {
+		g_stat_shard.ordinal = g_thread_ordinals.acquire();
+	}
+
+	return _stat_shards[g_stat_shard.ordinal & (_num_stat_shards - 1)].pools[pool_index];
 }
 
 void Allocator::writeAllocationLog(void) const
@@ -466,13 +762,14 @@ void Allocator::writeAllocationLog(void) const
 		"===========================================================\n\n"
 	);
 
-	for (size_t i = 0; i < _tag_ids.size(); ++i) {
-		const MemoryPoolInfo& mem_pool_info = _tagged_pools[i];
+	for (int32_t i = 0; i < getNumPools(); ++i) {
+		MemoryPoolStats mem_pool_info;
+		getPoolStats(i, mem_pool_info);
 
 		log.printf("%s:\n", mem_pool_info.pool_name);
-		log.printf("\tBytes Allocated: %zu\n", mem_pool_info.total_bytes_allocated.load());
-		log.printf("\tAllocations: %zu\n", mem_pool_info.num_allocations.load());
-		log.printf("\tFrees: %zu\n\n", mem_pool_info.num_frees.load());
+		log.printf("\tBytes Allocated: %zu\n", mem_pool_info.total_bytes_allocated);
+		log.printf("\tAllocations: %zu\n", mem_pool_info.num_allocations);
+		log.printf("\tFrees: %zu\n\n", mem_pool_info.num_frees);
 
 		total_bytes += mem_pool_info.total_bytes_allocated;
 		total_allocs += mem_pool_info.num_allocations;
@@ -525,33 +822,34 @@ void Allocator::writeLeakLog(void) const
 		"===========================================================\n\n"
 	);
 
-	for (AllocationHeader* header = _list_head; header;) {
+	for (AllocationTrackingData* tracking_data = _list_head; tracking_data;) {
+		const AllocationHeader* const header = GetHeader(tracking_data);
 		const char* const pool_name = _tagged_pools[header->pool_index].pool_name;
 
 	#ifdef GATHER_ALLOCATION_STACKTRACE
 		log.printf("Address 0x%p [%s]:\n", reinterpret_cast<const int8_t*>(header) + sizeof(AllocationHeader), pool_name);
 
-		const int32_t frames = header->trace.getNumCapturedFrames();
+		const int32_t frames = tracking_data->trace.getNumCapturedFrames();
 
 		for (int32_t i = 0; i < frames; ++i) {
 			log.printf(
 				"\t(0x%llX) [%s:(%u)] %s\n",
-				header->trace.getAddress(i),
-				header->trace.getFileName(i),
-				header->trace.getLineNumber(i),
-				header->trace.getSymbolName(i)
+				tracking_data->trace.getAddress(i),
+				tracking_data->trace.getFileName(i),
+				tracking_data->trace.getLineNumber(i),
+				tracking_data->trace.getSymbolName(i)
 			);
 		}
 
 		log.printf("\n");
 	#else
-		log.printf("%s:(%i) [%s]\n", header->file, header->line, pool_name);
+		log.printf("%s:(%i) [%s]\n", tracking_data->file, header->line, pool_name);
 	#endif
 
-		AllocationHeader* const old_header = header;
-		header = header->next;
+		AllocationTrackingData* const old_tracking_data = tracking_data;
+		tracking_data = tracking_data->next;
 
-		mi_free(old_header);
+		mi_free(old_tracking_data);
 	}
 #endif
 }
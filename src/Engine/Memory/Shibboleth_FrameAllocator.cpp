@@ -0,0 +1,423 @@
+/************************************************************************************
+Copyright (C) 2022 by Nicholas LaCroix
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+************************************************************************************/
+
+#include "Shibboleth_FrameAllocator.h"
+#include <Gaff_Assert.h>
+#include <eathread/eathread.h>
+#include <EASTL/algorithm.h>
+
+NS_SHIBBOLETH
+
+// Sits directly in front of every pointer we return.
+struct alignas(16) FrameAllocationHeader final
+{
+	size_t size;
+	void* overflow_block; // Non-null if this allocation didn't fit in the arena.
+};
+
+struct FrameArena final
+{
+	FrameAllocator* owner;
+	EA::Thread::ThreadId thread_id; // kThreadIdInvalid while no thread owns the arena.
+
+	int8_t* buffers[FrameAllocator::k_num_frame_buffers];
+	size_t arena_size;
+
+	// Only touched by the owning thread.
+	size_t used;
+	size_t frame_overflow_bytes;
+	int32_t curr_buffer;
+	uint32_t generation;
+
+	// Written by the owning thread, read by anyone asking for stats.
+	std::atomic_size_t high_water_mark;
+	std::atomic_size_t overflow_high_water_mark;
+	std::atomic_size_t num_overflow_allocations;
+};
+
+static constexpr size_t k_min_frame_alignment = alignof(FrameAllocationHeader);
+
+// Gives the arena back to its allocator when the thread exits. Needs a destructor, so THREAD_LOCAL won't do.
+struct ThreadFrameArena final
+{
+	~ThreadFrameArena(void)
+	{
+		if (arena) {
+			arena->owner->releaseThreadArena(arena);
+		}
+	}
+
+	FrameArena* arena = nullptr;
+};
+
+static thread_local ThreadFrameArena g_thread_arena;
+
+static int8_t* AlignUp(int8_t* ptr, size_t alignment)
+{
+	const uintptr_t address = reinterpret_cast<uintptr_t>(ptr);
+	return reinterpret_cast<int8_t*>((address + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1));
+}
+
+static FrameAllocationHeader* GetFrameHeader(void* data)
+{
+	return reinterpret_cast<FrameAllocationHeader*>(reinterpret_cast<int8_t*>(data) - sizeof(FrameAllocationHeader));
+}
+
+static const FrameAllocationHeader* GetFrameHeader(const void* data)
+{
+	return reinterpret_cast<const FrameAllocationHeader*>(reinterpret_cast<const int8_t*>(data) - sizeof(FrameAllocationHeader));
+}
+
+static void UpdateHighWaterMark(std::atomic_size_t& high_water_mark, size_t value)
+{
+	// Only the owning thread writes, so a plain compare and store is enough.
+	if (value > high_water_mark.load(std::memory_order_relaxed)) {
+		high_water_mark.store(value, std::memory_order_relaxed);
+	}
+}
+
+
+FrameAllocator::FrameAllocator(IAllocator& backing_allocator):
+	_backing_allocator(backing_allocator),
+	_pool_index(backing_allocator.getPoolIndex("Frame Allocator"))
+{
+}
+
+FrameAllocator::~FrameAllocator(void)
+{
+	const int32_t num_arenas = _num_arenas.load(std::memory_order_acquire);
+
+	for (int32_t i = 0; i < num_arenas; ++i) {
+		FrameArena* const arena = _arenas[i];
+
+		SHIB_FREE(arena->buffers[0], _backing_allocator);
+		SHIB_FREET(arena, _backing_allocator);
+	}
+}
+
+void* FrameAllocator::allocate(size_t n, int flags)
+{
+	GAFF_REF(flags);
+	return alloc(n, __FILE__, __LINE__);
+}
+
+void* FrameAllocator::allocate(size_t n, size_t alignment, size_t, int flags)
+{
+	GAFF_REF(flags);
+	return alloc(n, alignment, __FILE__, __LINE__);
+}
+
+void FrameAllocator::deallocate(void* p, size_t)
+{
+	free(p);
+}
+
+const char* FrameAllocator::get_name() const
+{
+	return "Frame Allocator";
+}
+
+void FrameAllocator::set_name(const char*)
+{
+}
+
+void FrameAllocator::addOnFreeCallback(OnFreeCallback, void*)
+{
+	GAFF_ASSERT_MSG(false, "FrameAllocator does not support on free callbacks.");
+}
+
+void FrameAllocator::removeOnFreeCallback(OnFreeCallback, void*)
+{
+	GAFF_ASSERT_MSG(false, "FrameAllocator does not support on free callbacks.");
+}
+
+int32_t FrameAllocator::getPoolIndex(const char* pool_name)
+{
+	return _backing_allocator.getPoolIndex(pool_name);
+}
+
+size_t FrameAllocator::getUsableSize(const void* data) const
+{
+	return GetFrameHeader(data)->size;
+}
+
+void* FrameAllocator::alloc(size_t size_bytes, size_t alignment, int32_t, const char* file, int line)
+{
+	return alloc(size_bytes, alignment, file, line);
+}
+
+void* FrameAllocator::alloc(size_t size_bytes, int32_t, const char* file, int line)
+{
+	return alloc(size_bytes, file, line);
+}
+
+void* FrameAllocator::alloc(size_t size_bytes, size_t alignment, const char* file, int line)
+{
+	GAFF_ASSERT((alignment & (alignment - 1)) == 0);
+	alignment = eastl::max(alignment, k_min_frame_alignment);
+
+	FrameArena* const arena = getThreadArena();
+
+	if (!arena) {
+		return allocOverflow(arena, size_bytes, alignment, file, line);
+	}
+
+	int8_t* const buffer = arena->buffers[arena->curr_buffer];
+	int8_t* const data = AlignUp(buffer + arena->used + sizeof(FrameAllocationHeader), alignment);
+	const size_t end = static_cast<size_t>(data - buffer) + size_bytes;
+
+	if (end > arena->arena_size) {
+		return allocOverflow(arena, size_bytes, alignment, file, line);
+	}
+
+	FrameAllocationHeader* const header = GetFrameHeader(data);
+	header->size = size_bytes;
+	header->overflow_block = nullptr;
+
+	arena->used = end;
+	UpdateHighWaterMark(arena->high_water_mark, end);
+
+	return data;
+}
+
+void* FrameAllocator::alloc(size_t size_bytes, const char* file, int line)
+{
+	return alloc(size_bytes, k_min_frame_alignment, file, line);
+}
+
+void FrameAllocator::free(void* data)
+{
+	if (!data) {
+		return;
+	}
+
+	// Arena memory is reclaimed in bulk. Only overflow allocations need to be given back.
+	FrameAllocationHeader* const header = GetFrameHeader(data);
+
+	if (header->overflow_block) {
+		SHIB_FREE(header->overflow_block, _backing_allocator);
+	}
+}
+
+void* FrameAllocator::calloc(size_t num_members, size_t member_size, size_t alignment, int32_t, const char* file, int line)
+{
+	return calloc(num_members, member_size, alignment, file, line);
+}
+
+void* FrameAllocator::calloc(size_t num_members, size_t member_size, size_t alignment, const char* file, int line)
+{
+	void* const data = alloc(num_members * member_size, alignment, file, line);
+
+	if (data) {
+		memset(data, 0, num_members * member_size);
+	}
+
+	return data;
+}
+
+void* FrameAllocator::calloc(size_t num_members, size_t member_size, int32_t, const char* file, int line)
+{
+	return calloc(num_members, member_size, file, line);
+}
+
+void* FrameAllocator::calloc(size_t num_members, size_t member_size, const char* file, int line)
+{
+	return calloc(num_members, member_size, k_min_frame_alignment, file, line);
+}
+
+void* FrameAllocator::realloc(void* old_ptr, size_t new_size, size_t alignment, int32_t, const char* file, int line)
+{
+	return realloc(old_ptr, new_size, alignment, file, line);
+}
+
+void* FrameAllocator::realloc(void* old_ptr, size_t new_size, size_t alignment, const char* file, int line)
+{
+	void* const data = alloc(new_size, alignment, file, line);
+
+	if (data && old_ptr) {
+		memcpy(data, old_ptr, eastl::min(new_size, getUsableSize(old_ptr)));
+		free(old_ptr);
+	}
+
+	return data;
+}
+
+void* FrameAllocator::realloc(void* old_ptr, size_t new_size, int32_t, const char* file, int line)
+{
+	return realloc(old_ptr, new_size, file, line);
+}
+
+void* FrameAllocator::realloc(void* old_ptr, size_t new_size, const char* file, int line)
+{
+	return realloc(old_ptr, new_size, k_min_frame_alignment, file, line);
+}
+
+void FrameAllocator::setArenaSize(size_t size_bytes)
+{
+	_arena_size.store(size_bytes, std::memory_order_relaxed);
+}
+
+size_t FrameAllocator::getArenaSize(void) const
+{
+	return _arena_size.load(std::memory_order_relaxed);
+}
+
+void FrameAllocator::reset(void)
+{
+	// Threads notice the new generation on their next allocation and swap to their next buffer.
+	_generation.fetch_add(1, std::memory_order_release);
+}
+
+int32_t FrameAllocator::getStats(FrameAllocatorStats* out_stats, int32_t max_threads) const
+{
+	const int32_t num_arenas = eastl::min(_num_arenas.load(std::memory_order_acquire), max_threads);
+
+	for (int32_t i = 0; i < num_arenas; ++i) {
+		const FrameArena& arena = *_arenas[i];
+		FrameAllocatorStats& stats = out_stats[i];
+
+		stats.thread_id = (uintptr_t)arena.thread_id;
+		stats.arena_size = arena.arena_size;
+		stats.high_water_mark = arena.high_water_mark.load(std::memory_order_relaxed);
+		stats.overflow_high_water_mark = arena.overflow_high_water_mark.load(std::memory_order_relaxed);
+		stats.num_overflow_allocations = arena.num_overflow_allocations.load(std::memory_order_relaxed);
+	}
+
+	return num_arenas;
+}
+
+FrameArena* FrameAllocator::getThreadArena(void)
+{
+	FrameArena* arena = g_thread_arena.arena;
+
+	if (!arena || arena->owner != this) {
+		arena = createThreadArena();
+		g_thread_arena.arena = arena;
+
+		if (!arena) {
+			return nullptr;
+		}
+	}
+
+	const uint32_t generation = _generation.load(std::memory_order_acquire);
+
+	// First allocation of a new frame. The buffer we're moving to was last used at least k_num_frame_buffers frames ago.
+	if (arena->generation != generation) {
+		arena->generation = generation;
+		arena->curr_buffer = static_cast<int32_t>(generation % k_num_frame_buffers);
+		arena->used = 0;
+		arena->frame_overflow_bytes = 0;
+	}
+
+	return arena;
+}
+
+FrameArena* FrameAllocator::createThreadArena(void)
+{
+	const EA::Thread::ThreadId thread_id = EA::Thread::GetThreadId();
+	const EA::Thread::AutoSpinLock lock(_arena_lock);
+	const int32_t num_arenas = _num_arenas.load(std::memory_order_relaxed);
+
+	// We may have been used by this thread before, but another allocator has used it since.
+	for (int32_t i = 0; i < num_arenas; ++i) {
+		if (_arenas[i]->thread_id == thread_id) {
+			return _arenas[i];
+		}
+	}
+
+	// Take over an arena from a thread that has exited. Its buffers follow the same frame rules as before,
+	// so anything the old thread allocated stays valid for as long as it would have.
+	for (int32_t i = 0; i < num_arenas; ++i) {
+		if (_arenas[i]->thread_id == EA::Thread::kThreadIdInvalid) {
+			_arenas[i]->thread_id = thread_id;
+			return _arenas[i];
+		}
+	}
+
+	if (num_arenas >= MAX_FRAME_ARENAS) {
+		return nullptr;
+	}
+
+	const size_t arena_size = _arena_size.load(std::memory_order_relaxed);
+	int8_t* const buffer = SHIB_ALLOC_CAST_POOL(int8_t*, arena_size * k_num_frame_buffers, _pool_index, _backing_allocator);
+
+	if (!buffer) {
+		return nullptr;
+	}
+
+	FrameArena* const arena = SHIB_ALLOCT_POOL(FrameArena, _pool_index, _backing_allocator);
+	arena->owner = this;
+	arena->thread_id = thread_id;
+	arena->arena_size = arena_size;
+	arena->used = 0;
+	arena->frame_overflow_bytes = 0;
+	arena->generation = _generation.load(std::memory_order_acquire);
+	arena->curr_buffer = static_cast<int32_t>(arena->generation % k_num_frame_buffers);
+	arena->high_water_mark = 0;
+	arena->overflow_high_water_mark = 0;
+	arena->num_overflow_allocations = 0;
+
+	for (int32_t i = 0; i < k_num_frame_buffers; ++i) {
+		arena->buffers[i] = buffer + arena_size * static_cast<size_t>(i);
+	}
+
+	_arenas[num_arenas] = arena;
+	_num_arenas.store(num_arenas + 1, std::memory_order_release);
+
+	return arena;
+}
+
+void FrameAllocator::releaseThreadArena(FrameArena* arena)
+{
+	const EA::Thread::AutoSpinLock lock(_arena_lock);
+	arena->thread_id = EA::Thread::kThreadIdInvalid;
+}
+
+void* FrameAllocator::allocOverflow(FrameArena* arena, size_t size_bytes, size_t alignment, const char* file, int line)
+{
+	int8_t* const block = reinterpret_cast<int8_t*>(_backing_allocator.alloc(
+		size_bytes + sizeof(FrameAllocationHeader) + alignment,
+		_pool_index,
+		file,
+		line
+	));
+
+	if (!block) {
+		return nullptr;
+	}
+
+	int8_t* const data = AlignUp(block + sizeof(FrameAllocationHeader), alignment);
+
+	FrameAllocationHeader* const header = GetFrameHeader(data);
+	header->size = size_bytes;
+	header->overflow_block = block;
+
+	if (arena) {
+		arena->frame_overflow_bytes += size_bytes;
+		arena->num_overflow_allocations.fetch_add(1, std::memory_order_relaxed);
+		UpdateHighWaterMark(arena->overflow_high_water_mark, arena->frame_overflow_bytes);
+	}
+
+	return data;
+}
+
+NS_END
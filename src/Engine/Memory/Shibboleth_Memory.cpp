@@ -21,11 +21,13 @@ THE SOFTWARE.
 ************************************************************************************/
 
 #include "Shibboleth_Memory.h"
+#include "Shibboleth_FrameAllocator.h"
 #include "Shibboleth_Allocator.h"
 
 NS_SHIBBOLETH
 
 static Allocator g_allocator;
+static FrameAllocator g_frame_allocator(g_allocator);
 
 int32_t GetPoolIndex(const char* pool_name)
 {
@@ -37,6 +39,11 @@ IAllocator& GetAllocator(void)
 	return g_allocator;
 }
 
+IAllocator& GetFrameAllocator(void)
+{
+	return g_frame_allocator;
+}
+
 void* ShibbolethAllocate(size_t size, size_t alignment, int32_t pool_index)
 {
 	return SHIB_ALLOC_ALIGNED_POOL(size, alignment, pool_index, g_allocator);
@@ -97,4 +104,49 @@ void SetLogDir(const char8_t* dir)
 	g_allocator.setLogDir(dir);
 }
 
+void SetAllocationHeaderMode(AllocationHeaderMode mode)
+{
+	g_allocator.setHeaderMode(mode);
+}
+
+AllocationHeaderMode GetAllocationHeaderMode(void)
+{
+	return g_allocator.getHeaderMode();
+}
+
+size_t GetAllocationHeaderSize(void)
+{
+	return g_allocator.getHeaderSize();
+}
+
+int32_t GetMemoryPoolStats(MemoryPoolStats* out_stats, int32_t max_pools)
+{
+	return g_allocator.getPoolStats(out_stats, max_pools);
+}
+
+int32_t GetNumMemoryPools(void)
+{
+	return g_allocator.getNumPools();
+}
+
+void ResetFrameAllocator(void)
+{
+	g_frame_allocator.reset();
+}
+
+void SetFrameAllocatorArenaSize(size_t size_bytes)
+{
+	g_frame_allocator.setArenaSize(size_bytes);
+}
+
+size_t GetFrameAllocatorArenaSize(void)
+{
+	return g_frame_allocator.getArenaSize();
+}
+
+int32_t GetFrameAllocatorStats(FrameAllocatorStats* out_stats, int32_t max_threads)
+{
+	return g_frame_allocator.getStats(out_stats, max_threads);
+}
+
 NS_END
@@ -23,14 +23,26 @@ THE SOFTWARE.
 #pragma once
 
 #include "Shibboleth_IAllocator.h"
-#include <EASTL/fixed_vector.h>
+#include "Shibboleth_Memory.h"
+#include <Gaff_DefaultAllocator.h>
 #include <Gaff_Hash.h>
+#include <eathread/eathread_spinlock.h>
+#include <EASTL/fixed_vector.h>
+#include <EASTL/hash_map.h>
 #include <atomic>
 
 #define REQUIRES_HEADER_LIST CHECK_FOR_DOUBLE_FREE || CHECK_FOR_LEAKS || CHECK_FOR_MISALIGNED_POINTER
 
-#if REQUIRES_HEADER_LIST
-	#include <eathread/eathread_spinlock.h>
+// Double free and misaligned pointer checks walk the allocation list, which only tracking headers are added to.
+#if defined(CHECK_FOR_DOUBLE_FREE) || defined(CHECK_FOR_MISALIGNED_POINTER)
+	#define FORCE_TRACKING_ALLOCATION_HEADER 1
+#else
+	#define FORCE_TRACKING_ALLOCATION_HEADER 0
+#endif
+
+// Leak checking also walks the allocation list. With release headers it would silently report nothing.
+#if defined(CHECK_FOR_LEAKS) && defined(USE_RELEASE_ALLOCATION_HEADER)
+	#error "CHECK_FOR_LEAKS requires tracking allocation headers. Don't define it alongside USE_RELEASE_ALLOCATION_HEADER."
 #endif
 
 
@@ -39,11 +51,18 @@ THE SOFTWARE.
 
 NS_SHIBBOLETH
 
+struct AllocationTrackingData;
 struct AllocationHeader;
 
 class Allocator final : public IAllocator
 {
 public:
+	static constexpr int32_t k_num_free_callbacks = 4;
+
+	// Live threads only share a stats shard once there are more of them than shards.
+	static constexpr int32_t k_min_stat_shards = 16;
+	static constexpr int32_t k_max_stat_shards = 1024;
+
 	explicit Allocator(void);
 	~Allocator(void);
 
@@ -83,46 +102,93 @@ public:
 	size_t getNumAllocations(size_t pool_index) const;
 	size_t getNumFrees(size_t pool_index) const;
 	const char* getPoolName(int32_t pool_index) const;
+	int32_t getNumPools(void) const;
+
+	int32_t getPoolStats(MemoryPoolStats* out_stats, int32_t max_pools) const;
+	void getPoolStats(int32_t pool_index, MemoryPoolStats& out_stats) const;
 
 	void setLogDir(const char8_t* log_dir);
 
+	void setHeaderMode(AllocationHeaderMode mode);
+	AllocationHeaderMode getHeaderMode(void) const;
+	size_t getHeaderSize(void) const;
+
 private:
 	struct MemoryPoolInfo
 	{
-		MemoryPoolInfo(void):
-			total_bytes_allocated(0),
-			curr_bytes_allocated(0),
-			num_allocations(0),
-			num_frees(0)
+		MemoryPoolInfo(void)
 		{
 			pool_name[0] = 0;
 		}
 
-		std::atomic_size_t total_bytes_allocated;
-		std::atomic_size_t curr_bytes_allocated;
-		std::atomic_size_t num_allocations;
-		std::atomic_size_t num_frees;
 		char pool_name[POOL_NAME_SIZE];
 	};
 
+	// Only ever touched with relaxed atomics. curr_bytes_allocated can wrap in a single shard when memory
+	// is freed on a different thread than it was allocated on, but the sum across all shards is correct.
+	struct PoolStats final
+	{
+		std::atomic_size_t total_bytes_allocated{ 0 };
+		std::atomic_size_t curr_bytes_allocated{ 0 };
+		std::atomic_size_t num_allocations{ 0 };
+		std::atomic_size_t num_frees{ 0 };
+	};
+
+	// Each live thread is assigned its own shard, padded out to a cache line so threads don't fight over the counters.
+	struct alignas(64) StatShard final
+	{
+		PoolStats pools[NUM_TAG_POOLS + 1];
+	};
+
+	struct FreeCallbacks final
+	{
+		OnFreeCallback callbacks[k_num_free_callbacks] = { nullptr };
+	};
+
+	using FreeCallbackMap = eastl::hash_map<
+		const void*,
+		FreeCallbacks,
+		eastl::hash<const void*>,
+		eastl::equal_to<const void*>,
+		Gaff::DefaultAllocator
+	>;
+
 #if REQUIRES_HEADER_LIST
 	EA::Thread::SpinLock _alloc_lock;
-	AllocationHeader* _list_head = nullptr;
+	AllocationTrackingData* _list_head = nullptr;
 #endif
 
+	// On free callbacks for release header allocations. Only populated by addOnFreeCallback().
+	// Uses the system allocator so that inserting never re-enters us.
+	EA::Thread::SpinLock _free_callback_lock;
+	FreeCallbackMap _free_callbacks;
+
+	std::atomic<AllocationHeaderMode> _header_mode;
+
+	// Sized from the core count. Always a power of two.
+	StatShard* _stat_shards = nullptr;
+	int32_t _num_stat_shards = 0;
+
 	MemoryPoolInfo _tagged_pools[NUM_TAG_POOLS + 1];
 	eastl::fixed_vector<Gaff::Hash32, NUM_TAG_POOLS + 1, false> _tag_ids;
 
 	char8_t _log_dir[64] = { u8'.', u8'/', u8'l', u8'o', u8'g', u8's', 0 };
 
-	void setHeaderData(
-		AllocationHeader* header,
+	void* setHeaderData(
+		void* data,
+		AllocationHeaderMode mode,
 		int32_t pool_index,
 		size_t size_bytes,
 		const char* file,
 		int line
 	);
 
+#if REQUIRES_HEADER_LIST
+	void removeFromAllocationList(AllocationTrackingData* tracking_data);
+#endif
+
+	PoolStats& getThreadPoolStats(int32_t pool_index);
+
 	void writeAllocationLog(void) const;
 	void writeLeakLog(void) const;
 
@@ -0,0 +1,114 @@
+/************************************************************************************
+Copyright (C) 2022 by Nicholas LaCroix
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+************************************************************************************/
+
+#pragma once
+
+#include "Shibboleth_IAllocator.h"
+#include "Shibboleth_Memory.h"
+#include <eathread/eathread_spinlock.h>
+#include <atomic>
+
+#define MAX_FRAME_ARENAS 128
+
+NS_SHIBBOLETH
+
+struct FrameArena;
+
+// Bump allocator with an arena per thread. Frees are a no-op, memory is reclaimed when the thread moves to a new frame.
+// Memory allocated during a frame stays valid until k_num_frame_buffers - 1 more calls to reset().
+// Allocations that don't fit in the arena fall back to the backing allocator.
+// Arenas are handed back when their thread exits and reused by the next new thread.
+class FrameAllocator final : public IAllocator
+{
+public:
+	// MainLoop can have up to three frames in flight.
+	static constexpr int32_t k_num_frame_buffers = 3;
+	// Overridden by the app_frame_allocator_size config.
+	static constexpr size_t k_default_arena_size = 256 * 1024;
+
+	explicit FrameAllocator(IAllocator& backing_allocator);
+	~FrameAllocator(void);
+
+	// For EASTL support.
+	void* allocate(size_t n, int flags = 0) override;
+	void* allocate(size_t n, size_t alignment, size_t, int flags = 0) override;
+	void deallocate(void* p, size_t) override;
+
+	const char* get_name() const override;
+	void set_name(const char* pName) override;
+
+	void addOnFreeCallback(OnFreeCallback callback, void* data) override;
+	void removeOnFreeCallback(OnFreeCallback callback, void* data) override;
+
+	int32_t getPoolIndex(const char* pool_name) override;
+	size_t getUsableSize(const void* data) const override;
+
+	void* alloc(size_t size_bytes, size_t alignment, int32_t pool_index, const char* file, int line) override;
+	void* alloc(size_t size_bytes, int32_t pool_index, const char* file, int line) override;
+
+	void* alloc(size_t size_bytes, size_t alignment, const char* file, int line) override;
+	void* alloc(size_t size_bytes, const char* file, int line) override;
+	void free(void* data) override;
+
+	void* calloc(size_t num_members, size_t member_size, size_t alignment, int32_t pool_index, const char* file, int line) override;
+	void* calloc(size_t num_members, size_t member_size, size_t alignment, const char* file, int line) override;
+	void* calloc(size_t num_members, size_t member_size, int32_t pool_index, const char* file, int line) override;
+	void* calloc(size_t num_members, size_t member_size, const char* file, int line) override;
+
+	void* realloc(void* old_ptr, size_t new_size, size_t alignment, int32_t pool_index, const char* file, int line) override;
+	void* realloc(void* old_ptr, size_t new_size, size_t alignment, const char* file, int line) override;
+
+	void* realloc(void* old_ptr, size_t new_size, int32_t pool_index, const char* file, int line) override;
+	void* realloc(void* old_ptr, size_t new_size, const char* file, int line) override;
+
+	// Only affects arenas for threads that haven't allocated from us yet.
+	void setArenaSize(size_t size_bytes);
+	size_t getArenaSize(void) const;
+
+	void reset(void);
+
+	int32_t getStats(FrameAllocatorStats* out_stats, int32_t max_threads) const;
+
+private:
+	IAllocator& _backing_allocator;
+	int32_t _pool_index = 0;
+
+	std::atomic_size_t _arena_size = k_default_arena_size;
+	std::atomic_uint32_t _generation = 0;
+
+	EA::Thread::SpinLock _arena_lock;
+	FrameArena* _arenas[MAX_FRAME_ARENAS] = { nullptr };
+	std::atomic_int32_t _num_arenas = 0;
+
+	FrameArena* getThreadArena(void);
+	FrameArena* createThreadArena(void);
+	void releaseThreadArena(FrameArena* arena);
+
+	void* allocOverflow(FrameArena* arena, size_t size_bytes, size_t alignment, const char* file, int line);
+
+	GAFF_NO_COPY(FrameAllocator);
+	GAFF_NO_MOVE(FrameAllocator);
+
+	friend struct ThreadFrameArena;
+};
+
+NS_END
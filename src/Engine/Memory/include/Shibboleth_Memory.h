@@ -35,9 +35,34 @@ NS_SHIBBOLETH
 
 class IAllocator;
 
+enum class AllocationHeaderMode
+{
+	Tracking, // Copies file name, supports leak logs and stack traces. Large per-allocation overhead.
+	Release // Only pool index, size and a pointer to the file name. On free callbacks live in a side table.
+};
+
+struct MemoryPoolStats final
+{
+	const char* pool_name;
+	size_t total_bytes_allocated;
+	size_t curr_bytes_allocated;
+	size_t num_allocations;
+	size_t num_frees;
+};
+
+struct FrameAllocatorStats final
+{
+	uintptr_t thread_id;
+	size_t arena_size;
+	size_t high_water_mark;
+	size_t overflow_high_water_mark;
+	size_t num_overflow_allocations;
+};
+
 // GetPoolIndex() is not thread-safe. Applications need to ensure they've created all their pools before threading.
 MEMORY_API int32_t GetPoolIndex(const char* pool_name);
 MEMORY_API IAllocator& GetAllocator(void);
+MEMORY_API IAllocator& GetFrameAllocator(void);
 
 MEMORY_API void* ShibbolethAllocate(size_t size, size_t alignment, int32_t pool_index);
 MEMORY_API void* ShibbolethAllocate(size_t size, int32_t pool_index);
@@ -56,4 +81,22 @@ MEMORY_API void* ShibbolethRealloc(void* old_ptr, size_t new_size);
 
 MEMORY_API void SetLogDir(const char8_t* dir);
 
+// Only affects new allocations. Builds that check for double frees or misaligned pointers always use tracking headers.
+MEMORY_API void SetAllocationHeaderMode(AllocationHeaderMode mode);
+MEMORY_API AllocationHeaderMode GetAllocationHeaderMode(void);
+MEMORY_API size_t GetAllocationHeaderSize(void);
+
+// Lock-free. Counters are summed from per-thread shards, so a snapshot taken while other threads are allocating
+// is approximate, but never blocks them. Returns the number of pools written to out_stats.
+MEMORY_API int32_t GetMemoryPoolStats(MemoryPoolStats* out_stats, int32_t max_pools);
+MEMORY_API int32_t GetNumMemoryPools(void);
+
+// Called by the main loop at frame boundaries. Memory from the frame allocator is valid for two more frame boundaries after it was allocated.
+MEMORY_API void ResetFrameAllocator(void);
+// Per thread, per frame. Only affects threads that haven't used the frame allocator yet.
+MEMORY_API void SetFrameAllocatorArenaSize(size_t size_bytes);
+MEMORY_API size_t GetFrameAllocatorArenaSize(void);
+// Returns the number of threads written to out_stats.
+MEMORY_API int32_t GetFrameAllocatorStats(FrameAllocatorStats* out_stats, int32_t max_threads);
+
 NS_END
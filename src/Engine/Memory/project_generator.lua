@@ -36,9 +36,13 @@ project "Memory"
 	filter { "configurations:*Debug*" }
 		defines { "CHECK_FOR_DOUBLE_FREE", "CHECK_FOR_LEAKS", "CHECK_FOR_MISALIGNED_POINTER" }
 
-	filter { "configurations:*Release* or *Profile*" }
+	-- Release headers are never added to the allocation list, so there is nothing for leak checking to report.
+	filter { "configurations:*Profile*" }
 		defines { "CHECK_FOR_LEAKS" }
 
+	filter { "configurations:*Release*" }
+		defines { "USE_RELEASE_ALLOCATION_HEADER" }
+
 	filter { "system:windows" }
 	-- 	links { "iphlpapi.lib", "psapi.lib", "userenv.lib" }
 		links { "Dbghelp" }
@@ -0,0 +1,381 @@
+/************************************************************************************
+Copyright (C) 2022 by Nicholas LaCroix
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+************************************************************************************/
+
+#include "Shibboleth_PackFileSystem.h"
+#include <Shibboleth_LogManager.h>
+#include <Shibboleth_Utilities.h>
+#include <Shibboleth_String.h>
+#include <Shibboleth_IApp.h>
+#include <Gaff_Utils.h>
+#include <Gaff_Hash.h>
+#include <EASTL/algorithm.h>
+#include <zstd.h>
+
+NS_SHIBBOLETH
+
+PackFile::~PackFile(void)
+{
+	if (_owns_buffer) {
+		SHIB_FREE(_file_buffer, GetAllocator());
+	}
+}
+
+size_t PackFile::size(void) const
+{
+	return _file_size;
+}
+
+const int8_t* PackFile::getBuffer(void) const
+{
+	return _file_buffer;
+}
+
+int8_t* PackFile::getBuffer(void)
+{
+	return _file_buffer;
+}
+
+
+
+PackFileSystem::~PackFileSystem(void)
+{
+	for (OpenFile& open_file : _open_files) {
+		if (open_file.file) {
+			SHIB_FREET(open_file.file, GetAllocator());
+		}
+	}
+
+	for (ZSTD_DCtx* context : _contexts) {
+		ZSTD_freeDCtx(context);
+	}
+
+	if (_dictionary) {
+		ZSTD_freeDDict(_dictionary);
+	}
+}
+
+bool PackFileSystem::init(const char8_t* pack_file)
+{
+	if (!_pack.open(pack_file)) {
+		return false;
+	}
+
+	const int8_t* const buffer = _pack.getBuffer();
+	const size_t size = _pack.size();
+
+	if (size < sizeof(PackHeader)) {
+		return false;
+	}
+
+	const PackHeader& header = *reinterpret_cast<const PackHeader*>(buffer);
+
+	if (header.magic != k_pack_magic || header.version != k_pack_version) {
+		return false;
+	}
+
+	// Offsets and sizes come straight from the file. Compare against what is left instead of adding, so they can't overflow.
+	const auto in_bounds = [size](uint64_t offset, uint64_t range_size) -> bool
+	{
+		return offset <= size && range_size <= size - offset;
+	};
+
+	if (header.entry_count > static_cast<uint32_t>(INT32_MAX) ||
+		!in_bounds(sizeof(PackHeader), sizeof(PackEntry) * static_cast<uint64_t>(header.entry_count)) ||
+		!in_bounds(header.names_offset, header.names_size) ||
+		!in_bounds(header.dictionary_offset, header.dictionary_size)) {
+
+		return false;
+	}
+
+	_entries = reinterpret_cast<const PackEntry*>(buffer + sizeof(PackHeader));
+	_names = reinterpret_cast<const char8_t*>(buffer + header.names_offset);
+	_entry_count = static_cast<int32_t>(header.entry_count);
+
+	// Check every entry once here, so lookups and opens can trust them.
+	for (int32_t i = 0; i < _entry_count; ++i) {
+		const PackEntry& entry = _entries[i];
+		const bool compressed = (entry.flags & static_cast<uint32_t>(PackEntryFlag::Compressed)) != 0;
+
+		// Names have to start and end inside the names block.
+		if (entry.name_offset >= header.names_size ||
+			!memchr(_names + entry.name_offset, 0, header.names_size - entry.name_offset)) {
+
+			return false;
+		}
+
+		// Stored entries are handed out as is, followed by a null terminator.
+		if (!compressed && (entry.size != entry.stored_size || entry.stored_size == UINT64_MAX)) {
+			return false;
+		}
+
+		if (!in_bounds(entry.offset, entry.stored_size + ((compressed) ? 0 : 1))) {
+			return false;
+		}
+
+		if (!compressed && buffer[entry.offset + entry.stored_size] != 0) {
+			return false;
+		}
+	}
+
+	if (header.dictionary_size) {
+		_dictionary = ZSTD_createDDict(buffer + header.dictionary_offset, static_cast<size_t>(header.dictionary_size));
+
+		if (!_dictionary) {
+			return false;
+		}
+	}
+
+	_open_files.resize(static_cast<size_t>(_entry_count));
+	return true;
+}
+
+IFile* PackFileSystem::openFile(const char8_t* file_name)
+{
+	GAFF_ASSERT(file_name && eastl::CharStrlen(file_name));
+
+	const int32_t entry_index = findEntry(file_name);
+	return (entry_index > -1) ? openFile(entry_index) : nullptr;
+}
+
+void PackFileSystem::closeFile(const IFile* file)
+{
+	GAFF_ASSERT(file);
+
+	const PackFile* const pack_file = static_cast<const PackFile*>(file);
+	PackFile* file_to_free = nullptr;
+
+	{
+		const EA::Thread::AutoMutex lock(_lock);
+		OpenFile& open_file = _open_files[pack_file->_entry_index];
+
+		GAFF_ASSERT(open_file.file == pack_file);
+
+		if (!--open_file.count) {
+			file_to_free = open_file.file;
+			open_file.file = nullptr;
+		}
+	}
+
+	if (file_to_free) {
+		SHIB_FREET(file_to_free, GetAllocator());
+	}
+}
+
+void PackFileSystem::openFileAsync(const char8_t* file_name, const OpenFileCallback& callback)
+{
+	// The archive is memory mapped. Stored entries are free to open and compressed ones are CPU bound,
+	// so there is nothing to gain from handing this off to another thread.
+	callback(openFile(file_name));
+}
+
+bool PackFileSystem::forEachFile(const char8_t* directory, eastl::function<bool(const char8_t*, IFile*)>& callback, const char8_t* extension, bool recursive)
+{
+	U8String prefix(directory);
+	NormalizePackPath(prefix);
+
+	if (prefix == u8".") {
+		prefix.clear();
+	}
+
+	if (!prefix.empty() && prefix.back() != u8'/') {
+		prefix.push_back(u8'/');
+	}
+
+	for (int32_t i = 0; i < _entry_count; ++i) {
+		const char8_t* const name = _names + _entries[i].name_offset;
+		const eastl::u8string_view name_view(name);
+
+		if (!name_view.starts_with(prefix.data())) {
+			continue;
+		}
+
+		// Anything with a slash after the prefix is in a sub-directory.
+		if (!recursive && name_view.find(u8'/', prefix.size()) != eastl::u8string_view::npos) {
+			continue;
+		}
+
+		if (extension && !Gaff::EndsWith(name, extension)) {
+			continue;
+		}
+
+		IFile* const file = openFile(i);
+
+		if (!file) {
+			LogErrorDefault("PackFileSystem: Skipping '%s'. Failed to open it.", name);
+			continue;
+		}
+
+		if (callback(name, file)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool PackFileSystem::forEachFile(const char8_t* directory, eastl::function<bool(const char8_t*, IFile*)>& callback, bool recursive)
+{
+	return forEachFile(directory, callback, nullptr, recursive);
+}
+
+int32_t PackFileSystem::findEntry(const char8_t* file_name) const
+{
+	U8String name(file_name);
+	NormalizePackPath(name);
+
+	const uint64_t name_hash = Gaff::FNV1aHash64(reinterpret_cast<const char*>(name.data()), name.size()).getHash();
+	const PackEntry* const end = _entries + _entry_count;
+
+	const PackEntry* it = eastl::lower_bound(_entries, end, name_hash,
+	[](const PackEntry& lhs, uint64_t rhs) -> bool
+	{
+		return lhs.name_hash < rhs;
+	});
+
+	// Entries with the same hash are next to each other.
+	for (; it != end && it->name_hash == name_hash; ++it) {
+		if (name == (_names + it->name_offset)) {
+			return static_cast<int32_t>(it - _entries);
+		}
+	}
+
+	return -1;
+}
+
+PackFile* PackFileSystem::createFile(int32_t entry_index)
+{
+	// Offsets and sizes were validated in init().
+	const PackEntry& entry = _entries[entry_index];
+	const bool compressed = (entry.flags & static_cast<uint32_t>(PackEntryFlag::Compressed)) != 0;
+
+	PackFile* const file = SHIB_ALLOCT(PackFile, GetAllocator());
+
+	if (!file) {
+		return nullptr;
+	}
+
+	file->_entry_index = entry_index;
+	file->_file_size = static_cast<size_t>(entry.size);
+
+	if (!compressed) {
+		file->_file_buffer = _pack.getBuffer() + entry.offset;
+		return file;
+	}
+
+	file->_file_buffer = SHIB_ALLOC_CAST(int8_t*, file->_file_size + 1, GetAllocator());
+	file->_owns_buffer = true;
+
+	if (!file->_file_buffer) {
+		SHIB_FREET(file, GetAllocator());
+		return nullptr;
+	}
+
+	ZSTD_DCtx* const context = acquireContext();
+
+	if (!context) {
+		SHIB_FREET(file, GetAllocator());
+		return nullptr;
+	}
+
+	const void* const src = _pack.getBuffer() + entry.offset;
+	const size_t src_size = static_cast<size_t>(entry.stored_size);
+
+	const size_t result = (_dictionary) ?
+		ZSTD_decompress_usingDDict(context, file->_file_buffer, file->_file_size, src, src_size, _dictionary) :
+		ZSTD_decompressDCtx(context, file->_file_buffer, file->_file_size, src, src_size);
+
+	releaseContext(context);
+
+	if (ZSTD_isError(result) || result != file->_file_size) {
+		LogErrorDefault(
+			"PackFileSystem: Failed to decompress '%s'. %s",
+			_names + entry.name_offset,
+			(ZSTD_isError(result)) ? ZSTD_getErrorName(result) : "Size does not match the table of contents."
+		);
+
+		SHIB_FREET(file, GetAllocator());
+		return nullptr;
+	}
+
+	file->_file_buffer[file->_file_size] = 0;
+	return file;
+}
+
+IFile* PackFileSystem::openFile(int32_t entry_index)
+{
+	{
+		const EA::Thread::AutoMutex lock(_lock);
+		OpenFile& open_file = _open_files[entry_index];
+
+		if (open_file.file) {
+			++open_file.count;
+			return open_file.file;
+		}
+	}
+
+	// Decompress outside of the lock so other files can be opened in the meantime.
+	PackFile* const file = createFile(entry_index);
+
+	if (!file) {
+		return nullptr;
+	}
+
+	const EA::Thread::AutoMutex lock(_lock);
+	OpenFile& open_file = _open_files[entry_index];
+
+	// Someone else opened the same file while we were decompressing it.
+	if (open_file.file) {
+		SHIB_FREET(file, GetAllocator());
+
+		++open_file.count;
+		return open_file.file;
+	}
+
+	open_file.file = file;
+	open_file.count = 1;
+
+	return file;
+}
+
+ZSTD_DCtx* PackFileSystem::acquireContext(void)
+{
+	{
+		const EA::Thread::AutoMutex lock(_lock);
+
+		if (!_contexts.empty()) {
+			ZSTD_DCtx* const context = _contexts.back();
+			_contexts.pop_back();
+
+			return context;
+		}
+	}
+
+	return ZSTD_createDCtx();
+}
+
+void PackFileSystem::releaseContext(ZSTD_DCtx* context)
+{
+	const EA::Thread::AutoMutex lock(_lock);
+	_contexts.emplace_back(context);
+}
+
+NS_END
@@ -0,0 +1,66 @@
+/************************************************************************************
+Copyright (C) 2022 by Nicholas LaCroix
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+************************************************************************************/
+
+#include "Shibboleth_PackFileSystem.h"
+#include <Shibboleth_AppConfigs.h>
+#include <Shibboleth_LogManager.h>
+#include <Shibboleth_Utilities.h>
+#include <Shibboleth_IApp.h>
+#include <Gaff_JSON.h>
+
+namespace
+{
+	Shibboleth::U8String g_pack_file;
+}
+
+DYNAMICEXPORT_C bool InitModule(Shibboleth::IApp& app)
+{
+	Shibboleth::SetApp(app);
+
+	const Gaff::JSON& pack_file = app.getConfigs().getObject(Shibboleth::k_config_app_pack_file);
+	g_pack_file = (pack_file.isString()) ? pack_file.getString() : Shibboleth::k_config_app_default_pack_file;
+
+	return true;
+}
+
+DYNAMICEXPORT_C Shibboleth::IFileSystem* CreateFileSystem(void)
+{
+	Shibboleth::PackFileSystem* const file_system = SHIB_ALLOCT(Shibboleth::PackFileSystem, Shibboleth::GetAllocator());
+
+	if (!file_system) {
+		return nullptr;
+	}
+
+	if (!file_system->init(g_pack_file.data())) {
+		LogErrorDefault("Failed to open pack file '%s'.", g_pack_file.data());
+		SHIB_FREET(file_system, Shibboleth::GetAllocator());
+		return nullptr;
+	}
+
+	return file_system;
+}
+
+DYNAMICEXPORT_C void DestroyFileSystem(Shibboleth::IFileSystem* file_system)
+{
+	SHIB_FREET(file_system, Shibboleth::GetAllocator());
+	g_pack_file = Shibboleth::U8String();
+}
@@ -0,0 +1,84 @@
+/************************************************************************************
+Copyright (C) 2022 by Nicholas LaCroix
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+************************************************************************************/
+
+#pragma once
+
+#include <Shibboleth_Defines.h>
+#include <Gaff_Defines.h>
+
+NS_SHIBBOLETH
+
+// Layout of a pack file. All values are in native byte order.
+//
+//		PackHeader
+//		PackEntry[entry_count]		Sorted by name_hash, then name.
+//		char8_t[names_size]			Entry names, each null terminated.
+//		uint8_t[dictionary_size]	Optional zstd dictionary shared by all compressed entries.
+//		Entry data
+//
+// Stored entries are followed by a null terminator, so they can be handed out without copying.
+
+constexpr uint32_t k_pack_magic = 0x4B415053; // "SPAK"
+constexpr uint32_t k_pack_version = 1;
+
+enum class PackEntryFlag : uint32_t
+{
+	Compressed = 1 << 0
+};
+
+struct PackHeader final
+{
+	uint32_t magic = k_pack_magic;
+	uint32_t version = k_pack_version;
+	uint32_t entry_count = 0;
+	uint32_t names_size = 0;
+	uint64_t names_offset = 0;
+	uint64_t dictionary_offset = 0;
+	uint64_t dictionary_size = 0;
+};
+
+struct PackEntry final
+{
+	uint64_t name_hash = 0;
+	uint64_t offset = 0;
+	uint64_t stored_size = 0; // Size in the pack file, not including the null terminator on stored entries.
+	uint64_t size = 0; // Size after decompression.
+	uint32_t name_offset = 0;
+	uint32_t flags = 0;
+};
+
+// Entry names use forward slashes and have no leading "./".
+template <class String>
+void NormalizePackPath(String& path)
+{
+	for (auto& c : path) {
+		if (c == u8'\\') {
+			c = u8'/';
+		}
+	}
+
+	while (path.size() >= 2 && path[0] == u8'.' && path[1] == u8'/') {
+		path.erase(path.begin(), path.begin() + 2);
+	}
+}
+
+NS_END
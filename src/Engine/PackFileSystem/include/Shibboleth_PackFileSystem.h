@@ -0,0 +1,100 @@
+/************************************************************************************
+Copyright (C) 2022 by Nicholas LaCroix
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+************************************************************************************/
+
+#pragma once
+
+#include "Shibboleth_PackFileFormat.h"
+#include <Shibboleth_IFileSystem.h>
+#include <Shibboleth_Vector.h>
+#include <eathread/eathread_mutex.h>
+#include <Gaff_MappedFile.h>
+
+struct ZSTD_DDict_s;
+struct ZSTD_DCtx_s;
+
+NS_SHIBBOLETH
+
+class PackFile final : public IFile
+{
+public:
+	PackFile(void) = default;
+	~PackFile(void);
+
+	size_t size(void) const override;
+
+	const int8_t* getBuffer(void) const override;
+	int8_t* getBuffer(void) override;
+
+private:
+	int8_t* _file_buffer = nullptr;
+	size_t _file_size = 0;
+	int32_t _entry_index = -1;
+	bool _owns_buffer = false;
+
+	friend class PackFileSystem;
+};
+
+// Reads files out of a single memory mapped pack file.
+// Stored entries point straight into the mapping. Compressed entries are decompressed on open.
+class PackFileSystem final : public IFileSystem
+{
+public:
+	PackFileSystem(void) = default;
+	~PackFileSystem(void);
+
+	bool init(const char8_t* pack_file);
+
+	IFile* openFile(const char8_t* file_name) override;
+	void closeFile(const IFile* file) override;
+
+	void openFileAsync(const char8_t* file_name, const OpenFileCallback& callback) override;
+
+	bool forEachFile(const char8_t* directory, eastl::function<bool(const char8_t*, IFile*)>& callback, const char8_t* extension, bool recursive = false) override;
+	bool forEachFile(const char8_t* directory, eastl::function<bool(const char8_t*, IFile*)>& callback, bool recursive = false) override;
+
+private:
+	struct OpenFile final
+	{
+		PackFile* file = nullptr;
+		int32_t count = 0;
+	};
+
+	Gaff::MappedFile _pack;
+	const PackEntry* _entries = nullptr;
+	const char8_t* _names = nullptr;
+	int32_t _entry_count = 0;
+
+	ZSTD_DDict_s* _dictionary = nullptr;
+
+	Vector<OpenFile> _open_files; // One per entry.
+	Vector<ZSTD_DCtx_s*> _contexts;
+	EA::Thread::Mutex _lock;
+
+	int32_t findEntry(const char8_t* file_name) const;
+	PackFile* createFile(int32_t entry_index);
+	IFile* openFile(int32_t entry_index);
+
+	ZSTD_DCtx_s* acquireContext(void);
+	void releaseContext(ZSTD_DCtx_s* context);
+};
+
+NS_END
@@ -0,0 +1,38 @@
+project "PackFileSystem"
+	location(GetEngineLocation())
+
+	kind "SharedLib"
+	language "C++"
+
+	files { "**.h", "**.cpp", "**.inl" }
+
+	includedirs
+	{
+		"include",
+		"../Engine/include",
+		"../Memory/include",
+		"../../Frameworks/Gaff/include",
+		"../../Dependencies/EASTL/include",
+		"../../Dependencies/rapidjson",
+		"../../Dependencies/zstd"
+	}
+
+	local deps =
+	{
+		"Engine",
+		"Gaff",
+		"Memory",
+		"EASTL",
+		"mpack",
+		"zstd"
+	}
+
+	dependson(deps)
+	links(deps)
+
+	flags { "FatalWarnings" }
+
+	NewDeleteLinkFix()
+	SetupConfigMap()
+
+	ModuleCopy("FileSystem")
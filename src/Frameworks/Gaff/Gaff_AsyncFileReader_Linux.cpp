@@ -0,0 +1,460 @@
+/************************************************************************************
+Copyright (C) 2022 by Nicholas LaCroix
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+************************************************************************************/
+
+#include "Gaff_Platform.h"
+
+#ifdef PLATFORM_LINUX
+
+#include "Gaff_AsyncFileReader.h"
+#include "Gaff_Assert.h"
+#include <EASTL/algorithm.h>
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstring>
+#include <cerrno>
+
+namespace
+{
+	// user_data of the no-op destroy() submits to wake up the completion thread.
+	constexpr uint64_t k_shutdown_user_data = 0;
+
+	// Linux never reads more than this in a single call. Larger files are read in chunks.
+	constexpr size_t k_max_read_size = 0x7FFFF000;
+
+	int SetupRing(uint32_t entries, io_uring_params& params)
+	{
+		return static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+	}
+
+	int EnterRing(int ring_fd, uint32_t to_submit, uint32_t min_complete, uint32_t flags)
+	{
+		return static_cast<int>(syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, nullptr, 0));
+	}
+
+	void* MapRing(int ring_fd, size_t size, off_t offset)
+	{
+		void* const ring = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, offset);
+		return (ring == MAP_FAILED) ? nullptr : ring;
+	}
+
+	uint32_t* RingPtr(void* ring, uint32_t offset)
+	{
+		return reinterpret_cast<uint32_t*>(reinterpret_cast<int8_t*>(ring) + offset);
+	}
+}
+
+NS_GAFF
+
+AsyncFileReader::~AsyncFileReader(void)
+{
+	destroy();
+}
+
+bool AsyncFileReader::init(int32_t queue_depth)
+{
+	GAFF_ASSERT(queue_depth > 0);
+	destroy();
+
+	io_uring_params params;
+	memset(&params, 0, sizeof(params));
+
+	const int ring_fd = SetupRing(static_cast<uint32_t>(queue_depth), params);
+
+	// Either the kernel is too old or io_uring has been disabled (commonly by seccomp in containers).
+	if (ring_fd < 0) {
+		return false;
+	}
+
+	_ring_fd = ring_fd;
+
+	// IORING_OP_OPENAT, IORING_OP_STATX and IORING_OP_READ shipped in the same kernel release as IORING_FEAT_RW_CUR_POS.
+	// Without IORING_FEAT_NODROP, completions can be lost if the completion queue fills up.
+	if (!(params.features & IORING_FEAT_RW_CUR_POS) || !(params.features & IORING_FEAT_NODROP)) {
+		destroy();
+		return false;
+	}
+
+	_sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+	_cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+	_sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+
+	_sq_ring = MapRing(_ring_fd, _sq_ring_size, IORING_OFF_SQ_RING);
+	_cq_ring = MapRing(_ring_fd, _cq_ring_size, IORING_OFF_CQ_RING);
+	_sqes = MapRing(_ring_fd, _sqes_size, IORING_OFF_SQES);
+
+	if (!_sq_ring || !_cq_ring || !_sqes) {
+		destroy();
+		return false;
+	}
+
+	_submit_queue.head = RingPtr(_sq_ring, params.sq_off.head);
+	_submit_queue.tail = RingPtr(_sq_ring, params.sq_off.tail);
+	_submit_queue.array = RingPtr(_sq_ring, params.sq_off.array);
+	_submit_queue.mask = *RingPtr(_sq_ring, params.sq_off.ring_mask);
+	_submit_queue.entries = *RingPtr(_sq_ring, params.sq_off.ring_entries);
+
+	_complete_queue.head = RingPtr(_cq_ring, params.cq_off.head);
+	_complete_queue.tail = RingPtr(_cq_ring, params.cq_off.tail);
+	_complete_queue.cqes = RingPtr(_cq_ring, params.cq_off.cqes);
+	_complete_queue.mask = *RingPtr(_cq_ring, params.cq_off.ring_mask);
+	_complete_queue.entries = *RingPtr(_cq_ring, params.cq_off.ring_entries);
+
+	if (pthread_create(&_completion_thread, nullptr, CompletionThread, this)) {
+		destroy();
+		return false;
+	}
+
+	_thread_started = true;
+	return true;
+}
+
+void AsyncFileReader::destroy(void)
+{
+	if (_thread_started) {
+		// The completion thread exits once it has seen this and every outstanding read has completed.
+		while (submit(IORING_OP_NOP, -1, nullptr, 0, 0, 0, k_shutdown_user_data) < 0) {
+			sched_yield();
+		}
+
+		pthread_join(_completion_thread, nullptr);
+		_thread_started = false;
+	}
+
+	if (_sqes) {
+		munmap(_sqes, _sqes_size);
+		_sqes = nullptr;
+	}
+
+	if (_cq_ring) {
+		munmap(_cq_ring, _cq_ring_size);
+		_cq_ring = nullptr;
+	}
+
+	if (_sq_ring) {
+		munmap(_sq_ring, _sq_ring_size);
+		_sq_ring = nullptr;
+	}
+
+	if (_ring_fd != -1) {
+		::close(_ring_fd);
+		_ring_fd = -1;
+	}
+
+	_submit_queue = SubmitQueue();
+	_complete_queue = CompleteQueue();
+}
+
+bool AsyncFileReader::isValid(void) const
+{
+	return _thread_started;
+}
+
+bool AsyncFileReader::read(const char8_t* file_name, Request& request)
+{
+	GAFF_ASSERT(isValid() && request.allocate && request.complete && file_name);
+
+	request.buffer = nullptr;
+	request.size = 0;
+	request._file_name = file_name;
+	request._bytes_read = 0;
+	request._fd = -1;
+	request._stage = Request::Stage::Open;
+	request._next_retry = nullptr;
+
+	// Every request has at most one entry in the ring at a time. Capping requests at the ring size means the completion thread
+	// never finds the submit queue full, and completions can never back up far enough to make the kernel refuse submits.
+	if (_in_flight.fetch_add(1) >= static_cast<int32_t>(_submit_queue.entries)) {
+		--_in_flight;
+		return false;
+	}
+
+	if (submitOpen(request) < 0) {
+		--_in_flight;
+		return false;
+	}
+
+	return true;
+}
+
+void* AsyncFileReader::CompletionThread(void* reader_ptr)
+{
+	AsyncFileReader& reader = *reinterpret_cast<AsyncFileReader*>(reader_ptr);
+	const CompleteQueue& queue = reader._complete_queue;
+	const io_uring_cqe* const cqes = reinterpret_cast<const io_uring_cqe*>(queue.cqes);
+	bool shutdown = false;
+
+	while (!shutdown || reader._in_flight > 0) {
+		// This is the only thread that moves head.
+		uint32_t head = *queue.head;
+		const uint32_t tail = __atomic_load_n(queue.tail, __ATOMIC_ACQUIRE);
+
+		if (head == tail) {
+			if (reader._retry_head) {
+				// Don't sleep waiting on completions that may never come while we still owe the kernel submits.
+				reader.retrySubmits();
+
+				if (reader._retry_head) {
+					sched_yield();
+				}
+
+			} else {
+				// Interrupted waits just loop back around.
+				EnterRing(reader._ring_fd, 0, 1, IORING_ENTER_GETEVENTS);
+			}
+
+			continue;
+		}
+
+		while (head != tail) {
+			const io_uring_cqe& cqe = cqes[head & queue.mask];
+			const uint64_t user_data = cqe.user_data;
+			const int32_t result = cqe.res;
+
+			// Hand the slot back before handling the completion, which may queue more reads.
+			__atomic_store_n(queue.head, ++head, __ATOMIC_RELEASE);
+
+			if (user_data == k_shutdown_user_data) {
+				shutdown = true;
+				continue;
+			}
+
+			reader.handleCompletion(*reinterpret_cast<Request*>(user_data), result);
+		}
+
+		reader.retrySubmits();
+	}
+
+	return nullptr;
+}
+
+int32_t AsyncFileReader::submit(uint8_t opcode, int32_t fd, const void* buffer, uint32_t size, uint64_t offset, uint32_t op_flags, uint64_t user_data)
+{
+	pthread_mutex_lock(&_submit_lock);
+
+	const uint32_t tail = *_submit_queue.tail;
+	const uint32_t head = __atomic_load_n(_submit_queue.head, __ATOMIC_ACQUIRE);
+
+	if (tail - head >= _submit_queue.entries) {
+		pthread_mutex_unlock(&_submit_lock);
+		return -EBUSY;
+	}
+
+	const uint32_t index = tail & _submit_queue.mask;
+	io_uring_sqe& sqe = reinterpret_cast<io_uring_sqe*>(_sqes)[index];
+
+	memset(&sqe, 0, sizeof(sqe));
+	sqe.opcode = opcode;
+	sqe.fd = fd;
+	sqe.addr = reinterpret_cast<uint64_t>(buffer);
+	sqe.len = size;
+	sqe.off = offset;
+	sqe.open_flags = op_flags; // Shares storage with the flags of every other opcode.
+	sqe.user_data = user_data;
+
+	_submit_queue.array[index] = index;
+	__atomic_store_n(_submit_queue.tail, tail + 1, __ATOMIC_RELEASE);
+
+	int result = EnterRing(_ring_fd, 1, 0, 0);
+
+	while (result < 0 && errno == EINTR) {
+		result = EnterRing(_ring_fd, 1, 0, 0);
+	}
+
+	int32_t error = 0;
+
+	// The kernel only consumes entries inside io_uring_enter(), which we are holding the lock around.
+	// If it didn't take ours, pull it back out so it can't complete after we've reported failure.
+	if (result <= 0 && __atomic_load_n(_submit_queue.head, __ATOMIC_ACQUIRE) == tail) {
+		__atomic_store_n(_submit_queue.tail, tail, __ATOMIC_RELEASE);
+		error = (result < 0) ? -errno : -EAGAIN;
+	}
+
+	pthread_mutex_unlock(&_submit_lock);
+	return error;
+}
+
+int32_t AsyncFileReader::submitOpen(Request& request)
+{
+	return submit(
+		IORING_OP_OPENAT,
+		AT_FDCWD,
+		request._file_name,
+		0,
+		0,
+		O_RDONLY | O_CLOEXEC,
+		reinterpret_cast<uint64_t>(&request)
+	);
+}
+
+int32_t AsyncFileReader::submitStat(Request& request)
+{
+	// An empty path with AT_EMPTY_PATH stats the file descriptor itself.
+	return submit(
+		IORING_OP_STATX,
+		request._fd,
+		"",
+		STATX_TYPE | STATX_SIZE,
+		reinterpret_cast<uint64_t>(&request._stat),
+		AT_EMPTY_PATH,
+		reinterpret_cast<uint64_t>(&request)
+	);
+}
+
+int32_t AsyncFileReader::submitRead(Request& request)
+{
+	const size_t read_size = eastl::min(request.size - request._bytes_read, k_max_read_size);
+
+	return submit(
+		IORING_OP_READ,
+		request._fd,
+		request.buffer + request._bytes_read,
+		static_cast<uint32_t>(read_size),
+		request._bytes_read,
+		0,
+		reinterpret_cast<uint64_t>(&request)
+	);
+}
+
+void AsyncFileReader::submitStage(Request& request)
+{
+	int32_t result = 0;
+
+	switch (request._stage) {
+		case Request::Stage::Open:
+			result = submitOpen(request);
+			break;
+
+		case Request::Stage::Stat:
+			result = submitStat(request);
+			break;
+
+		case Request::Stage::Read:
+			result = submitRead(request);
+			break;
+	}
+
+	// The ring is busy. Try again once some completions have been handled, rather than failing the load.
+	if (result == -EBUSY || result == -EAGAIN) {
+		if (_retry_tail) {
+			_retry_tail->_next_retry = &request;
+		} else {
+			_retry_head = &request;
+		}
+
+		_retry_tail = &request;
+
+	} else if (result) {
+		finish(request, result);
+	}
+}
+
+void AsyncFileReader::retrySubmits(void)
+{
+	Request* request = _retry_head;
+
+	_retry_head = nullptr;
+	_retry_tail = nullptr;
+
+	// Anything that still can't be submitted goes back on the list, in the same order.
+	while (request) {
+		Request* const next = request->_next_retry;
+		request->_next_retry = nullptr;
+
+		submitStage(*request);
+		request = next;
+	}
+}
+
+void AsyncFileReader::handleCompletion(Request& request, int32_t result)
+{
+	if (result < 0) {
+		finish(request, result);
+		return;
+	}
+
+	switch (request._stage) {
+		case Request::Stage::Open:
+			request._fd = result;
+			request._stage = Request::Stage::Stat;
+
+			submitStage(request);
+			break;
+
+		case Request::Stage::Stat:
+			if (!S_ISREG(request._stat.stx_mode)) {
+				finish(request, (S_ISDIR(request._stat.stx_mode)) ? -EISDIR : -EINVAL);
+				break;
+			}
+
+			request.size = static_cast<size_t>(request._stat.stx_size);
+			request.buffer = request.allocate(request, request.size);
+
+			if (!request.buffer) {
+				finish(request, -ENOMEM);
+				break;
+			}
+
+			request._stage = Request::Stage::Read;
+
+			submitStage(request);
+			break;
+
+		case Request::Stage::Read:
+			// The file got shorter after we checked its size.
+			if (!result && request._bytes_read < request.size) {
+				finish(request, -EIO);
+				break;
+			}
+
+			request._bytes_read += static_cast<size_t>(result);
+
+			if (request._bytes_read < request.size) {
+				submitStage(request);
+
+			} else {
+				finish(request, 0);
+			}
+			break;
+	}
+}
+
+void AsyncFileReader::finish(Request& request, int32_t result)
+{
+	if (request._fd != -1) {
+		::close(request._fd);
+		request._fd = -1;
+	}
+
+	// request may be freed by the callback.
+	request.complete(request, result);
+
+	// Decrement last, so destroy() doesn't return while a callback is still running.
+	--_in_flight;
+}
+
+NS_END
+
+#endif
@@ -0,0 +1,58 @@
+/************************************************************************************
+Copyright (C) 2022 by Nicholas LaCroix
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+************************************************************************************/
+
+#include "Gaff_Platform.h"
+
+#if defined(PLATFORM_WINDOWS) || defined(PLATFORM_MAC)
+
+#include "Gaff_AsyncFileReader.h"
+
+NS_GAFF
+
+// Not implemented on these platforms. init() always fails, so callers use their blocking fallback.
+// LooseFileSystem runs those blocking opens on the read file job pool, so the requesting thread still doesn't wait on them.
+AsyncFileReader::~AsyncFileReader(void)
+{
+}
+
+bool AsyncFileReader::init(int32_t /*queue_depth*/)
+{
+	return false;
+}
+
+void AsyncFileReader::destroy(void)
+{
+}
+
+bool AsyncFileReader::isValid(void) const
+{
+	return false;
+}
+
+bool AsyncFileReader::read(const char8_t* /*file_name*/, Request& /*request*/)
+{
+	return false;
+}
+
+NS_END
+
+#endif
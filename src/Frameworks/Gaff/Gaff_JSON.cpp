@@ -719,6 +719,24 @@ const char8_t* JSON::getKey(int32_t index) const
 	return (getValue().MemberBegin() + index)->name.GetString();
 }
 
+eastl::u8string_view JSON::getKeyView(int32_t index) const
+{
+	GAFF_ASSERT(isObject() && index < size());
+	const auto& name = (getValue().MemberBegin() + index)->name;
+	return eastl::u8string_view(name.GetString(), static_cast<size_t>(name.GetStringLength()));
+}
+
+eastl::u8string_view JSON::getStringView(eastl::u8string_view default_value) const
+{
+	return (isString()) ? getStringView() : default_value;
+}
+
+eastl::u8string_view JSON::getStringView(void) const
+{
+	const JSONValue& value = getValue();
+	return eastl::u8string_view(value.GetString(), static_cast<size_t>(value.GetStringLength()));
+}
+
 JSON JSON::getValue(int32_t index) const
 {
 	GAFF_ASSERT(isObject() && index < size());
@@ -0,0 +1,104 @@
+/************************************************************************************
+Copyright (C) 2022 by Nicholas LaCroix
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+************************************************************************************/
+
+#include "Gaff_Platform.h"
+
+#if defined(PLATFORM_LINUX) || defined(PLATFORM_MAC)
+
+#include "Gaff_MappedFile.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+NS_GAFF
+
+MappedFile::~MappedFile(void)
+{
+	close();
+}
+
+bool MappedFile::open(const char8_t* file_name)
+{
+	close();
+
+	const int fd = ::open(reinterpret_cast<const char*>(file_name), O_RDONLY);
+
+	if (fd == -1) {
+		return false;
+	}
+
+	struct stat file_stat;
+
+	if (fstat(fd, &file_stat) == -1 || file_stat.st_size <= 0) {
+		::close(fd);
+		return false;
+	}
+
+	void* const buffer = mmap(nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+
+	// The mapping keeps its own reference to the file.
+	::close(fd);
+
+	if (buffer == MAP_FAILED) {
+		return false;
+	}
+
+	_buffer = reinterpret_cast<int8_t*>(buffer);
+	_size = static_cast<size_t>(file_stat.st_size);
+
+	return true;
+}
+
+void MappedFile::close(void)
+{
+	if (_buffer) {
+		munmap(_buffer, _size);
+
+		_buffer = nullptr;
+		_size = 0;
+	}
+}
+
+bool MappedFile::isOpen(void) const
+{
+	return _buffer != nullptr;
+}
+
+const int8_t* MappedFile::getBuffer(void) const
+{
+	return _buffer;
+}
+
+int8_t* MappedFile::getBuffer(void)
+{
+	return _buffer;
+}
+
+size_t MappedFile::size(void) const
+{
+	return _size;
+}
+
+NS_END
+
+#endif
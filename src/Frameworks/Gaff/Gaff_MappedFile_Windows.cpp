@@ -0,0 +1,113 @@
+/************************************************************************************
+Copyright (C) 2022 by Nicholas LaCroix
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+************************************************************************************/
+
+#include "Gaff_Platform.h"
+
+#ifdef PLATFORM_WINDOWS
+
+#include "Gaff_MappedFile.h"
+#include "Gaff_IncludeWindows.h"
+#include "Gaff_String.h"
+
+NS_GAFF
+
+MappedFile::~MappedFile(void)
+{
+	close();
+}
+
+bool MappedFile::open(const char8_t* file_name)
+{
+	close();
+
+	CONVERT_STRING(wchar_t, temp, file_name);
+	const HANDLE file = CreateFileW(temp, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+	if (file == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+
+	LARGE_INTEGER file_size;
+
+	if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart <= 0) {
+		CloseHandle(file);
+		return false;
+	}
+
+	const HANDLE file_mapping = CreateFileMappingW(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+
+	// The mapping keeps its own reference to the file.
+	CloseHandle(file);
+
+	if (!file_mapping) {
+		return false;
+	}
+
+	void* const buffer = MapViewOfFile(file_mapping, FILE_MAP_COPY, 0, 0, 0);
+
+	if (!buffer) {
+		CloseHandle(file_mapping);
+		return false;
+	}
+
+	_buffer = reinterpret_cast<int8_t*>(buffer);
+	_size = static_cast<size_t>(file_size.QuadPart);
+	_file_mapping = file_mapping;
+
+	return true;
+}
+
+void MappedFile::close(void)
+{
+	if (_buffer) {
+		UnmapViewOfFile(_buffer);
+		CloseHandle(_file_mapping);
+
+		_buffer = nullptr;
+		_file_mapping = nullptr;
+		_size = 0;
+	}
+}
+
+bool MappedFile::isOpen(void) const
+{
+	return _buffer != nullptr;
+}
+
+const int8_t* MappedFile::getBuffer(void) const
+{
+	return _buffer;
+}
+
+int8_t* MappedFile::getBuffer(void)
+{
+	return _buffer;
+}
+
+size_t MappedFile::size(void) const
+{
+	return _size;
+}
+
+NS_END
+
+#endif
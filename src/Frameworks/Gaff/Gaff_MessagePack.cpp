@@ -152,7 +152,7 @@ MessagePackNode MessagePackNode::getObject(const char* key) const
 MessagePackNode MessagePackNode::getObject(int32_t index) const
 {
 	GAFF_ASSERT(isArray() && index < size());
-	return MessagePackNode(mpack_node_map_value_at(_node, static_cast<size_t>(index)));
+	return MessagePackNode(mpack_node_array_at(_node, static_cast<size_t>(index)));
 }
 
 const char8_t* MessagePackNode::getKey(char8_t* buffer, size_t buf_size, int32_t index) const
@@ -190,6 +190,30 @@ const char8_t* MessagePackNode::getKey(int32_t index) const
 	return ret;
 }
 
+eastl::u8string_view MessagePackNode::getKeyView(int32_t index) const
+{
+	GAFF_ASSERT(isObject() && index < size());
+
+	// Points into the parsed buffer. Not null terminated.
+	mpack_node_t node = mpack_node_map_key_at(_node, static_cast<size_t>(index));
+	GAFF_ASSERT(node.data->type == mpack_type_str);
+
+	return eastl::u8string_view(reinterpret_cast<const char8_t*>(mpack_node_str(node)), mpack_node_strlen(node));
+}
+
+eastl::u8string_view MessagePackNode::getStringView(eastl::u8string_view default_value) const
+{
+	return (isString()) ? getStringView() : default_value;
+}
+
+eastl::u8string_view MessagePackNode::getStringView(void) const
+{
+	GAFF_ASSERT(isString());
+
+	// Points into the parsed buffer. Not null terminated.
+	return eastl::u8string_view(reinterpret_cast<const char8_t*>(mpack_node_str(_node)), mpack_node_strlen(_node));
+}
+
 MessagePackNode MessagePackNode::getValue(int32_t index) const
 {
 	GAFF_ASSERT(isObject() && index < size());
@@ -0,0 +1,156 @@
+/************************************************************************************
+Copyright (C) 2022 by Nicholas LaCroix
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+************************************************************************************/
+
+#pragma once
+
+#include "Gaff_IncludeEASTLAtomic.h"
+#include "Gaff_Defines.h"
+
+#ifdef PLATFORM_LINUX
+	#include <sys/stat.h>
+	#include <pthread.h>
+#endif
+
+NS_GAFF
+
+// Opens and reads whole files without a thread blocking on each one. On Linux this is backed by io_uring.
+// There is no implementation on other platforms yet. When init() fails (unsupported platform, old kernel, or io_uring disabled),
+// callers are expected to fall back to blocking reads, preferably on a thread set aside for them.
+class AsyncFileReader final
+{
+public:
+	struct Request;
+
+	// Called from the completion thread once the file is open. Returns a buffer of at least size bytes to read the file into.
+	// Returning null fails the request.
+	using AllocateFunc = int8_t* (*)(Request& request, size_t size);
+
+	// Called once per request, from the completion thread. result is zero on success, or a negative errno value on failure.
+	// On failure, a buffer returned by allocate is still owned by the request.
+	using CompleteFunc = void (*)(Request& request, int32_t result);
+
+	struct Request
+	{
+		AllocateFunc allocate = nullptr;
+		CompleteFunc complete = nullptr;
+
+		int8_t* buffer = nullptr;
+		size_t size = 0;
+
+	private:
+#ifdef PLATFORM_LINUX
+		enum class Stage
+		{
+			Open,
+			Stat,
+			Read
+		};
+
+		struct statx _stat;
+#endif
+
+		const char8_t* _file_name = nullptr;
+		size_t _bytes_read = 0;
+		int32_t _fd = -1;
+
+#ifdef PLATFORM_LINUX
+		Stage _stage = Stage::Open;
+
+		// Next request waiting for the completion thread to submit its stage again.
+		Request* _next_retry = nullptr;
+#endif
+
+		friend class AsyncFileReader;
+	};
+
+	AsyncFileReader(void) = default;
+	~AsyncFileReader(void);
+
+	bool init(int32_t queue_depth = 256);
+	void destroy(void);
+
+	bool isValid(void) const;
+
+	// Queues an open of the file, followed by a read of its entire contents. Nothing is done on the calling thread.
+	// If this returns false, request.complete will not be called. request and file_name must stay alive until it completes.
+	// Fails if queue_depth requests are already in flight.
+	// Files that don't exist or can't be opened complete with the error.
+	bool read(const char8_t* file_name, Request& request);
+
+private:
+#ifdef PLATFORM_LINUX
+	struct SubmitQueue final
+	{
+		uint32_t* head = nullptr;
+		uint32_t* tail = nullptr;
+		uint32_t* array = nullptr;
+		uint32_t mask = 0;
+		uint32_t entries = 0;
+	};
+
+	struct CompleteQueue final
+	{
+		uint32_t* head = nullptr;
+		uint32_t* tail = nullptr;
+		void* cqes = nullptr;
+		uint32_t mask = 0;
+		uint32_t entries = 0;
+	};
+
+	SubmitQueue _submit_queue;
+	CompleteQueue _complete_queue;
+	void* _sqes = nullptr;
+
+	void* _sq_ring = nullptr;
+	void* _cq_ring = nullptr;
+	size_t _sq_ring_size = 0;
+	size_t _cq_ring_size = 0;
+	size_t _sqes_size = 0;
+
+	pthread_mutex_t _submit_lock = PTHREAD_MUTEX_INITIALIZER;
+	pthread_t _completion_thread;
+	bool _thread_started = false;
+
+	// Only touched by the completion thread.
+	Request* _retry_head = nullptr;
+	Request* _retry_tail = nullptr;
+
+	eastl::atomic<int32_t> _in_flight = 0;
+	int32_t _ring_fd = -1;
+
+	static void* CompletionThread(void* reader);
+
+	int32_t submit(uint8_t opcode, int32_t fd, const void* buffer, uint32_t size, uint64_t offset, uint32_t op_flags, uint64_t user_data);
+	int32_t submitOpen(Request& request);
+	int32_t submitStat(Request& request);
+	int32_t submitRead(Request& request);
+	void submitStage(Request& request);
+	void retrySubmits(void);
+	void handleCompletion(Request& request, int32_t result);
+	void finish(Request& request, int32_t result);
+#endif
+
+	GAFF_NO_COPY(AsyncFileReader);
+	GAFF_NO_MOVE(AsyncFileReader);
+};
+
+NS_END
@@ -27,6 +27,7 @@ THE SOFTWARE.
 #include "Gaff_IncludeRapidJSON.h"
 #include <rapidjson/stringbuffer.h>
 #include <rapidjson/document.h>
+#include <EASTL/string_view.h>
 
 NS_GAFF
 
@@ -135,6 +136,9 @@ public:
 
 	const char8_t* getKey(char8_t* buffer, size_t buf_size, int32_t index) const;
 	const char8_t* getKey(int32_t index) const;
+	eastl::u8string_view getKeyView(int32_t index) const;
+	eastl::u8string_view getStringView(eastl::u8string_view default_value) const;
+	eastl::u8string_view getStringView(void) const;
 	JSON getValue(int32_t index) const;
 
 	const char8_t* getString(char8_t* buffer, size_t buf_size, const char8_t* default_value) const;
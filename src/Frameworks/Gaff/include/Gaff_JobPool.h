@@ -22,12 +22,16 @@ THE SOFTWARE.
 
 #pragma once
 
+#include "Gaff_WorkStealingDeque.h"
+#include "Gaff_HashString.h"
+#include "Gaff_VectorMap.h"
 #include "Gaff_SmartPtrs.h"
 #include "Gaff_Assert.h"
 #include "Gaff_Vector.h"
 #include "Gaff_Queue.h"
 #include "Gaff_Utils.h"
 #include "Gaff_IncludeEASTLAtomic.h"
+#include <eathread/eathread_condition.h>
 #include <eathread/eathread_semaphore.h>
 #include <eathread/eathread_thread.h>
 #include <eathread/eathread_mutex.h>
@@ -44,9 +48,22 @@ struct JobData final
 };
 
 using Counter = eastl::atomic<int32_t>;
-using JobPair = eastl::pair<JobData, Counter*>;
 using ThreadInitOrShutdownFunc = void (*)(uintptr_t);
 
+struct JobQueueStats final
+{
+	// Empty for the default pool. Owned by the job pool.
+	const char8_t* name = nullptr;
+
+	int32_t queue_depth = 0;
+	int32_t peak_queue_depth = 0;
+
+	// Latency is the time from a job being added to it starting, in nanoseconds.
+	uint64_t num_jobs_started = 0;
+	uint64_t total_latency_ns = 0;
+	uint64_t max_latency_ns = 0;
+};
+
 template <class Allocator = DefaultAllocator>
 class JobPool
 {
@@ -54,11 +71,12 @@ public:
 	JobPool(const Allocator& allocator = Allocator());
 	~JobPool(void);
 
-	bool init(int32_t num_threads = static_cast<int32_t>(GetNumberOfCores()), ThreadInitOrShutdownFunc init = nullptr, ThreadInitOrShutdownFunc shutdown = nullptr);
+	bool init(int32_t num_threads = static_cast<int32_t>(GetNumberOfCores()), ThreadInitOrShutdownFunc init = nullptr, ThreadInitOrShutdownFunc shutdown = nullptr, bool work_stealing = true);
 	void destroy(void);
 
 	bool isRunning(void) const;
 	bool isPaused(void) const;
+	bool isWorkStealing(void) const;
 
 	void pause(void);
 	void run(void);
@@ -79,9 +97,17 @@ public:
 
 	void helpWhileWaiting(EA::Thread::ThreadId thread_id, const Counter& counter);
 	void helpWhileWaiting(const Counter& counter);
+
+	// Runs jobs on this thread, including main thread jobs if this is the main thread, until done() returns true.
+	// When there is nothing to run, blocks until a counter reaches zero, the pool runs out of jobs or main thread jobs are queued.
+	template <class Predicate>
+	void helpUntil(EA::Thread::ThreadId thread_id, Predicate&& done);
 	void helpAndFreeCounter(EA::Thread::ThreadId thread_id, Counter* counter);
 	void helpAndFreeCounter(Counter* counter);
 
+	// Wakes all threads blocked in helpUntil(). Call this after changing something a waiter is checking from outside of a job.
+	void notifyWaiters(void);
+
 	void help(EA::Thread::ThreadId thread_id, eastl::chrono::milliseconds ms = eastl::chrono::milliseconds::zero());
 	void help(eastl::chrono::milliseconds ms = eastl::chrono::milliseconds::zero());
 
@@ -89,12 +115,66 @@ public:
 	void getThreadIDs(EA::Thread::ThreadId* out) const;
 	EA::Thread::ThreadId getMainThreadID(void) const;
 
+	// Snapshot of the default pool, named pools and main thread jobs. Counters are relaxed, so values may lag slightly.
+	void getStats(Vector<JobQueueStats, Allocator>& out) const;
+
+	// Clears peak queue depth and latency counters. Current queue depth is left alone.
+	void resetStats(void);
+
 private:
+	// Upper bound on a single wait, in case done() becomes true without a job finishing.
+	static constexpr int32_t k_max_wait_ms = 5;
+
+	// How long an idle worker backs off when the only jobs left are ones it can't run yet.
+	static constexpr int32_t k_worker_retry_ms = 1;
+
+	struct QueueStats final
+	{
+		eastl::atomic<int32_t> queue_depth = 0;
+		eastl::atomic<int32_t> peak_queue_depth = 0;
+		eastl::atomic<uint64_t> num_jobs_started = 0;
+		eastl::atomic<uint64_t> total_latency_ns = 0;
+		eastl::atomic<uint64_t> max_latency_ns = 0;
+	};
+
+	struct QueuedJob final
+	{
+		JobData job;
+		Counter* counter = nullptr;
+
+		// Queue the job was added to. Jobs stolen from local queues still report to the default pool.
+		QueueStats* stats = nullptr;
+		int64_t queue_time = 0;
+	};
+
 	struct JobQueue final
 	{
-		Queue<JobPair, Allocator> jobs;
+		Queue<QueuedJob, Allocator> jobs;
 		UniquePtr<EA::Thread::Mutex, Allocator> read_write_lock;
 		UniquePtr<EA::Thread::Semaphore, Allocator> thread_lock;
+
+		// Heap allocated so the address is stable when new pools are added.
+		UniquePtr<QueueStats, Allocator> stats;
+	};
+
+	// Each worker thread, and the main thread, owns one of these. Jobs added to the default pool
+	// from one of these threads go to its local deque. Idle threads steal from the other deques.
+	struct LocalQueue final
+	{
+		explicit LocalQueue(const Allocator& allocator):
+			jobs(WorkStealingDeque<QueuedJob, Allocator>::k_default_capacity, allocator)
+		{
+		}
+
+		WorkStealingDeque<QueuedJob, Allocator> jobs;
+		EA::Thread::ThreadId thread_id = EA::Thread::kThreadIdInvalid;
+	};
+
+	struct LocalQueueCache final
+	{
+		const JobPool<Allocator>* pool = nullptr;
+		EA::Thread::ThreadId thread_id = EA::Thread::kThreadIdInvalid;
+		int32_t index = -1;
 	};
 
 	struct ThreadData final
@@ -109,23 +189,48 @@ private:
 	VectorMap<HashString32<Allocator>, JobQueue, Allocator> _job_pools;
 	JobQueue _main_thread_jobs;
 
+	// Last entry is the main thread.
+	Vector<UniquePtr<LocalQueue, Allocator>, Allocator> _local_queues;
+
 	Vector<EA::Thread::Thread, Allocator> _threads;
 	ThreadData _thread_data;
 
 	EA::Thread::Semaphore _thread_lock;
 
+	// Threads blocked in helpUntil()/waitForCounter() sleep on this until something changes.
+	EA::Thread::Condition _wait_condition;
+	EA::Thread::Mutex _wait_lock;
+	eastl::atomic<uint32_t> _wait_epoch = 0;
+	eastl::atomic<int32_t> _num_waiters = 0;
+
 	EA::Thread::ThreadId _main_thread_id;
 	eastl::atomic<int32_t> _num_main_thread_jobs = 0;
 	eastl::atomic<int32_t> _num_jobs = 0;
 
 	Allocator _allocator;
 
+	bool _work_stealing = true;
+
 	void notifyThreads(void);
+	void wakeWaiter(void);
+
+	template <class Predicate>
+	void waitUntil(Predicate&& done, uint32_t epoch);
+
+	bool tryDoAJob(EA::Thread::ThreadId thread_id);
+
+	void initQueue(JobQueue& job_queue);
+	void markQueued(QueueStats& stats, int32_t num_jobs);
 
 	bool doJobFromQueue(EA::Thread::ThreadId thread_id, JobQueue& job_queue);
-	void doJob(EA::Thread::ThreadId thread_id, JobPair& job);
+	void doJob(EA::Thread::ThreadId thread_id, QueuedJob& job);
 	bool doAJob(EA::Thread::ThreadId thread_id);
 
+	int32_t getLocalQueueIndex(EA::Thread::ThreadId thread_id) const;
+	static LocalQueueCache& GetLocalQueueCache(void);
+	bool doJobFromLocalQueues(EA::Thread::ThreadId thread_id, int32_t local_index);
+
+	static int64_t GetStatsTime(void);
 	static intptr_t JobThread(void* data);
 
 	GAFF_NO_COPY(JobPool);
@@ -23,6 +23,7 @@ THE SOFTWARE.
 template <class Allocator>
 JobPool<Allocator>::JobPool(const Allocator& allocator):
 	_job_pools(allocator),
+	_local_queues(allocator),
 	_threads(allocator),
 	_allocator(allocator)
 {
@@ -38,20 +39,26 @@ JobPool<Allocator>::~JobPool(void)
 }
 
 template <class Allocator>
-bool JobPool<Allocator>::init(int32_t num_threads, ThreadInitOrShutdownFunc init, ThreadInitOrShutdownFunc shutdown)
+bool JobPool<Allocator>::init(int32_t num_threads, ThreadInitOrShutdownFunc init, ThreadInitOrShutdownFunc shutdown, bool work_stealing)
 {
 	// Add the default queue.
-	JobQueue& job_queue = _job_pools[HashString32<Allocator>(_allocator)];
-	job_queue.jobs = Queue<JobPair, Allocator>(_allocator);
-	job_queue.read_write_lock = UniquePtr<EA::Thread::Mutex, Allocator>(GAFF_ALLOCT(EA::Thread::Mutex, _allocator));
-
-	_main_thread_jobs.jobs = Queue<JobPair, Allocator>(_allocator);
-	_main_thread_jobs.read_write_lock = UniquePtr<EA::Thread::Mutex, Allocator>(GAFF_ALLOCT(EA::Thread::Mutex, _allocator));
+	initQueue(_job_pools[HashString32<Allocator>(_allocator)]);
+	initQueue(_main_thread_jobs);
 
 	_thread_data.init_func = init;
 	_thread_data.shutdown_func = shutdown;
 	_threads.resize(num_threads);
 
+	_work_stealing = work_stealing;
+
+	if (_work_stealing) {
+		_local_queues.reserve(static_cast<size_t>(num_threads + 1));
+
+		for (int32_t i = 0; i <= num_threads; ++i) {
+			_local_queues.emplace_back(GAFF_ALLOCT(LocalQueue, _allocator, _allocator));
+		}
+	}
+
 	for (int32_t i = 0; i < num_threads; ++i) {
 		U8String<Allocator> thread_name(_allocator);
 		thread_name.sprintf(u8"Job Pool Worker Thread %i", i);
@@ -71,9 +78,18 @@ bool JobPool<Allocator>::init(int32_t num_threads, ThreadInitOrShutdownFunc init
 			destroy();
 			return false;
 		}
+
+		if (_work_stealing) {
+			_local_queues[i]->thread_id = thread_id;
+		}
 	}
 
 	_main_thread_id = EA::Thread::GetThreadId();
+
+	if (_work_stealing) {
+		_local_queues.back()->thread_id = _main_thread_id;
+	}
+
 	return true;
 }
 
@@ -82,12 +98,14 @@ void JobPool<Allocator>::destroy(void)
 {
 	_thread_data.running = false;
 	notifyThreads();
+	notifyWaiters();
 
 	for (EA::Thread::Thread& thread : _threads) {
 		thread.WaitForEnd();
 	}
 
 	_threads.clear();
+	_local_queues.clear();
 	_job_pools.erase(_job_pools.begin(), _job_pools.end());
 }
 
@@ -103,6 +121,12 @@ bool JobPool<Allocator>::isPaused(void) const
 	return _thread_data.pause;
 }
 
+template <class Allocator>
+bool JobPool<Allocator>::isWorkStealing(void) const
+{
+	return _work_stealing;
+}
+
 template <class Allocator>
 void JobPool<Allocator>::pause(void)
 {
@@ -124,8 +148,7 @@ void JobPool<Allocator>::addPool(const HashStringView32<>& name, int32_t max_con
 	GAFF_ASSERT(_job_pools.find(copy) == _job_pools.end());
 
 	JobQueue& job_queue = _job_pools[copy];
-	job_queue.jobs = Queue<JobPair, Allocator>(_allocator);
-	job_queue.read_write_lock = UniquePtr<EA::Thread::Mutex, Allocator>(GAFF_ALLOCT(EA::Thread::Mutex, _allocator));
+	initQueue(job_queue);
 	job_queue.thread_lock = UniquePtr<EA::Thread::Semaphore, Allocator>(GAFF_ALLOCT(EA::Thread::Semaphore, _allocator, max_concurrent_threads));
 }
 
@@ -146,11 +169,15 @@ void JobPool<Allocator>::addMainThreadJobs(const JobData* jobs, int32_t num_jobs
 		*cnt += num_jobs;
 	}
 
+	markQueued(*_main_thread_jobs.stats, num_jobs);
+
+	const int64_t queue_time = GetStatsTime();
+
 	_main_thread_jobs.read_write_lock->Lock();
 
 	for (int32_t i = 0; i < num_jobs; ++i) {
 		GAFF_ASSERT(jobs[i].job_func);
-		_main_thread_jobs.jobs.emplace(JobPair(jobs[i], cnt));
+		_main_thread_jobs.jobs.emplace(QueuedJob{ jobs[i], cnt, _main_thread_jobs.stats.get(), queue_time });
 	}
 
 	_main_thread_jobs.read_write_lock->Unlock();
@@ -160,6 +187,9 @@ void JobPool<Allocator>::addMainThreadJobs(const JobData* jobs, int32_t num_jobs
 
 	// Main thread is not part of the thread pool. Don't post to the pool threads.
 	//_thread_lock.Post(num_jobs);
+
+	// Only the main thread can run these. It may be blocked waiting on a counter.
+	wakeWaiter();
 }
 
 template <class Allocator>
@@ -190,16 +220,43 @@ void JobPool<Allocator>::addJobs(const JobData* jobs, int32_t num_jobs, Counter*
 		*cnt += num_jobs;
 	}
 
-	job_queue.read_write_lock->Lock();
+	// Count the jobs before they are visible to other threads, as thieves can start on them immediately.
+	_num_jobs += num_jobs;
+	markQueued(*job_queue.stats, num_jobs);
 
-	for (int32_t i = 0; i < num_jobs; ++i) {
-		GAFF_ASSERT(jobs[i].job_func);
-		job_queue.jobs.emplace(JobPair(jobs[i], cnt));
+	const int64_t queue_time = GetStatsTime();
+
+	int32_t start_index = 0;
+
+	// Named pools always go through their shared queue to preserve max_concurrent_threads.
+	if (_work_stealing && pool == Hash32(0)) {
+		const int32_t local_index = getLocalQueueIndex(EA::Thread::GetThreadId());
+
+		if (local_index > -1) {
+			WorkStealingDeque<QueuedJob, Allocator>& local_queue = _local_queues[local_index]->jobs;
+
+			for (; start_index < num_jobs; ++start_index) {
+				GAFF_ASSERT(jobs[start_index].job_func);
+
+				// Local queue is full, overflow the rest into the shared queue.
+				if (!local_queue.push(QueuedJob{ jobs[start_index], cnt, job_queue.stats.get(), queue_time })) {
+					break;
+				}
+			}
+		}
 	}
 
-	job_queue.read_write_lock->Unlock();
+	if (start_index < num_jobs) {
+		job_queue.read_write_lock->Lock();
+
+		for (int32_t i = start_index; i < num_jobs; ++i) {
+			GAFF_ASSERT(jobs[i].job_func);
+			job_queue.jobs.emplace(QueuedJob{ jobs[i], cnt, job_queue.stats.get(), queue_time });
+		}
+
+		job_queue.read_write_lock->Unlock();
+	}
 
-	_num_jobs += num_jobs;
 	_thread_lock.Post(num_jobs);
 }
 
@@ -220,8 +277,10 @@ void JobPool<Allocator>::waitForAndFreeCounter(Counter* counter)
 template <class Allocator>
 void JobPool<Allocator>::waitForCounter(const Counter& counter)
 {
-	while (counter > 0 && _thread_data.running) {
-		EA::Thread::ThreadSleep();
+	const auto done = [&counter]() -> bool { return counter <= 0; };
+
+	while (!done() && _thread_data.running) {
+		waitUntil(done, _wait_epoch);
 	}
 }
 
@@ -239,28 +298,20 @@ void JobPool<Allocator>::waitForAllJobsToFinish(EA::Thread::ThreadId thread_id)
 	if (thread_id == _main_thread_id) {
 		while (doJobFromQueue(thread_id, _main_thread_jobs)) {
 			--_num_main_thread_jobs;
-			EA::Thread::ThreadSleep();
 		}
 	}
 
-	while (_num_jobs > 0) {
-		EA::Thread::ThreadSleep();
+	const auto done = [this]() -> bool { return _num_jobs <= 0; };
+
+	while (!done() && _thread_data.running) {
+		waitUntil(done, _wait_epoch);
 	}
 }
 
 template <class Allocator>
 void JobPool<Allocator>::helpWhileWaiting(EA::Thread::ThreadId thread_id, const Counter& counter)
 {
-	while (counter > 0) {
-		if (_thread_lock.Wait(EA::Thread::kTimeoutImmediate) >= 0) {
-			if (!doAJob(thread_id)) {
-				// We didn't do a job, put the count back.
-				_thread_lock.Post();
-			}
-		}
-
-		EA::Thread::ThreadSleep();
-	}
+	helpUntil(thread_id, [&counter]() -> bool { return counter <= 0; });
 }
 
 template <class Allocator>
@@ -269,6 +320,20 @@ void JobPool<Allocator>::helpWhileWaiting(const Counter& counter)
 	helpWhileWaiting(EA::Thread::GetThreadId(), counter);
 }
 
+template <class Allocator>
+template <class Predicate>
+void JobPool<Allocator>::helpUntil(EA::Thread::ThreadId thread_id, Predicate&& done)
+{
+	while (!done() && _thread_data.running) {
+		// Grab the epoch before looking for work, so a counter finishing after this point wakes us.
+		const uint32_t epoch = _wait_epoch;
+
+		if (!tryDoAJob(thread_id)) {
+			waitUntil(done, epoch);
+		}
+	}
+}
+
 template <class Allocator>
 void JobPool<Allocator>::helpAndFreeCounter(EA::Thread::ThreadId thread_id, Counter* counter)
 {
@@ -335,12 +400,147 @@ EA::Thread::ThreadId JobPool<Allocator>::getMainThreadID(void) const
 	return _main_thread_id;
 }
 
+template <class Allocator>
+void JobPool<Allocator>::getStats(Vector<JobQueueStats, Allocator>& out) const
+{
+	const auto copy_stats = [](const QueueStats& stats, const char8_t* name) -> JobQueueStats
+	{
+		JobQueueStats out_stats;
+		out_stats.name = name;
+		out_stats.queue_depth = stats.queue_depth.load(eastl::memory_order_relaxed);
+		out_stats.peak_queue_depth = stats.peak_queue_depth.load(eastl::memory_order_relaxed);
+		out_stats.num_jobs_started = stats.num_jobs_started.load(eastl::memory_order_relaxed);
+		out_stats.total_latency_ns = stats.total_latency_ns.load(eastl::memory_order_relaxed);
+		out_stats.max_latency_ns = stats.max_latency_ns.load(eastl::memory_order_relaxed);
+
+		return out_stats;
+	};
+
+	out.clear();
+	out.reserve(_job_pools.size() + 1);
+
+	for (const auto& pair : _job_pools) {
+		out.emplace_back(copy_stats(*pair.second.stats, pair.first.getBuffer()));
+	}
+
+	if (_main_thread_jobs.stats) {
+		out.emplace_back(copy_stats(*_main_thread_jobs.stats, u8"Main Thread"));
+	}
+}
+
+template <class Allocator>
+void JobPool<Allocator>::resetStats(void)
+{
+	const auto reset_stats = [](QueueStats& stats) -> void
+	{
+		stats.peak_queue_depth.store(stats.queue_depth.load(eastl::memory_order_relaxed), eastl::memory_order_relaxed);
+		stats.num_jobs_started.store(0, eastl::memory_order_relaxed);
+		stats.total_latency_ns.store(0, eastl::memory_order_relaxed);
+		stats.max_latency_ns.store(0, eastl::memory_order_relaxed);
+	};
+
+	for (auto& pair : _job_pools) {
+		reset_stats(*pair.second.stats);
+	}
+
+	if (_main_thread_jobs.stats) {
+		reset_stats(*_main_thread_jobs.stats);
+	}
+}
+
 template <class Allocator>
 void JobPool<Allocator>::notifyThreads(void)
 {
 	_thread_lock.Post(static_cast<int>(_threads.size()));
 }
 
+template <class Allocator>
+void JobPool<Allocator>::notifyWaiters(void)
+{
+	++_wait_epoch;
+
+	// Taking the lock guarantees a waiter is either already blocked on the condition, or will see the new epoch.
+	if (_num_waiters > 0) {
+		_wait_lock.Lock();
+		_wait_condition.Signal(true);
+		_wait_lock.Unlock();
+	}
+}
+
+template <class Allocator>
+void JobPool<Allocator>::wakeWaiter(void)
+{
+	++_wait_epoch;
+
+	// Same as notifyWaiters(), but only one waiter gets woken. waitUntil() passes it on if it wasn't for them.
+	if (_num_waiters > 0) {
+		_wait_lock.Lock();
+		_wait_condition.Signal(false);
+		_wait_lock.Unlock();
+	}
+}
+
+template <class Allocator>
+template <class Predicate>
+void JobPool<Allocator>::waitUntil(Predicate&& done, uint32_t epoch)
+{
+	_wait_lock.Lock();
+	++_num_waiters;
+
+	// done() is checked outside the lock. If it changed because of a job, the epoch changed with it.
+	if (epoch == _wait_epoch && !done() && _thread_data.running) {
+		_wait_condition.Wait(&_wait_lock, EA::Thread::GetThreadTime() + k_max_wait_ms);
+
+		// Something happened, but not what we are waiting on. Hand the wakeup to the next waiter.
+		// A waiter only forwards when the epoch moved since it went to sleep, so this can't bounce back and forth.
+		if (epoch != _wait_epoch && _num_waiters > 1 && !done()) {
+			_wait_condition.Signal(false);
+		}
+	}
+
+	--_num_waiters;
+	_wait_lock.Unlock();
+}
+
+template <class Allocator>
+bool JobPool<Allocator>::tryDoAJob(EA::Thread::ThreadId thread_id)
+{
+	if (_thread_lock.Wait(EA::Thread::kTimeoutImmediate) >= 0) {
+		if (doAJob(thread_id)) {
+			return true;
+		}
+
+		// We didn't do a job, put the count back.
+		_thread_lock.Post();
+	}
+
+	// Main thread jobs don't post to the semaphore.
+	if (thread_id == _main_thread_id && doJobFromQueue(thread_id, _main_thread_jobs)) {
+		--_num_main_thread_jobs;
+		return true;
+	}
+
+	return false;
+}
+
+template <class Allocator>
+void JobPool<Allocator>::initQueue(JobQueue& job_queue)
+{
+	job_queue.jobs = Queue<QueuedJob, Allocator>(_allocator);
+	job_queue.read_write_lock = UniquePtr<EA::Thread::Mutex, Allocator>(GAFF_ALLOCT(EA::Thread::Mutex, _allocator));
+	job_queue.stats = UniquePtr<QueueStats, Allocator>(GAFF_ALLOCT(QueueStats, _allocator));
+}
+
+template <class Allocator>
+void JobPool<Allocator>::markQueued(QueueStats& stats, int32_t num_jobs)
+{
+	const int32_t depth = stats.queue_depth.fetch_add(num_jobs, eastl::memory_order_relaxed) + num_jobs;
+	int32_t peak = stats.peak_queue_depth.load(eastl::memory_order_relaxed);
+
+	while (depth > peak && !stats.peak_queue_depth.compare_exchange_weak(peak, depth, eastl::memory_order_relaxed)) {
+	}
+}
+
 template <class Allocator>
 bool JobPool<Allocator>::doJobFromQueue(EA::Thread::ThreadId thread_id, JobQueue& job_queue)
 {
@@ -355,7 +555,7 @@ bool JobPool<Allocator>::doJobFromQueue(EA::Thread::ThreadId thread_id, JobQueue
 			}
 
 		} else {
-			JobPair job = job_queue.jobs.front();
+			QueuedJob job = job_queue.jobs.front();
 			job_queue.jobs.pop();
 			job_queue.read_write_lock->Unlock();
 
@@ -373,30 +573,56 @@ bool JobPool<Allocator>::doJobFromQueue(EA::Thread::ThreadId thread_id, JobQueue
 }
 
 template <class Allocator>
-void JobPool<Allocator>::doJob(EA::Thread::ThreadId thread_id, JobPair& job)
+void JobPool<Allocator>::doJob(EA::Thread::ThreadId thread_id, QueuedJob& job)
 {
+	if (job.stats) {
+		QueueStats& stats = *job.stats;
+		const uint64_t latency = static_cast<uint64_t>(eastl::max(GetStatsTime() - job.queue_time, int64_t(0)));
+		uint64_t max_latency = stats.max_latency_ns.load(eastl::memory_order_relaxed);
+
+		stats.queue_depth.fetch_sub(1, eastl::memory_order_relaxed);
+		stats.num_jobs_started.fetch_add(1, eastl::memory_order_relaxed);
+		stats.total_latency_ns.fetch_add(latency, eastl::memory_order_relaxed);
+
+		while (latency > max_latency && !stats.max_latency_ns.compare_exchange_weak(max_latency, latency, eastl::memory_order_relaxed)) {
+		}
+	}
+
 	const uintptr_t id_int = (uintptr_t)&thread_id;
-	job.first.job_func(id_int, job.first.job_data);
+	job.job.job_func(id_int, job.job.job_data);
 
-	if (job.second) {
-		//DebugPrintf("FUNC: %p\n", job.front);
+	// Waiters only care about counters finishing, so don't wake anyone for every job.
+	bool wake = false;
 
-		//if (!job.second->count) {
-		//	DebugPrintf("JOB FAIL(%d) - %p:(%d)\n", Thread::GetCurrentThreadID(), job.second, job.second->count);
-		//} else {
-		//	DebugPrintf("JOB(%d) - %p:(%d)\n", Thread::GetCurrentThreadID(), job.second, job.second->count);
-		//}
+	if (job.counter) {
+		GAFF_ASSERT(*job.counter > 0);
+		wake = (--(*job.counter) == 0);
+	}
 
-		GAFF_ASSERT(*job.second > 0);
-		--(*job.second);
+	if (--_num_jobs == 0) {
+		wake = true;
 	}
 
-	--_num_jobs;
+	if (wake) {
+		wakeWaiter();
+	}
 }
 
 template <class Allocator>
 bool JobPool<Allocator>::doAJob(EA::Thread::ThreadId thread_id)
 {
+	const int32_t local_index = (_work_stealing) ? getLocalQueueIndex(thread_id) : -1;
+
+	// Our own jobs first. Most recently pushed is most likely to still be in cache.
+	if (local_index > -1) {
+		QueuedJob job;
+
+		if (_local_queues[local_index]->jobs.pop(job)) {
+			doJob(thread_id, job);
+			return true;
+		}
+	}
+
 	// Do main thread jobs.
 	if (thread_id == _main_thread_id) {
 		if (doJobFromQueue(thread_id, _main_thread_jobs)) {
@@ -411,9 +637,92 @@ bool JobPool<Allocator>::doAJob(EA::Thread::ThreadId thread_id)
 		}
 	}
 
+	return _work_stealing && doJobFromLocalQueues(thread_id, local_index);
+}
+
+template <class Allocator>
+int32_t JobPool<Allocator>::getLocalQueueIndex(EA::Thread::ThreadId thread_id) const
+{
+	if (_local_queues.empty()) {
+		return -1;
+	}
+
+	if (thread_id == _main_thread_id) {
+		return static_cast<int32_t>(_local_queues.size()) - 1;
+	}
+
+	// JobPool lives in headers that are compiled into every module, and thread locals are not shared across
+	// module boundaries on all platforms. Each module may end up with its own copy of the cache, so it is only
+	// ever treated as a hint and checked against the queue it points at.
+	LocalQueueCache& cache = GetLocalQueueCache();
+
+	if (cache.pool == this && cache.thread_id == thread_id) {
+		if (cache.index == -1) {
+			return -1;
+		}
+
+		if (cache.index < static_cast<int32_t>(_local_queues.size()) && _local_queues[cache.index]->thread_id == thread_id) {
+			return cache.index;
+		}
+	}
+
+	int32_t index = -1;
+
+	for (int32_t i = 0; i < static_cast<int32_t>(_local_queues.size()); ++i) {
+		if (_local_queues[i]->thread_id == thread_id) {
+			index = i;
+			break;
+		}
+	}
+
+	// Only cache lookups for the calling thread.
+	if (thread_id == EA::Thread::GetThreadId()) {
+		cache.pool = this;
+		cache.thread_id = thread_id;
+		cache.index = index;
+	}
+
+	return index;
+}
+
+template <class Allocator>
+typename JobPool<Allocator>::LocalQueueCache& JobPool<Allocator>::GetLocalQueueCache(void)
+{
+	static thread_local LocalQueueCache cache;
+	return cache;
+}
+
+template <class Allocator>
+bool JobPool<Allocator>::doJobFromLocalQueues(EA::Thread::ThreadId thread_id, int32_t local_index)
+{
+	const int32_t num_queues = static_cast<int32_t>(_local_queues.size());
+
+	// Start with our neighbor so that thieves spread out over the victims.
+	for (int32_t i = 1; i <= num_queues; ++i) {
+		const int32_t index = (local_index + i) % num_queues;
+
+		if (index == local_index) {
+			continue;
+		}
+
+		QueuedJob job;
+
+		if (_local_queues[index]->jobs.steal(job)) {
+			doJob(thread_id, job);
+			return true;
+		}
+	}
+
 	return false;
 }
 
+template <class Allocator>
+int64_t JobPool<Allocator>::GetStatsTime(void)
+{
+	const auto now = eastl::chrono::high_resolution_clock::now().time_since_epoch();
+	return eastl::chrono::duration_cast<eastl::chrono::nanoseconds>(now).count();
+}
+
 template <class Allocator>
 intptr_t JobPool<Allocator>::JobThread(void* data)
 {
@@ -428,6 +737,9 @@ intptr_t JobPool<Allocator>::JobThread(void* data)
 		EA::Thread::ThreadSleep();
 	}
 
+	// Local queue owners are all assigned by now. Find ours once so job adds from this thread don't have to.
+	job_pool->getLocalQueueIndex(thread_id);
+
 	if (thread_data.init_func) {
 		thread_data.init_func(id_int);
 	}
@@ -439,16 +751,16 @@ intptr_t JobPool<Allocator>::JobThread(void* data)
 
 		// Count of the semaphore is number of jobs, every time we do a job, grab a count from the semaphore.
 		// No timout, so this shouldn't ever return < 0.
-		if (job_pool->_thread_lock.Wait() >= 0) {
-			// If _num_jobs is 0, then we have nothing to do and were woken up for some other reason.
+		if (job_pool->_thread_lock.Wait() >= 0 && !job_pool->doAJob(thread_id)) {
+			// Main thread jobs are never run here. If they are all that is left, we were woken up for some other reason.
 			// Don't post the job count back.
-			while (job_pool->_num_jobs > 0 && !job_pool->doAJob(thread_id)) {
-				// We didn't do a job, put the count back.
-				//job_pool->_thread_lock.Post();
+			if ((job_pool->_num_jobs - job_pool->_num_main_thread_jobs) > 0) {
+				// Remaining jobs are in a named pool that is at its thread limit. Put the count back and
+				// give the running jobs a moment, instead of pegging a core retrying.
+				job_pool->_thread_lock.Post();
+				EA::Thread::ThreadSleep(k_worker_retry_ms);
 			}
 		}
-
-		// Should we sleep here? Help keep CPU from being pegged all the time?
 	}
 
 	if (thread_data.shutdown_func) {
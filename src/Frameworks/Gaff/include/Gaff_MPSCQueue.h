@@ -0,0 +1,78 @@
+/************************************************************************************
+Copyright (C) 2022 by Nicholas LaCroix
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+************************************************************************************/
+
+#pragma once
+
+#include "Gaff_DefaultAllocator.h"
+#include "Gaff_IncludeEASTLAtomic.h"
+#include "Gaff_Assert.h"
+
+NS_GAFF
+
+// Bounded multi-producer, single-consumer queue. Each slot carries a sequence number, so producers only contend
+// on claiming a slot and never on each other's data. Values are written and read in place. Capacity must be a power of two.
+template <class T, class Allocator = DefaultAllocator>
+class MPSCQueue final
+{
+public:
+	static constexpr int64_t k_default_capacity = 1024;
+
+	MPSCQueue(int64_t capacity = k_default_capacity, const Allocator& allocator = Allocator());
+	~MPSCQueue(void);
+
+	// Safe to call from any thread. Claims a slot and calls writer(T&) on it.
+	// Returns false without calling writer if the queue is full.
+	template <class Writer>
+	bool tryPush(Writer&& writer);
+
+	// Consumer thread only. Calls reader(T&) on the oldest value, then releases the slot.
+	// Returns false if the queue is empty, or the oldest slot is still being written.
+	template <class Reader>
+	bool tryPop(Reader&& reader);
+
+	// Counts slots that have been claimed but not yet written as not empty.
+	bool empty(void) const;
+	int64_t capacity(void) const;
+
+private:
+	struct Cell final
+	{
+		eastl::atomic<int64_t> sequence;
+		T value;
+	};
+
+	// Keep the producer and consumer indices on separate cache lines.
+	alignas(64) eastl::atomic<int64_t> _tail = 0;
+	alignas(64) eastl::atomic<int64_t> _head = 0;
+
+	Cell* _buffer = nullptr;
+	int64_t _mask = 0;
+
+	Allocator _allocator;
+
+	GAFF_NO_COPY(MPSCQueue);
+	GAFF_NO_MOVE(MPSCQueue);
+};
+
+#include "Gaff_MPSCQueue.inl"
+
+NS_END
@@ -0,0 +1,104 @@
+/************************************************************************************
+Copyright (C) 2022 by Nicholas LaCroix
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+************************************************************************************/
+
+template <class T, class Allocator>
+MPSCQueue<T, Allocator>::MPSCQueue(int64_t capacity, const Allocator& allocator):
+	_mask(capacity - 1),
+	_allocator(allocator)
+{
+	GAFF_ASSERT(capacity > 0 && (capacity & (capacity - 1)) == 0);
+	_buffer = GAFF_ALLOC_CAST(Cell*, sizeof(Cell) * static_cast<size_t>(capacity), _allocator);
+
+	for (int64_t i = 0; i < capacity; ++i) {
+		Construct(_buffer + i);
+		_buffer[i].sequence.store(i, eastl::memory_order_relaxed);
+	}
+}
+
+template <class T, class Allocator>
+MPSCQueue<T, Allocator>::~MPSCQueue(void)
+{
+	GAFF_FREE_ARRAYT(_buffer, static_cast<size_t>(_mask + 1), _allocator);
+}
+
+template <class T, class Allocator>
+template <class Writer>
+bool MPSCQueue<T, Allocator>::tryPush(Writer&& writer)
+{
+	int64_t tail = _tail.load(eastl::memory_order_relaxed);
+
+	for (;;) {
+		Cell& cell = _buffer[tail & _mask];
+		const int64_t sequence = cell.sequence.load(eastl::memory_order_acquire);
+		const int64_t diff = sequence - tail;
+
+		if (diff == 0) {
+			// Slot is free for this lap. Claim it.
+			if (_tail.compare_exchange_weak(tail, tail + 1, eastl::memory_order_relaxed)) {
+				writer(cell.value);
+				cell.sequence.store(tail + 1, eastl::memory_order_release);
+				return true;
+			}
+
+		// Consumer hasn't released this slot from the previous lap yet.
+		} else if (diff < 0) {
+			return false;
+
+		// Another producer claimed this slot first.
+		} else {
+			tail = _tail.load(eastl::memory_order_relaxed);
+		}
+	}
+}
+
+template <class T, class Allocator>
+template <class Reader>
+bool MPSCQueue<T, Allocator>::tryPop(Reader&& reader)
+{
+	const int64_t head = _head.load(eastl::memory_order_relaxed);
+	Cell& cell = _buffer[head & _mask];
+
+	if (cell.sequence.load(eastl::memory_order_acquire) != head + 1) {
+		return false;
+	}
+
+	reader(cell.value);
+
+	// Hand the slot to the producer that will use it on the next lap.
+	cell.sequence.store(head + _mask + 1, eastl::memory_order_release);
+	_head.store(head + 1, eastl::memory_order_relaxed);
+
+	return true;
+}
+
+template <class T, class Allocator>
+bool MPSCQueue<T, Allocator>::empty(void) const
+{
+	// Sequentially consistent, so a consumer that publishes "about to sleep" and then checks empty() can't miss a push.
+	return _tail.load() == _head.load();
+}
+
+template <class T, class Allocator>
+int64_t MPSCQueue<T, Allocator>::capacity(void) const
+{
+	return _mask + 1;
+}
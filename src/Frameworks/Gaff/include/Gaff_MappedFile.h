@@ -0,0 +1,57 @@
+/************************************************************************************
+Copyright (C) 2022 by Nicholas LaCroix
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+************************************************************************************/
+
+#pragma once
+
+#include "Gaff_Defines.h"
+
+NS_GAFF
+
+// Maps a whole file into memory. Pages are copy-on-write, so writing to the mapping never touches the file on disk.
+class MappedFile final
+{
+public:
+	MappedFile(void) = default;
+	~MappedFile(void);
+
+	bool open(const char8_t* file_name);
+	void close(void);
+
+	bool isOpen(void) const;
+
+	const int8_t* getBuffer(void) const;
+	int8_t* getBuffer(void);
+	size_t size(void) const;
+
+private:
+	int8_t* _buffer = nullptr;
+	size_t _size = 0;
+
+#ifdef PLATFORM_WINDOWS
+	void* _file_mapping = nullptr;
+#endif
+
+	GAFF_NO_COPY(MappedFile);
+	GAFF_NO_MOVE(MappedFile);
+};
+
+NS_END
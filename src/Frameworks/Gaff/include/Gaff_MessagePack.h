@@ -23,6 +23,7 @@ THE SOFTWARE.
 #pragma once
 
 #include "Gaff_Assert.h"
+#include <EASTL/string_view.h>
 
 MSVC_DISABLE_WARNING_PUSH(4127)
 	#include <mpack.h>
@@ -105,6 +106,9 @@ public:
 
 	const char8_t* getKey(char8_t* buffer, size_t buf_size, int32_t index) const;
 	const char8_t* getKey(int32_t index) const;
+	eastl::u8string_view getKeyView(int32_t index) const;
+	eastl::u8string_view getStringView(eastl::u8string_view default_value) const;
+	eastl::u8string_view getStringView(void) const;
 	MessagePackNode getValue(int32_t index) const;
 
 	void freeString(const char8_t* str) const;
@@ -0,0 +1,69 @@
+/************************************************************************************
+Copyright (C) 2022 by Nicholas LaCroix
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+************************************************************************************/
+
+#pragma once
+
+#include "Gaff_DefaultAllocator.h"
+#include "Gaff_IncludeEASTLAtomic.h"
+#include "Gaff_Assert.h"
+
+NS_GAFF
+
+// Bounded Chase-Lev deque. The owning thread pushes and pops from the bottom,
+// any other thread may steal from the top. Capacity must be a power of two.
+template <class T, class Allocator = DefaultAllocator>
+class WorkStealingDeque final
+{
+public:
+	static constexpr int64_t k_default_capacity = 4096;
+
+	WorkStealingDeque(int64_t capacity = k_default_capacity, const Allocator& allocator = Allocator());
+	~WorkStealingDeque(void);
+
+	// Owner thread only. Returns false if the deque is full.
+	bool push(const T& value);
+	bool pop(T& out);
+
+	// Safe to call from any thread.
+	bool steal(T& out);
+
+	bool empty(void) const;
+	int64_t size(void) const;
+	int64_t capacity(void) const;
+
+private:
+	// Keep the owner and thief indices on separate cache lines.
+	alignas(64) eastl::atomic<int64_t> _top = 0;
+	alignas(64) eastl::atomic<int64_t> _bottom = 0;
+
+	T* _buffer = nullptr;
+	int64_t _mask = 0;
+
+	Allocator _allocator;
+
+	GAFF_NO_COPY(WorkStealingDeque);
+	GAFF_NO_MOVE(WorkStealingDeque);
+};
+
+#include "Gaff_WorkStealingDeque.inl"
+
+NS_END
@@ -0,0 +1,125 @@
+/************************************************************************************
+Copyright (C) 2022 by Nicholas LaCroix
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+************************************************************************************/
+
+template <class T, class Allocator>
+WorkStealingDeque<T, Allocator>::WorkStealingDeque(int64_t capacity, const Allocator& allocator):
+	_mask(capacity - 1),
+	_allocator(allocator)
+{
+	GAFF_ASSERT(capacity > 0 && (capacity & (capacity - 1)) == 0);
+	_buffer = GAFF_ALLOC_CAST(T*, sizeof(T) * static_cast<size_t>(capacity), _allocator);
+
+	for (int64_t i = 0; i < capacity; ++i) {
+		Construct(_buffer + i);
+	}
+}
+
+template <class T, class Allocator>
+WorkStealingDeque<T, Allocator>::~WorkStealingDeque(void)
+{
+	GAFF_FREE_ARRAYT(_buffer, static_cast<size_t>(_mask + 1), _allocator);
+}
+
+template <class T, class Allocator>
+bool WorkStealingDeque<T, Allocator>::push(const T& value)
+{
+	const int64_t bottom = _bottom.load(eastl::memory_order_relaxed);
+	const int64_t top = _top.load(eastl::memory_order_acquire);
+
+	if ((bottom - top) > _mask) {
+		return false;
+	}
+
+	_buffer[bottom & _mask] = value;
+	_bottom.store(bottom + 1, eastl::memory_order_release);
+
+	return true;
+}
+
+template <class T, class Allocator>
+bool WorkStealingDeque<T, Allocator>::pop(T& out)
+{
+	const int64_t bottom = _bottom.load(eastl::memory_order_relaxed) - 1;
+	_bottom.store(bottom, eastl::memory_order_relaxed);
+
+	eastl::atomic_thread_fence(eastl::memory_order_seq_cst);
+
+	int64_t top = _top.load(eastl::memory_order_relaxed);
+
+	// Deque was empty, restore bottom.
+	if (top > bottom) {
+		_bottom.store(bottom + 1, eastl::memory_order_relaxed);
+		return false;
+	}
+
+	out = _buffer[bottom & _mask];
+
+	// More than one element left, no race with thieves.
+	if (top < bottom) {
+		return true;
+	}
+
+	// Last element. Race any thieves for it.
+	const bool won = _top.compare_exchange_strong(top, top + 1, eastl::memory_order_seq_cst, eastl::memory_order_relaxed);
+	_bottom.store(bottom + 1, eastl::memory_order_relaxed);
+
+	return won;
+}
+
+template <class T, class Allocator>
+bool WorkStealingDeque<T, Allocator>::steal(T& out)
+{
+	int64_t top = _top.load(eastl::memory_order_acquire);
+	eastl::atomic_thread_fence(eastl::memory_order_seq_cst);
+	const int64_t bottom = _bottom.load(eastl::memory_order_acquire);
+
+	if (top >= bottom) {
+		return false;
+	}
+
+	// If we lose the race below, this value is discarded. The owner can only overwrite
+	// this slot after another thief has already advanced top past it.
+	out = _buffer[top & _mask];
+
+	return _top.compare_exchange_strong(top, top + 1, eastl::memory_order_seq_cst, eastl::memory_order_relaxed);
+}
+
+template <class T, class Allocator>
+bool WorkStealingDeque<T, Allocator>::empty(void) const
+{
+	return size() <= 0;
+}
+
+template <class T, class Allocator>
+int64_t WorkStealingDeque<T, Allocator>::size(void) const
+{
+	const int64_t bottom = _bottom.load(eastl::memory_order_relaxed);
+	const int64_t top = _top.load(eastl::memory_order_relaxed);
+
+	return bottom - top;
+}
+
+template <class T, class Allocator>
+int64_t WorkStealingDeque<T, Allocator>::capacity(void) const
+{
+	return _mask + 1;
+}
@@ -24,7 +24,9 @@ THE SOFTWARE.
 #include "Gleam_Transform.h"
 #include "Gleam_AABB.h"
 #include "Gleam_OBB.h"
+#include <Gaff_Assert.h>
 #include <cmath>
+#include <limits>
 
 NS_GLEAM
 
@@ -33,6 +35,11 @@ Frustum::Frustum(float fov, float aspect_ratio, float z_near, float z_far)
 	construct(fov, aspect_ratio, z_near, z_far);
 }
 
+Frustum::Frustum(const Mat4x4& view_projection)
+{
+	construct(view_projection);
+}
+
 void Frustum::construct(float fov, float aspect_ratio, float z_near, float z_far)
 {
 	fov *= 0.5f;
@@ -59,6 +66,38 @@ void Frustum::construct(float fov, float aspect_ratio, float z_near, float z_far
 	_planes[5] = Plane(Vec3(0.0f, 0.0f, 1.0f), z_far);
 }
 
+void Frustum::construct(const Mat4x4& view_projection)
+{
+	// Extract the clip planes from the rows of the matrix (Gribb/Hartmann).
+	const Vec4 row_x(view_projection[0][0], view_projection[1][0], view_projection[2][0], view_projection[3][0]);
+	const Vec4 row_y(view_projection[0][1], view_projection[1][1], view_projection[2][1], view_projection[3][1]);
+	const Vec4 row_z(view_projection[0][2], view_projection[1][2], view_projection[2][2], view_projection[3][2]);
+	const Vec4 row_w(view_projection[0][3], view_projection[1][3], view_projection[2][3], view_projection[3][3]);
+
+#if GLM_CONFIG_CLIP_CONTROL & GLM_CLIP_CONTROL_ZO_BIT
+	const Vec4 near_plane = row_z;
+#else
+	const Vec4 near_plane = row_w + row_z;
+#endif
+
+	const Vec4 planes[6] = {
+		row_w + row_x,
+		row_w - row_x,
+		row_w + row_y,
+		row_w - row_y,
+		near_plane,
+		row_w - row_z
+	};
+
+	// Points inside satisfy dot(plane.xyz, point) + plane.w >= 0. Flip them so normals point outside, like construct() above.
+	for (int32_t i = 0; i < 6; ++i) {
+		const Vec3 normal(planes[i]);
+		const float inv_length = 1.0f / glm::length(normal);
+
+		_planes[i].set(-normal * inv_length, planes[i].w * inv_length);
+	}
+}
+
 bool Frustum::contains(const AABB& aabb) const
 {
 	const int32_t size = static_cast<int32_t>(ARRAY_SIZE(_planes));
@@ -86,6 +125,38 @@ bool Frustum::contains(const OBB& obb) const
 	return true;
 }
 
+int32_t Frustum::contains(const Vec4SIMD (&center)[3], const Vec4SIMD (&axes)[3][3]) const
+{
+	// Largest signed distance of any box past any plane. A box is outside if it is fully in front of at least one plane.
+	Vec4SIMD max_outside(-std::numeric_limits<float>::max());
+
+	for (const Plane& plane : _planes) {
+		const Vec3 normal = plane.getNormal();
+		const Vec4SIMD nx(normal.x);
+		const Vec4SIMD ny(normal.y);
+		const Vec4SIMD nz(normal.z);
+
+		const Vec4SIMD dist = center[0] * nx + center[1] * ny + center[2] * nz;
+		const Vec4SIMD radius =
+			glm::abs(axes[0][0] * nx + axes[0][1] * ny + axes[0][2] * nz) +
+			glm::abs(axes[1][0] * nx + axes[1][1] * ny + axes[1][2] * nz) +
+			glm::abs(axes[2][0] * nx + axes[2][1] * ny + axes[2][2] * nz);
+
+		max_outside = glm::max(max_outside, dist - radius - Vec4SIMD(plane.getDistance()));
+	}
+
+	return ((max_outside.x < 0.0f) ? 1 : 0) |
+		((max_outside.y < 0.0f) ? 2 : 0) |
+		((max_outside.z < 0.0f) ? 4 : 0) |
+		((max_outside.w < 0.0f) ? 8 : 0);
+}
+
+const Plane& Frustum::getPlane(int32_t index) const
+{
+	GAFF_ASSERT(index >= 0 && index < static_cast<int32_t>(ARRAY_SIZE(_planes)));
+	return _planes[index];
+}
+
 void Frustum::transform(const Transform& transform)
 {
 	_planes[0].transform(transform);
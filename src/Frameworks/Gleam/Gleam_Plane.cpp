@@ -96,9 +96,9 @@ Plane::ContainResult Plane::contains(const OBB& obb) const
 	float dist_max = dist_center + dist_x + dist_y + dist_z;
 	float dist_min = dist_center - dist_x - dist_y - dist_z;
 
-	if (dist_max < _normal[3]) {
+	if (dist_max < _distance) {
 		return BACK;
-	} else if (dist_min < _normal[3]) {
+	} else if (dist_min < _distance) {
 		return INTERSECTS;
 	}
 
@@ -22,6 +22,7 @@ THE SOFTWARE.
 
 #pragma once
 
+#include "Gleam_Matrix4x4.h"
 #include "Gleam_Plane.h"
 
 NS_GLEAM
@@ -34,14 +35,22 @@ class Frustum
 {
 public:
 	Frustum(float fov, float aspect_ratio, float z_near, float z_far);
+	explicit Frustum(const Mat4x4& view_projection);
 	GAFF_STRUCTORS_DEFAULT(Frustum);
 	GAFF_COPY_DEFAULT(Frustum);
 
 	void construct(float fov, float aspect_ratio, float z_near, float z_far);
+	void construct(const Mat4x4& view_projection);
 
 	bool contains(const AABB& aabb) const;
 	bool contains(const OBB& obb) const;
 
+	// Tests 4 OBBs at once. Each SIMD lane is a different box, axes are scaled by the box's half extents.
+	// Returns a mask with bit N set if box N is at least partially inside the frustum.
+	int32_t contains(const Vec4SIMD (&center)[3], const Vec4SIMD (&axes)[3][3]) const;
+
+	const Plane& getPlane(int32_t index) const;
+
 	void transform(const Transform& transform);
 
 private:
@@ -0,0 +1,86 @@
+/************************************************************************************
+Copyright (C) 2022 by Nicholas LaCroix
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+************************************************************************************/
+
+#include "Shibboleth_WebMemoryHandler.h"
+#include <Shibboleth_DevWebAttributes.h>
+#include <Shibboleth_DevWebUtils.h>
+#include <Shibboleth_Memory.h>
+#include <Gaff_JSON.h>
+
+SHIB_REFLECTION_DEFINE_BEGIN(Shibboleth::WebMemoryHandler)
+	.classAttrs(Shibboleth::DevWebCommandAttribute(u8"/memory"))
+
+	.template BASE(Shibboleth::IDevWebHandler)
+	.ctor<>()
+SHIB_REFLECTION_DEFINE_END(Shibboleth::WebMemoryHandler)
+
+NS_SHIBBOLETH
+
+SHIB_REFLECTION_CLASS_DEFINE(WebMemoryHandler)
+
+bool WebMemoryHandler::handleGet(CivetServer*, mg_connection* conn)
+{
+	// Snapshot is lock-free, so polling this won't stall threads that are allocating.
+	MemoryPoolStats stats[64];
+	const int32_t num_pools = GetMemoryPoolStats(stats, static_cast<int32_t>(ARRAY_SIZE(stats)));
+
+	Gaff::JSON pools = Gaff::JSON::CreateArray();
+
+	for (int32_t i = 0; i < num_pools; ++i) {
+		Gaff::JSON pool = Gaff::JSON::CreateObject();
+		pool.setObject(u8"name", Gaff::JSON::CreateString(reinterpret_cast<const char8_t*>(stats[i].pool_name)));
+		pool.setObject(u8"total_bytes_allocated", Gaff::JSON::CreateUInt64(stats[i].total_bytes_allocated));
+		pool.setObject(u8"curr_bytes_allocated", Gaff::JSON::CreateUInt64(stats[i].curr_bytes_allocated));
+		pool.setObject(u8"num_allocations", Gaff::JSON::CreateUInt64(stats[i].num_allocations));
+		pool.setObject(u8"num_frees", Gaff::JSON::CreateUInt64(stats[i].num_frees));
+
+		pools.push(std::move(pool));
+	}
+
+	FrameAllocatorStats frame_stats[64];
+	const int32_t num_frame_stats = GetFrameAllocatorStats(frame_stats, static_cast<int32_t>(ARRAY_SIZE(frame_stats)));
+
+	Gaff::JSON frame_arenas = Gaff::JSON::CreateArray();
+
+	for (int32_t i = 0; i < num_frame_stats; ++i) {
+		Gaff::JSON arena = Gaff::JSON::CreateObject();
+		arena.setObject(u8"thread_id", Gaff::JSON::CreateUInt64(frame_stats[i].thread_id));
+		arena.setObject(u8"arena_size", Gaff::JSON::CreateUInt64(frame_stats[i].arena_size));
+		arena.setObject(u8"high_water_mark", Gaff::JSON::CreateUInt64(frame_stats[i].high_water_mark));
+		arena.setObject(u8"overflow_high_water_mark", Gaff::JSON::CreateUInt64(frame_stats[i].overflow_high_water_mark));
+		arena.setObject(u8"num_overflow_allocations", Gaff::JSON::CreateUInt64(frame_stats[i].num_overflow_allocations));
+
+		frame_arenas.push(std::move(arena));
+	}
+
+	Gaff::JSON response = Gaff::JSON::CreateObject();
+	response.setObject(u8"pools", std::move(pools));
+	response.setObject(u8"frame_arenas", std::move(frame_arenas));
+
+	const char8_t* const response_string = response.dump();
+	WriteResponse(*conn, reinterpret_cast<const char*>(response_string));
+	response.freeDumpString(response_string);
+
+	return true;
+}
+
+NS_END
@@ -0,0 +1,129 @@
+/************************************************************************************
+Copyright (C) 2022 by Nicholas LaCroix
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+************************************************************************************/
+
+#include "Shibboleth_WebProfilerHandler.h"
+#include <Shibboleth_DevWebAttributes.h>
+#include <Shibboleth_DevWebUtils.h>
+#include <Shibboleth_IMainLoop.h>
+#include <Shibboleth_AppUtils.h>
+#include <Shibboleth_JobPool.h>
+#include <Shibboleth_IApp.h>
+#include <CivetServer.h>
+#include <Gaff_JSON.h>
+
+SHIB_REFLECTION_DEFINE_BEGIN(Shibboleth::WebProfilerHandler)
+	.classAttrs(Shibboleth::DevWebCommandAttribute(u8"/profiler"))
+
+	.template BASE(Shibboleth::IDevWebHandler)
+	.ctor<>()
+SHIB_REFLECTION_DEFINE_END(Shibboleth::WebProfilerHandler)
+
+NS_SHIBBOLETH
+
+SHIB_REFLECTION_CLASS_DEFINE(WebProfilerHandler)
+
+static Gaff::JSON TimingStatsToJSON(const TimingStats& stats)
+{
+	Gaff::JSON timing = Gaff::JSON::CreateObject();
+	timing.setObject(u8"min_ns", Gaff::JSON::CreateInt64(stats.min_ns));
+	timing.setObject(u8"avg_ns", Gaff::JSON::CreateInt64(stats.avg_ns));
+	timing.setObject(u8"max_ns", Gaff::JSON::CreateInt64(stats.max_ns));
+	timing.setObject(u8"p99_ns", Gaff::JSON::CreateInt64(stats.p99_ns));
+	timing.setObject(u8"num_samples", Gaff::JSON::CreateInt32(stats.num_samples));
+
+	return timing;
+}
+
+bool WebProfilerHandler::handleGet(CivetServer*, mg_connection* conn)
+{
+	IApp& app = GetApp();
+
+	Gaff::JSON systems = Gaff::JSON::CreateArray();
+	Gaff::JSON blocks = Gaff::JSON::CreateArray();
+
+	if (const IMainLoop* const main_loop = app.getMainLoop()) {
+		Vector<SystemTimingStats> system_stats(ProxyAllocator("DevWeb"));
+		Vector<BlockTimingStats> block_stats(ProxyAllocator("DevWeb"));
+
+		main_loop->getSystemTimings(system_stats);
+		main_loop->getBlockTimings(block_stats);
+
+		for (const SystemTimingStats& stats : system_stats) {
+			Gaff::JSON system = Gaff::JSON::CreateObject();
+			system.setObject(u8"name", Gaff::JSON::CreateString(stats.name));
+			system.setObject(u8"block", Gaff::JSON::CreateInt32(stats.block));
+			system.setObject(u8"row", Gaff::JSON::CreateInt32(stats.row));
+			system.setObject(u8"update", TimingStatsToJSON(stats.update));
+			system.setObject(u8"wait", TimingStatsToJSON(stats.wait));
+
+			systems.push(std::move(system));
+		}
+
+		for (const BlockTimingStats& stats : block_stats) {
+			Gaff::JSON block = Gaff::JSON::CreateObject();
+			block.setObject(u8"run", TimingStatsToJSON(stats.run));
+			block.setObject(u8"stall", TimingStatsToJSON(stats.stall));
+
+			blocks.push(std::move(block));
+		}
+	}
+
+	JobPool& job_pool = app.getJobPool();
+	Vector<Gaff::JobQueueStats> queue_stats(ProxyAllocator("DevWeb"));
+	job_pool.getStats(queue_stats);
+
+	Gaff::JSON job_pools = Gaff::JSON::CreateArray();
+
+	for (const Gaff::JobQueueStats& stats : queue_stats) {
+		const uint64_t avg_latency = (stats.num_jobs_started) ? stats.total_latency_ns / stats.num_jobs_started : 0;
+
+		Gaff::JSON pool = Gaff::JSON::CreateObject();
+		pool.setObject(u8"name", Gaff::JSON::CreateString(stats.name));
+		pool.setObject(u8"queue_depth", Gaff::JSON::CreateInt32(stats.queue_depth));
+		pool.setObject(u8"peak_queue_depth", Gaff::JSON::CreateInt32(stats.peak_queue_depth));
+		pool.setObject(u8"num_jobs_started", Gaff::JSON::CreateUInt64(stats.num_jobs_started));
+		pool.setObject(u8"avg_latency_ns", Gaff::JSON::CreateUInt64(avg_latency));
+		pool.setObject(u8"max_latency_ns", Gaff::JSON::CreateUInt64(stats.max_latency_ns));
+
+		job_pools.push(std::move(pool));
+	}
+
+	// "/profiler?reset" starts a new window for peaks and latencies. Rolling timings reset themselves.
+	const mg_request_info* const request = mg_get_request_info(conn);
+
+	if (request && request->query_string && !strcmp(request->query_string, "reset")) {
+		job_pool.resetStats();
+	}
+
+	Gaff::JSON response = Gaff::JSON::CreateObject();
+	response.setObject(u8"systems", std::move(systems));
+	response.setObject(u8"blocks", std::move(blocks));
+	response.setObject(u8"job_pools", std::move(job_pools));
+
+	const char8_t* const response_string = response.dump();
+	WriteResponse(*conn, reinterpret_cast<const char*>(response_string));
+	response.freeDumpString(response_string);
+
+	return true;
+}
+
+NS_END
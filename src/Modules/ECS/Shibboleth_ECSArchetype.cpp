@@ -244,6 +244,34 @@ void ECSArchetype::copy(
 	}
 }
 
+void ECSArchetype::copy(const ECSArchetype& old_archetype, const EntityCopy* entity_copies, int32_t count)
+{
+	copySharedInstanceData(old_archetype);
+	copyDefaultData(old_archetype);
+
+	const auto end = _vars.end();
+	auto it = _vars.begin();
+
+	for (const RefDefOffset& rdo : old_archetype._vars) {
+		const auto it_pos = eastl::find(it, end, rdo.ref_def, [](const auto& lhs, const auto* rhs) -> bool { return lhs.ref_def == rhs; });
+
+		// Component was deleted.
+		if (it_pos == end) {
+			continue;
+		}
+
+		it = it_pos;
+
+		for (int32_t i = 0; i < count; ++i) {
+			const EntityCopy& entity_copy = entity_copies[i];
+			const void* const old_component = reinterpret_cast<const int8_t*>(entity_copy.old_data) + rdo.offset;
+			void* const new_component = reinterpret_cast<int8_t*>(entity_copy.new_data) + it->offset;
+
+			rdo.copy_func(old_component, entity_copy.old_index, new_component, entity_copy.new_index);
+		}
+	}
+}
+
 int32_t ECSArchetype::getComponentSharedOffset(Gaff::Hash64 component) const
 {
 	const auto it = Gaff::LowerBound(_shared_vars, component, SearchPredicate);
@@ -902,11 +930,25 @@ Gaff::Hash64 ArchetypeReference::getArchetypeHash(void) const
 	return _archetype;
 }
 
+void ArchetypeReference::addRef(int32_t count) const
+{
+	_count += count;
+}
+
 void ArchetypeReference::addRef(void) const
 {
 	++_count;
 }
 
+void ArchetypeReference::release(int32_t count) const
+{
+	const int32_t new_count = (_count -= count);
+
+	if (!new_count) {
+		_ecs_mgr.removeArchetype(_archetype);
+	}
+}
+
 void ArchetypeReference::release(void) const
 {
 	const int32_t new_count = --_count;
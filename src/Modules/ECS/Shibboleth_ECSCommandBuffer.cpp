@@ -0,0 +1,288 @@
+/************************************************************************************
+Copyright (C) 2022 by Nicholas LaCroix
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+************************************************************************************/
+
+#include "Shibboleth_ECSCommandBuffer.h"
+#include <EASTL/sort.h>
+
+NS_SHIBBOLETH
+
+ECSCommandBuffer::~ECSCommandBuffer(void)
+{
+	clear();
+}
+
+EntityID ECSCommandBuffer::createEntity(Gaff::Hash64 archetype)
+{
+	const EA::Thread::AutoMutex lock(_lock);
+	const int32_t created_index = static_cast<int32_t>(_create_commands.size());
+
+	_create_commands.emplace_back(CreateCommand{ archetype, created_index });
+	return ToPlaceholder(created_index);
+}
+
+void ECSCommandBuffer::destroyEntity(EntityID id)
+{
+	GAFF_ASSERT(ValidEntityID(id) || IsPlaceholder(id));
+
+	const EA::Thread::AutoMutex lock(_lock);
+	_destroy_commands.emplace_back(DestroyCommand{ id, _next_order++ });
+}
+
+void ECSCommandBuffer::modify(EntityID id, ECSManager::ArchetypeModifier modifier)
+{
+	GAFF_ASSERT(ValidEntityID(id) || IsPlaceholder(id));
+
+	const EA::Thread::AutoMutex lock(_lock);
+	_modify_commands.emplace_back(ModifyCommand{ modifier, id, _next_order++ });
+}
+
+void ECSCommandBuffer::apply(ECSManager& ecs_mgr)
+{
+	Vector<CreateCommand> create_commands(ProxyAllocator("ECS"));
+	Vector<ModifyCommand> modify_commands(ProxyAllocator("ECS"));
+	Vector<SetCommand> set_commands(ProxyAllocator("ECS"));
+	Vector<DestroyCommand> destroy_commands(ProxyAllocator("ECS"));
+
+	// Take ownership of everything recorded so far. Anything recorded while applying goes into the next batch.
+	{
+		const EA::Thread::AutoMutex lock(_lock);
+
+		create_commands.swap(_create_commands);
+		modify_commands.swap(_modify_commands);
+		set_commands.swap(_set_commands);
+		destroy_commands.swap(_destroy_commands);
+		_next_order = 0;
+	}
+
+	Vector<EntityID> ids(ProxyAllocator::GetFrame());
+
+	// Create entities, one batch per archetype.
+	_created_entities.clear();
+	_created_entities.resize(create_commands.size(), EntityID_None);
+
+	eastl::stable_sort(create_commands.begin(), create_commands.end(), [](const CreateCommand& lhs, const CreateCommand& rhs) -> bool
+	{
+		return lhs.archetype < rhs.archetype;
+	});
+
+	for (int32_t begin = 0; begin < static_cast<int32_t>(create_commands.size());) {
+		const Gaff::Hash64 archetype = create_commands[begin].archetype;
+		int32_t end = begin + 1;
+
+		while (end < static_cast<int32_t>(create_commands.size()) && create_commands[end].archetype == archetype) {
+			++end;
+		}
+
+		ids.resize(static_cast<size_t>(end - begin));
+		ecs_mgr.createEntities(archetype, end - begin, ids.data());
+
+		for (int32_t i = begin; i < end; ++i) {
+			_created_entities[create_commands[i].created_index] = ids[i - begin];
+		}
+
+		begin = end;
+	}
+
+	// Put every command for an entity back in the order it was recorded.
+	Vector<CommandRef> commands(ProxyAllocator::GetFrame());
+	commands.reserve(modify_commands.size() + set_commands.size() + destroy_commands.size());
+
+	for (int32_t i = 0; i < static_cast<int32_t>(modify_commands.size()); ++i) {
+		commands.emplace_back(CommandRef{ resolve(modify_commands[i].id), modify_commands[i].order, 0, i, CommandType::Modify });
+	}
+
+	for (int32_t i = 0; i < static_cast<int32_t>(set_commands.size()); ++i) {
+		commands.emplace_back(CommandRef{ resolve(set_commands[i].id), set_commands[i].order, 0, i, CommandType::Set });
+	}
+
+	for (int32_t i = 0; i < static_cast<int32_t>(destroy_commands.size()); ++i) {
+		commands.emplace_back(CommandRef{ resolve(destroy_commands[i].id), destroy_commands[i].order, 0, i, CommandType::Destroy });
+	}
+
+	eastl::sort(commands.begin(), commands.end(), [](const CommandRef& lhs, const CommandRef& rhs) -> bool
+	{
+		return (lhs.id == rhs.id) ? lhs.order < rhs.order : lhs.id < rhs.id;
+	});
+
+	// Split each entity's commands into steps. A new step starts whenever the kind of command changes,
+	// so a step for an entity is either a run of modifies, a run of sets or a destroy.
+	// Everything after a destroy is dropped.
+	int32_t num_steps = 0;
+
+	for (int32_t begin = 0; begin < static_cast<int32_t>(commands.size());) {
+		const EntityID id = commands[begin].id;
+		int32_t end = begin;
+		int32_t step = -1;
+		bool destroyed = false;
+
+		while (end < static_cast<int32_t>(commands.size()) && commands[end].id == id) {
+			CommandRef& command = commands[end];
+
+			if (destroyed) {
+				command.step = -1;
+
+			} else {
+				if (end == begin || command.type != commands[end - 1].type || command.type == CommandType::Destroy) {
+					++step;
+				}
+
+				command.step = step;
+				destroyed = command.type == CommandType::Destroy;
+			}
+
+			++end;
+		}
+
+		num_steps = Gaff::Max(num_steps, step + 1);
+		begin = end;
+	}
+
+	// Keeps each entity's commands together and in order within a step.
+	eastl::stable_sort(commands.begin(), commands.end(), [](const CommandRef& lhs, const CommandRef& rhs) -> bool
+	{
+		return lhs.step < rhs.step;
+	});
+
+	Vector<ECSManager::ArchetypeModifier> modifiers(ProxyAllocator::GetFrame());
+	Vector<int32_t> modifier_offsets(ProxyAllocator::GetFrame());
+	Vector<EntityID> destroy_ids(ProxyAllocator::GetFrame());
+	int32_t begin = 0;
+
+	// Skip dropped commands.
+	while (begin < static_cast<int32_t>(commands.size()) && commands[begin].step < 0) {
+		++begin;
+	}
+
+	// Entities in the same step are independent of each other, so each step is batched as a whole.
+	for (int32_t step = 0; step < num_steps; ++step) {
+		modifiers.clear();
+		modifier_offsets.clear();
+		destroy_ids.clear();
+		ids.clear();
+
+		for (; begin < static_cast<int32_t>(commands.size()) && commands[begin].step == step; ++begin) {
+			const CommandRef& command = commands[begin];
+
+			switch (command.type) {
+				case CommandType::Modify:
+					if (ids.empty() || ids.back() != command.id) {
+						ids.emplace_back(command.id);
+						modifier_offsets.emplace_back(static_cast<int32_t>(modifiers.size()));
+					}
+
+					modifiers.emplace_back(modify_commands[command.index].modifier);
+					break;
+
+				case CommandType::Set: {
+					const SetCommand& set_command = set_commands[command.index];
+					set_command.set_func(ecs_mgr, command.id, set_command.value);
+				} break;
+
+				case CommandType::Destroy:
+					destroy_ids.emplace_back(command.id);
+					break;
+			}
+		}
+
+		if (!ids.empty()) {
+			modifier_offsets.emplace_back(static_cast<int32_t>(modifiers.size()));
+			ecs_mgr.modify(ids.data(), modifier_offsets.data(), static_cast<int32_t>(ids.size()), modifiers.data());
+		}
+
+		if (!destroy_ids.empty()) {
+			ecs_mgr.destroyEntities(destroy_ids.data(), static_cast<int32_t>(destroy_ids.size()));
+		}
+	}
+
+	for (const SetCommand& command : set_commands) {
+		command.free_func(command.value);
+	}
+}
+
+void ECSCommandBuffer::clear(void)
+{
+	const EA::Thread::AutoMutex lock(_lock);
+
+	for (const SetCommand& command : _set_commands) {
+		command.free_func(command.value);
+	}
+
+	_create_commands.clear();
+	_modify_commands.clear();
+	_set_commands.clear();
+	_destroy_commands.clear();
+	_created_entities.clear();
+	_next_order = 0;
+}
+
+EntityID ECSCommandBuffer::resolve(EntityID id) const
+{
+	if (!IsPlaceholder(id)) {
+		return id;
+	}
+
+	const int32_t created_index = FromPlaceholder(id);
+	GAFF_ASSERT(created_index < static_cast<int32_t>(_created_entities.size()));
+
+	return _created_entities[created_index];
+}
+
+const Vector<EntityID>& ECSCommandBuffer::getCreatedEntities(void) const
+{
+	return _created_entities;
+}
+
+bool ECSCommandBuffer::isEmpty(void) const
+{
+	const EA::Thread::AutoMutex lock(_lock);
+
+	return _create_commands.empty() &&
+		_modify_commands.empty() &&
+		_set_commands.empty() &&
+		_destroy_commands.empty();
+}
+
+bool ECSCommandBuffer::IsPlaceholder(EntityID id)
+{
+	return id < EntityID_None;
+}
+
+void ECSCommandBuffer::addSetCommand(EntityID id, void* value, SetFunc set_func, FreeFunc free_func)
+{
+	GAFF_ASSERT(ValidEntityID(id) || IsPlaceholder(id));
+
+	const EA::Thread::AutoMutex lock(_lock);
+	_set_commands.emplace_back(SetCommand{ set_func, free_func, value, id, _next_order++ });
+}
+
+// Placeholders count down from just below EntityID_None, so they can never collide with a real ID.
+EntityID ECSCommandBuffer::ToPlaceholder(int32_t created_index)
+{
+	return EntityID_None - 1 - created_index;
+}
+
+int32_t ECSCommandBuffer::FromPlaceholder(EntityID id)
+{
+	return EntityID_None - 1 - id;
+}
+
+NS_END
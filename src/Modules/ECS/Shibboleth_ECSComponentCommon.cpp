@@ -22,6 +22,7 @@ THE SOFTWARE.
 
 #include "Shibboleth_ECSComponentCommon.h"
 #include <Shibboleth_EngineAttributesCommon.h>
+#include <Gaff_Math.h>
 
 SHIB_ECS_SINGLE_ARG_COMPONENT_DEFINE(Shibboleth::PlayerOwner, nullptr, u8"Player")
 SHIB_ECS_SINGLE_ARG_COMPONENT_DEFINE(Shibboleth::PageSize, nullptr, u8"Memory")
@@ -200,4 +201,93 @@ PlayerOwner PlayerOwner::GetInternal(const void* component, int32_t page_index)
 	return PlayerOwner(*comp);
 }
 
+void CalculateTransforms(
+	const void* position_begin,
+	const void* rotation_begin,
+	const void* scale_begin,
+	const Gleam::Vec3& local_offset,
+	Gleam::Vec4SIMD (&out_model)[4][3])
+{
+	const Gleam::Vec4SIMD pitch = Rotation::GetPitch(rotation_begin) * Gaff::TurnsToRad;
+	const Gleam::Vec4SIMD yaw = Rotation::GetYaw(rotation_begin) * Gaff::TurnsToRad;
+	const Gleam::Vec4SIMD roll = Rotation::GetRoll(rotation_begin) * Gaff::TurnsToRad;
+
+	const Gleam::Vec4SIMD cp = glm::cos(pitch);
+	const Gleam::Vec4SIMD sp = glm::sin(pitch);
+	const Gleam::Vec4SIMD ch = glm::cos(yaw);
+	const Gleam::Vec4SIMD sh = glm::sin(yaw);
+	const Gleam::Vec4SIMD cb = glm::cos(roll);
+	const Gleam::Vec4SIMD sb = glm::sin(roll);
+
+	const Gleam::Vec4SIMD scale_x = Scale::GetX(scale_begin);
+	const Gleam::Vec4SIMD scale_y = Scale::GetY(scale_begin);
+	const Gleam::Vec4SIMD scale_z = Scale::GetZ(scale_begin);
+
+	// Same as glm::yawPitchRoll() followed by glm::scale().
+	out_model[0][0] = (ch * cb + sh * sp * sb) * scale_x;
+	out_model[0][1] = (sb * cp) * scale_x;
+	out_model[0][2] = (ch * sp * sb - sh * cb) * scale_x;
+
+	out_model[1][0] = (sh * sp * cb - ch * sb) * scale_y;
+	out_model[1][1] = (cb * cp) * scale_y;
+	out_model[1][2] = (sb * sh + ch * sp * cb) * scale_y;
+
+	out_model[2][0] = (sh * cp) * scale_z;
+	out_model[2][1] = -sp * scale_z;
+	out_model[2][2] = (ch * cp) * scale_z;
+
+	// Fold the local offset into the translation.
+	out_model[3][0] = Position::GetX(position_begin) + out_model[0][0] * local_offset.x + out_model[1][0] * local_offset.y + out_model[2][0] * local_offset.z;
+	out_model[3][1] = Position::GetY(position_begin) + out_model[0][1] * local_offset.x + out_model[1][1] * local_offset.y + out_model[2][1] * local_offset.z;
+	out_model[3][2] = Position::GetZ(position_begin) + out_model[0][2] * local_offset.x + out_model[1][2] * local_offset.y + out_model[2][2] * local_offset.z;
+}
+
+void StoreTransforms(
+	const Gleam::Vec4SIMD (&model)[4][3],
+	const Gleam::Mat4x4& pre_transform,
+	Gleam::Mat4x4* const (&out_transforms)[4])
+{
+	// Compute the whole block first, then write each lane out a column at a time.
+	Gleam::Vec4SIMD result[4][4];
+
+	for (int32_t column = 0; column < 4; ++column) {
+		for (int32_t row = 0; row < 4; ++row) {
+			result[column][row] =
+				Gleam::Vec4SIMD(pre_transform[0][row]) * model[column][0] +
+				Gleam::Vec4SIMD(pre_transform[1][row]) * model[column][1] +
+				Gleam::Vec4SIMD(pre_transform[2][row]) * model[column][2];
+		}
+	}
+
+	for (int32_t row = 0; row < 4; ++row) {
+		result[3][row] += Gleam::Vec4SIMD(pre_transform[3][row]);
+	}
+
+	for (int32_t lane = 0; lane < 4; ++lane) {
+		Gleam::Mat4x4* const out = out_transforms[lane];
+
+		if (!out) {
+			continue;
+		}
+
+		for (int32_t column = 0; column < 4; ++column) {
+			(*out)[column] = Gleam::Vec4(result[column][0][lane], result[column][1][lane], result[column][2][lane], result[column][3][lane]);
+		}
+	}
+}
+
+void CalculateTransforms(
+	const void* position_begin,
+	const void* rotation_begin,
+	const void* scale_begin,
+	const Gleam::Mat4x4& pre_transform,
+	const Gleam::Vec3& local_offset,
+	Gleam::Mat4x4* const (&out_transforms)[4])
+{
+	Gleam::Vec4SIMD model[4][3];
+
+	CalculateTransforms(position_begin, rotation_begin, scale_begin, local_offset, model);
+	StoreTransforms(model, pre_transform, out_transforms);
+}
+
 NS_END
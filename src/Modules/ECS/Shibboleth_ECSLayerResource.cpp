@@ -126,7 +126,6 @@ void ECSLayerResource::archetypeLoaded(const Vector<IResource*>&)
 
 	Gaff::Hash32 layer_name;
 	Gaff::Hash32 scene_name;
-	int32_t index = 0;
 
 	const auto& reader = *_reader_wrapper.getReader();
 
@@ -137,9 +136,8 @@ void ECSLayerResource::archetypeLoaded(const Vector<IResource*>&)
 			LogErrorResource("ECSLayerResource - 'layer' field is not a string.");
 		}
 
-		char8_t name_temp[256] = { 0 };
-		reader.readString(name_temp, sizeof(name_temp), u8"<default>");
-		layer_name = Gaff::FNV1aHash32String(name_temp);
+		const eastl::u8string_view name = reader.readStringView(u8"<default>");
+		layer_name = Gaff::FNV1aHash32T(name.data(), name.size());
 	}
 
 	{
@@ -149,37 +147,80 @@ void ECSLayerResource::archetypeLoaded(const Vector<IResource*>&)
 			LogErrorResource("ECSLayerResource - 'scene' field is not a string.");
 		}
 
-		char8_t name_temp[256] = { 0 };
-		reader.readString(name_temp, sizeof(name_temp), u8"main");
-		scene_name = Gaff::FNV1aHash32String(name_temp);
+		const eastl::u8string_view name = reader.readStringView(u8"main");
+		scene_name = Gaff::FNV1aHash32T(name.data(), name.size());
 	}
 
 	const auto objects_guard = reader.enterElementGuard(u8"objects");
 	ECSManager& ecs_mgr = GetManagerTFast<ECSManager>();
 
-	for (const auto& arch_res : _archetypes) {
+	const ProxyAllocator allocator("Resource");
+	const int32_t num_objects = static_cast<int32_t>(_archetypes.size());
+	Vector<EntityID> object_ids(static_cast<size_t>(num_objects), EntityID_None, allocator);
+	VectorMap< Gaff::Hash64, Vector<int32_t> > archetype_objects(allocator);
+
+	// Resolve every object's final archetype first, so each archetype only has its entities created once.
+	for (int32_t index = 0; index < num_objects; ++index) {
+		const ECSArchetypeResourcePtr& arch_res = _archetypes[index];
+
 		if (!arch_res->isLoaded()) {
 			continue;
 		}
 
 		const auto element_guard = reader.enterElementGuard(index);
+
+		{
+			const auto comps_guard = reader.enterElementGuard(u8"components");
+
+			if (!reader.isNull() && !reader.isObject()) {
+				LogErrorResource("ECSLayerResource - 'components' field is not an object for object at index %i.", index);
+				continue;
+			}
+		}
+
 		const auto override_guard = reader.enterElementGuard(u8"overrides");
 		Gaff::Hash64 archetype(0);
 
 		if (loadOverrides(reader, ecs_mgr, arch_res->getArchetype(), layer_name, scene_name, archetype)) {
-			const auto comps_guard = reader.enterElementGuard(u8"components");
+			auto it = archetype_objects.find(archetype);
 
-			const EntityID id = (reader.isNull()) ? ecs_mgr.createEntity(archetype) : ecs_mgr.loadEntity(archetype, reader);
-
-			if (id == EntityID_None) {
-				LogErrorResource("ECSLayerResource - Failed to create entity for object at index %i.", index);
+			if (it == archetype_objects.end()) {
+				it = archetype_objects.emplace(archetype, Vector<int32_t>(allocator)).first;
 			}
 
+			it->second.emplace_back(index);
+
 		} else {
 			LogErrorResource("ECSLayerResource - Failed to load archetype overrides for object at index %i.", index);
 		}
+	}
+
+	Vector<EntityID> ids(allocator);
+
+	for (const auto& entry : archetype_objects) {
+		const int32_t count = static_cast<int32_t>(entry.second.size());
+		ids.resize(static_cast<size_t>(count));
+
+		ecs_mgr.createEntities(entry.first, count, ids.data());
+
+		for (int32_t i = 0; i < count; ++i) {
+			object_ids[entry.second[i]] = ids[i];
+		}
+	}
+
+	for (int32_t index = 0; index < num_objects; ++index) {
+		const EntityID id = object_ids[index];
 
-		++index;
+		if (id == EntityID_None) {
+			continue;
+		}
+
+		const auto element_guard = reader.enterElementGuard(index);
+		const auto comps_guard = reader.enterElementGuard(u8"components");
+
+		if (!reader.isNull()) {
+			ecs_mgr.loadEntity(id, reader);
+		}
 	}
 
 	// Always mark succeeded, even if an object failed to load.
@@ -220,7 +261,7 @@ void ECSLayerResource::loadLayer(IFile* file, uintptr_t /*thread_id_int*/)
 
 		reader.forEachInArray([&](int32_t index) -> bool
 		{
-			char8_t archetype[256] = { 0 };
+			eastl::u8string_view archetype;
 
 			{
 				const auto guard = reader.enterElementGuard(u8"archetype");
@@ -230,11 +271,11 @@ void ECSLayerResource::loadLayer(IFile* file, uintptr_t /*thread_id_int*/)
 					return false;
 
 				} else if (!reader.isNull()) {
-					reader.readString(archetype, ARRAY_SIZE(archetype));
+					archetype = reader.readStringView();
 				}
 			}
 
-			if (archetype[0] == 0) {
+			if (archetype.empty()) {
 				_archetypes.emplace_back(res_mgr.getResourceT<ECSArchetypeResource>(ECSManager::k_empty_archetype_res_name));
 			} else {
 				_archetypes.emplace_back(res_mgr.requestResourceT<ECSArchetypeResource>(archetype));
@@ -22,10 +22,12 @@ THE SOFTWARE.
 
 #include "Shibboleth_ECSManager.h"
 #include "Shibboleth_ECSComponentCommon.h"
+#include "Shibboleth_ECSCommandBuffer.h"
 #include <Shibboleth_SerializeReaderWrapper.h>
 #include <Shibboleth_ResourceManager.h>
 #include <Shibboleth_IFileSystem.h>
 #include <Shibboleth_LogManager.h>
+#include <Shibboleth_JobPool.h>
 #include <Gaff_Function.h>
 #include <Gaff_Math.h>
 
@@ -38,8 +40,17 @@ NS_SHIBBOLETH
 
 SHIB_REFLECTION_CLASS_DEFINE(ECSManager)
 
+ECSManager::ECSManager(void)
+{
+	ProxyAllocator allocator("ECS");
+	_command_buffer.reset(SHIB_ALLOCT(ECSCommandBuffer, allocator));
+}
+
 ECSManager::~ECSManager(void)
 {
+	// Drop any commands that never got applied.
+	_command_buffer->clear();
+
 	_curr_scene = nullptr;
 
 	Vector<Gaff::Hash64> entity_hashes(ProxyAllocator("ECS"));
@@ -116,6 +127,13 @@ void ECSManager::removeArchetype(Gaff::Hash64 archetype)
 		_queries[query_index].removeArchetype(it->second.get());
 	}
 
+	// Remove any cached transitions into this archetype.
+	const EntityData* const removed_data = it->second.get();
+
+	for (auto& entry : _entity_pages) {
+		eastl::erase_if(entry.second->transitions, [removed_data](const auto& transition) -> bool { return transition.second == removed_data; });
+	}
+
 	SHIB_FREE(it->second->arch_ref, GetAllocator());
 	_entity_pages.erase(it);
 }
@@ -188,6 +206,104 @@ EntityID ECSManager::createEntity(Gaff::Hash64 archetype)
 	return id;
 }
 
+void ECSManager::createEntities(const ECSArchetype& archetype, int32_t count, EntityID* out_ids)
+{
+	createEntities(archetype.getHash(), count, out_ids);
+}
+
+void ECSManager::createEntities(Gaff::Hash64 archetype, int32_t count, EntityID* out_ids)
+{
+	GAFF_ASSERT(count >= 0 && (!count || out_ids));
+
+	if (count <= 0) {
+		return;
+	}
+
+	const EA::Thread::AutoMutex lock(_entity_page_lock);
+	const auto it = _entity_pages.find(archetype);
+	GAFF_ASSERT(it != _entity_pages.end() && it->first == archetype);
+	EntityData& data = *(it->second);
+
+	// Reuse freed IDs first, then hand out a contiguous range off the end.
+	const int32_t num_reused_ids = Gaff::Min(count, static_cast<int32_t>(_free_ids.size()));
+
+	for (int32_t i = 0; i < num_reused_ids; ++i) {
+		out_ids[i] = _free_ids.back();
+		_free_ids.pop_back();
+	}
+
+	for (int32_t i = num_reused_ids; i < count; ++i) {
+		out_ids[i] = _next_id++;
+	}
+
+	if (_next_id > static_cast<int32_t>(_entities.size())) {
+		_entities.resize(static_cast<size_t>(_next_id));
+	}
+
+	const int32_t num_entities_per_page = data.num_entities_per_page;
+	int32_t id_index = 0;
+
+	const auto assign_entity = [&](EntityPage* page, int32_t page_index, int32_t index) -> void
+	{
+		const EntityID id = out_ids[id_index++];
+		Entity& entity = _entities[id];
+
+		entity.data = &data;
+		entity.page = page;
+		entity.index = index;
+
+		data.entity_ids[page_index * num_entities_per_page + index] = id;
+	};
+
+	// Fill holes left behind by destroyed entities.
+	while (id_index < count && !data.free_indices.empty()) {
+		const int32_t global_index = data.free_indices.back();
+		const int32_t page_index = global_index / num_entities_per_page;
+		EntityPage* const page = data.pages[page_index].get();
+
+		data.free_indices.pop_back();
+		++page->num_entities;
+
+		assign_entity(page, page_index, global_index - page_index * num_entities_per_page);
+	}
+
+	// Fill the unused tail of the last page.
+	if (id_index < count && !data.pages.empty()) {
+		const int32_t page_index = static_cast<int32_t>(data.pages.size()) - 1;
+		EntityPage* const page = data.pages.back().get();
+		const int32_t num_to_add = Gaff::Min(count - id_index, num_entities_per_page - page->next_index);
+
+		for (int32_t i = 0; i < num_to_add; ++i) {
+			assign_entity(page, page_index, page->next_index + i);
+		}
+
+		page->num_entities += num_to_add;
+		page->next_index += num_to_add;
+	}
+
+	// Everything else goes into freshly constructed pages.
+	if (id_index < count) {
+		const int32_t num_new_pages = (count - id_index + num_entities_per_page - 1) / num_entities_per_page;
+		data.pages.reserve(data.pages.size() + static_cast<size_t>(num_new_pages));
+
+		for (int32_t i = 0; i < num_new_pages; ++i) {
+			const int32_t page_index = static_cast<int32_t>(data.pages.size());
+			EntityPage* const page = allocatePage(data);
+			const int32_t num_to_add = Gaff::Min(count - id_index, num_entities_per_page);
+
+			for (int32_t j = 0; j < num_to_add; ++j) {
+				assign_entity(page, page_index, j);
+			}
+
+			page->num_entities = num_to_add;
+			page->next_index = num_to_add;
+		}
+	}
+
+	data.num_entities += count;
+	data.arch_ref->addRef(count);
+}
+
 EntityID ECSManager::loadEntity(const ECSArchetype& archetype, const ISerializeReader& reader)
 {
 	if (!reader.isObject()) {
@@ -198,13 +314,7 @@ EntityID ECSManager::loadEntity(const ECSArchetype& archetype, const ISerializeR
 	const EntityID id = createEntity(archetype);
 
 	if (ValidEntityID(id)) {
-		archetype.loadDefaults(*this, id);
-
-		reader.forEachInObject([&](const char8_t* component) -> bool {
-			const Gaff::Hash64 comp_hash = Gaff::FNV1aHash64String(component);
-			archetype.loadComponent(*this, id, reader, comp_hash);
-			return false;
-		});
+		loadEntity(id, reader);
 	}
 
 	return id;
@@ -215,11 +325,35 @@ EntityID ECSManager::loadEntity(Gaff::Hash64 archetype_hash, const ISerializeRea
 	return loadEntity(getArchetype(archetype_hash), reader);
 }
 
+bool ECSManager::loadEntity(EntityID id, const ISerializeReader& reader)
+{
+	if (!reader.isObject()) {
+		LogErrorDefault("Malformed entity. Entity is not an object.");
+		return false;
+	}
+
+	const ECSArchetype& archetype = getArchetype(id);
+	archetype.loadDefaults(*this, id);
+
+	reader.forEachInObject([&](const char8_t* component) -> bool {
+		const Gaff::Hash64 comp_hash = Gaff::FNV1aHash64String(component);
+		archetype.loadComponent(*this, id, reader, comp_hash);
+		return false;
+	});
+
+	return true;
+}
+
 void ECSManager::destroyEntity(EntityID id)
 {
 	destroyEntityInternal(id, true);
 }
 
+void ECSManager::destroyEntities(const EntityID* ids, int32_t count)
+{
+	destroyEntitiesInternal(ids, count, true);
+}
+
 const void* ECSManager::getComponentShared(Gaff::Hash64 archetype, const Refl::IReflectionDefinition& component) const
 {
 	return const_cast<ECSManager*>(this)->getComponentShared(archetype, component);
@@ -382,6 +516,19 @@ int32_t ECSManager::getNumEntities(const ECSQueryResult& query_result) const
 	return reinterpret_cast<const EntityData*>(query_result.entity_data)->num_entities;
 }
 
+int32_t ECSManager::getEntityCapacity(const ECSQueryResult& query_result) const
+{
+	return static_cast<int32_t>(reinterpret_cast<const EntityData*>(query_result.entity_data)->entity_ids.size());
+}
+
+EntityID ECSManager::getEntityID(const ECSQueryResult& query_result, int32_t entity_index) const
+{
+	const EntityData* const data = reinterpret_cast<const EntityData*>(query_result.entity_data);
+	GAFF_ASSERT(entity_index < static_cast<int32_t>(data->entity_ids.size()));
+
+	return data->entity_ids[entity_index];
+}
+
 void ECSManager::registerQuery(ECSQuery&& query)
 {
 	ECSQuery& new_query = _queries.emplace_back(std::move(query));
@@ -415,6 +562,11 @@ const ECSArchetype& ECSManager::getEmptyArchetype(void) const
 	return getArchetype(Gaff::k_init_hash64);
 }
 
+ECSCommandBuffer& ECSManager::getCommandBuffer(void)
+{
+	return *_command_buffer;
+}
+
 void ECSManager::destroyEntityInternal(EntityID id, bool change_ref_count)
 {
 	const EA::Thread::AutoMutex lock(_entity_page_lock);
@@ -470,13 +622,152 @@ void ECSManager::destroyEntityInternal(EntityID id, bool change_ref_count)
 	}
 }
 
-void ECSManager::migrate(EntityID id, Gaff::Hash64 new_archetype)
+void ECSManager::destroyEntitiesInternal(const EntityID* ids, int32_t count, bool change_ref_count)
+{
+	GAFF_ASSERT(count >= 0 && (!count || ids));
+
+	if (count <= 0) {
+		return;
+	}
+
+	struct DestroyedEntityData final
+	{
+		EntityData* data;
+		int32_t num_destroyed;
+	};
+
+	const EA::Thread::AutoMutex lock(_entity_page_lock);
+
+	Vector<DestroyedEntityData> destroyed_data(ProxyAllocator::GetFrame());
+	DestroyedEntityData* curr_data = nullptr;
+	EntityPage* curr_page = nullptr;
+	int32_t page_index = -1;
+
+	for (int32_t i = 0; i < count; ++i) {
+		const EntityID id = ids[i];
+		GAFF_ASSERT(ValidEntityID(id) && id < _next_id && _entities[id].data);
+
+		Entity& entity = _entities[id];
+		EntityData& data = *entity.data;
+
+		if (!curr_data || curr_data->data != &data) {
+			const auto it = Gaff::Find(destroyed_data, &data, [](const DestroyedEntityData& lhs, const EntityData* rhs) -> bool { return lhs.data == rhs; });
+
+			if (it == destroyed_data.end()) {
+				curr_data = &destroyed_data.emplace_back(DestroyedEntityData{ &data, 0 });
+			} else {
+				curr_data = it;
+			}
+		}
+
+		// Batches tend to be grouped by page, so only look up the page index when it changes.
+		if (entity.page != curr_page) {
+			const auto it = Gaff::Find(data.pages, entity.page, [](const auto& lhs, const EntityPage* rhs) -> bool { return lhs.get() == rhs; });
+			page_index = static_cast<int32_t>(eastl::distance(data.pages.begin(), it));
+			curr_page = entity.page;
+		}
+
+		const int32_t global_index = entity.index + page_index * data.num_entities_per_page;
+		const int32_t entity_offset = (entity.index / 4) * data.archetype.size() * 4;
+		void* const comp_data = reinterpret_cast<int8_t*>(entity.page) + sizeof(EntityPage) + entity_offset;
+
+		data.archetype.destroyEntity(id, comp_data, entity.index % 4);
+
+		--data.num_entities;
+		--entity.page->num_entities;
+
+		data.free_indices.emplace_back(global_index);
+		data.entity_ids[global_index] = -1;
+
+		entity.page = nullptr;
+		entity.data = nullptr;
+		entity.index = -1;
+
+		_free_ids.emplace_back(id);
+		++curr_data->num_destroyed;
+	}
+
+	// Empty pages are only released once the whole batch is done.
+	for (DestroyedEntityData& entry : destroyed_data) {
+		removeEmptyPages(*entry.data);
+	}
+
+	// Releasing the last reference removes the archetype, so do this last.
+	if (change_ref_count) {
+		for (DestroyedEntityData& entry : destroyed_data) {
+			entry.data->arch_ref->release(entry.num_destroyed);
+		}
+	}
+}
+
+void ECSManager::migrate(const EntityID* ids, int32_t count, EntityData& data, Vector<ArchetypeReference*>& old_arch_refs)
+{
+	const EA::Thread::AutoMutex lock(_entity_page_lock);
+
+	Vector<ECSArchetype::EntityCopy> entity_copies(ProxyAllocator::GetFrame());
+	Vector<Entity> new_entities(ProxyAllocator::GetFrame());
+
+	entity_copies.reserve(static_cast<size_t>(count));
+	old_arch_refs.reserve(old_arch_refs.size() + static_cast<size_t>(count));
+	new_entities.reserve(static_cast<size_t>(count));
+
+	for (int32_t i = 0; i < count; ++i) {
+		const EntityID id = ids[i];
+		GAFF_ASSERT(ValidEntityID(id) && id < _next_id && _entities[id].data);
+
+		const Entity& entity = _entities[id];
+
+		const int32_t global_index = allocateIndex(data, id);
+		const int32_t page = global_index / data.num_entities_per_page;
+		const int32_t new_index = global_index - page * data.num_entities_per_page;
+
+		const int32_t old_entity_offset = (entity.index / 4) * entity.data->archetype.size() * 4;
+		const int32_t new_entity_offset = (new_index / 4) * data.archetype.size() * 4;
+
+		EntityPage* const new_page = data.pages[page].get();
+		const void* const old_data = reinterpret_cast<const int8_t*>(entity.page) + sizeof(EntityPage) + old_entity_offset;
+		void* const new_data = reinterpret_cast<int8_t*>(new_page) + sizeof(EntityPage) + new_entity_offset;
+
+		entity_copies.emplace_back(ECSArchetype::EntityCopy{ old_data, entity.index % 4, new_data, new_index % 4 });
+		old_arch_refs.emplace_back(entity.data->arch_ref);
+		new_entities.emplace_back(Entity{ &data, new_page, new_index });
+	}
+
+	// Copy runs of entities that come from the same archetype together.
+	for (int32_t begin = 0; begin < count;) {
+		const EntityData* const old_entity_data = _entities[ids[begin]].data;
+		int32_t end = begin + 1;
+
+		while (end < count && _entities[ids[end]].data == old_entity_data) {
+			++end;
+		}
+
+		data.archetype.copy(old_entity_data->archetype, entity_copies.data() + begin, end - begin);
+		begin = end;
+	}
+
+	// Remove the old entities from their old archetypes.
+	destroyEntitiesInternal(ids, count, false);
+
+	_free_ids.resize(_free_ids.size() - static_cast<size_t>(count)); // We still want to use these IDs.
+
+	for (int32_t i = 0; i < count; ++i) {
+		_entities[ids[i]] = new_entities[i];
+	}
+
+	data.arch_ref->addRef(count);
+}
+
+void ECSManager::migrate(EntityID id, EntityData& data)
 {
 	const EA::Thread::AutoMutex lock(_entity_page_lock);
-	GAFF_ASSERT(_entity_pages.find(new_archetype) != _entity_pages.end());
-	EntityData& data = *_entity_pages[new_archetype];
 	Entity& entity = _entities[id];
 
+	// Component change didn't result in a new archetype.
+	if (entity.data == &data) {
+		return;
+	}
+
 	const int32_t global_index = allocateIndex(data, id);
 	const int32_t page = global_index / data.num_entities_per_page;
 	const int32_t new_index = global_index - page * data.num_entities_per_page;
@@ -537,6 +828,21 @@ int32_t ECSManager::allocateIndex(EntityData& data, EntityID id)
 	}
 
 	// Didn't find a free index. Need to allocate a new page.
+	EntityPage* const page = allocatePage(data);
+
+	page->num_entities = 1;
+	page->next_index = 1;
+
+	++data.num_entities;
+
+	const int32_t global_index = static_cast<int32_t>(data.pages.size() - 1) * data.num_entities_per_page;
+	data.entity_ids[global_index] = id;
+
+	return global_index;
+}
+
+ECSManager::EntityPage* ECSManager::allocatePage(EntityData& data)
+{
 	ProxyAllocator allocator("ECS");
 	EntityPage* const page = reinterpret_cast<EntityPage*>(SHIB_ALLOC_ALIGNED(data.page_size, 16, allocator));
 
@@ -544,26 +850,195 @@ int32_t ECSManager::allocateIndex(EntityData& data, EntityID id)
 
 	data.archetype.constructPage(page + 1, data.num_entities_per_page);
 
-	page->num_entities = 1;
-	page->next_index = 1;
+	page->num_entities = 0;
+	page->next_index = 0;
 
 	data.pages.emplace_back(page);
-	++data.num_entities;
-
-	const int32_t global_index = static_cast<int32_t>(data.pages.size() - 1) * data.num_entities_per_page;
 	data.entity_ids.resize(data.entity_ids.size() + static_cast<size_t>(data.num_entities_per_page), -1);
-	data.entity_ids[global_index] = id;
 
-	return global_index;
+	return page;
+}
+
+void ECSManager::removeEmptyPages(EntityData& data)
+{
+	const int32_t num_entities_per_page = data.num_entities_per_page;
+	const int32_t num_pages = static_cast<int32_t>(data.pages.size());
+	Vector<int32_t> page_remap(ProxyAllocator::GetFrame());
+	int32_t num_kept_pages = 0;
+
+	page_remap.resize(static_cast<size_t>(num_pages), -1);
+
+	// Compact the remaining pages and their entity IDs towards the front.
+	for (int32_t i = 0; i < num_pages; ++i) {
+		if (data.pages[i]->num_entities == 0) {
+			data.pages[i].reset();
+			continue;
+		}
+
+		if (i != num_kept_pages) {
+			const auto ids_begin = data.entity_ids.begin() + i * num_entities_per_page;
+
+			eastl::copy(ids_begin, ids_begin + num_entities_per_page, data.entity_ids.begin() + num_kept_pages * num_entities_per_page);
+			data.pages[num_kept_pages] = std::move(data.pages[i]);
+		}
+
+		page_remap[i] = num_kept_pages++;
+	}
+
+	if (num_kept_pages == num_pages) {
+		return;
+	}
+
+	data.pages.resize(static_cast<size_t>(num_kept_pages));
+	data.entity_ids.resize(static_cast<size_t>(num_kept_pages * num_entities_per_page));
+
+	// Drop free indices that were on removed pages and shift the rest to where their page moved.
+	int32_t num_free_indices = 0;
+
+	for (int32_t free_index : data.free_indices) {
+		const int32_t new_page_index = page_remap[free_index / num_entities_per_page];
+
+		if (new_page_index > -1) {
+			data.free_indices[num_free_indices++] = new_page_index * num_entities_per_page + free_index % num_entities_per_page;
+		}
+	}
+
+	data.free_indices.resize(static_cast<size_t>(num_free_indices));
+}
+
+void ECSManager::modify(const EntityID* ids, int32_t count, ArchetypeModifier modifier)
+{
+	GAFF_ASSERT(count >= 0 && (!count || ids));
+
+	if (count <= 0) {
+		return;
+	}
+
+	const EA::Thread::AutoMutex lock(_entity_page_lock);
+	const Gaff::Hash64 transition = modifier.transition;
+
+	Vector<EntityMigration> migrations(ProxyAllocator::GetFrame());
+	migrations.reserve(static_cast<size_t>(count));
+
+	for (int32_t i = 0; i < count; ++i) {
+		const EntityID id = ids[i];
+		GAFF_ASSERT(ValidEntityID(id) && id < _next_id && _entities[id].data);
+
+		EntityData* const old_data = _entities[id].data;
+		EntityData& new_data = getTransition(*old_data, transition, [modifier](const ECSArchetype& base_archetype, ECSArchetype& archetype) -> void
+		{
+			BuildModifiedArchetype(base_archetype, archetype, modifier);
+		});
+
+		// Nothing to do, entity is already in the destination archetype.
+		if (&new_data == old_data) {
+			continue;
+		}
+
+		migrations.emplace_back(EntityMigration{ &new_data, old_data, id });
+	}
+
+	migrate(migrations);
+}
+
+void ECSManager::modify(const EntityID* ids, const int32_t* modifier_offsets, int32_t count, const ArchetypeModifier* modifiers)
+{
+	GAFF_ASSERT(count >= 0 && (!count || (ids && modifier_offsets && modifiers)));
+
+	if (count <= 0) {
+		return;
+	}
+
+	const EA::Thread::AutoMutex lock(_entity_page_lock);
+
+	Vector<EntityMigration> migrations(ProxyAllocator::GetFrame());
+	migrations.reserve(static_cast<size_t>(count));
+
+	for (int32_t i = 0; i < count; ++i) {
+		const EntityID id = ids[i];
+		GAFF_ASSERT(ValidEntityID(id) && id < _next_id && _entities[id].data);
+
+		EntityData* const old_data = _entities[id].data;
+		EntityData* new_data = old_data;
+
+		// Walk the transitions without moving the entity. Only the final archetype is migrated to.
+		for (int32_t j = modifier_offsets[i]; j < modifier_offsets[i + 1]; ++j) {
+			const ArchetypeModifier modifier = modifiers[j];
+
+			new_data = &getTransition(*new_data, modifier.transition, [modifier](const ECSArchetype& base_archetype, ECSArchetype& archetype) -> void
+			{
+				BuildModifiedArchetype(base_archetype, archetype, modifier);
+			});
+		}
+
+		// Nothing to do, entity ended up back in the archetype it started in.
+		if (new_data == old_data) {
+			continue;
+		}
+
+		migrations.emplace_back(EntityMigration{ new_data, old_data, id });
+	}
+
+	migrate(migrations);
+}
+
+void ECSManager::migrate(Vector<EntityMigration>& migrations)
+{
+	eastl::sort(migrations.begin(), migrations.end(), [](const EntityMigration& lhs, const EntityMigration& rhs) -> bool
+	{
+		return (lhs.new_data == rhs.new_data) ? lhs.old_data < rhs.old_data : lhs.new_data < rhs.new_data;
+	});
+
+	Vector<ArchetypeReferencePtr> new_arch_refs(ProxyAllocator::GetFrame());
+	Vector<ArchetypeReference*> old_arch_refs(ProxyAllocator::GetFrame());
+	Vector<EntityID> migrate_ids(ProxyAllocator::GetFrame());
+	old_arch_refs.reserve(migrations.size());
+	migrate_ids.reserve(migrations.size());
+
+	// Destinations came out of the transition cache as raw pointers. Hold them until the whole batch is done.
+	for (const EntityMigration& migration : migrations) {
+		if (new_arch_refs.empty() || new_arch_refs.back().get() != migration.new_data->arch_ref) {
+			new_arch_refs.emplace_back(migration.new_data->arch_ref);
+		}
+	}
+
+	for (int32_t begin = 0; begin < static_cast<int32_t>(migrations.size());) {
+		EntityData* const new_data = migrations[begin].new_data;
+		int32_t end = begin;
+
+		migrate_ids.clear();
+
+		while (end < static_cast<int32_t>(migrations.size()) && migrations[end].new_data == new_data) {
+			migrate_ids.emplace_back(migrations[end].id);
+			++end;
+		}
+
+		migrate(migrate_ids.data(), static_cast<int32_t>(migrate_ids.size()), *new_data, old_arch_refs);
+		begin = end;
+	}
+
+	// Releasing the last reference removes the archetype. A later group may still be migrating into it, so do this last.
+	for (ArchetypeReference* arch_ref : old_arch_refs) {
+		arch_ref->release();
+	}
 }
 
 ArchetypeReference* ECSManager::modifyInternal(EntityID& id, ArchetypeModifier modifier)
 {
+	const EA::Thread::AutoMutex lock(_entity_page_lock);
 	GAFF_ASSERT(id < _next_id && _entities[id].data);
 
-	const ECSArchetype& base_archetype = getArchetype(id);
-	ECSArchetype archetype;
+	EntityData& data = getTransition(*_entities[id].data, modifier.transition, [modifier](const ECSArchetype& base_archetype, ECSArchetype& archetype) -> void
+	{
+		BuildModifiedArchetype(base_archetype, archetype, modifier);
+	});
+
+	migrate(id, data);
+	return data.arch_ref;
+}
 
+void ECSManager::BuildModifiedArchetype(const ECSArchetype& base_archetype, ECSArchetype& archetype, ArchetypeModifier modifier)
+{
 	archetype.copy(base_archetype);
 
 	if (modifier.removeShared) {
@@ -583,11 +1058,22 @@ ArchetypeReference* ECSManager::modifyInternal(EntityID& id, ArchetypeModifier m
 	}
 
 	archetype.finalize(base_archetype);
+}
+
+void ECSManager::runParallelIterateJobs(ParallelIterateChunk* chunks, int32_t num_chunks, void (*job_func)(uintptr_t, void*))
+{
+	Vector<Gaff::JobData> jobs(static_cast<size_t>(num_chunks), ProxyAllocator::GetFrame());
+
+	for (int32_t i = 0; i < num_chunks; ++i) {
+		jobs[i].job_func = job_func;
+		jobs[i].job_data = chunks + i;
+	}
 
-	ArchetypeReference* const arch_ref = addArchetypeInternal(std::move(archetype));
-	migrate(id, archetype.getHash());
+	JobPool& job_pool = GetApp().getJobPool();
+	Gaff::Counter counter = 0;
 
-	return arch_ref;
+	job_pool.addJobs(jobs.data(), num_chunks, counter);
+	job_pool.helpWhileWaiting(counter);
 }
 
 ArchetypeReference* ECSManager::addArchetypeInternal(ECSArchetype&& archetype)
@@ -57,20 +57,26 @@ void ECSSceneResource::loadScene(const ISerializeReader& reader)
 {
 	ResourceManager& res_mgr = GetManagerTFast<ResourceManager>();
 
-	reader.forEachInArray([&](int32_t) -> bool
+	reader.forEachInArray([&](int32_t index) -> bool
 	{
-		char8_t name[256];
-		char8_t path[256];
+		eastl::u8string_view name;
+		eastl::u8string_view path;
 		bool delay_load = false;
 
 		{
 			const auto guard = reader.enterElementGuard(u8"name");
-			reader.readString(name, ARRAY_SIZE(name));
+			name = reader.readStringView(u8"");
 		}
 
 		{
 			const auto guard = reader.enterElementGuard(u8"layer_file");
-			reader.readString(path, ARRAY_SIZE(path));
+
+			if (!reader.isString()) {
+				LogErrorResource("Failed to load layer at index %i in scene '%s'. 'layer_file' is not a string.", index, getFilePath().getBuffer());
+				return false;
+			}
+
+			path = reader.readStringView();
 		}
 
 		{
@@ -80,7 +86,7 @@ void ECSSceneResource::loadScene(const ISerializeReader& reader)
 
 		_layers.emplace_back(LayerData{
 			res_mgr.requestResourceT<ECSLayerResource>(path, delay_load),
-			HashString64<>(name),
+			HashString64<>(name.data(), name.size()),
 		});
 
 		return false;
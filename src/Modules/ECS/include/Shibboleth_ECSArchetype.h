@@ -37,6 +37,14 @@ class ECSArchetype final
 	GAFF_NO_COPY(ECSArchetype);
 
 public:
+	struct EntityCopy final
+	{
+		const void* old_data;
+		int32_t old_index;
+		void* new_data;
+		int32_t new_index;
+	};
+
 	template <class T>
 	bool removeShared(void)
 	{
@@ -150,6 +158,9 @@ public:
 		int32_t new_index
 	);
 
+	// Copies a batch of entities that all come from old_archetype, one component at a time.
+	void copy(const ECSArchetype& old_archetype, const EntityCopy* entity_copies, int32_t count);
+
 	int32_t getComponentSharedOffset(Gaff::Hash64 component) const;
 	int32_t getComponentOffset(Gaff::Hash64 component) const;
 
@@ -261,7 +272,9 @@ public:
 	const ECSArchetype& getArchetype(void) const;
 	Gaff::Hash64 getArchetypeHash(void) const;
 
+	void addRef(int32_t count) const;
 	void addRef(void) const;
+	void release(int32_t count) const;
 	void release(void) const;
 	int32_t getRefCount(void) const;
 
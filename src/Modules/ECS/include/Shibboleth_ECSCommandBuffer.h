@@ -0,0 +1,169 @@
+/************************************************************************************
+Copyright (C) 2022 by Nicholas LaCroix
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+************************************************************************************/
+
+#pragma once
+
+#include "Shibboleth_ECSManager.h"
+#include <eathread/eathread_mutex.h>
+
+NS_SHIBBOLETH
+
+// Records structural changes from any thread without touching the ECSManager.
+// apply() plays them back in batches. Entities are created first, grouped by archetype.
+// Everything else happens in the order it was recorded for any one entity. Back to back adds/removes
+// on an entity are collapsed, so it moves straight to its final archetype, and entities are batched by
+// that final archetype. Commands recorded for an entity after it is destroyed are dropped.
+class ECSCommandBuffer final
+{
+public:
+	template <class... Components>
+	void removeSharedComponents(EntityID id)
+	{
+		modify(id, ECSManager::RemoveSharedComponentsModifier<Components...>());
+	}
+
+	template <class... Components>
+	void addSharedComponents(EntityID id)
+	{
+		modify(id, ECSManager::AddSharedComponentsModifier<Components...>());
+	}
+
+	template <class... Components>
+	void removeComponents(EntityID id)
+	{
+		modify(id, ECSManager::RemoveComponentsModifier<Components...>());
+	}
+
+	template <class... Components>
+	void addComponents(EntityID id)
+	{
+		modify(id, ECSManager::AddComponentsModifier<Components...>());
+	}
+
+	template <class T, class Value>
+	void set(EntityID id, const Value& value)
+	{
+		ProxyAllocator allocator("ECS");
+		Value* const value_copy = SHIB_ALLOCT(Value, allocator, value);
+
+		addSetCommand(id, value_copy, &SetValue<T, Value>, &FreeValue<Value>);
+	}
+
+	~ECSCommandBuffer(void);
+
+	// Returns a placeholder ID. It can be passed to this buffer's other commands before apply() is called.
+	// Use resolve() after apply() to get the real ID.
+	EntityID createEntity(Gaff::Hash64 archetype);
+	void destroyEntity(EntityID id);
+	void modify(EntityID id, ECSManager::ArchetypeModifier modifier);
+
+	void apply(ECSManager& ecs_mgr);
+	void clear(void);
+
+	// Maps a placeholder from the last apply() to its real ID. Real IDs are returned unchanged.
+	EntityID resolve(EntityID id) const;
+
+	// In the order createEntity() was called.
+	const Vector<EntityID>& getCreatedEntities(void) const;
+	bool isEmpty(void) const;
+
+	static bool IsPlaceholder(EntityID id);
+
+private:
+	using SetFunc = void (*)(ECSManager&, EntityID, const void*);
+	using FreeFunc = void (*)(void*);
+
+	enum class CommandType
+	{
+		Modify,
+		Set,
+		Destroy
+	};
+
+	struct CreateCommand final
+	{
+		Gaff::Hash64 archetype;
+		int32_t created_index;
+	};
+
+	struct ModifyCommand final
+	{
+		ECSManager::ArchetypeModifier modifier;
+		EntityID id;
+		int32_t order;
+	};
+
+	struct SetCommand final
+	{
+		SetFunc set_func;
+		FreeFunc free_func;
+		void* value;
+		EntityID id;
+		int32_t order;
+	};
+
+	struct DestroyCommand final
+	{
+		EntityID id;
+		int32_t order;
+	};
+
+	// Used by apply() to put every command touching an entity back in recording order.
+	struct CommandRef final
+	{
+		EntityID id;
+		int32_t order;
+		int32_t step;
+		int32_t index;
+		CommandType type;
+	};
+
+	mutable EA::Thread::Mutex _lock;
+
+	Vector<CreateCommand> _create_commands{ ProxyAllocator("ECS") };
+	Vector<ModifyCommand> _modify_commands{ ProxyAllocator("ECS") };
+	Vector<SetCommand> _set_commands{ ProxyAllocator("ECS") };
+	Vector<DestroyCommand> _destroy_commands{ ProxyAllocator("ECS") };
+	int32_t _next_order = 0;
+
+	Vector<EntityID> _created_entities{ ProxyAllocator("ECS") };
+
+	void addSetCommand(EntityID id, void* value, SetFunc set_func, FreeFunc free_func);
+
+	static EntityID ToPlaceholder(int32_t created_index);
+	static int32_t FromPlaceholder(EntityID id);
+
+	template <class T, class Value>
+	static void SetValue(ECSManager& ecs_mgr, EntityID id, const void* value)
+	{
+		T::Set(ecs_mgr, id, *reinterpret_cast<const Value*>(value));
+	}
+
+	template <class Value>
+	static void FreeValue(void* value)
+	{
+		ProxyAllocator allocator("ECS");
+		SHIB_FREET(reinterpret_cast<Value*>(value), allocator);
+	}
+};
+
+NS_END
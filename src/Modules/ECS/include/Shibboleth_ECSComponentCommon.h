@@ -68,6 +68,36 @@ SHIB_ECS_SINGLE_ARG_COMPONENT_DECLARE_WITH_DEFAULT(PageSize, int32_t, ECSCompone
 SHIB_ECS_SINGLE_ARG_COMPONENT_DECLARE(Scene, Gaff::Hash32, ECSComponentBaseShared)
 SHIB_ECS_SINGLE_ARG_COMPONENT_DECLARE(Layer, Gaff::Hash32, ECSComponentBaseShared)
 
+
+// Calculates model * translate(local_offset) for a block of 4 entities, reading
+// Position/Rotation/Scale straight from their page data. Each SIMD lane is a different entity.
+// Output is indexed [column][row]. The bottom row is always (0, 0, 0, 1), so it is omitted.
+void CalculateTransforms(
+	const void* position_begin,
+	const void* rotation_begin,
+	const void* scale_begin,
+	const Gleam::Vec3& local_offset,
+	Gleam::Vec4SIMD (&out_model)[4][3]
+);
+
+// Writes pre_transform * model for each lane of a block produced by CalculateTransforms().
+// Null entries in out_transforms are skipped, which is how empty or culled slots are handled.
+void StoreTransforms(
+	const Gleam::Vec4SIMD (&model)[4][3],
+	const Gleam::Mat4x4& pre_transform,
+	Gleam::Mat4x4* const (&out_transforms)[4]
+);
+
+// Calculates pre_transform * model * translate(local_offset) for a block of 4 entities.
+void CalculateTransforms(
+	const void* position_begin,
+	const void* rotation_begin,
+	const void* scale_begin,
+	const Gleam::Mat4x4& pre_transform,
+	const Gleam::Vec3& local_offset,
+	Gleam::Mat4x4* const (&out_transforms)[4]
+);
+
 NS_END
 
 SHIB_REFLECTION_DECLARE(Shibboleth::PlayerOwner)
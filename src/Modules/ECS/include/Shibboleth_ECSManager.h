@@ -27,13 +27,34 @@ THE SOFTWARE.
 #include "Shibboleth_ECSEntity.h"
 #include "Shibboleth_ECSQuery.h"
 #include <Shibboleth_IManager.h>
+#include <Gaff_Math.h>
 #include <eathread/eathread_mutex.h>
 
 NS_SHIBBOLETH
 
+class ECSCommandBuffer;
 class ECSQuery;
 class IFile;
 
+enum class ArchetypeTransitionOp
+{
+	RemoveShared,
+	AddShared,
+	Remove,
+	Add
+};
+
+// Keys the archetype transition cache. Built from the components' reflection hashes rather than
+// helper function addresses, which change when the module that instantiated them is reloaded.
+template <class... Components>
+Gaff::Hash64 ArchetypeTransitionHash(ArchetypeTransitionOp op)
+{
+	Gaff::Hash64 hash = Gaff::FNV1aHash64T(op);
+	((hash = Gaff::FNV1aHash64T(Refl::Reflection<Components>::GetHash(), hash)), ...);
+
+	return hash;
+}
+
 template <class First, class... Rest>
 void RemoveSharedComponentHelper(ECSArchetype& archetype)
 {
@@ -85,8 +106,49 @@ public:
 		void (*addShared)(ECSArchetype&);
 		void (*remove)(ECSArchetype&);
 		void (*add)(ECSArchetype&);
+
+		// Identifies the modification in the transition cache. See ArchetypeTransitionHash().
+		Gaff::Hash64 transition;
+
+		bool operator==(const ArchetypeModifier& rhs) const = default;
 	};
 
+	template <class... Components>
+	static ArchetypeModifier RemoveSharedComponentsModifier(void)
+	{
+		return ArchetypeModifier{
+			&RemoveSharedComponentHelper<Components...>, nullptr, nullptr, nullptr,
+			ArchetypeTransitionHash<Components...>(ArchetypeTransitionOp::RemoveShared)
+		};
+	}
+
+	template <class... Components>
+	static ArchetypeModifier AddSharedComponentsModifier(void)
+	{
+		return ArchetypeModifier{
+			nullptr, &AddSharedComponentHelper<Components...>, nullptr, nullptr,
+			ArchetypeTransitionHash<Components...>(ArchetypeTransitionOp::AddShared)
+		};
+	}
+
+	template <class... Components>
+	static ArchetypeModifier RemoveComponentsModifier(void)
+	{
+		return ArchetypeModifier{
+			nullptr, nullptr, &RemoveComponentHelper<Components...>, nullptr,
+			ArchetypeTransitionHash<Components...>(ArchetypeTransitionOp::Remove)
+		};
+	}
+
+	template <class... Components>
+	static ArchetypeModifier AddComponentsModifier(void)
+	{
+		return ArchetypeModifier{
+			nullptr, nullptr, nullptr, &AddComponentHelper<Components...>,
+			ArchetypeTransitionHash<Components...>(ArchetypeTransitionOp::Add)
+		};
+	}
+
 	template <class T>
 	const T* getComponentShared(Gaff::Hash64 archetype) const
 	{
@@ -241,6 +303,15 @@ public:
 		modifyInternal(id, modifier);
 	}
 
+	// Applies the same modification to every entity in ids. Entities are grouped by their
+	// destination archetype and migrated together under a single lock.
+	void modify(const EntityID* ids, int32_t count, ArchetypeModifier modifier);
+
+	// Applies a chain of modifications to each entity, moving it straight to its final archetype.
+	// ids[i] gets modifiers[modifier_offsets[i]] through modifiers[modifier_offsets[i + 1] - 1], in that order.
+	// modifier_offsets has count + 1 entries.
+	void modify(const EntityID* ids, const int32_t* modifier_offsets, int32_t count, const ArchetypeModifier* modifiers);
+
 	template <class T1, class T2, class T3, class T4, class T5, class Callback>
 	void iterate(
 		const ECSQueryResult& query_result1,
@@ -294,6 +365,66 @@ public:
 		iterateInternal<Callback, T>(std::forward<Callback>(callback), query_results);
 	}
 
+	// Splits the entities into chunks of grain_size and runs them as jobs, helping out until they're all done.
+	// Callback is called from multiple threads at once. A grain_size of zero uses one page of entities per job.
+	template <class T1, class T2, class T3, class T4, class T5, class Callback>
+	void parallelIterate(
+		const ECSQueryResult& query_result1,
+		const ECSQueryResult& query_result2,
+		const ECSQueryResult& query_result3,
+		const ECSQueryResult& query_result4,
+		const ECSQueryResult& query_result5,
+		Callback&& callback,
+		int32_t grain_size = 0)
+	{
+		const ECSQueryResult* query_results[] = { &query_result1, &query_result2, &query_result3, &query_result4, &query_result5 };
+		parallelIterateInternal<Callback, T1, T2, T3, T4, T5>(callback, query_results, grain_size);
+	}
+
+	template <class T1, class T2, class T3, class T4, class Callback>
+	void parallelIterate(
+		const ECSQueryResult& query_result1,
+		const ECSQueryResult& query_result2,
+		const ECSQueryResult& query_result3,
+		const ECSQueryResult& query_result4,
+		Callback&& callback,
+		int32_t grain_size = 0)
+	{
+		const ECSQueryResult* query_results[] = { &query_result1, &query_result2, &query_result3, &query_result4 };
+		parallelIterateInternal<Callback, T1, T2, T3, T4>(callback, query_results, grain_size);
+	}
+
+	template <class T1, class T2, class T3, class Callback>
+	void parallelIterate(
+		const ECSQueryResult& query_result1,
+		const ECSQueryResult& query_result2,
+		const ECSQueryResult& query_result3,
+		Callback&& callback,
+		int32_t grain_size = 0)
+	{
+		const ECSQueryResult* query_results[] = { &query_result1, &query_result2, &query_result3 };
+		parallelIterateInternal<Callback, T1, T2, T3>(callback, query_results, grain_size);
+	}
+
+	template <class T1, class T2, class Callback>
+	void parallelIterate(
+		const ECSQueryResult& query_result1,
+		const ECSQueryResult& query_result2,
+		Callback&& callback,
+		int32_t grain_size = 0)
+	{
+		const ECSQueryResult* query_results[] = { &query_result1, &query_result2 };
+		parallelIterateInternal<Callback, T1, T2>(callback, query_results, grain_size);
+	}
+
+	template <class T, class Callback>
+	void parallelIterate(const ECSQueryResult& query_result, Callback&& callback, int32_t grain_size = 0)
+	{
+		const ECSQueryResult* query_results[] = { &query_result };
+		parallelIterateInternal<Callback, T>(callback, query_results, grain_size);
+	}
+
+	ECSManager(void);
 	~ECSManager(void);
 
 	bool initAllModulesLoaded(void) override;
@@ -315,10 +446,18 @@ public:
 	EntityID createEntity(const ECSArchetype& archetype);
 	EntityID createEntity(Gaff::Hash64 archetype);
 
+	// Creates count entities of the same archetype, writing their IDs to out_ids.
+	// Takes the entity lock once, fills free slots and whole new pages in bulk.
+	void createEntities(const ECSArchetype& archetype, int32_t count, EntityID* out_ids);
+	void createEntities(Gaff::Hash64 archetype, int32_t count, EntityID* out_ids);
+
 	EntityID loadEntity(const ECSArchetype& archetype, const ISerializeReader& reader);
 	EntityID loadEntity(Gaff::Hash64 archetype, const ISerializeReader& reader);
+	// Loads component data into an entity that has already been created, e.g. by createEntities().
+	bool loadEntity(EntityID id, const ISerializeReader& reader);
 
 	void destroyEntity(EntityID id);
+	void destroyEntities(const EntityID* ids, int32_t count);
 
 	const void* getComponentShared(Gaff::Hash64 archetype, const Refl::IReflectionDefinition& component) const;
 	const void* getComponentShared(Gaff::Hash64 archetype, Gaff::Hash64 component) const;
@@ -350,6 +489,11 @@ public:
 	void* getComponent(const ECSQueryResult& query_result, int32_t entity_index);
 	int32_t getNumEntities(const ECSQueryResult& query_result) const;
 
+	// Number of entity slots in the query result's pages, including empty ones. Always a multiple of 4,
+	// so it can be walked in blocks of 4 with getComponent(). Empty slots return EntityID_None from getEntityID().
+	int32_t getEntityCapacity(const ECSQueryResult& query_result) const;
+	EntityID getEntityID(const ECSQueryResult& query_result, int32_t entity_index) const;
+
 	void registerQuery(ECSQuery&& query);
 
 	const ECSSceneResourcePtr& getCurrentScene(void) const;
@@ -359,6 +503,9 @@ public:
 
 	const ECSArchetype& getEmptyArchetype(void) const;
 
+	// Structural changes recorded here are applied when ECSCommandBufferSystem runs.
+	ECSCommandBuffer& getCommandBuffer(void);
+
 private:
 	struct EntityData;
 
@@ -385,6 +532,9 @@ private:
 		Vector<EntityID> entity_ids{ ProxyAllocator("ECS") };
 		Vector<int32_t> free_indices{ ProxyAllocator("ECS") };
 		Vector<int32_t> queries{ ProxyAllocator("ECS") };
+
+		// Archetypes this one turns into when components are added or removed. Keyed by the kind of change.
+		VectorMap<Gaff::Hash64, EntityData*> transitions{ ProxyAllocator("ECS") };
 	};
 
 	struct Entity final
@@ -394,6 +544,22 @@ private:
 		int32_t index = -1;
 	};
 
+	struct EntityMigration final
+	{
+		EntityData* new_data;
+		EntityData* old_data;
+		EntityID id;
+	};
+
+	struct ParallelIterateChunk final
+	{
+		ECSManager* ecs_mgr;
+		void* callback;
+		const ECSQueryResult** query_results;
+		int32_t begin;
+		int32_t end;
+	};
+
 	mutable EA::Thread::Mutex _entity_page_lock;
 
 	VectorMap< Gaff::Hash64, UniquePtr<EntityData> > _entity_pages{ ProxyAllocator("ECS") };
@@ -406,14 +572,26 @@ private:
 	ECSArchetypeResourcePtr _empty_arch_res;
 	ECSSceneResourcePtr _curr_scene;
 
+	UniquePtr<ECSCommandBuffer> _command_buffer;
+
 	//bool loadFile(const char* file_name, IFile* file);
 	void destroyEntityInternal(EntityID id, bool change_ref_count);
-	void migrate(EntityID id, Gaff::Hash64 new_archetype);
+	void destroyEntitiesInternal(const EntityID* ids, int32_t count, bool change_ref_count);
+	void migrate(const EntityID* ids, int32_t count, EntityData& data, Vector<ArchetypeReference*>& old_arch_refs);
+	void migrate(EntityID id, EntityData& data);
+	void migrate(Vector<EntityMigration>& migrations);
 	int32_t allocateIndex(EntityData& data, EntityID id);
+	EntityPage* allocatePage(EntityData& data);
+	void removeEmptyPages(EntityData& data);
 
 	ArchetypeReference* modifyInternal(EntityID& id, ArchetypeModifier modifier);
 	ArchetypeReference* addArchetypeInternal(ECSArchetype&& archetype);
 
+	template <class BuildFunc>
+	EntityData& getTransition(EntityData& data, Gaff::Hash64 transition, BuildFunc&& build_func);
+
+	static void BuildModifiedArchetype(const ECSArchetype& base_archetype, ECSArchetype& archetype, ArchetypeModifier modifier);
+
 	template <class... Components>
 	ArchetypeReference* removeSharedComponentsInternal(Gaff::Hash64 archetype_hash);
 
@@ -450,6 +628,18 @@ private:
 	template <class Callback, class... Components, size_t array_size>
 	void iterateInternal(Callback&& callback, const ECSQueryResult* (&query_results)[array_size]);
 
+	template <class Callback, class... Components, size_t array_size>
+	void iterateRangeInternal(Callback&& callback, const ECSQueryResult* (&query_results)[array_size], int32_t begin, int32_t end);
+
+	template <class Callback, class... Components, size_t array_size>
+	void parallelIterateInternal(Callback& callback, const ECSQueryResult* (&query_results)[array_size], int32_t grain_size);
+
+	template <class Callback, class... Components>
+	static void ParallelIterateJob(uintptr_t thread_id_int, void* data);
+
+	// Hands the chunks to the job pool and helps out until they're done. Kept out of line so the header doesn't drag in the job pool.
+	void runParallelIterateJobs(ParallelIterateChunk* chunks, int32_t num_chunks, void (*job_func)(uintptr_t, void*));
+
 	SHIB_REFLECTION_CLASS_DECLARE(ECSManager);
 };
 
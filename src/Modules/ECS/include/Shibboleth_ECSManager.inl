@@ -79,9 +79,12 @@ struct IsPointerHelper<Ret (Args...)> final
 	}
 };
 
-template <class Callback, size_t index>
+template <class CallbackRef, size_t index>
 static constexpr bool IsPointer(void)
 {
+	// Callbacks can come in as lvalue references, check the type being referenced.
+	using Callback = std::remove_cvref_t<CallbackRef>;
+
 	if constexpr (std::is_class<Callback>::value) {
 		static_assert(&Callback::operator(), "Does not have operator()");
 		return IsPointerHelper<decltype(&Callback::operator())>::template IsPtr<index>();
@@ -165,63 +168,103 @@ ArchetypeReference* ECSManager::addComponentsInternal(Gaff::Hash64 archetype_has
 template <class... Components>
 ArchetypeReference* ECSManager::removeSharedComponentsInternal(EntityID id)
 {
-	const ECSArchetype& base_archetype = getArchetype(id);
-	ECSArchetype archetype;
-
-	archetype.copy(base_archetype);
-	RemoveSharedComponentHelper<Components...>(archetype);
-	archetype.finalize(base_archetype);
-
-	const auto archetype_ref = addArchetype(std::move(archetype));
-	migrate(id, archetype.getHash());
+	const EA::Thread::AutoMutex lock(_entity_page_lock);
+	GAFF_ASSERT(ValidEntityID(id) && id < _next_id && _entities[id].data);
+
+	EntityData& data = getTransition(
+		*_entities[id].data,
+		ArchetypeTransitionHash<Components...>(ArchetypeTransitionOp::RemoveShared),
+		[](const ECSArchetype& base_archetype, ECSArchetype& archetype) -> void
+		{
+			archetype.copy(base_archetype);
+			RemoveSharedComponentHelper<Components...>(archetype);
+			archetype.finalize(base_archetype);
+		}
+	);
 
-	return archetype_ref;
+	migrate(id, data);
+	return data.arch_ref;
 }
 
 template <class... Components>
 ArchetypeReference* ECSManager::removeComponentsInternal(EntityID id)
 {
-	const ECSArchetype& base_archetype = getArchetype(id);
-	ECSArchetype archetype;
-
-	archetype.copy(base_archetype, true);
-	RemoveComponentHelper<Components...>(archetype);
-	archetype.finalize();
-
-	const auto arch_ref = addArchetypeInternal(std::move(archetype));
-	migrate(id, archetype.getHash());
+	const EA::Thread::AutoMutex lock(_entity_page_lock);
+	GAFF_ASSERT(ValidEntityID(id) && id < _next_id && _entities[id].data);
+
+	EntityData& data = getTransition(
+		*_entities[id].data,
+		ArchetypeTransitionHash<Components...>(ArchetypeTransitionOp::Remove),
+		[](const ECSArchetype& base_archetype, ECSArchetype& archetype) -> void
+		{
+			archetype.copy(base_archetype, true);
+			RemoveComponentHelper<Components...>(archetype);
+			archetype.finalize();
+		}
+	);
 
-	return arch_ref;
+	migrate(id, data);
+	return data.arch_ref;
 }
 
 template <class... Components>
 ArchetypeReference* ECSManager::addSharedComponentsInternal(EntityID id)
 {
-	const ECSArchetype& base_archetype = getArchetype(id);
-	ECSArchetype archetype;
-
-	archetype.copy(base_archetype);
-	AddSharedComponentHelper<Components...>(archetype);
-	archetype.finalize(base_archetype);
-
-	ArchetypeReference* const arch_ref = addArchetypeInternal(std::move(archetype));
-	migrate(id, archetype.getHash());
+	const EA::Thread::AutoMutex lock(_entity_page_lock);
+	GAFF_ASSERT(ValidEntityID(id) && id < _next_id && _entities[id].data);
+
+	EntityData& data = getTransition(
+		*_entities[id].data,
+		ArchetypeTransitionHash<Components...>(ArchetypeTransitionOp::AddShared),
+		[](const ECSArchetype& base_archetype, ECSArchetype& archetype) -> void
+		{
+			archetype.copy(base_archetype);
+			AddSharedComponentHelper<Components...>(archetype);
+			archetype.finalize(base_archetype);
+		}
+	);
 
-	return arch_ref;
+	migrate(id, data);
+	return data.arch_ref;
 }
 
 template <class... Components>
 ArchetypeReference* ECSManager::addComponentsInternal(EntityID id)
 {
+	const EA::Thread::AutoMutex lock(_entity_page_lock);
+	GAFF_ASSERT(ValidEntityID(id) && id < _next_id && _entities[id].data);
+
+	EntityData& data = getTransition(
+		*_entities[id].data,
+		ArchetypeTransitionHash<Components...>(ArchetypeTransitionOp::Add),
+		[](const ECSArchetype& base_archetype, ECSArchetype& archetype) -> void
+		{
+			archetype.copy(base_archetype, true);
+			AddComponentHelper<Components...>(archetype);
+			archetype.finalize();
+		}
+	);
+
+	migrate(id, data);
+	return data.arch_ref;
+}
+
+// Caller is expected to be holding _entity_page_lock.
+template <class BuildFunc>
+ECSManager::EntityData& ECSManager::getTransition(EntityData& data, Gaff::Hash64 transition, BuildFunc&& build_func)
+{
+	if (const auto it = data.transitions.find(transition); it != data.transitions.end()) {
+		return *it->second;
+	}
+
 	ECSArchetype archetype;
-	archetype.copy(getArchetype(id), true);
-	AddComponentHelper<Components...>(archetype);
-	archetype.finalize();
+	build_func(data.archetype, archetype);
 
-	ArchetypeReference* const arch_ref = addArchetypeInternal(std::move(archetype));
-	migrate(id, archetype.getHash());
+	const ArchetypeReference* const arch_ref = addArchetypeInternal(std::move(archetype));
+	EntityData& new_data = *_entity_pages[arch_ref->getArchetypeHash()];
 
-	return arch_ref;
+	data.transitions.emplace(transition, &new_data);
+	return new_data;
 }
 
 template <class Callback, size_t index, class ComponentFirst, class... ComponentsRest, size_t array_size, class... ComponentsPrev>
@@ -338,4 +381,77 @@ void ECSManager::iterateInternal(Callback&& callback, const ECSQueryResult* (&qu
 	}
 }
 
+template <class Callback, class... Components, size_t array_size>
+void ECSManager::iterateRangeInternal(Callback&& callback, const ECSQueryResult* (&query_results)[array_size], int32_t begin, int32_t end)
+{
+	static_assert(sizeof...(Components) == array_size);
+
+	const EntityData* const data = reinterpret_cast<const EntityData*>(query_results[0]->entity_data);
+
+	for (int32_t i = begin; i < end; ++i) {
+		if (data->entity_ids[i] == -1) {
+			continue;
+		}
+
+		if constexpr (sizeof...(Components) == 0) {
+			callback(data->entity_ids[i]);
+		} else {
+			iterateInternalHelper<Callback, 0, Components...>(std::forward<Callback>(callback), data->entity_ids[i], i, query_results);
+		}
+	}
+}
+
+template <class Callback, class... Components, size_t array_size>
+void ECSManager::parallelIterateInternal(Callback& callback, const ECSQueryResult* (&query_results)[array_size], int32_t grain_size)
+{
+	static_assert(sizeof...(Components) == array_size);
+
+	// Assumes all query results are from the same query, and should be pointing at the same entity data.
+	const EntityData* const data = reinterpret_cast<const EntityData*>(query_results[0]->entity_data);
+	const int32_t num_indices = static_cast<int32_t>(data->entity_ids.size());
+
+	if (!data->num_entities) {
+		return;
+	}
+
+	// Keep chunks a multiple of 4 so that jobs don't share a group of components.
+	grain_size = (grain_size > 0) ? grain_size : data->num_entities_per_page;
+	grain_size = (grain_size + 3) & ~3;
+
+	const int32_t num_chunks = (num_indices + grain_size - 1) / grain_size;
+
+	// Not worth the overhead of a job.
+	if (num_chunks <= 1) {
+		iterateRangeInternal<Callback&, Components...>(callback, query_results, 0, num_indices);
+		return;
+	}
+
+	// Only needed until we return, which is exactly what the frame allocator is for.
+	Vector<ParallelIterateChunk> chunks(static_cast<size_t>(num_chunks), ProxyAllocator::GetFrame());
+
+	for (int32_t i = 0; i < num_chunks; ++i) {
+		ParallelIterateChunk& chunk = chunks[i];
+		chunk.ecs_mgr = this;
+		chunk.callback = const_cast<void*>(reinterpret_cast<const void*>(&callback));
+		chunk.query_results = query_results;
+		chunk.begin = i * grain_size;
+		chunk.end = Gaff::Min(chunk.begin + grain_size, num_indices);
+	}
+
+	runParallelIterateJobs(chunks.data(), num_chunks, ParallelIterateJob<Callback, Components...>);
+}
+
+template <class Callback, class... Components>
+void ECSManager::ParallelIterateJob(uintptr_t /*thread_id_int*/, void* data)
+{
+	using QueryResultArray = const ECSQueryResult* [sizeof...(Components)];
+	using CallbackType = std::remove_reference_t<Callback>;
+
+	const ParallelIterateChunk& chunk = *reinterpret_cast<const ParallelIterateChunk*>(data);
+	CallbackType& callback = *reinterpret_cast<CallbackType*>(chunk.callback);
+	QueryResultArray& query_results = *reinterpret_cast<QueryResultArray*>(chunk.query_results);
+
+	chunk.ecs_mgr->iterateRangeInternal<CallbackType&, Components...>(callback, query_results, chunk.begin, chunk.end);
+}
+
 NS_END
@@ -0,0 +1,342 @@
+/************************************************************************************
+Copyright (C) 2022 by Nicholas LaCroix
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+************************************************************************************/
+
+#include "Shibboleth_BakedMesh.h"
+#include <Gaff_Assert.h>
+#include <assimp/scene.h>
+#include <assimp/mesh.h>
+
+NS_SHIBBOLETH
+
+static size_t AlignBlob(Vector<int8_t>& out)
+{
+	const size_t offset = (out.size() + BakedMesh::k_data_alignment - 1) & ~(BakedMesh::k_data_alignment - 1);
+	out.resize(offset, 0);
+
+	return offset;
+}
+
+static bool InBlob(uint64_t offset, uint64_t size, size_t blob_size)
+{
+	return offset <= blob_size && size <= blob_size - offset;
+}
+
+bool BakedMesh::Bake(const aiScene& scene, const Vector<int32_t>& centering_meshes, const BakedMeshSource& source, Vector<int8_t>& out)
+{
+	if (!scene.HasMeshes()) {
+		return false;
+	}
+
+	const int32_t num_submeshes = static_cast<int32_t>(scene.mNumMeshes);
+	const size_t submeshes_offset = sizeof(BakedMeshHeader);
+
+	out.clear();
+	out.resize(submeshes_offset + sizeof(BakedSubmeshHeader) * num_submeshes, 0);
+
+	Vector<uint32_t> vertex_order{ ProxyAllocator("Graphics") };
+	Vector<uint32_t> indices{ ProxyAllocator("Graphics") };
+	Vector<uint32_t> remap{ ProxyAllocator("Graphics") };
+	Gleam::AABB centering_aabb;
+
+	for (int32_t i = 0; i < num_submeshes; ++i) {
+		const aiMesh& mesh = *scene.mMeshes[i];
+
+		if (!mesh.HasFaces() || !mesh.HasPositions()) {
+			return false;
+		}
+
+		// Drop anything that isn't a triangle.
+		indices.clear();
+		indices.reserve(static_cast<size_t>(mesh.mNumFaces) * 3);
+
+		for (int32_t j = 0; j < static_cast<int32_t>(mesh.mNumFaces); ++j) {
+			const aiFace& face = mesh.mFaces[j];
+
+			if (face.mNumIndices == 3) {
+				indices.push_back(face.mIndices[0]);
+				indices.push_back(face.mIndices[1]);
+				indices.push_back(face.mIndices[2]);
+			}
+		}
+
+		if (indices.empty()) {
+			return false;
+		}
+
+		// Lay vertices out in the order the triangles first touch them, so vertex fetches walk forward through memory.
+		// Vertices no triangle references are dropped.
+		remap.assign(mesh.mNumVertices, UINT32_MAX);
+		vertex_order.clear();
+
+		for (uint32_t& index : indices) {
+			if (remap[index] == UINT32_MAX) {
+				remap[index] = static_cast<uint32_t>(vertex_order.size());
+				vertex_order.push_back(index);
+			}
+
+			index = remap[index];
+		}
+
+		BakedSubmeshHeader header = {};
+
+		header.aabb_min[0] = mesh.mAABB.mMin.x;
+		header.aabb_min[1] = mesh.mAABB.mMin.y;
+		header.aabb_min[2] = mesh.mAABB.mMin.z;
+		header.aabb_max[0] = mesh.mAABB.mMax.x;
+		header.aabb_max[1] = mesh.mAABB.mMax.y;
+		header.aabb_max[2] = mesh.mAABB.mMax.z;
+
+		header.vertex_count = static_cast<int32_t>(vertex_order.size());
+		header.index_count = static_cast<int32_t>(indices.size());
+		header.index_size = (header.vertex_count <= UINT16_MAX) ? sizeof(uint16_t) : sizeof(uint32_t);
+
+		// Same stream order MeshResource has always used. Positions, normals, tangents, bitangents, UVs, then colors.
+		const auto add_stream = [&header](int32_t size) -> bool
+		{
+			if (header.stream_count == BakedSubmeshHeader::k_max_streams) {
+				return false;
+			}
+
+			header.stream_offsets[header.stream_count++] = static_cast<uint32_t>(header.vertex_stride);
+			header.vertex_stride += size;
+			return true;
+		};
+
+		bool streams_fit = add_stream(sizeof(float) * 3);
+
+		if (mesh.HasNormals()) {
+			streams_fit = streams_fit && add_stream(sizeof(float) * 3);
+		}
+
+		if (mesh.HasTangentsAndBitangents()) {
+			streams_fit = streams_fit && add_stream(sizeof(float) * 3);
+			streams_fit = streams_fit && add_stream(sizeof(float) * 3);
+		}
+
+		for (int32_t j = 0; j < static_cast<int32_t>(mesh.GetNumUVChannels()); ++j) {
+			streams_fit = streams_fit && add_stream(static_cast<int32_t>(sizeof(float) * mesh.mNumUVComponents[j]));
+		}
+
+		for (int32_t j = 0; j < static_cast<int32_t>(mesh.GetNumColorChannels()); ++j) {
+			streams_fit = streams_fit && add_stream(sizeof(float) * 4);
+		}
+
+		if (!streams_fit) {
+			return false;
+		}
+
+		// Name.
+		header.name_offset = out.size();
+		header.name_size = static_cast<int32_t>(mesh.mName.length);
+		out.insert(out.end(), mesh.mName.data, mesh.mName.data + mesh.mName.length);
+
+		// Vertices.
+		header.vertex_offset = AlignBlob(out);
+		out.resize(out.size() + static_cast<size_t>(header.vertex_count) * header.vertex_stride);
+
+		int8_t* curr = out.data() + header.vertex_offset;
+
+		const auto write = [&curr](const void* data, size_t size) -> void
+		{
+			memcpy(curr, data, size);
+			curr += size;
+		};
+
+		for (uint32_t vertex : vertex_order) {
+			write(&mesh.mVertices[vertex], sizeof(float) * 3);
+
+			if (mesh.HasNormals()) {
+				const aiVector3D normal = mesh.mNormals[vertex].NormalizeSafe();
+				write(&normal, sizeof(float) * 3);
+			}
+
+			if (mesh.HasTangentsAndBitangents()) {
+				const aiVector3D tan = mesh.mTangents[vertex].NormalizeSafe();
+				const aiVector3D bitan = mesh.mBitangents[vertex].NormalizeSafe();
+
+				write(&tan, sizeof(float) * 3);
+				write(&bitan, sizeof(float) * 3);
+			}
+
+			for (int32_t j = 0; j < static_cast<int32_t>(mesh.GetNumUVChannels()); ++j) {
+				write(&mesh.mTextureCoords[j][vertex], sizeof(float) * mesh.mNumUVComponents[j]);
+			}
+
+			for (int32_t j = 0; j < static_cast<int32_t>(mesh.GetNumColorChannels()); ++j) {
+				write(&mesh.mColors[j][vertex], sizeof(float) * 4);
+			}
+		}
+
+		// Indices.
+		header.index_offset = AlignBlob(out);
+		out.resize(out.size() + static_cast<size_t>(header.index_count) * header.index_size);
+
+		if (header.index_size == sizeof(uint16_t)) {
+			uint16_t* const out_indices = reinterpret_cast<uint16_t*>(out.data() + header.index_offset);
+
+			for (int32_t j = 0; j < header.index_count; ++j) {
+				out_indices[j] = static_cast<uint16_t>(indices[j]);
+			}
+
+		} else {
+			memcpy(out.data() + header.index_offset, indices.data(), sizeof(uint32_t) * indices.size());
+		}
+
+		memcpy(out.data() + submeshes_offset + sizeof(BakedSubmeshHeader) * i, &header, sizeof(BakedSubmeshHeader));
+	}
+
+	for (int32_t index : centering_meshes) {
+		if (index < 0 || index >= num_submeshes) {
+			// $TODO: Log error.
+			continue;
+		}
+
+		const aiAABB& aabb = scene.mMeshes[index]->mAABB;
+		centering_aabb.addAABB(Gleam::AABB(
+			Gleam::Vec3(aabb.mMin.x, aabb.mMin.y, aabb.mMin.z),
+			Gleam::Vec3(aabb.mMax.x, aabb.mMax.y, aabb.mMax.z)
+		));
+	}
+
+	const Gleam::Vec3 centering_vector = -centering_aabb.getCenter();
+
+	BakedMeshHeader header = {};
+
+	header.magic = k_magic;
+	header.version = k_version;
+	header.source = source;
+	header.centering_vector[0] = centering_vector.x;
+	header.centering_vector[1] = centering_vector.y;
+	header.centering_vector[2] = centering_vector.z;
+	header.num_submeshes = num_submeshes;
+
+	memcpy(out.data(), &header, sizeof(BakedMeshHeader));
+	return true;
+}
+
+bool BakedMesh::init(const void* data, size_t size)
+{
+	_data = nullptr;
+	_size = 0;
+
+	if (!data || size < sizeof(BakedMeshHeader)) {
+		return false;
+	}
+
+	const BakedMeshHeader* const header = reinterpret_cast<const BakedMeshHeader*>(data);
+
+	if (header->magic != k_magic || header->version != k_version || header->num_submeshes < 0) {
+		return false;
+	}
+
+	if (!InBlob(sizeof(BakedMeshHeader), sizeof(BakedSubmeshHeader) * static_cast<uint64_t>(header->num_submeshes), size)) {
+		return false;
+	}
+
+	const BakedSubmeshHeader* const submeshes = reinterpret_cast<const BakedSubmeshHeader*>(header + 1);
+
+	// Bad data here would have us reading past the end of the file, or handing garbage to the GPU.
+	for (int32_t i = 0; i < header->num_submeshes; ++i) {
+		const BakedSubmeshHeader& submesh = submeshes[i];
+
+		if (submesh.name_size < 0 || submesh.vertex_count <= 0 || submesh.vertex_stride <= 0 || submesh.index_count <= 0 ||
+			(submesh.index_size != sizeof(uint16_t) && submesh.index_size != sizeof(uint32_t)) ||
+			submesh.stream_count <= 0 || submesh.stream_count > BakedSubmeshHeader::k_max_streams) {
+
+			return false;
+		}
+
+		if (!InBlob(submesh.name_offset, static_cast<uint64_t>(submesh.name_size), size) ||
+			!InBlob(submesh.vertex_offset, static_cast<uint64_t>(submesh.vertex_count) * static_cast<uint64_t>(submesh.vertex_stride), size) ||
+			!InBlob(submesh.index_offset, static_cast<uint64_t>(submesh.index_count) * static_cast<uint64_t>(submesh.index_size), size)) {
+
+			return false;
+		}
+
+		for (int32_t j = 0; j < submesh.stream_count; ++j) {
+			if (submesh.stream_offsets[j] >= static_cast<uint32_t>(submesh.vertex_stride)) {
+				return false;
+			}
+		}
+	}
+
+	_data = reinterpret_cast<const int8_t*>(data);
+	_size = size;
+
+	return true;
+}
+
+const BakedMeshSource& BakedMesh::getSource(void) const
+{
+	return getHeader().source;
+}
+
+Gleam::Vec3 BakedMesh::getCenteringVector(void) const
+{
+	const float* const centering_vector = getHeader().centering_vector;
+	return Gleam::Vec3(centering_vector[0], centering_vector[1], centering_vector[2]);
+}
+
+int32_t BakedMesh::getNumSubmeshes(void) const
+{
+	return getHeader().num_submeshes;
+}
+
+const BakedSubmeshHeader& BakedMesh::getSubmesh(int32_t index) const
+{
+	GAFF_ASSERT(index >= 0 && index < getNumSubmeshes());
+	return reinterpret_cast<const BakedSubmeshHeader*>(_data + sizeof(BakedMeshHeader))[index];
+}
+
+eastl::u8string_view BakedMesh::getSubmeshName(int32_t index) const
+{
+	const BakedSubmeshHeader& submesh = getSubmesh(index);
+	return eastl::u8string_view(reinterpret_cast<const char8_t*>(_data + submesh.name_offset), static_cast<size_t>(submesh.name_size));
+}
+
+Gleam::AABB BakedMesh::getSubmeshAABB(int32_t index) const
+{
+	const BakedSubmeshHeader& submesh = getSubmesh(index);
+
+	return Gleam::AABB(
+		Gleam::Vec3(submesh.aabb_min[0], submesh.aabb_min[1], submesh.aabb_min[2]),
+		Gleam::Vec3(submesh.aabb_max[0], submesh.aabb_max[1], submesh.aabb_max[2])
+	);
+}
+
+const void* BakedMesh::getVertexData(int32_t index) const
+{
+	return _data + getSubmesh(index).vertex_offset;
+}
+
+const void* BakedMesh::getIndexData(int32_t index) const
+{
+	return _data + getSubmesh(index).index_offset;
+}
+
+const BakedMeshHeader& BakedMesh::getHeader(void) const
+{
+	GAFF_ASSERT(_data);
+	return *reinterpret_cast<const BakedMeshHeader*>(_data);
+}
+
+NS_END
@@ -21,12 +21,19 @@ THE SOFTWARE.
 ************************************************************************************/
 
 #include "Shibboleth_ClearRenderTargetSystem.h"
-#include "Shibboleth_RenderManagerBase.h"
 #include "Shibboleth_CameraComponent.h"
+#include "Shibboleth_RenderManager.h"
+#include <Shibboleth_MainLoopAttributes.h>
 #include <Shibboleth_ECSManager.h>
 #include <Shibboleth_AppUtils.h>
 
 SHIB_REFLECTION_DEFINE_BEGIN(Shibboleth::ClearRenderTargetSystem)
+	.classAttrs(
+		Shibboleth::SystemAccessAttribute::Read<Shibboleth::ECSManager>(),
+		Shibboleth::SystemAccessAttribute::Read<Shibboleth::Camera>(),
+		Shibboleth::SystemAccessAttribute::Write<Shibboleth::RenderManager>()
+	)
+
 	.template BASE(Shibboleth::ISystem)
 	.ctor<>()
 SHIB_REFLECTION_DEFINE_END(Shibboleth::ClearRenderTargetSystem)
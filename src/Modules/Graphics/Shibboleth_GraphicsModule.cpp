@@ -56,7 +56,21 @@ THE SOFTWARE.
 
 		static void GraphicsLog(const char8_t* msg, Gleam::LogMsgType type)
 		{
-			const Shibboleth::LogType msg_type = static_cast<Shibboleth::LogType>(type);
+			Shibboleth::LogType msg_type = Shibboleth::LogType::Info;
+
+			switch (type) {
+				case Gleam::LogMsgType::Warning:
+					msg_type = Shibboleth::LogType::Warning;
+					break;
+
+				case Gleam::LogMsgType::Error:
+					msg_type = Shibboleth::LogType::Error;
+					break;
+
+				default:
+					break;
+			}
+
 			Shibboleth::GetApp().getLogManager().logMessage(msg_type, Shibboleth::k_log_channel_default, msg);
 		}
 
@@ -237,10 +237,9 @@ void MaterialResource::loadMaterial(IFile* file, uintptr_t thread_id_int)
 			return;
 		}
 
-		const char8_t* const tag = reader.readString(u8"main");
-		device_tag = tag;
-		devices = render_mgr.getDevicesByTag(tag);
-		reader.freeString(tag);
+		const eastl::u8string_view tag = reader.readStringView(u8"main");
+		device_tag.assign(tag.data(), tag.size());
+		devices = render_mgr.getDevicesByTag(Gaff::FNV1aHash32T(tag.data(), tag.size()));
 	}
 
 	if (!devices || devices->empty()) {
@@ -263,9 +262,8 @@ void MaterialResource::loadMaterial(IFile* file, uintptr_t thread_id_int)
 				return;
 			}
 
-			const char8_t* const res_path = reader.readString();
-			const U8String final_path = U8String(res_path) + Gleam::IShader::g_shader_extensions[static_cast<int32_t>(render_mgr.getRendererType())];
-			reader.freeString(res_path);
+			const eastl::u8string_view res_path = reader.readStringView();
+			const U8String final_path = U8String(res_path.data(), res_path.size()) + Gleam::IShader::g_shader_extensions[static_cast<int32_t>(render_mgr.getRendererType())];
 
 			const HashStringView64<> path_hash(final_path);
 			ShaderResourcePtr compute = res_mgr.getResourceT<ShaderResource>(path_hash);
@@ -347,9 +345,8 @@ void MaterialResource::loadMaterial(IFile* file, uintptr_t thread_id_int)
 			continue;
 		}
 
-		const char8_t* const res_path = reader.readString();
-		const U8String final_path = U8String(res_path) + Gleam::IShader::g_shader_extensions[static_cast<int32_t>(render_mgr.getRendererType())];
-		reader.freeString(res_path);
+		const eastl::u8string_view res_path = reader.readStringView();
+		const U8String final_path = U8String(res_path.data(), res_path.size()) + Gleam::IShader::g_shader_extensions[static_cast<int32_t>(render_mgr.getRendererType())];
 
 		const HashStringView64<> path_hash(final_path);
 		shaders[index] = res_mgr.getResourceT<ShaderResource>(path_hash);
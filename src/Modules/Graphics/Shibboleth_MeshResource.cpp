@@ -22,6 +22,7 @@ THE SOFTWARE.
 
 #include "Shibboleth_MeshResource.h"
 #include "Shibboleth_IRenderManager.h"
+#include "Shibboleth_BakedMesh.h"
 #include <Shibboleth_ResourceAttributesCommon.h>
 #include <Shibboleth_ResourceManager.h>
 #include <Shibboleth_ResourceLogging.h>
@@ -245,6 +246,79 @@ bool MeshResource::createMesh(Gleam::IRenderDevice& device, const aiMesh& mesh)
 	return createMesh(devices, mesh);
 }
 
+bool MeshResource::createMesh(const Vector<Gleam::IRenderDevice*>& devices, const BakedMesh& mesh, int32_t submesh)
+{
+	const IRenderManager& render_mgr = GETMANAGERT(Shibboleth::IRenderManager, Shibboleth::RenderManager);
+	ResourceManager& res_mgr = GetManagerTFast<ResourceManager>();
+	const BakedSubmeshHeader& header = mesh.getSubmesh(submesh);
+
+	_meshes.reserve(devices.size());
+	_aabb = mesh.getSubmeshAABB(submesh);
+
+	// Baked data is already laid out the way the GPU wants it. No need to repack.
+	Gleam::IBuffer::Settings settings{
+		mesh.getVertexData(submesh),
+		static_cast<size_t>(header.vertex_count) * header.vertex_stride,
+		header.vertex_stride,
+		header.vertex_stride,
+		Gleam::IBuffer::Type::VertexData,
+		Gleam::IBuffer::MapType::None,
+		true
+	};
+
+	bool succeeded = true;
+
+	U8String res_name = getFilePath().getString() + u8":vertex_buffer";
+	_vertex_data = res_mgr.createResourceT<BufferResource>(res_name.data());
+
+	if (!_vertex_data->createBuffer(devices, settings)) {
+		LogErrorResource("Failed to load mesh '%s'. Failed to create vertex buffer.", getFilePath().getBuffer());
+		succeeded = false;
+	}
+
+	// Create indice data.
+	settings = Gleam::IBuffer::Settings{
+		mesh.getIndexData(submesh),
+		static_cast<size_t>(header.index_count) * header.index_size,
+		0,
+		header.index_size,
+		Gleam::IBuffer::Type::IndexData,
+		Gleam::IBuffer::MapType::None,
+		true
+	};
+
+	res_name = getFilePath().getString() + u8":indice_buffer";
+	_indice_data = res_mgr.createResourceT<BufferResource>(res_name.data());
+
+	if (!_indice_data->createBuffer(devices, settings)) {
+		LogErrorResource("Failed to load mesh '%s'. Failed to create indice buffer.", getFilePath().getBuffer());
+		succeeded = false;
+	}
+
+	for (int32_t j = 0; j < static_cast<int32_t>(devices.size()); ++j) {
+		Gleam::IRenderDevice* const rd = devices[j];
+		Gleam::IBuffer* const vertex_buffer = _vertex_data->getBuffer(*rd);
+		Gleam::IBuffer* const indice_buffer = _indice_data->getBuffer(*rd);
+
+		if (!vertex_buffer || !indice_buffer) {
+			continue;
+		}
+
+		Gleam::IMesh* const gpu_mesh = render_mgr.createMesh();
+		_meshes[rd].reset(gpu_mesh);
+
+		gpu_mesh->setTopologyType(Gleam::IMesh::TopologyType::TriangleList);
+		gpu_mesh->setIndiceBuffer(indice_buffer);
+		gpu_mesh->setIndexCount(header.index_count);
+
+		for (int32_t k = 0; k < header.stream_count; ++k) {
+			gpu_mesh->addBuffer(vertex_buffer, header.stream_offsets[k]);
+		}
+	}
+
+	return succeeded;
+}
+
 const Gleam::IMesh* MeshResource::getMesh(const Gleam::IRenderDevice& rd) const
 {
 	const auto it = _meshes.find(&rd);
@@ -22,16 +22,20 @@ THE SOFTWARE.
 
 #include "Shibboleth_ModelResource.h"
 #include "Shibboleth_RenderManagerBase.h"
+#include "Shibboleth_GraphicsConfigs.h"
+#include "Shibboleth_BakedMesh.h"
 #include <Shibboleth_LoadFileCallbackAttribute.h>
 #include <Shibboleth_ResourceAttributesCommon.h>
 #include <Shibboleth_SerializeReaderWrapper.h>
 #include <Shibboleth_ResourceManager.h>
 #include <Shibboleth_ResourceLogging.h>
 #include <Shibboleth_IFileSystem.h>
+#include <Gaff_File.h>
 
 #include <assimp/postprocess.h>
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
+#include <filesystem>
 
 SHIB_REFLECTION_DEFINE_BEGIN(Shibboleth::ModelResource)
 	.classAttrs(
@@ -49,6 +53,32 @@ NS_SHIBBOLETH
 
 SHIB_REFLECTION_CLASS_DEFINE(ModelResource)
 
+// Fills in the size and modified time of the model's source file, if it exists on disk.
+static bool GetSourceStats(const char8_t* model_file_path, BakedMeshSource& source)
+{
+	U8String final_path(ProxyAllocator("Resource"));
+	final_path.sprintf(u8"Resources/%s", model_file_path);
+
+	const std::filesystem::path path(final_path.data());
+	std::error_code error;
+
+	const uintmax_t size = std::filesystem::file_size(path, error);
+
+	if (error) {
+		return false;
+	}
+
+	const std::filesystem::file_time_type modified_time = std::filesystem::last_write_time(path, error);
+
+	if (error) {
+		return false;
+	}
+
+	source.size = static_cast<uint64_t>(size);
+	source.modified_time = static_cast<int64_t>(modified_time.time_since_epoch().count());
+	return true;
+}
+
 template <int32_t flag, size_t size>
 static int32_t GetIgnoreFlag(const char (&field)[size], const ISerializeReader& reader)
 {
@@ -110,6 +140,8 @@ bool ModelResource::createMesh(const Vector<Gleam::IRenderDevice*>& devices, con
 	}
 
 	_centering_vector = -aabb.getCenter();
+	calculateAABB();
+
 	return succeeded;
 }
 
@@ -141,9 +173,43 @@ bool ModelResource::createMesh(const Vector<MeshResourcePtr>& meshes, const Vect
 
 	_centering_vector = -aabb.getCenter();
 	_meshes = meshes;
+	calculateAABB();
+
 	return true;
 }
 
+bool ModelResource::createMesh(const Vector<Gleam::IRenderDevice*>& devices, const BakedMesh& mesh)
+{
+	ResourceManager& res_mgr = GetManagerTFast<ResourceManager>();
+	bool succeeded = true;
+
+	for (int32_t i = 0; i < mesh.getNumSubmeshes(); ++i) {
+		const eastl::u8string_view name = mesh.getSubmeshName(i);
+		U8String mesh_name = getFilePath().getString() + u8":";
+
+		if (!name.empty()) {
+			mesh_name.append(name.data(), name.size());
+		} else {
+			mesh_name.append_sprintf(u8"%i", i);
+		}
+
+		auto mesh_res = res_mgr.createResourceT<MeshResource>(mesh_name.data());
+
+		if (mesh_res->createMesh(devices, mesh, i)) {
+			_meshes.emplace_back(std::move(mesh_res));
+
+		} else {
+			LogErrorResource("Failed to create model '%s'. Failed to load submesh '%s'.", getFilePath().getBuffer(), mesh_name.data());
+			succeeded = false;
+		}
+	}
+
+	_centering_vector = mesh.getCenteringVector();
+	calculateAABB();
+
+	return succeeded;
+}
+
 bool ModelResource::createMesh(const Vector<Gleam::IRenderDevice*>& devices, const aiScene& scene)
 {
 	Vector<int32_t> centering_meshes;
@@ -178,6 +244,25 @@ const Gleam::Vec3& ModelResource::getCenteringVector(void) const
 	return _centering_vector;
 }
 
+const Gleam::AABB& ModelResource::getAABB(void) const
+{
+	return _aabb;
+}
+
+void ModelResource::calculateAABB(void)
+{
+	if (_meshes.empty()) {
+		_aabb = Gleam::AABB();
+		return;
+	}
+
+	_aabb = _meshes[0]->getAABB();
+
+	for (int32_t i = 1; i < static_cast<int32_t>(_meshes.size()); ++i) {
+		_aabb.addAABB(_meshes[i]->getAABB());
+	}
+}
+
 void ModelResource::loadModel(IFile* file, uintptr_t thread_id_int)
 {
 	SerializeReaderWrapper readerWrapper;
@@ -192,7 +277,6 @@ void ModelResource::loadModel(IFile* file, uintptr_t thread_id_int)
 	ResourceManager& res_mgr = GetManagerTFast<ResourceManager>();
 	const ISerializeReader& reader = *readerWrapper.getReader();
 	const Vector<Gleam::IRenderDevice*>* devices = nullptr;
-	const IFile* model_file = nullptr;
 	U8String model_file_path;
 	U8String device_tag;
 
@@ -229,17 +313,9 @@ void ModelResource::loadModel(IFile* file, uintptr_t thread_id_int)
 		const char8_t* const path = reader.readString();
 
 		model_file_path = path;
-		model_file = res_mgr.loadFileAndWait(path, thread_id_int);
-
 		reader.freeString(path);
 	}
 
-	if (!model_file) {
-		LogErrorResource("Failed to load mesh '%s'. Unable to find or load file '%s'.", getFilePath().getBuffer(), model_file_path.data());
-		failed();
-		return;
-	}
-
 	const int32_t ignore_flags =	aiComponent_ANIMATIONS | aiComponent_CAMERAS |
 									aiComponent_LIGHTS | aiComponent_MATERIALS |
 									aiComponent_TEXTURES |
@@ -249,6 +325,72 @@ void ModelResource::loadModel(IFile* file, uintptr_t thread_id_int)
 									GetIgnoreFlag<aiComponent_TANGENTS_AND_BITANGENTS>("ignore_tangents", reader) |
 									GetIgnoreFlag<aiComponent_TEXCOORDS>("ignore_uvs", reader);
 
+	Vector<int32_t> centering_meshes(ProxyAllocator("Resource"));
+	bool center_all = false;
+
+	{
+		const auto guard = reader.enterElementGuard(u8"center");
+
+		if (reader.isTrue()) {
+			center_all = true;
+
+		} else if (reader.isArray()) {
+			reader.forEachInArray([&](int32_t) -> bool
+			{
+				if (!reader.isInt32()) {
+					// $TODO: Log error.
+					return false;
+				}
+
+				centering_meshes.emplace_back(reader.readInt32());
+				return false;
+			});
+		}
+	}
+
+	// Anything in the .model file that changes the baked output goes into the options hash, so editing it invalidates the bake too.
+	Gaff::Hash64 options_hash = Gaff::FNV1aHash64T(model_file_path.data(), model_file_path.size());
+	options_hash = Gaff::FNV1aHash64T(ignore_flags, options_hash);
+	options_hash = Gaff::FNV1aHash64T(center_all, options_hash);
+	options_hash = Gaff::FNV1aHash64T(centering_meshes.data(), centering_meshes.size(), options_hash);
+
+	BakedMeshSource source = { 0, 0, options_hash };
+	const bool has_source_stats = GetSourceStats(model_file_path.data(), source);
+
+	IFileSystem& fs = GetApp().getFileSystem();
+	const U8String baked_path = getFilePath().getString() + BakedMesh::k_extension;
+	const IFile* const baked_file = res_mgr.loadFileAndWait(baked_path.data(), thread_id_int);
+	BakedMesh baked_mesh;
+
+	if (baked_file && baked_mesh.init(baked_file->getBuffer(), baked_file->size())) {
+		// Without the source file on disk there is nothing to compare against, which is what a shipped build looks like.
+		if (!has_source_stats || baked_mesh.getSource() == source) {
+			const bool success = createMesh(*devices, baked_mesh);
+
+			fs.closeFile(baked_file);
+
+			if (success) {
+				succeeded();
+			} else {
+				failed();
+			}
+
+			return;
+		}
+	}
+
+	if (baked_file) {
+		fs.closeFile(baked_file);
+	}
+
+	// Only read the source when there is no usable bake.
+	const IFile* const model_file = res_mgr.loadFileAndWait(model_file_path.data(), thread_id_int);
+
+	if (!model_file) {
+		LogErrorResource("Failed to load mesh '%s'. Unable to find or load file '%s'.", getFilePath().getBuffer(), model_file_path.data());
+		failed();
+		return;
+	}
 
 	const size_t index = model_file_path.rfind(u8'.');
 	
@@ -260,46 +402,50 @@ void ModelResource::loadModel(IFile* file, uintptr_t thread_id_int)
 		ignore_flags
 	);
 	
+	// Triangles are re-ordered for the post-transform vertex cache here, since we only pay for it when baking.
 	const aiScene* const scene = importer.ReadFileFromMemory(
 		model_file->getBuffer(),
 		model_file->size(),
-		aiProcessPreset_TargetRealtime_Fast | aiProcess_ConvertToLeftHanded | static_cast<unsigned int>(aiProcess_GenBoundingBoxes),
+		aiProcessPreset_TargetRealtime_Fast | aiProcess_ConvertToLeftHanded | aiProcess_ImproveCacheLocality | static_cast<unsigned int>(aiProcess_GenBoundingBoxes),
 		reinterpret_cast<const char*>(model_file_path.data() + index)
 	);
 	
+	fs.closeFile(model_file);
+
 	if (!scene) {
 		LogErrorResource("Failed to load mesh '%s' with error '%s'", getFilePath().getBuffer(), importer.GetErrorString());
 		failed();
 		return;
 	}
 
-	Vector<int32_t> centering_meshes(ProxyAllocator("Resource"));
+	if (center_all) {
+		centering_meshes.set_capacity(scene->mNumMeshes);
 
-	{
-		const auto guard = reader.enterElementGuard(u8"center");
+		for (int32_t i = 0; i < static_cast<int32_t>(scene->mNumMeshes); ++i) {
+			centering_meshes.emplace_back(i);
+		}
+	}
 
-		if (reader.isTrue()) {
-			centering_meshes.set_capacity(scene->mNumMeshes);
+	Vector<int8_t> baked_data(ProxyAllocator("Resource"));
 
-			for (int32_t i = 0; i < static_cast<int32_t>(scene->mNumMeshes); ++i) {
-				centering_meshes.emplace_back(i);
-			}
+	if (!BakedMesh::Bake(*scene, centering_meshes, source, baked_data) || !baked_mesh.init(baked_data.data(), baked_data.size())) {
+		LogErrorResource("Failed to load mesh '%s'. Failed to bake mesh data from '%s'.", getFilePath().getBuffer(), model_file_path.data());
+		failed();
+		return;
+	}
 
-		} else if (reader.isArray()) {
-			reader.forEachInArray([&](int32_t) -> bool
-			{
-				if (!reader.isInt32()) {
-					// $TODO: Log error.
-					return false;
-				}
+	if (GetApp().getConfigs().getObject(k_config_graphics_write_baked_meshes).getBool(false)) {
+		U8String final_path(ProxyAllocator("Resource"));
+		final_path.sprintf(u8"Resources/%s", baked_path.data());
 
-				centering_meshes.emplace_back(reader.readInt32());
-				return false;
-			});
+		Gaff::File file;
+
+		if (!file.open(final_path.data(), Gaff::File::OpenMode::WriteBinary) || file.write(baked_data.data(), 1, baked_data.size()) != baked_data.size()) {
+			LogWarningResource("Failed to write baked mesh '%s'.", final_path.data());
 		}
 	}
 
-	if (createMesh(*devices, *scene, centering_meshes)) {
+	if (createMesh(*devices, baked_mesh)) {
 		succeeded();
 	} else {
 		failed();
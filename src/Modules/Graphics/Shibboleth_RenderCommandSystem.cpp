@@ -21,9 +21,10 @@ THE SOFTWARE.
 ************************************************************************************/
 
 #include "Shibboleth_RenderCommandSystem.h"
-#include "Shibboleth_RenderManagerBase.h"
 #include "Shibboleth_CameraComponent.h"
+#include "Shibboleth_RenderManager.h"
 #include <Shibboleth_ECSComponentCommon.h>
+#include <Shibboleth_MainLoopAttributes.h>
 #include <Shibboleth_ECSManager.h>
 #include <Gaff_Math.h>
 #include <gtx/euler_angles.hpp>
@@ -34,6 +35,16 @@ SHIB_REFLECTION_DEFINE_BEGIN(Shibboleth::RenderCommandSubmissionSystem)
 SHIB_REFLECTION_DEFINE_END(Shibboleth::RenderCommandSubmissionSystem)
 
 SHIB_REFLECTION_DEFINE_BEGIN(Shibboleth::RenderCommandSystem)
+	.classAttrs(
+		Shibboleth::SystemAccessAttribute::Read<Shibboleth::ECSManager>(),
+		Shibboleth::SystemAccessAttribute::Read<Shibboleth::Position>(),
+		Shibboleth::SystemAccessAttribute::Read<Shibboleth::Rotation>(),
+		Shibboleth::SystemAccessAttribute::Read<Shibboleth::Scale>(),
+		Shibboleth::SystemAccessAttribute::Read<Shibboleth::Camera>(),
+		Shibboleth::SystemAccessAttribute::Write<Shibboleth::RenderManager>(),
+		Shibboleth::SystemAccessAttribute::Write<Shibboleth::ResourceManager>()
+	)
+
 	.template BASE(Shibboleth::ISystem)
 	.template ctor<>()
 SHIB_REFLECTION_DEFINE_END(Shibboleth::RenderCommandSystem)
@@ -283,9 +294,25 @@ void RenderCommandSystem::update(uintptr_t thread_id_int)
 		_job_pool->helpWhileWaiting(thread_id, _job_counter);
 	}
 
+	_culling_stats.clear();
+
+	for (const DeviceJobData& device_job_data : _device_job_data_cache) {
+		for (const RenderJobData& render_data : device_job_data.render_job_data_cache) {
+			CullingStats& stats = _culling_stats[render_data.camera];
+			stats.visible_instances += render_data.visible_count;
+			stats.culled_instances += render_data.culled_count;
+		}
+	}
+
 	_cache_index = (_cache_index + 1) % 2;
 }
 
+const RenderCommandSystem::CullingStats* RenderCommandSystem::getCullingStats(EntityID camera) const
+{
+	const auto it = _culling_stats.find(camera);
+	return (it != _culling_stats.end()) ? &it->second : nullptr;
+}
+
 void RenderCommandSystem::newObjectArchetype(const ECSArchetype& archetype)
 {
 	auto* const material = _materials.back();
@@ -658,43 +685,97 @@ void RenderCommandSystem::GenerateCommandListJob(uintptr_t thread_id_int, void*
 		}
 	}
 
-	Vector<void*> buffer_cache(instance_data.instance_data->pages.size(), nullptr, ProxyAllocator("Graphics"));
+	Vector<void*> buffer_cache(instance_data.instance_data->pages.size(), nullptr, ProxyAllocator::GetFrame());
 
 	for (int32_t j = 0; j < static_cast<int32_t>(buffer_cache.size()); ++j) {
 		buffer_cache[j] = instance_data.instance_data->pages[j].buffer->getBuffer(owning_device)->map(*deferred_device);
 	}
 
-	const Gleam::Vec3& centering_vector = job_data.rcs->_models[job_data.index]->value->getCenteringVector();
+	const ModelResource& model = *job_data.rcs->_models[job_data.index]->value;
+	const Gleam::Vec3& centering_vector = model.getCenteringVector();
+	const Gleam::Vec3 bounds_center = model.getAABB().getCenter();
+	const Gleam::Vec3 bounds_extent = model.getAABB().getExtent();
 
-	job_data.rcs->_ecs_mgr->iterate<Position, Rotation, Scale>(
-		job_data.rcs->_position[job_data.index], job_data.rcs->_rotation[job_data.index], job_data.rcs->_scale[job_data.index],
-		[&](EntityID /*id*/, const Position& obj_pos, const Rotation& obj_rot, const Scale& obj_scale) -> void
-		{
-			const Gleam::Vec3 euler_angles = obj_rot.value * Gaff::TurnsToRad;
+	const ECSQueryResult& position_result = job_data.rcs->_position[job_data.index];
+	const ECSQueryResult& rotation_result = job_data.rcs->_rotation[job_data.index];
+	const ECSQueryResult& scale_result = job_data.rcs->_scale[job_data.index];
+	const int32_t entity_capacity = job_data.rcs->_ecs_mgr->getEntityCapacity(position_result);
+	int32_t culled_count = 0;
 
-			Gleam::Mat4x4 transform = glm::yawPitchRoll(euler_angles.y, euler_angles.x, euler_angles.z);
-			transform[3] = Gleam::Vec4(obj_pos.value, 1.0f);
-			transform = glm::scale(transform, obj_scale.value);
+	// Transform and cull entities a block of 4 at a time, compacting the visible ones into the instance buffers.
+	for (int32_t entity_index = 0; entity_index < entity_capacity && (object_index + culled_count) < object_count; entity_index += 4) {
+		int32_t valid_mask = 0;
 
-			const int32_t instance_index = object_index % instance_data.buffer_instance_count;
-			const int32_t buffer_index = object_index / instance_data.buffer_instance_count;
-			void* const buffer = buffer_cache[buffer_index];
+		for (int32_t lane = 0; lane < 4; ++lane) {
+			if (ValidEntityID(job_data.rcs->_ecs_mgr->getEntityID(position_result, entity_index + lane))) {
+				valid_mask |= 1 << lane;
+			}
+		}
 
-			// Write to instance buffer.
-			Gleam::Mat4x4 center_object = glm::identity<Gleam::Mat4x4>();
-			center_object[3] = Gleam::Vec4(centering_vector, 1.0f);
+		if (!valid_mask) {
+			continue;
+		}
 
-			Gleam::Mat4x4* const matrix = reinterpret_cast<Gleam::Mat4x4*>(reinterpret_cast<int8_t*>(buffer) + (stride * instance_index) + instance_data.model_to_proj_offset);
-			*matrix = job_data.view_projection * transform * center_object;
+		Gleam::Vec4SIMD model_transforms[4][3];
 
+		CalculateTransforms(
+			job_data.rcs->_ecs_mgr->getComponent(position_result, entity_index),
+			job_data.rcs->_ecs_mgr->getComponent(rotation_result, entity_index),
+			job_data.rcs->_ecs_mgr->getComponent(scale_result, entity_index),
+			centering_vector,
+			model_transforms
+		);
+
+		// Move the model's bounds into world space as an OBB per lane.
+		Gleam::Vec4SIMD bounds_world_center[3];
+		Gleam::Vec4SIMD bounds_world_axes[3][3];
+
+		for (int32_t row = 0; row < 3; ++row) {
+			bounds_world_center[row] = model_transforms[3][row] +
+				model_transforms[0][row] * bounds_center.x +
+				model_transforms[1][row] * bounds_center.y +
+				model_transforms[2][row] * bounds_center.z;
+
+			for (int32_t axis = 0; axis < 3; ++axis) {
+				bounds_world_axes[axis][row] = model_transforms[axis][row] * bounds_extent[axis];
+			}
+		}
+
+		const int32_t visible_mask = valid_mask & job_data.frustum.contains(bounds_world_center, bounds_world_axes);
+		Gleam::Mat4x4* out_transforms[4] = { nullptr, nullptr, nullptr, nullptr };
+
+		for (int32_t lane = 0; lane < 4; ++lane) {
+			if (!(valid_mask & (1 << lane))) {
+				continue;
+			}
+
+			if (!(visible_mask & (1 << lane))) {
+				++culled_count;
+				continue;
+			}
+
+			const int32_t instance_index = object_index % instance_data.buffer_instance_count;
+			const int32_t buffer_index = object_index / instance_data.buffer_instance_count;
+			int8_t* const buffer = reinterpret_cast<int8_t*>(buffer_cache[buffer_index]);
+
+			out_transforms[lane] = reinterpret_cast<Gleam::Mat4x4*>(buffer + (stride * instance_index) + instance_data.model_to_proj_offset);
 			++object_index;
 		}
-	);
+
+		if (visible_mask) {
+			StoreTransforms(model_transforms, job_data.view_projection, out_transforms);
+		}
+	}
 
 	for (const auto& page : instance_data.instance_data->pages) {
 		page.buffer->getBuffer(owning_device)->unmap(*deferred_device);
 	}
 
+	job_data.visible_count = object_index;
+	job_data.culled_count = culled_count;
+
+	const int32_t num_visible_pages = (object_index + instance_data.buffer_instance_count - 1) / instance_data.buffer_instance_count;
+
 
 	// Iterate over all the instance buffers and set their resource views and render.
 	Gleam::IProgramBuffers* const pb = instance_data.program_buffers->getProgramBuffer(owning_device);
@@ -706,7 +787,7 @@ void RenderCommandSystem::GenerateCommandListJob(uintptr_t thread_id_int, void*
 			continue;
 		}
 
-		for (int32_t k = 0; k < num_pages; ++k) {
+		for (int32_t k = 0; k < num_visible_pages; ++k) {
 			for (int32_t j = 0; j < static_cast<int32_t>(Gleam::IShader::Type::PipelineCount); ++j) {
 				InstanceData::BufferVarMap& var_map = instance_data.pipeline_data[j].buffer_vars;
 
@@ -724,7 +805,7 @@ void RenderCommandSystem::GenerateCommandListJob(uintptr_t thread_id_int, void*
 			}
 
 			pb->bind(*deferred_device);
-			mesh->renderInstanced(*deferred_device, object_count);
+			mesh->renderInstanced(*deferred_device, eastl::min(object_index - k * instance_data.buffer_instance_count, instance_data.buffer_instance_count));
 		}
 	}
 
@@ -785,6 +866,7 @@ void RenderCommandSystem::DeviceJob(uintptr_t thread_id_int, void* data)
 					camera_transform[3] = Gleam::Vec4(cam_pos.value, 1.0f);
 
 					const Gleam::Mat4x4 final_camera = projection * glm::inverse(camera_transform);
+					const Gleam::Frustum camera_frustum(final_camera);
 
 					for (int32_t i = 0; i < num_objects; ++i) {
 						const int32_t cache_index = job_data.rcs->_cache_index;
@@ -816,6 +898,10 @@ void RenderCommandSystem::DeviceJob(uintptr_t thread_id_int, void* data)
 						render_data.device = &device;
 						render_data.target = render_target;
 						render_data.view_projection = final_camera;
+						render_data.frustum = camera_frustum;
+						render_data.camera = id;
+						render_data.visible_count = 0;
+						render_data.culled_count = 0;
 					}
 				}
 			}
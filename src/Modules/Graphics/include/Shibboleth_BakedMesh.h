@@ -0,0 +1,114 @@
+/************************************************************************************
+Copyright (C) 2022 by Nicholas LaCroix
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+************************************************************************************/
+
+#pragma once
+
+#include <Shibboleth_Vector.h>
+#include <Gleam_AABB.h>
+#include <Gaff_Hash.h>
+#include <EASTL/string_view.h>
+
+struct aiScene;
+
+NS_SHIBBOLETH
+
+// Identifies what a bake was made from. Compared against the source file's stats, so checking a bake never reads the source.
+struct BakedMeshSource final
+{
+	uint64_t size;
+	int64_t modified_time;
+	Gaff::Hash64 options_hash;
+
+	bool operator==(const BakedMeshSource& rhs) const = default;
+};
+
+// On disk layout. Everything is little endian and offsets are from the start of the blob.
+struct BakedMeshHeader final
+{
+	uint32_t magic;
+	uint32_t version;
+	BakedMeshSource source;
+	float centering_vector[3];
+	int32_t num_submeshes;
+};
+
+struct BakedSubmeshHeader final
+{
+	static constexpr int32_t k_max_streams = 16;
+
+	float aabb_min[3];
+	float aabb_max[3];
+
+	uint64_t name_offset;
+	uint64_t vertex_offset;
+	uint64_t index_offset;
+
+	int32_t name_size;
+	int32_t vertex_count;
+	int32_t vertex_stride;
+	int32_t index_count;
+	int32_t index_size;
+	int32_t stream_count;
+
+	uint32_t stream_offsets[k_max_streams];
+};
+
+static_assert(sizeof(BakedMeshSource) == 24, "BakedMeshSource layout changed. Bump BakedMesh::k_version.");
+static_assert(sizeof(BakedMeshHeader) == 48, "BakedMeshHeader layout changed. Bump BakedMesh::k_version.");
+static_assert(sizeof(BakedSubmeshHeader) == 136, "BakedSubmeshHeader layout changed. Bump BakedMesh::k_version.");
+
+// Read-only view of a baked mesh blob. Vertex and index data are stored exactly as the GPU buffers expect them,
+// so they can be handed to IBuffer::init() straight out of a file buffer or memory map.
+class BakedMesh final
+{
+public:
+	static constexpr uint32_t k_magic = 0x4D424853; // "SHBM"
+	static constexpr uint32_t k_version = 2;
+	static constexpr size_t k_data_alignment = 16;
+
+	// Appended to the model resource path to find its baked mesh.
+	static constexpr const char8_t* const k_extension = u8".bmesh";
+
+	// Triangles are expected to already be in vertex cache friendly order. Vertices are re-ordered by first use.
+	static bool Bake(const aiScene& scene, const Vector<int32_t>& centering_meshes, const BakedMeshSource& source, Vector<int8_t>& out);
+
+	// Does not copy data. data must outlive this view.
+	bool init(const void* data, size_t size);
+
+	const BakedMeshSource& getSource(void) const;
+	Gleam::Vec3 getCenteringVector(void) const;
+
+	int32_t getNumSubmeshes(void) const;
+	const BakedSubmeshHeader& getSubmesh(int32_t index) const;
+	eastl::u8string_view getSubmeshName(int32_t index) const;
+	Gleam::AABB getSubmeshAABB(int32_t index) const;
+	const void* getVertexData(int32_t index) const;
+	const void* getIndexData(int32_t index) const;
+
+private:
+	const int8_t* _data = nullptr;
+	size_t _size = 0;
+
+	const BakedMeshHeader& getHeader(void) const;
+};
+
+NS_END
@@ -29,6 +29,7 @@ NS_SHIBBOLETH
 // Graphics
 constexpr const char8_t* const k_config_graphics_cfg = u8"graphics_cfg";
 constexpr const char8_t* const k_config_graphics_no_windows = u8"graphics_no_windows";
+constexpr const char8_t* const k_config_graphics_write_baked_meshes = u8"graphics_write_baked_meshes";
 
 constexpr const char8_t* const k_config_graphics_default_cfg = u8"cfg/graphics.cfg";
 
@@ -33,6 +33,7 @@ static constexpr Gaff::Hash32 k_log_channel_graphics = Gaff::FNV1aHash32StringCo
 #define LogWarningGraphics(msg, ...) LogWarning(Shibboleth::k_log_channel_resource, msg, ##__VA_ARGS__)
 #define LogErrorGraphics(msg, ...) LogError(Shibboleth::k_log_channel_graphics, msg, ##__VA_ARGS__)
 #define LogInfoGraphics(msg, ...) LogInfo(Shibboleth::k_log_channel_resource, msg, ##__VA_ARGS__)
+#define LogDebugGraphics(msg, ...) LogDebug(Shibboleth::k_log_channel_graphics, msg, ##__VA_ARGS__)
 
 #define LogInfoStringGraphics(msg, ...) Shibboleth::GetApp().getLogManager().logMessage(Shibboleth::LogType::Info, Shibboleth::k_log_channel_graphics, msg);
 
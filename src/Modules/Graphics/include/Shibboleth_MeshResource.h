@@ -31,6 +31,8 @@ struct aiMesh;
 
 NS_SHIBBOLETH
 
+class BakedMesh;
+
 class MeshResource final : public IResource
 {
 public:
@@ -40,6 +42,7 @@ public:
 
 	bool createMesh(const Vector<Gleam::IRenderDevice*>& devices, const aiMesh& mesh);
 	bool createMesh(Gleam::IRenderDevice& device, const aiMesh& mesh);
+	bool createMesh(const Vector<Gleam::IRenderDevice*>& devices, const BakedMesh& mesh, int32_t submesh);
 
 	const Gleam::IMesh* getMesh(const Gleam::IRenderDevice& rd) const;
 	Gleam::IMesh* getMesh(const Gleam::IRenderDevice& rd);
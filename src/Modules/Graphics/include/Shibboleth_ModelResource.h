@@ -38,6 +38,7 @@ public:
 	bool createMesh(const Vector<Gleam::IRenderDevice*>& devices, const aiScene& scene, const Vector<int32_t>& centering_meshes);
 	bool createMesh(Gleam::IRenderDevice& device, const aiScene& scene, const Vector<int32_t>& centering_meshes);
 	bool createMesh(const Vector<MeshResourcePtr>& meshes, const Vector<int32_t>& centering_meshes);
+	bool createMesh(const Vector<Gleam::IRenderDevice*>& devices, const BakedMesh& mesh);
 	bool createMesh(const Vector<Gleam::IRenderDevice*>& devices, const aiScene& scene);
 	bool createMesh(Gleam::IRenderDevice& device, const aiScene& scene);
 	bool createMesh(const Vector<MeshResourcePtr>& meshes);
@@ -46,10 +47,14 @@ public:
 	int32_t getNumMeshes(void) const;
 
 	const Gleam::Vec3& getCenteringVector(void) const;
+	const Gleam::AABB& getAABB(void) const;
 
 private:
 	Vector<MeshResourcePtr> _meshes{ ProxyAllocator("Graphics") };
 	Gleam::Vec3 _centering_vector = glm::zero<Gleam::Vec3>();
+	Gleam::AABB _aabb;
+
+	void calculateAABB(void);
 
 	void loadModel(IFile* file, uintptr_t thread_id_int);
 
@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include <Shibboleth_ECSQuery.h>
 #include <Shibboleth_ISystem.h>
 #include <Shibboleth_JobPool.h>
+#include <Gleam_Frustum.h>
 
 NS_GLEAM
 	class IRenderTarget;
@@ -73,9 +74,18 @@ public:
 	static constexpr const char8_t* ProgramBuffersFormat = u8"RenderCommandSystem:ProgramBuffers:%llu";
 	static constexpr const char8_t* ConstBufferFormat = u8"RenderCommandSystem:ConstBuffer:%s:%llu";
 
+	struct CullingStats final
+	{
+		int32_t visible_instances = 0;
+		int32_t culled_instances = 0;
+	};
+
 	bool init(void) override;
 	void update(uintptr_t thread_id_int) override;
 
+	// Instance counts from the last update, summed over every device the camera renders to.
+	const CullingStats* getCullingStats(EntityID camera) const;
+
 private:
 	struct InstanceData final
 	{
@@ -120,6 +130,11 @@ private:
 		Gleam::IRenderTarget* target;
 
 		Gleam::Mat4x4 view_projection;
+		Gleam::Frustum frustum;
+
+		EntityID camera;
+		int32_t visible_count;
+		int32_t culled_count;
 	};
 
 	struct DeviceJobData final
@@ -164,6 +179,8 @@ private:
 	Vector<ECSQueryResult> _rotation{ ProxyAllocator("Graphics") };
 	Vector<ECSQueryResult> _scale{ ProxyAllocator("Graphics") };
 
+	VectorMap<EntityID, CullingStats> _culling_stats{ ProxyAllocator("Graphics") };
+
 	Vector<DeviceJobData> _device_job_data_cache{ ProxyAllocator("Graphics") };
 	Vector<Gaff::JobData> _job_data_cache{ ProxyAllocator("Graphics") };
 	Gaff::Counter _job_counter = 0;
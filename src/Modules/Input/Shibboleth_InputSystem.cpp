@@ -22,9 +22,17 @@ THE SOFTWARE.
 
 #include "Shibboleth_InputSystem.h"
 #include "Shibboleth_InputManager.h"
+#include <Shibboleth_MainLoopAttributes.h>
 #include <Shibboleth_AppUtils.h>
 
-SHIB_REFLECTION_DEFINE_WITH_CTOR_AND_BASE(Shibboleth::InputSystem, Shibboleth::ISystem)
+SHIB_REFLECTION_DEFINE_BEGIN(Shibboleth::InputSystem)
+	.classAttrs(
+		Shibboleth::SystemAccessAttribute::Write<Shibboleth::InputManager>()
+	)
+
+	.template BASE(Shibboleth::ISystem)
+	.template ctor<>()
+SHIB_REFLECTION_DEFINE_END(Shibboleth::InputSystem)
 
 NS_SHIBBOLETH
 
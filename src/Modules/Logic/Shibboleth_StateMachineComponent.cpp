@@ -92,7 +92,7 @@ bool StateMachine::Load(const ISerializeReader& reader, StateMachine& out)
 		return false;
 	}
 
-	while (out.resource->getState() == ResourceState::Pending) {
+	while (out.resource->isPending()) {
 		// $TODO: Help out?
 		EA::Thread::ThreadSleep();
 	}
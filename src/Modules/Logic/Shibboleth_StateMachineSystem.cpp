@@ -49,8 +49,9 @@ bool StateMachineSystem::init(void)
 
 void StateMachineSystem::update(uintptr_t /*thread_id_int*/)
 {
-	// $TODO: Jobify this loop.
 	for (const auto& sm_arch : _state_machines) {
+		// Not parallelIterate. Processes are shared by every instance of a state machine and aren't thread-safe,
+		// e.g. LuaProcess keeps per-process state and restores it into whichever Lua state it is handed.
 		_ecs_mgr->iterate<StateMachine>(
 			sm_arch,
 			[](EntityID id, StateMachine& state_machine) -> void
@@ -21,10 +21,15 @@ THE SOFTWARE.
 ************************************************************************************/
 
 #include "Shibboleth_GameTimeSystem.h"
+#include "Shibboleth_MainLoopAttributes.h"
 #include "Shibboleth_GameTime.h"
 #include <Shibboleth_AppUtils.h>
 
 SHIB_REFLECTION_DEFINE_BEGIN(Shibboleth::GameTimeSystem)
+	.classAttrs(
+		Shibboleth::SystemAccessAttribute::Write<Shibboleth::GameTimeManager>()
+	)
+
 	.template BASE(Shibboleth::ISystem)
 	.template ctor<>()
 SHIB_REFLECTION_DEFINE_END(Shibboleth::GameTimeSystem)
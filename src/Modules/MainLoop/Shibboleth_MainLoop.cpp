@@ -21,6 +21,8 @@ THE SOFTWARE.
 ************************************************************************************/
 
 #include "Shibboleth_MainLoop.h"
+#include "Shibboleth_MainLoopAttributes.h"
+#include "Shibboleth_SystemGraph.h"
 #include <Shibboleth_SerializeReaderWrapper.h>
 #include <Shibboleth_AppConfigs.h>
 #include <Shibboleth_LogManager.h>
@@ -28,6 +30,8 @@ THE SOFTWARE.
 #include <Shibboleth_ISystem.h>
 #include <Shibboleth_AppUtils.h>
 #include <eathread/eathread.h>
+#include <EASTL/algorithm.h>
+#include <EASTL/chrono.h>
 
 SHIB_REFLECTION_DEFINE_BEGIN(Shibboleth::MainLoop)
 	.template BASE(Shibboleth::IMainLoop)
@@ -38,10 +42,10 @@ NS_SHIBBOLETH
 
 SHIB_REFLECTION_CLASS_DEFINE(MainLoop)
 
-static void UpdateSystemJob(uintptr_t thread_id_int, void* data)
+static int64_t GetTimeNS(void)
 {
-	ISystem* const system = reinterpret_cast<ISystem*>(data);
-	system->update(thread_id_int);
+	const auto now = eastl::chrono::high_resolution_clock::now().time_since_epoch();
+	return eastl::chrono::duration_cast<eastl::chrono::nanoseconds>(now).count();
 }
 
 bool MainLoop::init(void)
@@ -73,9 +77,6 @@ bool MainLoop::init(void)
 
 	_blocks.resize(reader.size());
 
-	//_systems.resize(reader.size());
-	//_job_data.resize(reader.size());
-
 	for (int32_t i = 0; i < reader.size(); ++i) {
 		const auto guard_1 = reader.enterElementGuard(i);
 
@@ -85,7 +86,6 @@ bool MainLoop::init(void)
 		}
 
 		UpdateBlock& block = _blocks[i];
-		block.rows.resize(reader.size());
 
 		for (int32_t j = 0; j < reader.size(); ++j) {
 			const auto guard_2 = reader.enterElementGuard(j);
@@ -95,10 +95,6 @@ bool MainLoop::init(void)
 				return false;
 			}
 
-			UpdateRow& row = block.rows[j];
-			row.job_data.resize(reader.size());
-			row.systems.resize(reader.size());
-
 			for (int32_t k = 0; k < reader.size(); ++k) {
 				const auto guard_3 = reader.enterElementGuard(k);
 
@@ -107,77 +103,50 @@ bool MainLoop::init(void)
 					return false;
 				}
 
-				const char8_t* system_name = reader.readString();
-				const bool optional = system_name[0] == u8'!';
+				// Points into the config's data. Not null terminated.
+				eastl::u8string_view system_name = reader.readStringView();
+				const bool optional = !system_name.empty() && system_name[0] == u8'!';
 
 				if (optional) {
-					++system_name;
+					system_name.remove_prefix(1);
 				}
 
-				const Gaff::Hash64 hash =  Gaff::FNV1aHash64String(system_name);
+				const int32_t name_length = static_cast<int32_t>(system_name.size());
+				const Gaff::Hash64 hash = Gaff::FNV1aHash64(reinterpret_cast<const char*>(system_name.data()), system_name.size());
 				const auto it = eastl::lower_bound(systems->begin(), systems->end(), hash, ReflectionManager::CompareRefHash);
 
 				if (it == systems->end() || hash != (*it)->getReflectionInstance().getHash()) {
+					LogErrorDefault("MainLoop: Could not find system '%.*s'.", name_length, system_name.data());
+
 					if (optional) {
-						LogErrorDefault("MainLoop: Could not find system '%s'.", system_name);
-						reader.freeString(system_name - 1);
 						continue;
-
-					} else {
-						LogErrorDefault("MainLoop: Could not find system '%s'.", system_name);
-						reader.freeString(system_name);
-						return false;
 					}
+
+					return false;
 				}
 
 				ISystem* const system = (*it)->createT<ISystem>(allocator);
 
 				if (!system) {
-					LogErrorDefault("MainLoop: Failed to create system '%s'", system_name);
-					reader.freeString(system_name);
+					LogErrorDefault("MainLoop: Failed to create system '%.*s'", name_length, system_name.data());
 					return false;
 				}
 
 				if (!system->init()) {
-					LogErrorDefault("MainLoop: Failed to initialize system '%s'", system_name);
-					reader.freeString(system_name);
+					LogErrorDefault("MainLoop: Failed to initialize system '%.*s'", name_length, system_name.data());
 					return false;
 				}
 
-				reader.freeString(system_name);
-
-				row.systems[k].reset(system);
-
-				row.job_data[k].job_func = UpdateSystemJob;
-				row.job_data[k].job_data = system;
+				SystemNode& node = block.systems.emplace_back();
+				node.system.reset(system);
+				node.row = j;
 			}
 		}
 	}
 
-	for (int32_t i = 0; i < static_cast<int32_t>(_blocks.size()); ++i) {
-		UpdateBlock& block = _blocks[i];
-
-		for (int32_t j = 0; j < static_cast<int32_t>(block.rows.size()); ++j) {
-			UpdateRow& row = block.rows[j];
-
-			for (int32_t k = 0; k < static_cast<int32_t>(row.systems.size()); ++k) {
-				if (!row.systems[k]) {
-					row.job_data.erase(row.job_data.begin() + k);
-					row.systems.erase(row.systems.begin() + k);
-					--k;
-				}
-			}
-
-			if (row.systems.empty()) {
-				block.rows.erase(block.rows.begin() + j);
-				--j;
-			}
-		}
-
-		if (block.rows.empty()) {
-			block.rows.erase(block.rows.begin() + i);
-			--i;
-		}
+	// Blocks won't move anymore, safe to hand out pointers.
+	for (UpdateBlock& block : _blocks) {
+		buildDependencies(block);
 	}
 
 	_update_windows = !app.getConfigs().getObject(k_config_app_editor_mode).getBool(false);
@@ -193,6 +162,11 @@ void MainLoop::destroy(void)
 void MainLoop::update(void)
 {
 	const int32_t num_blocks = static_cast<int32_t>(_blocks.size());
+	const int64_t now = GetTimeNS();
+
+	if (!num_blocks) {
+		ResetFrameAllocator();
+	}
 
 	for (int32_t i = 0; i < num_blocks; ++i) {
 		UpdateBlock& block = _blocks[i];
@@ -203,58 +177,195 @@ void MainLoop::update(void)
 			continue;
 		}
 
-		// We finished our jobs, increment the current row.
-		if (job_counter == 0) {
-			++block.curr_row;
+		// We finished all our systems, increment the frame count.
+		if (job_counter == 0 && block.running) {
+			block.frame = (block.frame + 1) % k_num_block_frames;
+			block.running = false;
+
+			block.finish_time = now;
+			block.run_time.add(now - block.start_time);
 
-			// We finished our block, increment the frame count and reset current row.
-			if (block.curr_row >= static_cast<int32_t>(block.rows.size())) {
-				block.frame = (block.frame + 1) % 3;
-				block.curr_row = -1;
+			// Last block finished, the whole frame is done.
+			if (i == (num_blocks - 1)) {
+				ResetFrameAllocator();
 			}
 		}
 
-		// We're waiting for another block.
-		if (block.curr_row < 0) {
-			// Check previous block.
-			if (i > 0) {
-				// If we're on the same frame, then it hasn't given us anything to act on. Wait for it to finish.
-				if (block.frame == _blocks[static_cast<size_t>(i - 1)].frame) {
-					block.counter = -1;
-					continue;
-				}
-			}
+		const int32_t prev_frame = (i > 0) ? _blocks[static_cast<size_t>(i - 1)].frame : -1;
+		const int32_t next_frame = (i < (num_blocks - 1)) ? _blocks[static_cast<size_t>(i + 1)].frame : -1;
 
-			// Check next block.
-			if (i < (num_blocks - 1)) {
-				const int32_t next_block_curr_frame = _blocks[static_cast<size_t>(i + 1)].frame;
-				const int32_t next_block_next_frame = (_blocks[static_cast<size_t>(i + 1)].frame + 1) % 3;
+		if (!CanStartBlock(block.frame, prev_frame, next_frame)) {
+			block.counter = -1;
+			continue;
+		}
 
-				// We're getting too far ahead of the next section. Wait for it to finish.
-				if (block.frame != next_block_curr_frame && block.frame != next_block_next_frame) {
-					block.counter = -1;
-					continue;
-				}
-			}
+		// Start the block. Everything else gets kicked off as its dependencies finish.
+		for (SystemNode& node : block.systems) {
+			node.remaining_dependencies = node.num_dependencies;
+		}
 
-			block.curr_row = 0;
+		if (block.finish_time) {
+			block.stall_time.add(now - block.finish_time);
 		}
 
-		// Process the next row.
+		block.start_time = now;
 		block.counter = 0;
+		block.running = true;
+
+		if (!block.root_job_data.empty()) {
+			_job_pool->addJobs(
+				block.root_job_data.data(),
+				static_cast<int32_t>(block.root_job_data.size()),
+				block.counter
+			);
+		}
+	}
+
+	if (!num_blocks) {
+		// Nothing to wait on. Help out a little and give some time to other threads.
+		_job_pool->help(_job_pool->getMainThreadID());
+		EA::Thread::ThreadSleep();
+		return;
+	}
+
+	// Help out until a block finishes. That is the only thing that lets us start more work.
+	_job_pool->helpUntil(_job_pool->getMainThreadID(), [this]() -> bool
+	{
+		for (const UpdateBlock& block : _blocks) {
+			if (block.running && block.counter <= 0) {
+				return true;
+			}
+		}
+
+		return false;
+	});
+}
+
+void MainLoop::getSystemTimings(Vector<SystemTimingStats>& out) const
+{
+	out.clear();
+
+	for (int32_t i = 0; i < static_cast<int32_t>(_blocks.size()); ++i) {
+		for (const SystemNode& node : _blocks[i].systems) {
+			SystemTimingStats& stats = out.emplace_back();
+			stats.name = node.system->getReflectionDefinition().getReflectionInstance().getName();
+			stats.block = i;
+			stats.row = node.row;
+			stats.update = node.update_time.calculate();
+			stats.wait = node.wait_time.calculate();
+		}
+	}
+}
+
+void MainLoop::getBlockTimings(Vector<BlockTimingStats>& out) const
+{
+	out.clear();
+
+	for (const UpdateBlock& block : _blocks) {
+		BlockTimingStats& stats = out.emplace_back();
+		stats.run = block.run_time.calculate();
+		stats.stall = block.stall_time.calculate();
+	}
+}
+
+void MainLoop::buildDependencies(UpdateBlock& block)
+{
+	const int32_t num_systems = static_cast<int32_t>(block.systems.size());
+	Vector<SystemGraphNode> graph(static_cast<size_t>(num_systems), ProxyAllocator("MainLoop"));
+
+	block.job_data.resize(static_cast<size_t>(num_systems));
+	block.root_job_data.clear();
+
+	for (int32_t i = 0; i < num_systems; ++i) {
+		SystemNode& node = block.systems[i];
+
+		node.system->getReflectionDefinition().getClassAttrs(graph[i].accesses);
+		graph[i].row = node.row;
+
+		node.block = &block;
+		node.job_pool = _job_pool;
+
+		block.job_data[i].job_func = UpdateSystemJob;
+		block.job_data[i].job_data = &node;
+	}
+
+	BuildSystemGraph(graph);
+
+	for (int32_t i = 0; i < num_systems; ++i) {
+		SystemNode& node = block.systems[i];
+		node.dependents = std::move(graph[i].dependents);
+		node.num_dependencies = graph[i].num_dependencies;
+
+		if (!node.num_dependencies) {
+			block.root_job_data.emplace_back(block.job_data[i]);
+		}
+	}
+}
+
+void MainLoop::UpdateSystemJob(uintptr_t thread_id_int, void* data)
+{
+	SystemNode& node = *reinterpret_cast<SystemNode*>(data);
+	const int64_t start = GetTimeNS();
+
+	node.system->update(thread_id_int);
+
+	const int64_t end = GetTimeNS();
+	node.wait_time.add(start - node.block->start_time);
+	node.update_time.add(end - start);
+
+	// This job still counts against the block's counter, so the block can't be seen as finished before dependents are added.
+	for (const int32_t index : node.dependents) {
+		if (--node.block->systems[index].remaining_dependencies == 0) {
+			node.job_pool->addJobs(&node.block->job_data[index], 1, node.block->counter);
+		}
+	}
+}
+
+MainLoop::TimingHistory::TimingHistory(void)
+{
+	for (eastl::atomic<int64_t>& sample : samples) {
+		sample.store(0, eastl::memory_order_relaxed);
+	}
+}
 
-		_job_pool->addJobs(
-			block.rows[block.curr_row].job_data.data(),
-			static_cast<int32_t>(block.rows[block.curr_row].job_data.size()),
-			block.counter
-		);
+void MainLoop::TimingHistory::add(int64_t sample)
+{
+	const int32_t index = num_samples.load(eastl::memory_order_relaxed);
+	samples[index % k_num_samples].store(sample, eastl::memory_order_relaxed);
+
+	// Wrap well before overflowing, but keep the count above k_num_samples so readers know the ring is full.
+	num_samples.store((index + 1 >= k_num_samples * 2) ? k_num_samples : index + 1, eastl::memory_order_release);
+}
+
+TimingStats MainLoop::TimingHistory::calculate(void) const
+{
+	const int32_t count = eastl::min(num_samples.load(eastl::memory_order_acquire), k_num_samples);
+	TimingStats stats;
+
+	if (!count) {
+		return stats;
 	}
 
-	// Help out a little before the next iteration.
-	_job_pool->help(_job_pool->getMainThreadID());
+	int64_t sorted[k_num_samples];
+	int64_t total = 0;
+
+	for (int32_t i = 0; i < count; ++i) {
+		sorted[i] = samples[i].load(eastl::memory_order_relaxed);
+		total += sorted[i];
+	}
+
+	eastl::sort(sorted, sorted + count);
+
+	// Nearest rank.
+	const int32_t p99_index = eastl::max((count * 99 + 99) / 100 - 1, 0);
+
+	stats.min_ns = sorted[0];
+	stats.avg_ns = total / count;
+	stats.max_ns = sorted[count - 1];
+	stats.p99_ns = sorted[p99_index];
+	stats.num_samples = count;
 
-	// Give some time to other threads.
-	EA::Thread::ThreadSleep();
+	return stats;
 }
 
 NS_END
@@ -0,0 +1,87 @@
+/************************************************************************************
+Copyright (C) 2022 by Nicholas LaCroix
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+************************************************************************************/
+
+#include "Shibboleth_SystemGraph.h"
+#include "Shibboleth_MainLoopAttributes.h"
+
+NS_SHIBBOLETH
+
+bool SystemsConflict(const Vector<const SystemAccessAttribute*>& lhs, const Vector<const SystemAccessAttribute*>& rhs)
+{
+	// Systems that don't declare what they touch are assumed to touch everything.
+	if (lhs.empty() || rhs.empty()) {
+		return true;
+	}
+
+	for (const SystemAccessAttribute* lhs_access : lhs) {
+		for (const SystemAccessAttribute* rhs_access : rhs) {
+			if (lhs_access->conflictsWith(*rhs_access)) {
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+void BuildSystemGraph(Vector<SystemGraphNode>& nodes)
+{
+	const int32_t num_nodes = static_cast<int32_t>(nodes.size());
+
+	for (SystemGraphNode& node : nodes) {
+		node.dependents.clear();
+		node.num_dependencies = 0;
+	}
+
+	// Systems in the same row were already declared safe to run together.
+	for (int32_t i = 0; i < num_nodes; ++i) {
+		SystemGraphNode& node = nodes[i];
+
+		for (int32_t j = i + 1; j < num_nodes; ++j) {
+			SystemGraphNode& other = nodes[j];
+
+			if (other.row == node.row || !SystemsConflict(node.accesses, other.accesses)) {
+				continue;
+			}
+
+			node.dependents.emplace_back(j);
+			++other.num_dependencies;
+		}
+	}
+}
+
+bool CanStartBlock(int32_t frame, int32_t prev_frame, int32_t next_frame)
+{
+	// If we're on the same frame as the previous block, then it hasn't given us anything to act on. Wait for it to finish.
+	if (prev_frame > -1 && frame == prev_frame) {
+		return false;
+	}
+
+	// We're getting too far ahead of the next block. Wait for it to finish.
+	if (next_frame > -1 && frame != next_frame && frame != (next_frame + 1) % k_num_block_frames) {
+		return false;
+	}
+
+	return true;
+}
+
+NS_END
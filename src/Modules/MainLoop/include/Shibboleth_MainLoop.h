@@ -37,27 +37,89 @@ public:
 	void destroy(void) override;
 	void update(void) override;
 
+	void getSystemTimings(Vector<SystemTimingStats>& out) const override;
+	void getBlockTimings(Vector<BlockTimingStats>& out) const override;
+
 private:
-	struct UpdateRow final
+	// Ring buffer of the most recent samples, in nanoseconds. Only one thread adds samples at a time,
+	// but any thread can read. Readers may see a sample from the previous trip around the ring, which is fine for stats.
+	struct TimingHistory final
 	{
-		Vector< UniquePtr<ISystem> > systems{ ProxyAllocator("MainLoop") };
-		Vector<Gaff::JobData> job_data{ ProxyAllocator("MainLoop") };
+		static constexpr int32_t k_num_samples = 128;
+
+		eastl::atomic<int64_t> samples[k_num_samples];
+		eastl::atomic<int32_t> num_samples = 0;
+
+		TimingHistory(void);
+
+		void add(int64_t sample);
+		TimingStats calculate(void) const;
+	};
+
+	struct UpdateBlock;
+
+	struct SystemNode final
+	{
+		UniquePtr<ISystem> system;
+
+		// Indices of systems in the same block that have to wait on this one.
+		Vector<int32_t> dependents{ ProxyAllocator("MainLoop") };
+		Gaff::Counter remaining_dependencies = 0;
+		int32_t num_dependencies = 0;
+
+		// Row in cfg/update_phases.cfg. Conflicting systems run in row order.
+		int32_t row = 0;
+
+		UpdateBlock* block = nullptr;
+		JobPool* job_pool = nullptr;
+
+		TimingHistory update_time;
+		TimingHistory wait_time;
+
+		SystemNode(void) = default;
+
+		SystemNode(SystemNode&& node):
+			system(std::move(node.system)),
+			dependents(std::move(node.dependents)),
+			remaining_dependencies(static_cast<int32_t>(node.remaining_dependencies)),
+			num_dependencies(node.num_dependencies),
+			row(node.row),
+			block(node.block),
+			job_pool(node.job_pool)
+		{
+		}
 	};
 
 	struct UpdateBlock final
 	{
-		Vector<UpdateRow> rows{ ProxyAllocator("MainLoop") };
+		Vector<SystemNode> systems{ ProxyAllocator("MainLoop") };
+		Vector<Gaff::JobData> job_data{ ProxyAllocator("MainLoop") };
+
+		// Systems with no dependencies. These are kicked off when the block starts.
+		Vector<Gaff::JobData> root_job_data{ ProxyAllocator("MainLoop") };
+
 		Gaff::Counter counter = -1;
-		int32_t curr_row = -1;
 		int32_t frame = 0;
+		bool running = false;
+
+		// Written on the main thread before any of the block's jobs are added.
+		int64_t start_time = 0;
+		int64_t finish_time = 0;
+
+		TimingHistory run_time;
+		TimingHistory stall_time;
 
 		UpdateBlock(void) = default;
 
 		UpdateBlock(UpdateBlock&& block):
-			rows(std::move(block.rows)),
+			systems(std::move(block.systems)),
+			job_data(std::move(block.job_data)),
+			root_job_data(std::move(block.root_job_data)),
 			counter(static_cast<int32_t>(block.counter)),
-			curr_row(block.curr_row),
-			frame(block.frame)
+			frame(block.frame),
+			running(block.running),
+			start_time(block.start_time),
+			finish_time(block.finish_time)
 		{
 		}
 	};
@@ -67,6 +129,10 @@ private:
 
 	bool _update_windows = true;
 
+	void buildDependencies(UpdateBlock& block);
+
+	static void UpdateSystemJob(uintptr_t thread_id_int, void* data);
+
 	SHIB_REFLECTION_CLASS_DECLARE(MainLoop);
 };
 
@@ -0,0 +1,71 @@
+/************************************************************************************
+Copyright (C) 2022 by Nicholas LaCroix
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+************************************************************************************/
+
+#pragma once
+
+#include <Shibboleth_Reflection.h>
+
+NS_SHIBBOLETH
+
+// Declares a component or manager an ISystem reads or writes while updating.
+// MainLoop uses these to decide which systems in a block can run at the same time.
+// A system with no access attributes is assumed to touch everything.
+class SystemAccessAttribute final : public Refl::IAttribute
+{
+public:
+	enum class Access
+	{
+		Read,
+		Write
+	};
+
+	template <class T>
+	static SystemAccessAttribute Read(void)
+	{
+		return SystemAccessAttribute(Refl::Reflection<T>::GetHash(), Access::Read);
+	}
+
+	template <class T>
+	static SystemAccessAttribute Write(void)
+	{
+		return SystemAccessAttribute(Refl::Reflection<T>::GetHash(), Access::Write);
+	}
+
+	SystemAccessAttribute(Gaff::Hash64 type_hash, Access access);
+
+	Gaff::Hash64 getTypeHash(void) const;
+	Access getAccess(void) const;
+
+	bool conflictsWith(const SystemAccessAttribute& rhs) const;
+
+	Refl::IAttribute* clone(void) const override;
+
+private:
+	Gaff::Hash64 _type_hash;
+	Access _access;
+
+	SHIB_REFLECTION_CLASS_DECLARE(SystemAccessAttribute);
+};
+
+NS_END
+
+SHIB_REFLECTION_DECLARE(Shibboleth::SystemAccessAttribute)
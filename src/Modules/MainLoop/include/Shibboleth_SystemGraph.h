@@ -0,0 +1,58 @@
+/************************************************************************************
+Copyright (C) 2022 by Nicholas LaCroix
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+************************************************************************************/
+
+#pragma once
+
+#include <Shibboleth_Vector.h>
+
+NS_SHIBBOLETH
+
+class SystemAccessAttribute;
+
+// The rules MainLoop schedules systems and update blocks by.
+// Kept apart from MainLoop so they can be exercised without an app.
+struct SystemGraphNode final
+{
+	// Row in cfg/update_phases.cfg. Conflicting systems run in row order.
+	int32_t row = 0;
+
+	// Empty means the system is assumed to touch everything.
+	Vector<const SystemAccessAttribute*> accesses{ ProxyAllocator("MainLoop") };
+
+	// Filled in by BuildSystemGraph(). Indices of systems that have to wait on this one.
+	Vector<int32_t> dependents{ ProxyAllocator("MainLoop") };
+	int32_t num_dependencies = 0;
+};
+
+// Blocks cycle through this many frames, so a block can be at most one frame ahead of the block after it.
+constexpr int32_t k_num_block_frames = 3;
+
+bool SystemsConflict(const Vector<const SystemAccessAttribute*>& lhs, const Vector<const SystemAccessAttribute*>& rhs);
+
+// Systems in the same row never wait on each other. Otherwise, a system waits on every conflicting system from an earlier row.
+void BuildSystemGraph(Vector<SystemGraphNode>& nodes);
+
+// Whether a block on frame can start its next run. prev_frame and next_frame are the frames of the
+// neighbouring blocks, or -1 for the first and last block.
+bool CanStartBlock(int32_t frame, int32_t prev_frame, int32_t next_frame);
+
+NS_END
@@ -355,10 +355,8 @@ void PhysicsManager::update(uintptr_t thread_id_int)
 		// $TODO: While the sim is running, run threads to create new bodies.
 
 		for (auto& pair : _scenes) {
-			while (!pair.second->fetchResults()) {
-				_job_pool->help(thread_id);
-				EA::Thread::ThreadSleep();
-			}
+			// PhysX tasks are dispatched to the job pool, so wake up whenever one of them finishes.
+			_job_pool->helpUntil(thread_id, [&pair]() -> bool { return pair.second->fetchResults(); });
 		}
 	}
 
@@ -34,14 +34,17 @@ THE SOFTWARE.
 #include <EASTL/algorithm.h>
 
 SHIB_REFLECTION_DEFINE_BEGIN(Shibboleth::ResourceState)
-	.entry("Pending", Shibboleth::ResourceState::Pending)
+	.entry("Queued", Shibboleth::ResourceState::Queued)
+	.entry("Loading", Shibboleth::ResourceState::Loading)
 	.entry("Failed", Shibboleth::ResourceState::Failed)
 	.entry("Loaded", Shibboleth::ResourceState::Loaded)
 	.entry("Delayed", Shibboleth::ResourceState::Delayed)
 SHIB_REFLECTION_DEFINE_END(Shibboleth::ResourceState)
 
 SHIB_REFLECTION_DEFINE_BEGIN(Shibboleth::IResource)
-	.func("requestLoad", &Shibboleth::IResource::requestLoad)
+	.func("requestLoad", static_cast<void (Shibboleth::IResource::*)(int32_t)>(&Shibboleth::IResource::requestLoad))
+	.func("requestLoad", static_cast<void (Shibboleth::IResource::*)(void)>(&Shibboleth::IResource::requestLoad))
+	.func("raiseLoadPriority", &Shibboleth::IResource::raiseLoadPriority)
 	.func("getFilePath", &Shibboleth::IResource::getFilePath)
 	.func("getState", &Shibboleth::IResource::getState)
 	.func("hasFailed", &Shibboleth::IResource::hasFailed)
@@ -67,36 +70,28 @@ static void LoadJob(uintptr_t thread_id_int, void* data)
 	SHIB_FREET(job_data, GetAllocator());
 }
 
-void IResource::requestLoad(void)
+void IResource::requestLoad(int32_t priority)
 {
 	if (_state != ResourceState::Delayed) {
 		return;
 	}
 
-	_res_mgr->requestLoad(*this);
+	_res_mgr->requestLoad(*this, priority);
 }
 
-void IResource::load(void)
+void IResource::requestLoad(void)
 {
-	const IFile* const file = loadFile(getFilePath().getBuffer());
-
-	if (file) {
-		const ILoadFileCallbackAttribute* const cb_attr = getReflectionDefinition().GET_CLASS_ATTR(Shibboleth::ILoadFileCallbackAttribute);
-		GAFF_ASSERT(cb_attr);
-
-		eastl::pair<IResource*, const IFile*>* const res_data = SHIB_ALLOCT(
-			GAFF_SINGLE_ARG(eastl::pair<IResource*, const IFile*>),
-			ProxyAllocator("Resource"),
-			this,
-			file
-		);
+	requestLoad(k_load_priority_default);
+}
 
-		Gaff::JobData job_data = { LoadJob, res_data };
-		GetApp().getJobPool().addJobs(&job_data, 1U, nullptr, cb_attr->getPool());
+void IResource::raiseLoadPriority(int32_t priority)
+{
+	_res_mgr->raiseLoadPriority(*this, priority);
+}
 
-	} else {
-		failed();
-	}
+void IResource::load(void)
+{
+	loadFile(getFilePath().getBuffer());
 }
 
 void IResource::addRef(void) const
@@ -118,6 +113,20 @@ int32_t IResource::getRefCount(void) const
 	return _count;
 }
 
+bool IResource::tryAddRef(void) const
+{
+	int32_t count = _count.load(eastl::memory_order_relaxed);
+
+	// Once the count hits zero, the resource is on its way to being removed and must not be handed out again.
+	while (count > 0) {
+		if (_count.compare_exchange_weak(count, count + 1)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
 const HashString64<>& IResource::getFilePath(void) const
 {
 	return _file_path;
@@ -135,7 +144,7 @@ bool IResource::hasFailed(void) const
 
 bool IResource::isPending(void) const
 {
-	return _state == ResourceState::Pending;
+	return _state == ResourceState::Queued || _state == ResourceState::Loading;
 }
 
 bool IResource::isLoaded(void) const
@@ -143,29 +152,46 @@ bool IResource::isLoaded(void) const
 	return _state == ResourceState::Loaded;
 }
 
-const IFile* IResource::loadFile(const char8_t* file_path)
+void IResource::loadFile(const char8_t* file_path)
 {
 	U8String final_path(ProxyAllocator("Resource"));
 	final_path.sprintf(u8"Resources/%s", file_path);
 
-	const IFile* const file = GetApp().getFileSystem().openFile(final_path.data());
+	// The callback may run on a file system I/O thread. Keep it light and hand the real work to the job pool.
+	GetApp().getFileSystem().openFileAsync(final_path.data(), [this](IFile* file) -> void
+	{
+		// The read is done, so let another load start. Anything left is CPU work or waiting on other resources.
+		_res_mgr->releaseLoadSlot(*this);
 
-	if (!file) {
-		// $TODO: Log error.
-		failed();
-	}
+		if (!file) {
+			// $TODO: Log error.
+			failed();
+			return;
+		}
+
+		const ILoadFileCallbackAttribute* const cb_attr = getReflectionDefinition().GET_CLASS_ATTR(Shibboleth::ILoadFileCallbackAttribute);
+		GAFF_ASSERT(cb_attr);
+
+		eastl::pair<IResource*, const IFile*>* const res_data = SHIB_ALLOCT(
+			GAFF_SINGLE_ARG(eastl::pair<IResource*, const IFile*>),
+			ProxyAllocator("Resource"),
+			this,
+			file
+		);
 
-	return file;
+		Gaff::JobData job_data = { LoadJob, res_data };
+		GetApp().getJobPool().addJobs(&job_data, 1U, nullptr, cb_attr->getPool());
+	});
 }
 
 void IResource::succeeded(void)
 {
-	_state = ResourceState::Loaded;
+	_res_mgr->resourceLoadFinished(*this, ResourceState::Loaded);
 }
 
 void IResource::failed(void)
 {
-	_state = ResourceState::Failed;
+	_res_mgr->resourceLoadFinished(*this, ResourceState::Failed);
 }
 
 NS_END
@@ -45,35 +45,13 @@ SHIB_REFLECTION_DEFINE_END(Shibboleth::ResourceManager)
 namespace
 {
 	static constexpr Gaff::Hash32 k_read_file_pool = Gaff::FNV1aHash32StringConst(Shibboleth::k_config_app_read_file_pool_name);
-
-	struct RawJobData final
-	{
-		const char8_t* file_path;
-		const Shibboleth::IFile* out_file;
-	};
-
-	static void ResourceFileLoadRawJob(uintptr_t /*id_int*/, void* data)
-	{
-		RawJobData* const job_data = reinterpret_cast<RawJobData*>(data);
-
-		Shibboleth::U8String final_path(Shibboleth::ProxyAllocator("Resource"));
-		final_path.sprintf(u8"Resources/%s", job_data->file_path);
-
-		job_data->out_file = Shibboleth::GetApp().getFileSystem().openFile(final_path.data());
-	}
-
-	static void ResourceFileLoadJob(uintptr_t /*id_int*/, void* data)
-	{
-		Shibboleth::IResource* res = reinterpret_cast<Shibboleth::IResource*>(data);
-		res->load();
-	}
-
-	static bool ResourceHashCompare(const Shibboleth::IResource* lhs, Gaff::Hash64 rhs)
-	{
-		return lhs->getFilePath().getHash() < rhs;
-	}
 }
 
+static_assert(
+	Shibboleth::IResource::k_load_priority_blocking == Shibboleth::ResourceLoadQueue<Shibboleth::IResource>::k_priority_uncapped,
+	"Blocked on loads must never wait on the in flight cap."
+);
+
 NS_SHIBBOLETH
 
 SHIB_REFLECTION_CLASS_DEFINE(ResourceManager)
@@ -85,9 +63,10 @@ ResourceManager::ResourceManager(void)
 
 ResourceManager::~ResourceManager(void)
 {
-	for (const IResource* res : _resources) {
-		LogWarningResource("Resource Leaked: %s", res->getFilePath().getBuffer());
-	}
+	_resources.forEach([](const IResource& res) -> void
+	{
+		LogWarningResource("Resource Leaked: %s", res.getFilePath().getBuffer());
+	});
 }
 
 bool ResourceManager::init(void)
@@ -141,258 +120,363 @@ IResourcePtr ResourceManager::createResource(HashStringView64<> name, const Refl
 		return IResourcePtr();
 	}
 
-	const EA::Thread::AutoMutex lock(_res_lock);
+	IResource* const resource = _resources.acquireOrInsert(name.getHash(), [&]() -> IResource*
+	{
+		const auto factory = ref_def.getFactory<>();
 
-	const auto it_res = Gaff::LowerBound(_resources, name.getHash(), ResourceHashCompare);
+		if (!factory) {
+			LogErrorResource("Resource type '%s' does not have a default constructor.", ref_def.getReflectionInstance().getName());
+			return nullptr;
+		}
 
-	if (it_res != _resources.end() && (*it_res)->getFilePath().getHash() == name.getHash()) {
-		return IResourcePtr(*it_res);
-	}
+		void* const data = factory(_allocator);
+		IResource* const new_resource = ref_def.GET_INTERFACE(Shibboleth::IResource, data);
+		new_resource->_state = ResourceState::Loaded;
+		new_resource->_file_path = name;
+		new_resource->_res_mgr = this;
 
-	// create instance
-	const auto factory = ref_def.getFactory<>();
+		// The table hands out the first reference.
+		new_resource->addRef();
+		return new_resource;
+	});
 
-	if (!factory) {
-		LogErrorResource("Resource type '%s' does not have a default constructor.", ref_def.getReflectionInstance().getName());
-		return IResourcePtr();
-	}
+	return IResourcePtr(resource, false);
+}
 
-	void* const data = factory(_allocator);
-	IResource* const resource = ref_def.GET_INTERFACE(Shibboleth::IResource, data);
-	resource->_state = ResourceState::Loaded;
-	resource->_file_path = name;
-	resource->_res_mgr = this;
+IResourcePtr ResourceManager::requestResource(HashStringView64<> name, bool delay_load)
+{
+	GAFF_ASSERT(name.getBuffer());
+	return requestResourceHelper(eastl::u8string_view(name.getBuffer()), name.getHash(), delay_load);
+}
 
-	_resources.insert(it_res, resource);
+IResourcePtr ResourceManager::requestResource(eastl::u8string_view name, bool delay_load)
+{
+	return requestResourceHelper(name, HashStringView64<>(name.data(), name.size()).getHash(), delay_load);
+}
 
-	return IResourcePtr(resource);
+IResourcePtr ResourceManager::requestResource(HashStringView64<> name)
+{
+	return requestResource(name, false);
 }
 
-IResourcePtr ResourceManager::requestResource(HashStringView64<> name, bool delay_load)
+IResourcePtr ResourceManager::getResource(HashStringView64<> name)
 {
-	const EA::Thread::AutoMutex lock(_res_lock);
+	return IResourcePtr(_resources.acquire(name.getHash()), false);
+}
 
-	const auto it_res = Gaff::LowerBound(_resources, name.getHash(), ResourceHashCompare);
+void ResourceManager::waitForResource(const IResource& resource)
+{
+	// Someone is now blocked on this resource. Don't leave it sitting behind loads nobody is waiting on.
+	raiseLoadPriority(resource, IResource::k_load_priority_blocking);
 
-	if (it_res != _resources.end() && (*it_res)->getFilePath().getHash() == name.getHash()) {
-		return IResourcePtr(*it_res);
-	}
+	// Run load jobs on this thread instead of sleeping. The resource may very well be waiting on one of them.
+	GetApp().getJobPool().helpUntil(EA::Thread::GetThreadId(), [&resource]() -> bool
+	{
+		return !resource.isPending();
+	});
+}
 
-	const size_t pos = Gaff::ReverseFind(name.getBuffer(), u8'.');
+const IFile* ResourceManager::loadFileAndWait(const char8_t* file_path, uintptr_t thread_id_int)
+{
+	U8String final_path(ProxyAllocator("Resource"));
+	final_path.sprintf(u8"Resources/%s", file_path);
 
-	if (pos == SIZE_T_FAIL) {
-		// $TODO: Log error
-		return IResourcePtr();
-	}
+	JobPool* const job_pool = &GetApp().getJobPool();
+	const IFile* out_file = nullptr;
+	Gaff::Counter counter = 1;
 
-	// Search for res_factory that handles this resource file.
-	const Gaff::Hash32 res_file_hash = Gaff::FNV1aHash32String(name.getBuffer() + pos);
-	const auto it_fact = _resource_factories.find(res_file_hash);
+	// Nothing is tying up a read thread while we wait, so keep running jobs on this one.
+	GetApp().getFileSystem().openFileAsync(final_path.data(), [job_pool, &out_file, &counter](IFile* file) -> void
+	{
+		out_file = file;
+		--counter;
 
-	if (it_fact == _resource_factories.end()) {
-		// $TODO: Log error
-		return IResourcePtr();
-	}
+		job_pool->notifyWaiters();
+	});
+
+	const EA::Thread::ThreadId thread_id = *((EA::Thread::ThreadId*)thread_id_int);
+	job_pool->helpWhileWaiting(thread_id, counter);
+
+	return out_file;
+}
 
-	// Assume all resources always inherit from IResource first.
-	IResource* const resource = reinterpret_cast<IResource*>(it_fact->second(_allocator));
-	resource->_file_path = name;
-	resource->_res_mgr = this;
+ResourceCallbackID ResourceManager::registerCallback(const Vector<IResource*>& resources, const ResourceStateCallback& callback)
+{
+	ResourceCallbackID id;
 
-	_resources.insert(it_res, resource);
+	{
+		// Resources change state under this lock, so nothing can finish between checking it and signing up.
+		const EA::Thread::AutoMutex lock(_callback_lock);
+		id = _callbacks.add(resources, callback);
+	}
 
-	if (!delay_load) {
-		requestLoad(*resource);
+	if (id.cb_id == -1) {
+		callback(resources);
 	}
 
-	return IResourcePtr(resource);
+	return id;
 }
 
-IResourcePtr ResourceManager::requestResource(HashStringView64<> name)
+void ResourceManager::removeCallback(ResourceCallbackID id)
 {
-	return requestResource(name, false);
+	const EA::Thread::AutoMutex lock(_callback_lock);
+	_callbacks.remove(id);
 }
 
-IResourcePtr ResourceManager::getResource(HashStringView64<> name)
+void ResourceManager::checkAndRemoveResources(void)
 {
-	const EA::Thread::AutoMutex lock(_res_lock);
+	{
+		const EA::Thread::AutoMutex pending_lock(_removal_lock);
 
-	const auto it_res = Gaff::LowerBound(_resources, name.getHash(), ResourceHashCompare);
+		for (int32_t i = 0; i < static_cast<int32_t>(_pending_removals.size());) {
+			const IResource* const resource = _pending_removals[i];
 
-	if (it_res != _resources.end() && (*it_res)->getFilePath().getHash() == name.getHash()) {
-		return IResourcePtr(*it_res);
-	}
+			// Don't remove if a thread is still loading it.
+			if (resource->isPending()) {
+				++i;
+				continue;
+			}
 
-	return IResourcePtr();
-}
+			_pending_removals.erase_unsorted(_pending_removals.begin() + i);
 
-void ResourceManager::waitForResource(const IResource& resource) const
-{
-	while (resource._state == ResourceState::Pending) {
-		// $TODO: Help out?
-		EA::Thread::ThreadSleep();
+			// Resource gained a reference since pending removal.
+			if (resource->getRefCount() > 0) {
+				continue;
+			}
+
+			_finished_removals.emplace_back(resource);
+		}
 	}
-}
 
-const IFile* ResourceManager::loadFileAndWait(const char8_t* file_path, uintptr_t thread_id_int)
-{
-	RawJobData data = { file_path, nullptr };
-	Gaff::JobData job_data = { ResourceFileLoadRawJob, &data };
-	Gaff::Counter counter = 0;
-	auto& job_pool = GetApp().getJobPool();
+	// Finishing a load takes the callback lock, then the load lock. Removal takes the load lock, then the removal lock.
+	// Taking the callback lock under the removal lock would close the loop, so don't hold it from here on.
+	for (const IResource* resource : _finished_removals) {
+		// Load was cancelled after it started. Stop anyone waiting on it.
+		{
+			const EA::Thread::AutoMutex callback_lock(_callback_lock);
+			_callbacks.cancelled(*resource);
+		}
 
-	const EA::Thread::ThreadId thread_id = *((EA::Thread::ThreadId*)thread_id_int);
+		// Remove and free the resource.
+		_resources.remove(resource->getFilePath().getHash(), *resource);
+	}
 
-	job_pool.addJobs(&job_data, 1, counter, k_read_file_pool);
-	job_pool.helpWhileWaiting(thread_id, counter);
+	_finished_removals.clear();
 
-	return data.out_file;
+	// Resources removed while a lookup was in flight couldn't be freed at the time.
+	_resources.reclaim();
 }
 
-ResourceCallbackID ResourceManager::registerCallback(const Vector<IResource*>& resources, const ResourceStateCallback& callback)
+void ResourceManager::checkCallbacks(void)
 {
-	GAFF_ASSERT(Gaff::Find(resources, nullptr) == resources.end());
-	bool already_loaded = true;
+	{
+		const EA::Thread::AutoMutex lock(_callback_lock);
+		_callbacks.collectReady();
+	}
 
-	for (IResource* res : resources) {
-		if (res->getState() == ResourceState::Pending) {
-			already_loaded = false;
-			break;
-		}
+	// Callbacks are free to register new callbacks, so don't hold the lock while calling them.
+	_callbacks.fireCollected();
+}
+
+IResourcePtr ResourceManager::requestResourceHelper(eastl::u8string_view name, Gaff::Hash64 hash, bool delay_load)
+{
+	// Already loaded resources are the common case. Don't bother with factories unless we have to.
+	if (IResource* const resource = _resources.acquire(hash)) {
+		return IResourcePtr(resource, false);
 	}
 
-	if (already_loaded) {
-		callback(resources);
-		return ResourceCallbackID{ Gaff::k_init_hash64, -1 };
+	const size_t pos = name.rfind(u8'.');
+
+	if (pos == eastl::u8string_view::npos) {
+		// $TODO: Log error
+		return IResourcePtr();
 	}
 
-	const Gaff::Hash64 hash = Gaff::FNV1aHash64(reinterpret_cast<const char*>(resources.data()), sizeof(IResource*) * resources.size());
-	const EA::Thread::AutoMutex lock(_callback_lock);
-	CallbackData& data = _callbacks[hash];
+	// Search for res_factory that handles this resource file.
+	const Gaff::Hash32 res_file_hash = Gaff::FNV1aHash32(reinterpret_cast<const char*>(name.data() + pos), name.size() - pos);
+	const auto it_fact = _resource_factories.find(res_file_hash);
 
-	if (data.resources.empty()) {
-		data.resources = resources;
+	if (it_fact == _resource_factories.end()) {
+		// $TODO: Log error
+		return IResourcePtr();
 	}
 
-	ResourceCallbackID id{ hash, data.next_id++ };
+	bool created = false;
 
-	data.callbacks[id.cb_id] = callback;
+	IResource* const resource = _resources.acquireOrInsert(hash, [&]() -> IResource*
+	{
+		// Assume all resources always inherit from IResource first.
+		IResource* const new_resource = reinterpret_cast<IResource*>(it_fact->second(_allocator));
+		new_resource->_file_path = HashString64<>(name.data(), name.size(), hash);
+		new_resource->_res_mgr = this;
 
-	return id;
+		// The table hands out the first reference.
+		new_resource->addRef();
+		created = true;
+
+		return new_resource;
+	});
+
+	// Only whoever created the resource kicks off its load.
+	if (created && !delay_load) {
+		requestLoad(*resource, IResource::k_load_priority_default);
+	}
+
+	return IResourcePtr(resource, false);
 }
 
-void ResourceManager::removeCallback(ResourceCallbackID id)
+void ResourceManager::resourceLoadFinished(IResource& resource, ResourceState state)
 {
-	const EA::Thread::AutoMutex lock(_callback_lock);
-	const auto it = _callbacks.find(id.res_id);
+	bool released_slot = false;
 
-	if (it == _callbacks.end()) {
-		return;
-	}
+	{
+		// Registration checks states under this lock, so nothing can finish between checking it and signing up.
+		const EA::Thread::AutoMutex lock(_callback_lock);
+		_callbacks.finished(resource);
 
-	it->second.callbacks.erase(id.cb_id);
+		// Change state last. Once the resource is no longer pending, it can be freed out from under us.
+		const EA::Thread::AutoMutex load_lock(_load_lock);
 
-	if (it->second.callbacks.empty()) {
-		_callbacks.erase(it);
+		// Loads normally give their slot back once their file is read. This covers any that finish without reading one.
+		released_slot = _load_queue.finish(resource);
+		resource._state = state;
 	}
-}
 
-void ResourceManager::checkAndRemoveResources(void)
-{
-	const EA::Thread::AutoMutex pending_lock(_removal_lock);
+	if (released_slot) {
+		startLoads();
+	}
 
-	for (int32_t i = 0; i < static_cast<int32_t>(_pending_removals.size());) {
-		const IResource* const resource = _pending_removals[i];
+	// Resources don't finish on a job counter, so threads in waitForResource() won't otherwise hear about it.
+	GetApp().getJobPool().notifyWaiters();
+}
 
-		// Don't remove if a thread is still loading it.
-		if (resource->getState() == ResourceState::Pending) {
-			++i;
+void ResourceManager::raiseLoadPriority(const IResource& resource, int32_t priority)
+{
+	bool raised = false;
 
-		} else {
-			_pending_removals.erase_unsorted(_pending_removals.begin() + i);
+	{
+		// Too late to matter once the load has started.
+		const EA::Thread::AutoMutex lock(_load_lock);
+		raised = _load_queue.raisePriority(resource, priority);
+	}
 
-			// Resource gained a reference since pending removal.
-			if (resource->getRefCount() > 0) {
-				return;
-			}
+	// Blocking loads skip the in flight cap, so this may be able to start now.
+	if (raised) {
+		startLoads();
+	}
+}
 
-			// Remove and free the resource.
-			const EA::Thread::AutoMutex res_lock(_res_lock);
-			const auto it_res = Gaff::LowerBound(_resources, resource->getFilePath().getHash(), ResourceHashCompare);
+void ResourceManager::requestLoad(IResource& resource, int32_t priority)
+{
+	{
+		const EA::Thread::AutoMutex lock(_load_lock);
 
-			if (it_res != _resources.end() && *it_res == resource) {
-				_resources.erase(it_res);
-			}
+		if (resource._state != ResourceState::Delayed) {
+			LogErrorResource(
+				"Call to ResourceManager::requestLoad() called on resource '%s' and is not marked for delayed load.",
+				resource._file_path.getBuffer()
+			);
 
-			SHIB_FREET(resource, GetAllocator());
+			return;
 		}
+
+		resource._state = ResourceState::Queued;
+		_load_queue.push(resource, priority);
 	}
+
+	startLoads();
 }
 
-void ResourceManager::checkCallbacks(void)
+void ResourceManager::removeResource(const IResource& resource)
 {
-	for (const auto& pair : _callbacks) {
-		_callback_keys.emplace_back(pair.first);
-	}
+	{
+		const EA::Thread::AutoMutex lock(_load_lock);
 
-	for (Gaff::Hash64 hash : _callback_keys) {
-		auto& cb_data = _callbacks[hash];
-		bool not_loaded = false;
+		// Nobody wants it anymore and no I/O has been done. Cancel the load.
+		if (_load_queue.remove(resource)) {
+			GAFF_ASSERT(resource._state == ResourceState::Queued);
 
-		for (IResource* res : cb_data.resources) {
-			if (res->getState() == ResourceState::Pending) {
-				not_loaded = true;
-				break;
-			}
+		// Resource load has already started. Wait until it is finished.
+		} else if (resource._state == ResourceState::Loading) {
+			const EA::Thread::AutoMutex removal_lock(_removal_lock);
+			_pending_removals.emplace_back(&resource);
+			return;
 		}
+	}
 
-		if (not_loaded) {
-			continue;
-		}
+	// The load was cancelled, or reverted to delayed before it started. Either way it is never going to finish.
+	{
+		const EA::Thread::AutoMutex lock(_callback_lock);
+		_callbacks.cancelled(resource);
+	}
 
-		for (auto& cb : cb_data.callbacks) {
-			cb.second(cb_data.resources);
-		}
+	_resources.remove(resource.getFilePath().getHash(), resource);
+}
+
+void ResourceManager::releaseLoadSlot(IResource& resource)
+{
+	bool released_slot = false;
 
-		_callbacks.erase(hash);
+	{
+		const EA::Thread::AutoMutex lock(_load_lock);
+		released_slot = _load_queue.finish(resource);
 	}
 
-	_callback_keys.clear();
+	if (released_slot) {
+		startLoads();
+	}
 }
 
-void ResourceManager::removeResource(const IResource& resource)
+void ResourceManager::cancelLoad(IResource& resource)
 {
-	// Resource load job has already been submitted. Wait until it is finished.
-	if (resource.getState() == ResourceState::Pending) {
-		const EA::Thread::AutoMutex lock(_removal_lock);
-		_pending_removals.emplace_back(&resource);
+	{
+		// Callbacks waiting on it are cancelled when it is removed.
+		const EA::Thread::AutoMutex lock(_load_lock);
 
-	} else {
-		const EA::Thread::AutoMutex lock(_res_lock);
+		_load_queue.finish(resource);
+		resource._state = ResourceState::Delayed;
+	}
 
-		const auto it_res = Gaff::LowerBound(_resources, resource.getFilePath().getHash(), ResourceHashCompare);
+	startLoads();
+}
 
-		if (it_res != _resources.end() && *it_res == &resource) {
-			_resources.erase(it_res);
-			SHIB_FREET(&resource, GetAllocator());
+void ResourceManager::startLoads(void)
+{
+	Vector<Gaff::JobData> jobs{ ProxyAllocator("Resource") };
+
+	{
+		const EA::Thread::AutoMutex lock(_load_lock);
+
+		while (IResource* const resource = _load_queue.startNext()) {
+			// The last reference was dropped, but removeResource() hasn't gotten to it yet.
+			// Leave it to be removed without ever touching the file.
+			if (!resource->getRefCount()) {
+				_load_queue.finish(*resource);
+				resource->_state = ResourceState::Delayed;
+				continue;
+			}
+
+			resource->_state = ResourceState::Loading;
+			jobs.emplace_back(Gaff::JobData{ ResourceLoadJob, resource });
 		}
 	}
+
+	if (!jobs.empty()) {
+		GetApp().getJobPool().addJobs(jobs.data(), static_cast<int32_t>(jobs.size()), nullptr, k_read_file_pool);
+	}
 }
 
-void ResourceManager::requestLoad(IResource& resource)
+void ResourceManager::ResourceLoadJob(uintptr_t /*id_int*/, void* data)
 {
-	if (resource._state != ResourceState::Delayed) {
-		LogErrorResource(
-			"Call to ResourceManager::requestLoad() called on resource '%s' and is not marked for delayed load.",
-			resource._file_path.getBuffer()
-		);
+	IResource* const resource = reinterpret_cast<IResource*>(data);
 
+	// Dropped between being started and the job running. It is waiting in pending removals, so don't touch the file.
+	if (!resource->getRefCount()) {
+		resource->_res_mgr->cancelLoad(*resource);
 		return;
 	}
 
-	resource._state = ResourceState::Pending;
-	Gaff::JobData job_data = { ResourceFileLoadJob, &resource };
-	GetApp().getJobPool().addJobs(&job_data, 1, nullptr, k_read_file_pool);
+	resource->load();
 }
 
 NS_END
@@ -22,6 +22,7 @@ THE SOFTWARE.
 
 #pragma once
 
+#include "Shibboleth_ResourceCallbackTable.h"
 #include <Shibboleth_Reflection.h>
 #include <Shibboleth_HashString.h>
 #include <Shibboleth_RefCounted.h>
@@ -39,21 +40,22 @@ THE SOFTWARE.
 
 NS_SHIBBOLETH
 
+template <class T>
+class ResourceLoadQueue;
+
+template <class T>
+class ResourceTable;
+
 class ResourceManager;
 class IFile;
 
 class IResource;
 using IResourcePtr = Gaff::RefPtr<IResource>;
 
-struct ResourceCallbackID final
-{
-	Gaff::Hash64 res_id = Gaff::k_init_hash64;
-	int32_t cb_id = -1;
-};
-
 enum class ResourceState
 {
-	Pending = 0,
+	Queued = 0,
+	Loading,
 	Failed,
 	Loaded,
 	Delayed
@@ -64,8 +66,16 @@ class IResource : public Gaff::IRefCounted, public Refl::IReflectionObject
 public:
 	static constexpr bool Creatable = false;
 
+	// Higher priority loads are started first. Loads of equal priority start in the order they were requested.
+	static constexpr int32_t k_load_priority_default = 0;
+	static constexpr int32_t k_load_priority_blocking = INT32_MAX;
+
+	void requestLoad(int32_t priority);
 	void requestLoad(void);
 
+	// Does nothing if the load has already started or priority is not higher than the current priority.
+	void raiseLoadPriority(int32_t priority);
+
 	virtual void load(void);
 
 	void addRef(void) const override;
@@ -80,7 +90,8 @@ public:
 	bool isLoaded(void) const;
 
 protected:
-	const IFile* loadFile(const char8_t* file_path);
+	// Reads the file without blocking, then queues the load file callback on its job pool.
+	void loadFile(const char8_t* file_path);
 
 	void succeeded(void);
 	void failed(void);
@@ -91,8 +102,19 @@ private:
 	ResourceState _state = ResourceState::Delayed;
 	HashString64<> _file_path;
 
+	// Callback groups still waiting on this resource. Guarded by the resource manager's callback lock.
+	mutable Vector<Gaff::Hash64> _callback_groups{ ProxyAllocator("Resource") };
+
 	ResourceManager* _res_mgr = nullptr;
 
+	// Slot in the resource manager's load queue. Guarded by the resource manager's load lock.
+	int32_t _load_queue_index = -1;
+
+	bool tryAddRef(void) const;
+
+	friend class ResourceCallbackTable<IResource>;
+	friend class ResourceLoadQueue<IResource>;
+	friend class ResourceTable<IResource>;
 	friend class ResourceManager;
 
 	SHIB_REFLECTION_CLASS_DECLARE(IResource);
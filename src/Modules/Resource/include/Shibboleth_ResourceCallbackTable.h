@@ -0,0 +1,94 @@
+/************************************************************************************
+Copyright (C) 2022 by Nicholas LaCroix
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+************************************************************************************/
+
+#pragma once
+
+#include <Shibboleth_VectorMap.h>
+#include <Shibboleth_Vector.h>
+#include <EASTL/functional.h>
+#include <Gaff_Assert.h>
+#include <Gaff_Hash.h>
+
+NS_SHIBBOLETH
+
+struct ResourceCallbackID final
+{
+	Gaff::Hash64 res_id = Gaff::k_init_hash64;
+	int32_t cb_id = -1;
+};
+
+// Callbacks waiting on groups of resources to finish loading. Groups are keyed by the hash of their resource pointers.
+// Each group counts how many of its resources are still pending, and each pending resource lists the groups waiting on it,
+// so a finished load only touches the groups waiting on it. Not thread-safe, except where noted.
+// T must provide bool isPending(void) const and a mutable Vector<Gaff::Hash64> _callback_groups member.
+template <class T>
+class ResourceCallbackTable final
+{
+public:
+	using Callback = eastl::function<void (const Vector<T*>&)>;
+
+	// Returns an ID with a cb_id of -1 if none of resources are pending. callback is not kept, so call it yourself.
+	ResourceCallbackID add(const Vector<T*>& resources, const Callback& callback);
+
+	// An emptied group is kept until its resources finish, so they never count down a group that isn't there.
+	// Adding a group for the same resources picks it back up.
+	void remove(ResourceCallbackID id);
+
+	// Call once resource is no longer pending.
+	void finished(T& resource);
+
+	// Call before freeing a resource that is still pending, or was never loaded.
+	// Groups stop waiting on it, and their callbacks are not handed a freed resource.
+	void cancelled(const T& resource);
+
+	// Moves groups whose resources have all finished to the firing list.
+	void collectReady(void);
+
+	// Calls and clears the firing list. Nothing else is touched, so this can be called without holding the table's lock,
+	// as long as collectReady() and fireCollected() are only ever called from one thread.
+	void fireCollected(void);
+
+	int32_t getNumGroups(void) const;
+
+private:
+	struct CallbackData final
+	{
+		VectorMap<int32_t, Callback> callbacks{ ProxyAllocator("Resource") };
+		Vector<T*> resources{ ProxyAllocator("Resource") };
+		int32_t next_id = 0;
+
+		// Number of entries in resources that have not finished loading.
+		int32_t remaining = 0;
+	};
+
+	VectorMap<Gaff::Hash64, CallbackData> _callbacks{ ProxyAllocator("Resource") };
+
+	// Groups whose resources have all finished loading. Fired on the next collectReady() and fireCollected().
+	Vector<Gaff::Hash64> _ready_callbacks{ ProxyAllocator("Resource") };
+	Vector<CallbackData> _firing_callbacks{ ProxyAllocator("Resource") };
+
+	void countDown(Gaff::Hash64 hash);
+};
+
+NS_END
+
+#include "Shibboleth_ResourceCallbackTable.inl"
@@ -0,0 +1,156 @@
+/************************************************************************************
+Copyright (C) 2022 by Nicholas LaCroix
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+************************************************************************************/
+
+NS_SHIBBOLETH
+
+template <class T>
+ResourceCallbackID ResourceCallbackTable<T>::add(const Vector<T*>& resources, const Callback& callback)
+{
+	GAFF_ASSERT(Gaff::Find(resources, nullptr) == resources.end());
+
+	const Gaff::Hash64 hash = Gaff::FNV1aHash64(reinterpret_cast<const char*>(resources.data()), sizeof(T*) * resources.size());
+	auto it = _callbacks.find(hash);
+
+	if (it == _callbacks.end()) {
+		int32_t remaining = 0;
+
+		for (const T* res : resources) {
+			if (res->isPending()) {
+				++remaining;
+			}
+		}
+
+		if (!remaining) {
+			return ResourceCallbackID{ Gaff::k_init_hash64, -1 };
+		}
+
+		it = _callbacks.emplace(hash, CallbackData()).first;
+		it->second.resources = resources;
+		it->second.remaining = remaining;
+
+		for (T* res : resources) {
+			if (res->isPending()) {
+				res->_callback_groups.emplace_back(hash);
+			}
+		}
+	}
+
+	CallbackData& data = it->second;
+	const ResourceCallbackID id{ hash, data.next_id++ };
+
+	data.callbacks[id.cb_id] = callback;
+	return id;
+}
+
+template <class T>
+void ResourceCallbackTable<T>::remove(ResourceCallbackID id)
+{
+	const auto it = _callbacks.find(id.res_id);
+
+	if (it != _callbacks.end()) {
+		it->second.callbacks.erase(id.cb_id);
+	}
+}
+
+template <class T>
+void ResourceCallbackTable<T>::finished(T& resource)
+{
+	for (Gaff::Hash64 hash : resource._callback_groups) {
+		countDown(hash);
+	}
+
+	resource._callback_groups.clear();
+}
+
+template <class T>
+void ResourceCallbackTable<T>::cancelled(const T& resource)
+{
+	for (Gaff::Hash64 hash : resource._callback_groups) {
+		const auto it = _callbacks.find(hash);
+		GAFF_ASSERT(it != _callbacks.end());
+
+		Vector<T*>& resources = it->second.resources;
+		const auto it_res = Gaff::Find(resources, &resource);
+
+		if (it_res != resources.end()) {
+			resources.erase(it_res);
+		}
+
+		countDown(hash);
+	}
+
+	resource._callback_groups.clear();
+}
+
+template <class T>
+void ResourceCallbackTable<T>::collectReady(void)
+{
+	for (Gaff::Hash64 hash : _ready_callbacks) {
+		const auto it = _callbacks.find(hash);
+
+		// Group was already collected, or collected and added again, after it was marked ready.
+		if (it == _callbacks.end() || it->second.remaining > 0) {
+			continue;
+		}
+
+		// Every callback was removed. Nobody is left to tell.
+		if (!it->second.callbacks.empty()) {
+			_firing_callbacks.emplace_back(eastl::move(it->second));
+		}
+
+		_callbacks.erase(it);
+	}
+
+	_ready_callbacks.clear();
+}
+
+template <class T>
+void ResourceCallbackTable<T>::fireCollected(void)
+{
+	// Callbacks are free to add new callbacks, so this doesn't touch anything add() does.
+	for (const CallbackData& cb_data : _firing_callbacks) {
+		for (const auto& cb : cb_data.callbacks) {
+			cb.second(cb_data.resources);
+		}
+	}
+
+	_firing_callbacks.clear();
+}
+
+template <class T>
+int32_t ResourceCallbackTable<T>::getNumGroups(void) const
+{
+	return static_cast<int32_t>(_callbacks.size());
+}
+
+template <class T>
+void ResourceCallbackTable<T>::countDown(Gaff::Hash64 hash)
+{
+	const auto it = _callbacks.find(hash);
+	GAFF_ASSERT(it != _callbacks.end() && it->second.remaining > 0);
+
+	if (--it->second.remaining == 0) {
+		_ready_callbacks.emplace_back(hash);
+	}
+}
+
+NS_END
@@ -0,0 +1,94 @@
+/************************************************************************************
+Copyright (C) 2022 by Nicholas LaCroix
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+************************************************************************************/
+
+#pragma once
+
+#include <Shibboleth_Vector.h>
+#include <Gaff_Assert.h>
+
+NS_SHIBBOLETH
+
+// Loads that have been requested but not started, kept as a heap, plus a cap on how many loads may run at once.
+// Higher priority loads start first. Loads of equal priority start in the order they were pushed.
+// Loads at k_priority_uncapped start even when the cap has been reached, as something is blocked waiting on them.
+// T must have an int32_t _load_queue_index member starting at -1. The queue keeps it pointing at the load's heap slot,
+// so raising priority and cancelling don't have to search. Not thread-safe.
+template <class T>
+class ResourceLoadQueue final
+{
+public:
+	static constexpr int32_t k_priority_uncapped = INT32_MAX;
+
+	explicit ResourceLoadQueue(int32_t max_in_flight);
+
+	void push(T& value, int32_t priority);
+
+	// Returns false if value is not queued or priority is not higher than its current priority.
+	bool raisePriority(const T& value, int32_t priority);
+
+	// Returns false if value is not queued. A removed load never starts.
+	bool remove(const T& value);
+
+	// Pops the next load to start, or returns null if nothing is queued or the cap has been reached.
+	// value holds a slot until finish() is called on it.
+	T* startNext(void);
+
+	// Gives back the slot taken by startNext(). Returns false if value does not hold one.
+	bool finish(T& value);
+
+	bool isQueued(const T& value) const;
+	bool isInFlight(const T& value) const;
+
+	int32_t getNumQueued(void) const;
+	int32_t getNumInFlight(void) const;
+
+private:
+	struct Entry final
+	{
+		T* value = nullptr;
+		int32_t priority = 0;
+		uint64_t order = 0;
+
+		// Highest priority wins, then whoever asked first.
+		bool operator<(const Entry& rhs) const
+		{
+			return (priority < rhs.priority) || (priority == rhs.priority && order > rhs.order);
+		}
+	};
+
+	static constexpr int32_t k_index_none = -1;
+	static constexpr int32_t k_index_in_flight = -2;
+
+	Vector<Entry> _heap{ ProxyAllocator("Resource") };
+	uint64_t _next_order = 0;
+	int32_t _max_in_flight = 0;
+	int32_t _num_in_flight = 0;
+
+	void removeAt(int32_t index);
+	void siftUp(int32_t index);
+	void siftDown(int32_t index);
+	void place(const Entry& entry, int32_t index);
+};
+
+NS_END
+
+#include "Shibboleth_ResourceLoadQueue.inl"
@@ -0,0 +1,210 @@
+/************************************************************************************
+Copyright (C) 2022 by Nicholas LaCroix
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+************************************************************************************/
+
+NS_SHIBBOLETH
+
+template <class T>
+ResourceLoadQueue<T>::ResourceLoadQueue(int32_t max_in_flight):
+	_max_in_flight(max_in_flight)
+{
+	GAFF_ASSERT(max_in_flight > 0);
+}
+
+template <class T>
+void ResourceLoadQueue<T>::push(T& value, int32_t priority)
+{
+	GAFF_ASSERT(value._load_queue_index == k_index_none);
+
+	_heap.emplace_back(Entry{ &value, priority, _next_order++ });
+	value._load_queue_index = static_cast<int32_t>(_heap.size()) - 1;
+
+	siftUp(value._load_queue_index);
+}
+
+template <class T>
+bool ResourceLoadQueue<T>::raisePriority(const T& value, int32_t priority)
+{
+	if (!isQueued(value)) {
+		return false;
+	}
+
+	const int32_t index = value._load_queue_index;
+	Entry& entry = _heap[index];
+
+	if (entry.priority >= priority) {
+		return false;
+	}
+
+	entry.priority = priority;
+	siftUp(index);
+
+	return true;
+}
+
+template <class T>
+bool ResourceLoadQueue<T>::remove(const T& value)
+{
+	if (!isQueued(value)) {
+		return false;
+	}
+
+	T* const removed = _heap[value._load_queue_index].value;
+	removeAt(value._load_queue_index);
+	removed->_load_queue_index = k_index_none;
+
+	return true;
+}
+
+template <class T>
+T* ResourceLoadQueue<T>::startNext(void)
+{
+	if (_heap.empty()) {
+		return nullptr;
+	}
+
+	if (_num_in_flight >= _max_in_flight && _heap.front().priority < k_priority_uncapped) {
+		return nullptr;
+	}
+
+	T* const value = _heap.front().value;
+	removeAt(0);
+
+	value->_load_queue_index = k_index_in_flight;
+	++_num_in_flight;
+
+	return value;
+}
+
+template <class T>
+bool ResourceLoadQueue<T>::finish(T& value)
+{
+	if (!isInFlight(value)) {
+		return false;
+	}
+
+	GAFF_ASSERT(_num_in_flight > 0);
+
+	value._load_queue_index = k_index_none;
+	--_num_in_flight;
+
+	return true;
+}
+
+template <class T>
+bool ResourceLoadQueue<T>::isQueued(const T& value) const
+{
+	return value._load_queue_index >= 0;
+}
+
+template <class T>
+bool ResourceLoadQueue<T>::isInFlight(const T& value) const
+{
+	return value._load_queue_index == k_index_in_flight;
+}
+
+template <class T>
+int32_t ResourceLoadQueue<T>::getNumQueued(void) const
+{
+	return static_cast<int32_t>(_heap.size());
+}
+
+template <class T>
+int32_t ResourceLoadQueue<T>::getNumInFlight(void) const
+{
+	return _num_in_flight;
+}
+
+template <class T>
+void ResourceLoadQueue<T>::removeAt(int32_t index)
+{
+	const int32_t last = static_cast<int32_t>(_heap.size()) - 1;
+
+	if (index != last) {
+		const Entry moved = _heap[last];
+		_heap.pop_back();
+
+		place(moved, index);
+
+		// The moved entry may belong above or below the hole.
+		siftUp(index);
+		siftDown(moved.value->_load_queue_index);
+
+	} else {
+		_heap.pop_back();
+	}
+}
+
+template <class T>
+void ResourceLoadQueue<T>::siftUp(int32_t index)
+{
+	const Entry entry = _heap[index];
+
+	while (index > 0) {
+		const int32_t parent = (index - 1) / 2;
+
+		if (!(_heap[parent] < entry)) {
+			break;
+		}
+
+		place(_heap[parent], index);
+		index = parent;
+	}
+
+	place(entry, index);
+}
+
+template <class T>
+void ResourceLoadQueue<T>::siftDown(int32_t index)
+{
+	const int32_t size = static_cast<int32_t>(_heap.size());
+	const Entry entry = _heap[index];
+
+	for (;;) {
+		int32_t child = index * 2 + 1;
+
+		if (child >= size) {
+			break;
+		}
+
+		if (child + 1 < size && _heap[child] < _heap[child + 1]) {
+			++child;
+		}
+
+		if (!(entry < _heap[child])) {
+			break;
+		}
+
+		place(_heap[child], index);
+		index = child;
+	}
+
+	place(entry, index);
+}
+
+template <class T>
+void ResourceLoadQueue<T>::place(const Entry& entry, int32_t index)
+{
+	_heap[index] = entry;
+	entry.value->_load_queue_index = index;
+}
+
+NS_END
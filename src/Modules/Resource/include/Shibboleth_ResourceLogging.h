@@ -33,6 +33,7 @@ static constexpr Gaff::Hash32 k_log_channel_resource = Gaff::FNV1aHash32StringCo
 #define LogWarningResource(msg, ...) LogWarning(Shibboleth::k_log_channel_resource, msg, ##__VA_ARGS__)
 #define LogErrorResource(msg, ...) LogError(Shibboleth::k_log_channel_resource, msg, ##__VA_ARGS__)
 #define LogInfoResource(msg, ...) LogInfo(Shibboleth::k_log_channel_resource, msg, ##__VA_ARGS__)
+#define LogDebugResource(msg, ...) LogDebug(Shibboleth::k_log_channel_resource, msg, ##__VA_ARGS__)
 
 #define LogInfoStringResource(msg, ...) Shibboleth::GetApp().getLogManager().logMessage(Shibboleth::LogType::Info, Shibboleth::k_log_channel_resource, msg);
 
@@ -22,6 +22,8 @@ THE SOFTWARE.
 
 #pragma once
 
+#include "Shibboleth_ResourceLoadQueue.h"
+#include "Shibboleth_ResourceTable.h"
 #include "Shibboleth_IResource.h"
 #include <Shibboleth_EngineAttributesCommon.h>
 #include <Shibboleth_VectorMap.h>
@@ -35,7 +37,7 @@ NS_SHIBBOLETH
 class ResourceManager final : public IManager
 {
 public:
-	using ResourceStateCallback = eastl::function<void (const Vector<IResource*>&)>;
+	using ResourceStateCallback = ResourceCallbackTable<IResource>::Callback;
 
 	ResourceManager(void);
 	~ResourceManager(void);
@@ -60,6 +62,19 @@ public:
 		return requestResourceT<T>(HashStringView64<>(name, eastl::CharStrlen(name)), delay_load);
 	}
 
+	// name does not need to be null terminated.
+	template <class T>
+	Gaff::RefPtr<T> requestResourceT(eastl::u8string_view name, bool delay_load = false)
+	{
+		IResourcePtr old_ptr = requestResource(name, delay_load);
+
+		if (old_ptr) {
+			return Gaff::RefPtr<T>(static_cast<T*>(old_ptr.release()), false);
+		} else {
+			return Gaff::RefPtr<T>();
+		}
+	}
+
 	IResourcePtr requestResource(const char8_t* name, bool delay_load = false)
 	{
 		return requestResource(HashStringView64<>(name, eastl::CharStrlen(name)), delay_load);
@@ -115,9 +130,10 @@ public:
 
 	IResourcePtr createResource(HashStringView64<> name, const Refl::IReflectionDefinition& ref_def);
 	IResourcePtr requestResource(HashStringView64<> name, bool delay_load);
+	IResourcePtr requestResource(eastl::u8string_view name, bool delay_load = false);
 	IResourcePtr requestResource(HashStringView64<> name);
 	IResourcePtr getResource(HashStringView64<> name);
-	void waitForResource(const IResource& resource) const;
+	void waitForResource(const IResource& resource);
 
 	const IFile* loadFileAndWait(const char8_t* file_path, uintptr_t thread_id_int);
 
@@ -127,23 +143,21 @@ public:
 private:
 	using FactoryFunc = void* (*)(Gaff::IAllocator&);
 
-	struct CallbackData final
-	{
-		VectorMap<int32_t, ResourceStateCallback> callbacks{ ProxyAllocator("Resource") };
-		Vector<IResource*> resources{ ProxyAllocator("Resource") };
-		int32_t next_id = 0;
-	};
+	// Loads still waiting on their file. Past this, loads stay queued so later, higher priority requests can go ahead of them.
+	static constexpr int32_t k_max_loads_in_flight = 16;
+
+	ResourceTable<IResource> _resources;
 
-	EA::Thread::Mutex _res_lock;
-	Vector<IResource*> _resources{ ProxyAllocator("Resource") };
+	ResourceLoadQueue<IResource> _load_queue{ k_max_loads_in_flight };
+	EA::Thread::Mutex _load_lock;
 
 	EA::Thread::Mutex _removal_lock;
 	Vector<const IResource*> _pending_removals{ ProxyAllocator("Resource") };
+	Vector<const IResource*> _finished_removals{ ProxyAllocator("Resource") };
 
 	VectorMap<Gaff::Hash32, FactoryFunc> _resource_factories{ ProxyAllocator("Resource") };
 
-	Vector<Gaff::Hash64> _callback_keys{ ProxyAllocator("Resource") };
-	VectorMap<Gaff::Hash64, CallbackData> _callbacks{ ProxyAllocator("Resource") };
+	ResourceCallbackTable<IResource> _callbacks;
 	EA::Thread::Mutex _callback_lock;
 
 	ProxyAllocator _allocator = ProxyAllocator("Resource");
@@ -151,8 +165,16 @@ private:
 	void checkAndRemoveResources(void);
 	void checkCallbacks(void);
 
+	IResourcePtr requestResourceHelper(eastl::u8string_view name, Gaff::Hash64 hash, bool delay_load);
+	void resourceLoadFinished(IResource& resource, ResourceState state);
+	void raiseLoadPriority(const IResource& resource, int32_t priority);
+	void requestLoad(IResource& resource, int32_t priority);
 	void removeResource(const IResource& resource);
-	void requestLoad(IResource& resource);
+	void releaseLoadSlot(IResource& resource);
+	void cancelLoad(IResource& resource);
+	void startLoads(void);
+
+	static void ResourceLoadJob(uintptr_t id_int, void* data);
 
 	friend class ResourceSystem;
 	friend class IResource;
@@ -170,9 +192,8 @@ static bool LoadRefPtr(const ISerializeReader& reader, Gaff::RefPtr<T>& out)
 		return false;
 	}
 
-	const char8_t* const res_path = reader.readString();
+	const eastl::u8string_view res_path = reader.readStringView();
 	out = GetManagerTFast<ResourceManager>().requestResourceT<T>(res_path);
-	reader.freeString(res_path);
 
 	return out;
 }
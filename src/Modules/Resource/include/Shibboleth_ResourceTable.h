@@ -0,0 +1,110 @@
+/************************************************************************************
+Copyright (C) 2022 by Nicholas LaCroix
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+************************************************************************************/
+
+#pragma once
+
+#include <Shibboleth_Vector.h>
+#include <Shibboleth_Memory.h>
+#include <Gaff_IncludeEASTLAtomic.h>
+#include <eathread/eathread_mutex.h>
+#include <Gaff_Assert.h>
+#include <Gaff_Hash.h>
+
+NS_SHIBBOLETH
+
+// Maps path hashes to reference counted values. Entries are split across shards by hash, each an open addressing table.
+// Lookups never lock. They bump their shard's reader count instead, and anything a lookup could be looking at
+// is only freed once that count is seen at zero. Inserts and removals lock only their shard.
+// T must provide bool tryAddRef(void) const, which adds a reference unless the count has already hit zero.
+template <class T>
+class ResourceTable final
+{
+public:
+	ResourceTable(void) = default;
+	~ResourceTable(void);
+
+	// Returns the value with a reference added, or null if it isn't in the table or has already been released.
+	T* acquire(Gaff::Hash64 hash) const;
+
+	// Same as acquire(), but calls factory() to make a new value if there isn't a live one.
+	// factory is called with the shard locked, and should return a value that already has one reference, or null.
+	template <class Factory>
+	T* acquireOrInsert(Gaff::Hash64 hash, Factory&& factory);
+
+	// Unmaps value if it is still what hash maps to. value is freed once no lookup can be reading it.
+	void remove(Gaff::Hash64 hash, const T& value);
+
+	// Frees removed values and old tables that lookups have since moved past.
+	void reclaim(void);
+
+	// Not safe to call while other threads are modifying the table.
+	template <class Callback>
+	void forEach(Callback&& callback) const;
+
+private:
+	struct Slot final
+	{
+		// Zero is empty. A slot keeps its hash for as long as the table lives, so a lookup can't be fooled by reuse.
+		eastl::atomic<uint64_t> hash = 0;
+		// Null with a non-zero hash is a removed entry. It is only ever refilled with a value for the same hash.
+		eastl::atomic<T*> value = nullptr;
+	};
+
+	struct Table final
+	{
+		Slot* slots = nullptr;
+		int32_t capacity = 0;
+		int32_t num_used = 0; // Includes removed entries. Only touched with the shard locked.
+	};
+
+	struct alignas(64) Shard final
+	{
+		eastl::atomic<Table*> table = nullptr;
+		mutable eastl::atomic<int32_t> readers = 0;
+
+		EA::Thread::Mutex lock;
+		Vector<const T*> retired_values{ ProxyAllocator("Resource") };
+		Vector<Table*> retired_tables{ ProxyAllocator("Resource") };
+	};
+
+	static constexpr int32_t k_num_shards = 32;
+	static constexpr int32_t k_initial_capacity = 64;
+
+	Shard _shards[k_num_shards];
+
+	static uint64_t GetKey(Gaff::Hash64 hash);
+	static Slot* FindSlot(const Table& table, uint64_t key);
+	static void InsertSlot(Table& table, uint64_t key, T* value);
+
+	static Table* CreateTable(int32_t capacity);
+	static void DestroyTable(Table* table);
+
+	static void TryReclaim(Shard& shard);
+
+	const Shard& getShard(uint64_t key) const;
+	Shard& getShard(uint64_t key);
+	Table* grow(Shard& shard, Table& table);
+};
+
+NS_END
+
+#include "Shibboleth_ResourceTable.inl"
@@ -0,0 +1,306 @@
+/************************************************************************************
+Copyright (C) 2022 by Nicholas LaCroix
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+************************************************************************************/
+
+NS_SHIBBOLETH
+
+template <class T>
+ResourceTable<T>::~ResourceTable(void)
+{
+	// Live values belong to whoever is still holding a reference. Only clean up what the table owns.
+	for (Shard& shard : _shards) {
+		for (const T* value : shard.retired_values) {
+			SHIB_FREET(value, GetAllocator());
+		}
+
+		for (Table* table : shard.retired_tables) {
+			DestroyTable(table);
+		}
+
+		DestroyTable(shard.table);
+	}
+}
+
+template <class T>
+T* ResourceTable<T>::acquire(Gaff::Hash64 hash) const
+{
+	const uint64_t key = GetKey(hash);
+	const Shard& shard = getShard(key);
+	T* result = nullptr;
+
+	// Nothing this lookup can see gets freed until readers drops back to zero.
+	++shard.readers;
+
+	if (const Table* const table = shard.table) {
+		if (const Slot* const slot = FindSlot(*table, key)) {
+			T* const value = slot->value;
+
+			if (value && value->tryAddRef()) {
+				result = value;
+			}
+		}
+	}
+
+	--shard.readers;
+	return result;
+}
+
+template <class T>
+template <class Factory>
+T* ResourceTable<T>::acquireOrInsert(Gaff::Hash64 hash, Factory&& factory)
+{
+	if (T* const value = acquire(hash)) {
+		return value;
+	}
+
+	const uint64_t key = GetKey(hash);
+	Shard& shard = getShard(key);
+
+	const EA::Thread::AutoMutex lock(shard.lock);
+	Table* table = shard.table.load(eastl::memory_order_relaxed);
+
+	if (!table) {
+		table = CreateTable(k_initial_capacity);
+		shard.table = table;
+	}
+
+	Slot* const slot = FindSlot(*table, key);
+
+	// Someone else may have inserted it between our lookup and taking the lock.
+	if (slot) {
+		T* const value = slot->value;
+
+		if (value && value->tryAddRef()) {
+			return value;
+		}
+	}
+
+	T* const value = factory();
+
+	if (!value) {
+		return nullptr;
+	}
+
+	// Either a removed entry, or one whose value is on its way out. Its remove() will see it's been replaced.
+	if (slot) {
+		slot->value = value;
+		return value;
+	}
+
+	// Keep the load factor under 3/4.
+	if ((table->num_used + 1) * 4 > table->capacity * 3) {
+		table = grow(shard, *table);
+	}
+
+	InsertSlot(*table, key, value);
+	return value;
+}
+
+template <class T>
+void ResourceTable<T>::remove(Gaff::Hash64 hash, const T& value)
+{
+	const uint64_t key = GetKey(hash);
+	Shard& shard = getShard(key);
+
+	const EA::Thread::AutoMutex lock(shard.lock);
+
+	if (const Table* const table = shard.table.load(eastl::memory_order_relaxed)) {
+		if (Slot* const slot = FindSlot(*table, key)) {
+			if (slot->value == &value) {
+				slot->value = nullptr;
+			}
+		}
+	}
+
+	shard.retired_values.emplace_back(&value);
+	TryReclaim(shard);
+}
+
+template <class T>
+void ResourceTable<T>::reclaim(void)
+{
+	for (Shard& shard : _shards) {
+		const EA::Thread::AutoMutex lock(shard.lock);
+		TryReclaim(shard);
+	}
+}
+
+template <class T>
+template <class Callback>
+void ResourceTable<T>::forEach(Callback&& callback) const
+{
+	for (const Shard& shard : _shards) {
+		const Table* const table = shard.table;
+
+		if (!table) {
+			continue;
+		}
+
+		for (int32_t i = 0; i < table->capacity; ++i) {
+			if (const T* const value = table->slots[i].value) {
+				callback(*value);
+			}
+		}
+	}
+}
+
+template <class T>
+uint64_t ResourceTable<T>::GetKey(Gaff::Hash64 hash)
+{
+	// Zero marks an empty slot.
+	return hash.getHash() ? hash.getHash() : 1;
+}
+
+template <class T>
+typename ResourceTable<T>::Slot* ResourceTable<T>::FindSlot(const Table& table, uint64_t key)
+{
+	const uint64_t mask = static_cast<uint64_t>(table.capacity - 1);
+
+	// Low bits pick the shard, so probe starting from the high bits.
+	for (uint64_t index = (key >> 32) & mask; ; index = (index + 1) & mask) {
+		const uint64_t slot_key = table.slots[index].hash;
+
+		if (slot_key == key) {
+			return table.slots + index;
+		}
+
+		// Slots are never emptied, so the first empty one ends the probe.
+		if (!slot_key) {
+			return nullptr;
+		}
+	}
+}
+
+template <class T>
+void ResourceTable<T>::InsertSlot(Table& table, uint64_t key, T* value)
+{
+	const uint64_t mask = static_cast<uint64_t>(table.capacity - 1);
+	uint64_t index = (key >> 32) & mask;
+
+	while (table.slots[index].hash) {
+		index = (index + 1) & mask;
+	}
+
+	// Set the value first. A lookup that sees the hash must also see the value.
+	table.slots[index].value = value;
+	table.slots[index].hash = key;
+
+	++table.num_used;
+}
+
+template <class T>
+typename ResourceTable<T>::Table* ResourceTable<T>::CreateTable(int32_t capacity)
+{
+	GAFF_ASSERT(capacity > 0 && !(capacity & (capacity - 1)));
+
+	Table* const table = SHIB_ALLOCT(Table, GetAllocator());
+	table->slots = SHIB_ALLOC_CAST(Slot*, sizeof(Slot) * static_cast<size_t>(capacity), GetAllocator());
+	table->capacity = capacity;
+
+	for (int32_t i = 0; i < capacity; ++i) {
+		Gaff::Construct(table->slots + i);
+	}
+
+	return table;
+}
+
+template <class T>
+void ResourceTable<T>::DestroyTable(Table* table)
+{
+	if (!table) {
+		return;
+	}
+
+	// Slots only hold atomics, nothing to destruct.
+	SHIB_FREE(table->slots, GetAllocator());
+	SHIB_FREET(table, GetAllocator());
+}
+
+template <class T>
+void ResourceTable<T>::TryReclaim(Shard& shard)
+{
+	// Anything retired was unmapped before this check. A lookup that starts after it can't find them,
+	// and if none are in flight now, none can still be holding one.
+	if (shard.readers) {
+		return;
+	}
+
+	for (const T* value : shard.retired_values) {
+		SHIB_FREET(value, GetAllocator());
+	}
+
+	for (Table* table : shard.retired_tables) {
+		DestroyTable(table);
+	}
+
+	shard.retired_values.clear();
+	shard.retired_tables.clear();
+}
+
+template <class T>
+const typename ResourceTable<T>::Shard& ResourceTable<T>::getShard(uint64_t key) const
+{
+	return _shards[key % k_num_shards];
+}
+
+template <class T>
+typename ResourceTable<T>::Shard& ResourceTable<T>::getShard(uint64_t key)
+{
+	return _shards[key % k_num_shards];
+}
+
+template <class T>
+typename ResourceTable<T>::Table* ResourceTable<T>::grow(Shard& shard, Table& table)
+{
+	int32_t num_live = 0;
+
+	for (int32_t i = 0; i < table.capacity; ++i) {
+		if (table.slots[i].value.load(eastl::memory_order_relaxed)) {
+			++num_live;
+		}
+	}
+
+	// Removed entries are dropped, so this may not actually get bigger. Leave room to grow before the next rebuild.
+	int32_t capacity = k_initial_capacity;
+
+	while ((num_live + 1) * 2 > capacity) {
+		capacity *= 2;
+	}
+
+	Table* const new_table = CreateTable(capacity);
+
+	for (int32_t i = 0; i < table.capacity; ++i) {
+		T* const value = table.slots[i].value.load(eastl::memory_order_relaxed);
+
+		if (value) {
+			InsertSlot(*new_table, table.slots[i].hash.load(eastl::memory_order_relaxed), value);
+		}
+	}
+
+	// Lookups already in the old table can keep using it until they're done.
+	shard.table = new_table;
+	shard.retired_tables.emplace_back(&table);
+
+	TryReclaim(shard);
+	return new_table;
+}
+
+NS_END
@@ -33,6 +33,7 @@ static constexpr Gaff::Hash32 k_log_channel_script = Gaff::FNV1aHash32StringCons
 #define LogWarningScript(msg, ...) LogWarning(Shibboleth::k_log_channel_script, msg, ##__VA_ARGS__)
 #define LogErrorScript(msg, ...) LogError(Shibboleth::k_log_channel_script, msg, ##__VA_ARGS__)
 #define LogInfoScript(msg, ...) LogInfo(Shibboleth::k_log_channel_script, msg, ##__VA_ARGS__)
+#define LogDebugScript(msg, ...) LogDebug(Shibboleth::k_log_channel_script, msg, ##__VA_ARGS__)
 
 #define LogInfoStringScript(msg, ...) Shibboleth::GetApp().getLogManager().logMessage(Shibboleth::LogType::Info, Shibboleth::k_log_channel_script, msg);
 
@@ -20,11 +20,17 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 ************************************************************************************/
 
+#include <Shibboleth_FrameAllocator.h>
 #include <Shibboleth_ProxyAllocator.h>
+#include <Shibboleth_Vector.h>
 #include <Gaff_DefaultAlignedAllocator.h>
 #include <Gaff_DefaultAllocator.h>
 #include <catch_amalgamated.hpp>
 #include <EASTL/vector.h>
+#include <thread>
+
+static constexpr size_t k_benchmark_num_allocations = 1024;
+static constexpr size_t k_benchmark_allocation_size = 16;
 
 template <class Allocator>
 void AllocatorTestHelper(const Allocator& allocator = Allocator())
@@ -73,3 +79,221 @@ TEST_CASE("shibboleth_newdelete_override")
 {
 	AllocatorTestHelper<eastl::allocator>();
 }
+
+static int32_t g_num_free_callbacks = 0;
+
+static void OnFreeCallback(void*)
+{
+	++g_num_free_callbacks;
+}
+
+TEST_CASE("shibboleth_allocator_header_modes")
+{
+	const Shibboleth::AllocationHeaderMode prev_mode = Shibboleth::GetAllocationHeaderMode();
+	Shibboleth::IAllocator& allocator = Shibboleth::GetAllocator();
+
+	for (const Shibboleth::AllocationHeaderMode mode : { Shibboleth::AllocationHeaderMode::Tracking, Shibboleth::AllocationHeaderMode::Release }) {
+		Shibboleth::SetAllocationHeaderMode(mode);
+		g_num_free_callbacks = 0;
+
+		void* const data = SHIB_ALLOC(100, allocator);
+		REQUIRE(data);
+		REQUIRE(allocator.getUsableSize(data) >= 100);
+
+		allocator.addOnFreeCallback(OnFreeCallback, data);
+		SHIB_FREE(data, allocator);
+
+		REQUIRE(g_num_free_callbacks == 1);
+	}
+
+	// Memory allocated with one header mode must be freeable after switching to the other.
+	Shibboleth::SetAllocationHeaderMode(Shibboleth::AllocationHeaderMode::Release);
+	void* const data = SHIB_ALLOC(100, allocator);
+
+	Shibboleth::SetAllocationHeaderMode(Shibboleth::AllocationHeaderMode::Tracking);
+	SHIB_FREE(data, allocator);
+
+	Shibboleth::SetAllocationHeaderMode(prev_mode);
+}
+
+static Shibboleth::MemoryPoolStats GetPoolStats(int32_t pool_index)
+{
+	eastl::vector<Shibboleth::MemoryPoolStats> stats(static_cast<size_t>(Shibboleth::GetNumMemoryPools()));
+	const int32_t num_pools = Shibboleth::GetMemoryPoolStats(stats.data(), static_cast<int32_t>(stats.size()));
+
+	REQUIRE(pool_index < num_pools);
+	return stats[static_cast<size_t>(pool_index)];
+}
+
+TEST_CASE("shibboleth_allocator_pool_stats")
+{
+	static constexpr int32_t k_num_threads = 4;
+	static constexpr size_t k_num_allocations = 256;
+	static constexpr size_t k_expected_bytes = k_num_threads * k_num_allocations * k_benchmark_allocation_size;
+
+	Shibboleth::IAllocator& allocator = Shibboleth::GetAllocator();
+	const int32_t pool_index = Shibboleth::GetPoolIndex("Pool Stats");
+	const Shibboleth::MemoryPoolStats start_stats = GetPoolStats(pool_index);
+
+	REQUIRE(!strcmp(start_stats.pool_name, "Pool Stats"));
+
+	eastl::vector<void*> allocations[k_num_threads];
+	std::thread threads[k_num_threads];
+
+	for (int32_t i = 0; i < k_num_threads; ++i) {
+		threads[i] = std::thread([&allocator, &allocations, pool_index, i](void) -> void
+		{
+			for (size_t j = 0; j < k_num_allocations; ++j) {
+				allocations[i].push_back(SHIB_ALLOC_POOL(k_benchmark_allocation_size, pool_index, allocator));
+			}
+		});
+	}
+
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+
+	Shibboleth::MemoryPoolStats stats = GetPoolStats(pool_index);
+
+	REQUIRE(stats.num_allocations - start_stats.num_allocations == k_num_threads * k_num_allocations);
+	REQUIRE(stats.total_bytes_allocated - start_stats.total_bytes_allocated == k_expected_bytes);
+	REQUIRE(stats.curr_bytes_allocated - start_stats.curr_bytes_allocated == k_expected_bytes);
+
+	// Free on different threads than we allocated on, so the per-thread counters don't line up.
+	for (int32_t i = 0; i < k_num_threads; ++i) {
+		threads[i] = std::thread([&allocator, &allocations, i](void) -> void
+		{
+			for (void* data : allocations[(i + 1) % k_num_threads]) {
+				SHIB_FREE(data, allocator);
+			}
+		});
+	}
+
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+
+	stats = GetPoolStats(pool_index);
+
+	REQUIRE(stats.num_frees - start_stats.num_frees == k_num_threads * k_num_allocations);
+	REQUIRE(stats.curr_bytes_allocated == start_stats.curr_bytes_allocated);
+}
+
+TEST_CASE("shibboleth_frame_allocator")
+{
+	Shibboleth::IAllocator& allocator = Shibboleth::GetFrameAllocator();
+
+	// Start on a fresh frame buffer.
+	Shibboleth::ResetFrameAllocator();
+
+	void* const data = SHIB_ALLOC(100, allocator);
+	void* const aligned_data = SHIB_ALLOC_ALIGNED(100, static_cast<size_t>(64), allocator);
+
+	REQUIRE(data);
+	REQUIRE(aligned_data);
+	REQUIRE(reinterpret_cast<uintptr_t>(aligned_data) % 64 == 0);
+	REQUIRE(allocator.getUsableSize(data) == 100);
+
+	memset(data, 1, 100);
+	void* const realloc_data = SHIB_REALLOC(data, 200, allocator);
+
+	REQUIRE(static_cast<const int8_t*>(realloc_data)[99] == 1);
+
+	// Frees are a no-op, memory is reused once we've cycled through all the frame buffers.
+	for (int32_t i = 0; i < Shibboleth::FrameAllocator::k_num_frame_buffers - 1; ++i) {
+		Shibboleth::ResetFrameAllocator();
+		REQUIRE(SHIB_ALLOC(100, allocator) != data);
+	}
+
+	Shibboleth::ResetFrameAllocator();
+	REQUIRE(SHIB_ALLOC(100, allocator) == data);
+
+	// Allocations too big for the arena fall back to the regular allocator.
+	const size_t arena_size = Shibboleth::GetFrameAllocatorArenaSize();
+	void* const overflow_data = SHIB_ALLOC(arena_size * 2, allocator);
+
+	REQUIRE(overflow_data);
+	memset(overflow_data, 0, arena_size * 2);
+	SHIB_FREE(overflow_data, allocator);
+
+	Shibboleth::Vector<int32_t> vec(Shibboleth::ProxyAllocator::GetFrame());
+
+	for (int32_t i = 0; i < 1000; ++i) {
+		vec.push_back(i);
+	}
+
+	REQUIRE(vec[999] == 999);
+
+	eastl::vector<Shibboleth::FrameAllocatorStats> stats(64);
+	const int32_t num_stats = Shibboleth::GetFrameAllocatorStats(stats.data(), static_cast<int32_t>(stats.size()));
+
+	REQUIRE(num_stats > 0);
+
+	const auto it = eastl::find_if(stats.begin(), stats.begin() + num_stats, [](const Shibboleth::FrameAllocatorStats& entry) -> bool
+	{
+		return entry.num_overflow_allocations > 0;
+	});
+
+	REQUIRE(it != stats.begin() + num_stats);
+	REQUIRE(it->overflow_high_water_mark >= arena_size * 2);
+	REQUIRE(it->high_water_mark > 0);
+	REQUIRE(it->high_water_mark <= it->arena_size);
+}
+
+TEST_CASE("shibboleth_frame_allocator_thread_exit")
+{
+	Shibboleth::IAllocator& allocator = Shibboleth::GetFrameAllocator();
+	eastl::vector<Shibboleth::FrameAllocatorStats> stats(MAX_FRAME_ARENAS);
+
+	// Make sure this thread has an arena before we start counting.
+	REQUIRE(SHIB_ALLOC(16, allocator));
+
+	std::thread([&allocator](void) -> void { REQUIRE(SHIB_ALLOC(16, allocator)); }).join();
+	const int32_t start_arenas = Shibboleth::GetFrameAllocatorStats(stats.data(), MAX_FRAME_ARENAS);
+
+	// More short lived threads than we have arenas. Each one should pick up the arena the last one gave back.
+	for (int32_t i = 0; i < MAX_FRAME_ARENAS * 2; ++i) {
+		void* data = nullptr;
+		std::thread([&allocator, &data](void) -> void { data = SHIB_ALLOC(16, allocator); }).join();
+
+		REQUIRE(data);
+		REQUIRE(allocator.getUsableSize(data) == 16);
+	}
+
+	REQUIRE(Shibboleth::GetFrameAllocatorStats(stats.data(), MAX_FRAME_ARENAS) == start_arenas);
+}
+
+TEST_CASE("shibboleth_allocator_header_benchmark", "[.][benchmark]")
+{
+	const Shibboleth::AllocationHeaderMode prev_mode = Shibboleth::GetAllocationHeaderMode();
+	Shibboleth::IAllocator& allocator = Shibboleth::GetAllocator();
+	eastl::vector<void*> allocations(k_benchmark_num_allocations, nullptr);
+
+	for (const Shibboleth::AllocationHeaderMode mode : { Shibboleth::AllocationHeaderMode::Tracking, Shibboleth::AllocationHeaderMode::Release }) {
+		Shibboleth::SetAllocationHeaderMode(mode);
+
+		// Builds with double free or misaligned pointer checks are always in tracking mode.
+		const bool is_tracking = Shibboleth::GetAllocationHeaderMode() == Shibboleth::AllocationHeaderMode::Tracking;
+		const size_t bytes_per_allocation = k_benchmark_allocation_size + Shibboleth::GetAllocationHeaderSize();
+
+		WARN(
+			(is_tracking ? "Tracking" : "Release") << " header: " <<
+			bytes_per_allocation << " bytes per " << k_benchmark_allocation_size << " byte allocation"
+		);
+
+		BENCHMARK(is_tracking ? "1024 Allocs/Frees (Tracking Header)" : "1024 Allocs/Frees (Release Header)")
+		{
+			for (void*& data : allocations) {
+				data = SHIB_ALLOC(k_benchmark_allocation_size, allocator);
+			}
+
+			for (void* data : allocations) {
+				SHIB_FREE(data, allocator);
+			}
+
+			return allocations.size();
+		};
+	}
+
+	Shibboleth::SetAllocationHeaderMode(prev_mode);
+}
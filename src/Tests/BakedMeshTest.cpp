@@ -0,0 +1,206 @@
+/************************************************************************************
+Copyright (C) 2022 by Nicholas LaCroix
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+************************************************************************************/
+
+#include <Shibboleth_BakedMesh.h>
+#include <catch_amalgamated.hpp>
+#include <assimp/scene.h>
+#include <assimp/mesh.h>
+
+namespace
+{
+	constexpr Shibboleth::BakedMeshSource k_source = { 1024, 123456789, Gaff::Hash64(42) };
+
+	// A quad, a degenerate line face that should be dropped, and a vertex nothing references.
+	aiMesh* MakeQuad(void)
+	{
+		aiMesh* const mesh = new aiMesh();
+
+		mesh->mName = "quad";
+		mesh->mNumVertices = 5;
+		mesh->mVertices = new aiVector3D[5]{ { 0.0f, 0.0f, 0.0f }, { 2.0f, 0.0f, 0.0f }, { 0.0f, 2.0f, 0.0f }, { 2.0f, 2.0f, 0.0f }, { 9.0f, 9.0f, 9.0f } };
+		mesh->mNormals = new aiVector3D[5]{ { 0.0f, 0.0f, 3.0f }, { 0.0f, 0.0f, 3.0f }, { 0.0f, 0.0f, 3.0f }, { 0.0f, 0.0f, 3.0f }, { 0.0f, 0.0f, 3.0f } };
+		mesh->mAABB = aiAABB(aiVector3D(0.0f, 0.0f, 0.0f), aiVector3D(2.0f, 2.0f, 0.0f));
+
+		mesh->mNumFaces = 3;
+		mesh->mFaces = new aiFace[3];
+
+		mesh->mFaces[0].mNumIndices = 3;
+		mesh->mFaces[0].mIndices = new unsigned int[3]{ 3, 1, 2 };
+		mesh->mFaces[1].mNumIndices = 3;
+		mesh->mFaces[1].mIndices = new unsigned int[3]{ 2, 1, 0 };
+		mesh->mFaces[2].mNumIndices = 2;
+		mesh->mFaces[2].mIndices = new unsigned int[2]{ 0, 1 };
+
+		return mesh;
+	}
+
+	void BakeQuad(Shibboleth::Vector<int8_t>& out)
+	{
+		aiScene scene;
+		scene.mNumMeshes = 1;
+		scene.mMeshes = new aiMesh*[1]{ MakeQuad() };
+
+		Shibboleth::Vector<int32_t> centering_meshes;
+		centering_meshes.emplace_back(0);
+
+		REQUIRE(Shibboleth::BakedMesh::Bake(scene, centering_meshes, k_source, out));
+	}
+
+	Shibboleth::BakedSubmeshHeader& GetSubmesh(Shibboleth::Vector<int8_t>& blob)
+	{
+		return *reinterpret_cast<Shibboleth::BakedSubmeshHeader*>(blob.data() + sizeof(Shibboleth::BakedMeshHeader));
+	}
+}
+
+TEST_CASE("shibboleth_baked_mesh_round_trip")
+{
+	Shibboleth::Vector<int8_t> blob;
+	BakeQuad(blob);
+
+	Shibboleth::BakedMesh mesh;
+	REQUIRE(mesh.init(blob.data(), blob.size()));
+
+	REQUIRE(mesh.getSource() == k_source);
+	REQUIRE(mesh.getNumSubmeshes() == 1);
+	REQUIRE(mesh.getSubmeshName(0) == u8"quad");
+
+	const Gleam::Vec3 centering_vector = mesh.getCenteringVector();
+	REQUIRE(centering_vector.x == -1.0f);
+	REQUIRE(centering_vector.y == -1.0f);
+	REQUIRE(centering_vector.z == 0.0f);
+
+	const Gleam::AABB aabb = mesh.getSubmeshAABB(0);
+	REQUIRE(aabb.getMin() == Gleam::Vec3(0.0f, 0.0f, 0.0f));
+	REQUIRE(aabb.getMax() == Gleam::Vec3(2.0f, 2.0f, 0.0f));
+
+	const Shibboleth::BakedSubmeshHeader& submesh = mesh.getSubmesh(0);
+
+	// Positions and normals. The unreferenced vertex and the line face are dropped.
+	REQUIRE(submesh.stream_count == 2);
+	REQUIRE(submesh.stream_offsets[0] == 0);
+	REQUIRE(submesh.stream_offsets[1] == sizeof(float) * 3);
+	REQUIRE(submesh.vertex_stride == sizeof(float) * 6);
+	REQUIRE(submesh.vertex_count == 4);
+	REQUIRE(submesh.index_count == 6);
+	REQUIRE(submesh.index_size == sizeof(uint16_t));
+
+	REQUIRE(submesh.vertex_offset % Shibboleth::BakedMesh::k_data_alignment == 0);
+	REQUIRE(submesh.index_offset % Shibboleth::BakedMesh::k_data_alignment == 0);
+
+	// Vertices are laid out in the order the triangles first use them.
+	const uint16_t* const indices = reinterpret_cast<const uint16_t*>(mesh.getIndexData(0));
+	const uint16_t expected_indices[] = { 0, 1, 2, 2, 1, 3 };
+
+	for (int32_t i = 0; i < submesh.index_count; ++i) {
+		REQUIRE(indices[i] == expected_indices[i]);
+	}
+
+	const float* const vertices = reinterpret_cast<const float*>(mesh.getVertexData(0));
+	const float expected_positions[4][3] = { { 2.0f, 2.0f, 0.0f }, { 2.0f, 0.0f, 0.0f }, { 0.0f, 2.0f, 0.0f }, { 0.0f, 0.0f, 0.0f } };
+
+	for (int32_t i = 0; i < submesh.vertex_count; ++i) {
+		const float* const vertex = vertices + i * 6;
+
+		REQUIRE(vertex[0] == expected_positions[i][0]);
+		REQUIRE(vertex[1] == expected_positions[i][1]);
+		REQUIRE(vertex[2] == expected_positions[i][2]);
+
+		// Normals are normalized when baked.
+		REQUIRE(vertex[3] == 0.0f);
+		REQUIRE(vertex[4] == 0.0f);
+		REQUIRE(vertex[5] == 1.0f);
+	}
+}
+
+TEST_CASE("shibboleth_baked_mesh_corrupt")
+{
+	Shibboleth::Vector<int8_t> good;
+	BakeQuad(good);
+
+	Shibboleth::BakedMesh mesh;
+	REQUIRE(mesh.init(good.data(), good.size()));
+
+	REQUIRE_FALSE(mesh.init(nullptr, good.size()));
+	REQUIRE_FALSE(mesh.init(good.data(), 0));
+	REQUIRE_FALSE(mesh.init(good.data(), sizeof(Shibboleth::BakedMeshHeader) - 1));
+
+	// Truncated anywhere past the header.
+	REQUIRE_FALSE(mesh.init(good.data(), sizeof(Shibboleth::BakedMeshHeader) + 1));
+	REQUIRE_FALSE(mesh.init(good.data(), good.size() - 1));
+
+	SECTION("bad header")
+	{
+		Shibboleth::Vector<int8_t> blob = good;
+		Shibboleth::BakedMeshHeader& header = *reinterpret_cast<Shibboleth::BakedMeshHeader*>(blob.data());
+
+		header.magic = 0;
+		REQUIRE_FALSE(mesh.init(blob.data(), blob.size()));
+
+		header = *reinterpret_cast<const Shibboleth::BakedMeshHeader*>(good.data());
+		header.version = Shibboleth::BakedMesh::k_version + 1;
+		REQUIRE_FALSE(mesh.init(blob.data(), blob.size()));
+
+		header = *reinterpret_cast<const Shibboleth::BakedMeshHeader*>(good.data());
+		header.num_submeshes = -1;
+		REQUIRE_FALSE(mesh.init(blob.data(), blob.size()));
+
+		header.num_submeshes = INT32_MAX;
+		REQUIRE_FALSE(mesh.init(blob.data(), blob.size()));
+	}
+
+	SECTION("bad submesh")
+	{
+		Shibboleth::Vector<int8_t> blob = good;
+		Shibboleth::BakedSubmeshHeader& submesh = GetSubmesh(blob);
+		const Shibboleth::BakedSubmeshHeader original = submesh;
+
+		submesh.name_offset = blob.size();
+		REQUIRE_FALSE(mesh.init(blob.data(), blob.size()));
+
+		submesh = original;
+		submesh.vertex_offset = UINT64_MAX - 1;
+		REQUIRE_FALSE(mesh.init(blob.data(), blob.size()));
+
+		submesh = original;
+		submesh.vertex_count = INT32_MAX;
+		REQUIRE_FALSE(mesh.init(blob.data(), blob.size()));
+
+		submesh = original;
+		submesh.index_offset = blob.size() - 1;
+		REQUIRE_FALSE(mesh.init(blob.data(), blob.size()));
+
+		submesh = original;
+		submesh.index_size = 3;
+		REQUIRE_FALSE(mesh.init(blob.data(), blob.size()));
+
+		submesh = original;
+		submesh.stream_count = Shibboleth::BakedSubmeshHeader::k_max_streams + 1;
+		REQUIRE_FALSE(mesh.init(blob.data(), blob.size()));
+
+		submesh = original;
+		submesh.stream_offsets[1] = static_cast<uint32_t>(submesh.vertex_stride);
+		REQUIRE_FALSE(mesh.init(blob.data(), blob.size()));
+
+		submesh = original;
+		REQUIRE(mesh.init(blob.data(), blob.size()));
+	}
+}
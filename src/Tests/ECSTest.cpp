@@ -21,10 +21,66 @@ THE SOFTWARE.
 ************************************************************************************/
 
 #include <Shibboleth_ECSComponentCommon.h>
+#include <Shibboleth_ECSCommandBuffer.h>
 #include <Shibboleth_ECSManager.h>
 #include <Shibboleth_ECSQuery.h>
 #include <Shibboleth_App.h>
 #include <catch_amalgamated.hpp>
+#include <Gleam_Frustum.h>
+#include <Gleam_OBB.h>
+#include <gtx/euler_angles.hpp>
+#include <EASTL/atomic.h>
+
+static Gleam::Mat4x4 CalculateTransformScalar(
+	const Shibboleth::Position& position,
+	const Shibboleth::Rotation& rotation,
+	const Shibboleth::Scale& scale,
+	const Gleam::Mat4x4& pre_transform,
+	const Gleam::Vec3& local_offset)
+{
+	const Gleam::Vec3 euler_angles = rotation.value * Gaff::TurnsToRad;
+
+	Gleam::Mat4x4 transform = glm::yawPitchRoll(euler_angles.y, euler_angles.x, euler_angles.z);
+	transform[3] = Gleam::Vec4(position.value, 1.0f);
+	transform = glm::scale(transform, scale.value);
+
+	Gleam::Mat4x4 offset = glm::identity<Gleam::Mat4x4>();
+	offset[3] = Gleam::Vec4(local_offset, 1.0f);
+
+	return pre_transform * transform * offset;
+}
+
+static void CalculateTransformsBatch(
+	Shibboleth::ECSManager& ecs_mgr,
+	const Shibboleth::ECSQueryResult& position_result,
+	const Shibboleth::ECSQueryResult& rotation_result,
+	const Shibboleth::ECSQueryResult& scale_result,
+	const Gleam::Mat4x4& pre_transform,
+	const Gleam::Vec3& local_offset,
+	Gleam::Mat4x4* out_transforms)
+{
+	const int32_t entity_capacity = ecs_mgr.getEntityCapacity(position_result);
+	int32_t object_index = 0;
+
+	for (int32_t entity_index = 0; entity_index < entity_capacity; entity_index += 4) {
+		Gleam::Mat4x4* out[4] = { nullptr, nullptr, nullptr, nullptr };
+
+		for (int32_t lane = 0; lane < 4; ++lane) {
+			if (Shibboleth::ValidEntityID(ecs_mgr.getEntityID(position_result, entity_index + lane))) {
+				out[lane] = out_transforms + object_index++;
+			}
+		}
+
+		Shibboleth::CalculateTransforms(
+			ecs_mgr.getComponent(position_result, entity_index),
+			ecs_mgr.getComponent(rotation_result, entity_index),
+			ecs_mgr.getComponent(scale_result, entity_index),
+			pre_transform,
+			local_offset,
+			out
+		);
+	}
+}
 
 TEST_CASE("shibboleth_ecs_archetype_hash")
 {
@@ -91,6 +147,284 @@ TEST_CASE("shibboleth_ecs_create_destroy_entity")
 	ecs_mgr.destroyEntity(id2);
 }
 
+TEST_CASE("shibboleth_ecs_create_destroy_entities")
+{
+	Refl::InitEnumReflection();
+	Refl::InitAttributeReflection();
+	Refl::InitClassReflection();
+
+	static constexpr int32_t k_num_entities = 3000;
+
+	Shibboleth::ECSManager ecs_mgr;
+
+	Shibboleth::ECSArchetype archetype;
+	REQUIRE(archetype.add<Shibboleth::Position>());
+	REQUIRE(archetype.add<Shibboleth::Scale>());
+	REQUIRE(archetype.finalize());
+
+	const Gaff::Hash64 archetype_hash = archetype.getHash();
+
+	// Hold a reference so the archetype outlives all of its entities.
+	Shibboleth::ArchetypeReferencePtr arch_ref;
+	ecs_mgr.addArchetype(std::move(archetype), arch_ref);
+
+	Shibboleth::Vector<Shibboleth::ECSQueryResult> position_output;
+	Shibboleth::ECSQuery query;
+
+	query.add<Shibboleth::Position>(position_output);
+	ecs_mgr.registerQuery(std::move(query));
+
+	REQUIRE(position_output.size() == 1);
+
+	Shibboleth::EntityID ids[k_num_entities];
+	ecs_mgr.createEntities(archetype_hash, k_num_entities, ids);
+
+	for (int32_t i = 0; i < k_num_entities; ++i) {
+		REQUIRE(ids[i] == i);
+		Shibboleth::Position::Set(ecs_mgr, ids[i], Shibboleth::Position(Gleam::Vec3(static_cast<float>(i))));
+	}
+
+	REQUIRE(ecs_mgr.getNumEntities(position_output[0]) == k_num_entities);
+
+	// Destroy the first half outright, which empties whole pages, and every third entity after that.
+	Shibboleth::Vector<Shibboleth::EntityID> to_destroy;
+
+	for (int32_t i = 0; i < k_num_entities; ++i) {
+		if (i < (k_num_entities / 2) || (i % 3) == 0) {
+			to_destroy.emplace_back(ids[i]);
+		}
+	}
+
+	ecs_mgr.destroyEntities(to_destroy.data(), static_cast<int32_t>(to_destroy.size()));
+
+	const int32_t num_alive = k_num_entities - static_cast<int32_t>(to_destroy.size());
+	REQUIRE(ecs_mgr.getNumEntities(position_output[0]) == num_alive);
+
+	for (int32_t i = 0; i < k_num_entities; ++i) {
+		if (i >= (k_num_entities / 2) && (i % 3) != 0) {
+			REQUIRE(Shibboleth::Position::Get(ecs_mgr, ids[i]).value == Gleam::Vec3(static_cast<float>(i)));
+		}
+	}
+
+	// Refill the holes and reuse the freed IDs.
+	Shibboleth::EntityID new_ids[k_num_entities];
+	ecs_mgr.createEntities(archetype_hash, k_num_entities, new_ids);
+
+	REQUIRE(ecs_mgr.getNumEntities(position_output[0]) == num_alive + k_num_entities);
+
+	for (int32_t i = 0; i < k_num_entities; ++i) {
+		Shibboleth::Position::Set(ecs_mgr, new_ids[i], Shibboleth::Position(Gleam::Vec3(-1.0f)));
+	}
+
+	for (int32_t i = 0; i < k_num_entities; ++i) {
+		if (i >= (k_num_entities / 2) && (i % 3) != 0) {
+			REQUIRE(Shibboleth::Position::Get(ecs_mgr, ids[i]).value == Gleam::Vec3(static_cast<float>(i)));
+		}
+	}
+
+	ecs_mgr.destroyEntities(new_ids, k_num_entities);
+	REQUIRE(ecs_mgr.getNumEntities(position_output[0]) == num_alive);
+	REQUIRE(arch_ref->getRefCount() == num_alive + 1);
+}
+
+TEST_CASE("shibboleth_ecs_command_buffer")
+{
+	Refl::InitEnumReflection();
+	Refl::InitAttributeReflection();
+	Refl::InitClassReflection();
+
+	static constexpr int32_t k_num_entities = 1000;
+
+	Shibboleth::ECSManager ecs_mgr;
+
+	Shibboleth::ECSArchetype archetype;
+	REQUIRE(archetype.add<Shibboleth::Position>());
+	REQUIRE(archetype.finalize());
+
+	const Gaff::Hash64 archetype_hash = archetype.getHash();
+
+	Shibboleth::ArchetypeReferencePtr arch_ref;
+	ecs_mgr.addArchetype(std::move(archetype), arch_ref);
+
+	Shibboleth::EntityID ids[k_num_entities];
+	ecs_mgr.createEntities(archetype_hash, k_num_entities, ids);
+
+	Shibboleth::Vector<Shibboleth::ECSQueryResult> position_output;
+	Shibboleth::ECSQuery query;
+
+	query.add<Shibboleth::Position>(position_output);
+	ecs_mgr.registerQuery(std::move(query));
+
+	REQUIRE(position_output.size() == 1);
+
+	Shibboleth::ECSCommandBuffer& command_buffer = ecs_mgr.getCommandBuffer();
+
+	// Record from multiple threads. Nothing should change until the buffer is applied.
+	ecs_mgr.parallelIterate<Shibboleth::Position>(
+		position_output[0],
+		[&command_buffer](Shibboleth::EntityID id, Shibboleth::Position) -> void
+		{
+			if ((id % 5) == 0) {
+				command_buffer.destroyEntity(id);
+
+			} else if ((id % 2) == 0) {
+				command_buffer.addComponents<Shibboleth::Scale>(id);
+				command_buffer.set<Shibboleth::Scale>(id, Shibboleth::Scale(Gleam::Vec3(static_cast<float>(id))));
+			}
+		},
+		64
+	);
+
+	const Shibboleth::EntityID created_id = command_buffer.createEntity(archetype_hash);
+
+	REQUIRE(Shibboleth::ECSCommandBuffer::IsPlaceholder(created_id));
+	REQUIRE(!command_buffer.isEmpty());
+	REQUIRE(ecs_mgr.getNumEntities(position_output[0]) == k_num_entities);
+
+	command_buffer.apply(ecs_mgr);
+
+	REQUIRE(command_buffer.isEmpty());
+	REQUIRE(command_buffer.getCreatedEntities().size() == 1);
+	REQUIRE(command_buffer.resolve(created_id) == command_buffer.getCreatedEntities()[0]);
+	REQUIRE(ecs_mgr.hasComponent<Shibboleth::Position>(command_buffer.resolve(created_id)));
+	REQUIRE(!ecs_mgr.hasComponent<Shibboleth::Scale>(command_buffer.resolve(created_id)));
+
+	int32_t num_alive = 1;
+	int32_t num_scaled = 0;
+
+	for (int32_t i = 0; i < k_num_entities; ++i) {
+		if ((i % 5) == 0) {
+			continue;
+		}
+
+		++num_alive;
+
+		if ((i % 2) == 0) {
+			REQUIRE(ecs_mgr.hasComponent<Shibboleth::Scale>(ids[i]));
+			REQUIRE(Shibboleth::Scale::Get(ecs_mgr, ids[i]).value == Gleam::Vec3(static_cast<float>(i)));
+			++num_scaled;
+
+		} else {
+			REQUIRE(!ecs_mgr.hasComponent<Shibboleth::Scale>(ids[i]));
+		}
+	}
+
+	REQUIRE(position_output.size() == 2);
+
+	const int32_t num_entities = ecs_mgr.getNumEntities(position_output[0]) + ecs_mgr.getNumEntities(position_output[1]);
+	REQUIRE(num_entities == num_alive);
+	REQUIRE(arch_ref->getRefCount() == num_alive - num_scaled + 1);
+}
+
+TEST_CASE("shibboleth_ecs_command_buffer_ordering")
+{
+	Refl::InitEnumReflection();
+	Refl::InitAttributeReflection();
+	Refl::InitClassReflection();
+
+	Shibboleth::ECSManager ecs_mgr;
+
+	Shibboleth::ECSArchetype archetype;
+	REQUIRE(archetype.add<Shibboleth::Position>());
+	REQUIRE(archetype.finalize());
+
+	const Gaff::Hash64 archetype_hash = archetype.getHash();
+
+	Shibboleth::ArchetypeReferencePtr arch_ref;
+	ecs_mgr.addArchetype(std::move(archetype), arch_ref);
+
+	Shibboleth::EntityID ids[3];
+	ecs_mgr.createEntities(archetype_hash, 3, ids);
+
+	Shibboleth::ECSCommandBuffer command_buffer;
+
+	// Placeholders can be used by the rest of the buffer before they are applied.
+	const Shibboleth::EntityID created_id = command_buffer.createEntity(archetype_hash);
+	command_buffer.addComponents<Shibboleth::Scale>(created_id);
+	command_buffer.set<Shibboleth::Scale>(created_id, Shibboleth::Scale(Gleam::Vec3(5.0f)));
+
+	// Set has to land between the add and the remove.
+	command_buffer.addComponents<Shibboleth::Scale>(ids[0]);
+	command_buffer.set<Shibboleth::Scale>(ids[0], Shibboleth::Scale(Gleam::Vec3(1.0f)));
+	command_buffer.removeComponents<Shibboleth::Scale>(ids[0]);
+
+	// Add then remove ends up back where it started.
+	command_buffer.addComponents<Shibboleth::Scale>(ids[1]);
+	command_buffer.removeComponents<Shibboleth::Scale>(ids[1]);
+	command_buffer.addComponents<Shibboleth::Scale>(ids[1]);
+	command_buffer.set<Shibboleth::Scale>(ids[1], Shibboleth::Scale(Gleam::Vec3(2.0f)));
+
+	// Anything after a destroy is dropped.
+	command_buffer.destroyEntity(ids[2]);
+	command_buffer.addComponents<Shibboleth::Scale>(ids[2]);
+	command_buffer.destroyEntity(ids[2]);
+
+	command_buffer.apply(ecs_mgr);
+
+	const Shibboleth::EntityID created = command_buffer.resolve(created_id);
+
+	REQUIRE(Shibboleth::ValidEntityID(created));
+	REQUIRE(ecs_mgr.hasComponent<Shibboleth::Scale>(created));
+	REQUIRE(Shibboleth::Scale::Get(ecs_mgr, created).value == Gleam::Vec3(5.0f));
+
+	REQUIRE(!ecs_mgr.hasComponent<Shibboleth::Scale>(ids[0]));
+	REQUIRE(ecs_mgr.getArchetype(ids[0]).getHash() == archetype_hash);
+
+	REQUIRE(ecs_mgr.hasComponent<Shibboleth::Scale>(ids[1]));
+	REQUIRE(Shibboleth::Scale::Get(ecs_mgr, ids[1]).value == Gleam::Vec3(2.0f));
+
+	// ids[0] plus the archetype reference we're holding.
+	REQUIRE(arch_ref->getRefCount() == 2);
+}
+
+TEST_CASE("shibboleth_ecs_command_buffer_swap_archetypes")
+{
+	Refl::InitEnumReflection();
+	Refl::InitAttributeReflection();
+	Refl::InitClassReflection();
+
+	Shibboleth::ECSManager ecs_mgr;
+
+	Shibboleth::ECSArchetype archetype;
+	REQUIRE(archetype.add<Shibboleth::Position>());
+	REQUIRE(archetype.finalize());
+
+	const Gaff::Hash64 archetype_hash = archetype.getHash();
+	ecs_mgr.addArchetype(std::move(archetype));
+
+	Shibboleth::EntityID ids[2];
+	ecs_mgr.createEntities(archetype_hash, 2, ids);
+
+	Shibboleth::Position::Set(ecs_mgr, ids[0], Shibboleth::Position(Gleam::Vec3(1.0f)));
+	Shibboleth::Position::Set(ecs_mgr, ids[1], Shibboleth::Position(Gleam::Vec3(2.0f)));
+
+	ecs_mgr.addComponents<Shibboleth::Scale>(ids[1]);
+	Shibboleth::Scale::Set(ecs_mgr, ids[1], Shibboleth::Scale(Gleam::Vec3(3.0f)));
+
+	const Gaff::Hash64 scale_archetype_hash = ecs_mgr.getArchetype(ids[1]).getHash();
+
+	// Each entity is the only one keeping its archetype alive, and each is moving into the other's archetype.
+	// Neither archetype can be removed until both have moved.
+	Shibboleth::ECSCommandBuffer command_buffer;
+	command_buffer.addComponents<Shibboleth::Scale>(ids[0]);
+	command_buffer.set<Shibboleth::Scale>(ids[0], Shibboleth::Scale(Gleam::Vec3(4.0f)));
+	command_buffer.removeComponents<Shibboleth::Scale>(ids[1]);
+
+	command_buffer.apply(ecs_mgr);
+
+	REQUIRE(ecs_mgr.getArchetype(ids[0]).getHash() == scale_archetype_hash);
+	REQUIRE(ecs_mgr.getArchetype(ids[1]).getHash() == archetype_hash);
+
+	REQUIRE(Shibboleth::Position::Get(ecs_mgr, ids[0]).value == Gleam::Vec3(1.0f));
+	REQUIRE(Shibboleth::Scale::Get(ecs_mgr, ids[0]).value == Gleam::Vec3(4.0f));
+	REQUIRE(Shibboleth::Position::Get(ecs_mgr, ids[1]).value == Gleam::Vec3(2.0f));
+	REQUIRE(!ecs_mgr.hasComponent<Shibboleth::Scale>(ids[1]));
+
+	// The entity, plus the reference we're holding to check.
+	REQUIRE(ecs_mgr.getArchetypeReference(ids[0])->getRefCount() == 2);
+	REQUIRE(ecs_mgr.getArchetypeReference(ids[1])->getRefCount() == 2);
+}
+
 TEST_CASE("shibboleth_ecs_add_remove_component")
 {
 	Refl::InitEnumReflection();
@@ -169,6 +503,55 @@ TEST_CASE("shibboleth_ecs_add_remove_shared_component")
 	ecs_mgr.destroyEntity(id);
 }
 
+TEST_CASE("shibboleth_ecs_archetype_transitions")
+{
+	Refl::InitEnumReflection();
+	Refl::InitAttributeReflection();
+	Refl::InitClassReflection();
+
+	Shibboleth::ECSManager ecs_mgr;
+
+	Shibboleth::ECSArchetype archetype;
+	REQUIRE(archetype.add<Shibboleth::Position>());
+	REQUIRE(archetype.finalize());
+
+	const Gaff::Hash64 archetype_hash = archetype.getHash();
+
+	Shibboleth::ArchetypeReferencePtr arch_ref;
+	ecs_mgr.addArchetype(std::move(archetype), arch_ref);
+
+	const Shibboleth::EntityID id = ecs_mgr.createEntity(archetype_hash);
+	Shibboleth::Position::Set(ecs_mgr, id, Shibboleth::Position(Gleam::Vec3(1.0f, 2.0f, 3.0f)));
+
+	// Toggling the same component should keep landing in the same two archetypes.
+	// Every time the entity leaves the Scale archetype it gets removed, so the cached transition into it must be dropped too.
+	for (int32_t i = 0; i < 100; ++i) {
+		ecs_mgr.addComponents<Shibboleth::Scale>(id);
+		REQUIRE(ecs_mgr.hasComponent<Shibboleth::Scale>(id));
+		REQUIRE(ecs_mgr.getArchetype(id).getHash() != archetype_hash);
+
+		ecs_mgr.removeComponents<Shibboleth::Scale>(id);
+		REQUIRE(!ecs_mgr.hasComponent<Shibboleth::Scale>(id));
+		REQUIRE(ecs_mgr.getArchetype(id).getHash() == archetype_hash);
+	}
+
+	// Keep the Scale archetype alive with a second entity so the cached transition gets used.
+	const Shibboleth::EntityID other_id = ecs_mgr.createEntity(archetype_hash);
+	ecs_mgr.addComponents<Shibboleth::Scale>(other_id);
+
+	const Gaff::Hash64 scale_archetype_hash = ecs_mgr.getArchetype(other_id).getHash();
+
+	for (int32_t i = 0; i < 100; ++i) {
+		ecs_mgr.addComponents<Shibboleth::Scale>(id);
+		REQUIRE(ecs_mgr.getArchetype(id).getHash() == scale_archetype_hash);
+
+		ecs_mgr.removeComponents<Shibboleth::Scale>(id);
+		REQUIRE(ecs_mgr.getArchetype(id).getHash() == archetype_hash);
+	}
+
+	REQUIRE(Shibboleth::Position::Get(ecs_mgr, id).value == Gleam::Vec3(1.0f, 2.0f, 3.0f));
+}
+
 TEST_CASE("shibboleth_ecs_query")
 {
 	Refl::InitEnumReflection();
@@ -210,3 +593,485 @@ TEST_CASE("shibboleth_ecs_query")
 	REQUIRE(Shibboleth::Position::Get(ecs_mgr, position_output[0], 0).value == Gleam::Vec3(0.0f, 1.0f, 2.0f));
 	REQUIRE(scale_output[0]->value == Gleam::Vec3(3.0f));
 }
+
+TEST_CASE("shibboleth_ecs_calculate_transforms")
+{
+	Refl::InitEnumReflection();
+	Refl::InitAttributeReflection();
+	Refl::InitClassReflection();
+
+	static constexpr int32_t k_num_entities = 103;
+
+	Shibboleth::ECSManager ecs_mgr;
+
+	Shibboleth::ECSArchetype archetype;
+	REQUIRE(archetype.add<Shibboleth::Position>());
+	REQUIRE(archetype.add<Shibboleth::Rotation>());
+	REQUIRE(archetype.add<Shibboleth::Scale>());
+	REQUIRE(archetype.finalize());
+
+	const Gaff::Hash64 archetype_hash = archetype.getHash();
+
+	Shibboleth::ArchetypeReferencePtr arch_ref;
+	ecs_mgr.addArchetype(std::move(archetype), arch_ref);
+
+	Shibboleth::EntityID ids[k_num_entities];
+	ecs_mgr.createEntities(archetype_hash, k_num_entities, ids);
+
+	for (int32_t i = 0; i < k_num_entities; ++i) {
+		const float value = static_cast<float>(i);
+
+		Shibboleth::Position::Set(ecs_mgr, ids[i], Shibboleth::Position(Gleam::Vec3(value, -value * 0.5f, 2.0f)));
+		Shibboleth::Rotation::Set(ecs_mgr, ids[i], Shibboleth::Rotation(Gleam::Vec3(value * 0.01f, value * 0.02f, value * -0.03f)));
+		Shibboleth::Scale::Set(ecs_mgr, ids[i], Shibboleth::Scale(Gleam::Vec3(1.0f + value * 0.1f, 2.0f, 0.5f)));
+	}
+
+	// Leave some holes so empty slots get skipped.
+	for (int32_t i = 0; i < k_num_entities; i += 3) {
+		ecs_mgr.destroyEntity(ids[i]);
+	}
+
+	Shibboleth::Vector<Shibboleth::ECSQueryResult> position_output;
+	Shibboleth::Vector<Shibboleth::ECSQueryResult> rotation_output;
+	Shibboleth::Vector<Shibboleth::ECSQueryResult> scale_output;
+	Shibboleth::ECSQuery query;
+
+	query.add<Shibboleth::Position>(position_output);
+	query.add<Shibboleth::Rotation>(rotation_output);
+	query.add<Shibboleth::Scale>(scale_output);
+
+	ecs_mgr.registerQuery(std::move(query));
+
+	REQUIRE(position_output.size() == 1);
+	REQUIRE((ecs_mgr.getEntityCapacity(position_output[0]) % 4) == 0);
+
+	const Gleam::Mat4x4 pre_transform = glm::perspectiveFovLH(1.5f, 1280.0f, 720.0f, 0.1f, 1000.0f) * glm::translate(glm::identity<Gleam::Mat4x4>(), Gleam::Vec3(1.0f, 2.0f, 3.0f));
+	const Gleam::Vec3 local_offset(0.25f, -0.5f, 1.0f);
+
+	const int32_t num_entities = ecs_mgr.getNumEntities(position_output[0]);
+	Shibboleth::Vector<Gleam::Mat4x4> expected;
+	Shibboleth::Vector<Gleam::Mat4x4> actual(static_cast<size_t>(num_entities));
+
+	ecs_mgr.iterate<Shibboleth::Position, Shibboleth::Rotation, Shibboleth::Scale>(
+		position_output[0], rotation_output[0], scale_output[0],
+		[&](Shibboleth::EntityID, const Shibboleth::Position& position, const Shibboleth::Rotation& rotation, const Shibboleth::Scale& scale) -> void
+		{
+			expected.emplace_back(CalculateTransformScalar(position, rotation, scale, pre_transform, local_offset));
+		}
+	);
+
+	CalculateTransformsBatch(ecs_mgr, position_output[0], rotation_output[0], scale_output[0], pre_transform, local_offset, actual.data());
+
+	REQUIRE(static_cast<int32_t>(expected.size()) == num_entities);
+
+	for (int32_t i = 0; i < num_entities; ++i) {
+		for (int32_t column = 0; column < 4; ++column) {
+			for (int32_t row = 0; row < 4; ++row) {
+				REQUIRE(actual[i][column][row] == Catch::Approx(expected[i][column][row]).epsilon(0.0001f).margin(0.0001f));
+			}
+		}
+	}
+}
+
+TEST_CASE("shibboleth_ecs_frustum_cull")
+{
+	Refl::InitEnumReflection();
+	Refl::InitAttributeReflection();
+	Refl::InitClassReflection();
+
+	static constexpr int32_t k_num_entities = 256;
+
+	Shibboleth::ECSManager ecs_mgr;
+
+	Shibboleth::ECSArchetype archetype;
+	REQUIRE(archetype.add<Shibboleth::Position>());
+	REQUIRE(archetype.add<Shibboleth::Rotation>());
+	REQUIRE(archetype.add<Shibboleth::Scale>());
+	REQUIRE(archetype.finalize());
+
+	const Gaff::Hash64 archetype_hash = archetype.getHash();
+
+	Shibboleth::ArchetypeReferencePtr arch_ref;
+	ecs_mgr.addArchetype(std::move(archetype), arch_ref);
+
+	Shibboleth::EntityID ids[k_num_entities];
+	ecs_mgr.createEntities(archetype_hash, k_num_entities, ids);
+
+	// Spread entities on a grid around the camera so some are in front, some behind and some off to the sides.
+	for (int32_t i = 0; i < k_num_entities; ++i) {
+		const float x = static_cast<float>(i % 16) * 8.0f - 64.0f;
+		const float z = static_cast<float>(i / 16) * 8.0f - 32.0f;
+
+		Shibboleth::Position::Set(ecs_mgr, ids[i], Shibboleth::Position(Gleam::Vec3(x, 0.0f, z)));
+		Shibboleth::Rotation::Set(ecs_mgr, ids[i], Shibboleth::Rotation(Gleam::Vec3(0.0f, static_cast<float>(i) * 0.05f, 0.0f)));
+		Shibboleth::Scale::Set(ecs_mgr, ids[i], Shibboleth::Scale(Gleam::Vec3(1.0f + static_cast<float>(i % 5), 1.0f, 1.0f)));
+	}
+
+	Shibboleth::Vector<Shibboleth::ECSQueryResult> position_output;
+	Shibboleth::Vector<Shibboleth::ECSQueryResult> rotation_output;
+	Shibboleth::Vector<Shibboleth::ECSQueryResult> scale_output;
+	Shibboleth::ECSQuery query;
+
+	query.add<Shibboleth::Position>(position_output);
+	query.add<Shibboleth::Rotation>(rotation_output);
+	query.add<Shibboleth::Scale>(scale_output);
+
+	ecs_mgr.registerQuery(std::move(query));
+
+	REQUIRE(position_output.size() == 1);
+
+	const Gleam::Frustum frustum(glm::perspectiveFovLH(1.5f, 1280.0f, 720.0f, 0.1f, 100.0f));
+	const Gleam::Vec3 bounds_center(0.5f, 0.0f, 0.0f);
+	const Gleam::Vec3 bounds_extent(1.0f, 1.0f, 1.0f);
+	const Gleam::Vec3 local_offset(0.0f, 0.0f, 0.0f);
+
+	const int32_t entity_capacity = ecs_mgr.getEntityCapacity(position_output[0]);
+	int32_t visible_count = 0;
+	int32_t culled_count = 0;
+
+	for (int32_t entity_index = 0; entity_index < entity_capacity; entity_index += 4) {
+		Gleam::Vec4SIMD model[4][3];
+
+		Shibboleth::CalculateTransforms(
+			ecs_mgr.getComponent(position_output[0], entity_index),
+			ecs_mgr.getComponent(rotation_output[0], entity_index),
+			ecs_mgr.getComponent(scale_output[0], entity_index),
+			local_offset,
+			model
+		);
+
+		Gleam::Vec4SIMD center[3];
+		Gleam::Vec4SIMD axes[3][3];
+
+		for (int32_t row = 0; row < 3; ++row) {
+			center[row] = model[3][row] + model[0][row] * bounds_center.x + model[1][row] * bounds_center.y + model[2][row] * bounds_center.z;
+
+			for (int32_t axis = 0; axis < 3; ++axis) {
+				axes[axis][row] = model[axis][row] * bounds_extent[axis];
+			}
+		}
+
+		const int32_t visible_mask = frustum.contains(center, axes);
+
+		for (int32_t lane = 0; lane < 4; ++lane) {
+			const Shibboleth::EntityID id = ecs_mgr.getEntityID(position_output[0], entity_index + lane);
+
+			if (!Shibboleth::ValidEntityID(id)) {
+				continue;
+			}
+
+			const Gleam::Mat4x4 transform = CalculateTransformScalar(
+				Shibboleth::Position::Get(ecs_mgr, id),
+				Shibboleth::Rotation::Get(ecs_mgr, id),
+				Shibboleth::Scale::Get(ecs_mgr, id),
+				glm::identity<Gleam::Mat4x4>(),
+				local_offset
+			);
+
+			const Gleam::OBB obb(
+				Gleam::Vec3(transform * Gleam::Vec4(bounds_center, 1.0f)),
+				Gleam::Vec3(transform[0]) * bounds_extent.x,
+				Gleam::Vec3(transform[1]) * bounds_extent.y,
+				Gleam::Vec3(transform[2]) * bounds_extent.z
+			);
+
+			const bool visible = (visible_mask & (1 << lane)) != 0;
+			REQUIRE(visible == frustum.contains(obb));
+
+			if (visible) {
+				++visible_count;
+			} else {
+				++culled_count;
+			}
+		}
+	}
+
+	REQUIRE((visible_count + culled_count) == k_num_entities);
+	REQUIRE(visible_count > 0);
+	REQUIRE(culled_count > 0);
+
+	// Directly in front of and directly behind the camera.
+	const Gleam::Vec4SIMD center[3] = { Gleam::Vec4SIMD(0.0f), Gleam::Vec4SIMD(0.0f), Gleam::Vec4SIMD(10.0f, -10.0f, 200.0f, 0.0f) };
+	const Gleam::Vec4SIMD axes[3][3] = {
+		{ Gleam::Vec4SIMD(1.0f), Gleam::Vec4SIMD(0.0f), Gleam::Vec4SIMD(0.0f) },
+		{ Gleam::Vec4SIMD(0.0f), Gleam::Vec4SIMD(1.0f), Gleam::Vec4SIMD(0.0f) },
+		{ Gleam::Vec4SIMD(0.0f), Gleam::Vec4SIMD(0.0f), Gleam::Vec4SIMD(1.0f) }
+	};
+
+	REQUIRE(frustum.contains(center, axes) == 0x9);
+}
+
+TEST_CASE("shibboleth_ecs_parallel_iterate")
+{
+	Refl::InitEnumReflection();
+	Refl::InitAttributeReflection();
+	Refl::InitClassReflection();
+
+	static constexpr int32_t k_num_entities = 5000;
+
+	Shibboleth::ECSManager ecs_mgr;
+
+	Shibboleth::ECSArchetype archetype;
+	REQUIRE(archetype.add<Shibboleth::Position>());
+	REQUIRE(archetype.add<Shibboleth::Scale>());
+	REQUIRE(archetype.finalize());
+
+	const Gaff::Hash64 archetype_hash = archetype.getHash();
+	ecs_mgr.addArchetype(std::move(archetype));
+
+	int32_t num_alive = 0;
+
+	for (int32_t i = 0; i < k_num_entities; ++i) {
+		const Shibboleth::EntityID id = ecs_mgr.createEntity(archetype_hash);
+		Shibboleth::Scale::Set(ecs_mgr, id, Shibboleth::Scale(Gleam::Vec3(static_cast<float>(id))));
+	}
+
+	// Leave some holes to skip over.
+	for (Shibboleth::EntityID id = 0; id < k_num_entities; ++id) {
+		if ((id % 7) == 0) {
+			ecs_mgr.destroyEntity(id);
+		} else {
+			++num_alive;
+		}
+	}
+
+	Shibboleth::Vector<Shibboleth::ECSQueryResult> position_output;
+	Shibboleth::Vector<Shibboleth::ECSQueryResult> scale_output;
+	Shibboleth::ECSQuery query;
+
+	query.add<Shibboleth::Position>(position_output);
+	query.add<Shibboleth::Scale>(scale_output);
+
+	ecs_mgr.registerQuery(std::move(query));
+
+	REQUIRE(position_output.size() == 1);
+
+	eastl::atomic<int32_t> count = 0;
+
+	ecs_mgr.parallelIterate<Shibboleth::Position, Shibboleth::Scale>(
+		position_output[0],
+		scale_output[0],
+		[&ecs_mgr, &count](Shibboleth::EntityID id, Shibboleth::Position, Shibboleth::Scale scale) -> void
+		{
+			Shibboleth::Position::Set(ecs_mgr, id, Shibboleth::Position(scale.value * 2.0f));
+			++count;
+		},
+		64
+	);
+
+	REQUIRE(count == num_alive);
+
+	for (Shibboleth::EntityID id = 0; id < k_num_entities; ++id) {
+		if ((id % 7) != 0) {
+			REQUIRE(Shibboleth::Position::Get(ecs_mgr, id).value == Gleam::Vec3(static_cast<float>(id) * 2.0f));
+		}
+	}
+}
+
+TEST_CASE("shibboleth_ecs_parallel_iterate_benchmark", "[.][benchmark]")
+{
+	Refl::InitEnumReflection();
+	Refl::InitAttributeReflection();
+	Refl::InitClassReflection();
+
+	const auto update_position = [](Shibboleth::ECSManager& ecs_mgr, Shibboleth::EntityID id, Shibboleth::Position position, Shibboleth::Scale scale) -> void
+	{
+		Shibboleth::Position::Set(ecs_mgr, id, Shibboleth::Position(position.value + scale.value * 0.016f));
+	};
+
+	for (const int32_t num_entities : { 10000, 100000, 1000000 }) {
+		Shibboleth::ECSManager ecs_mgr;
+
+		Shibboleth::ECSArchetype archetype;
+		REQUIRE(archetype.add<Shibboleth::Position>());
+		REQUIRE(archetype.add<Shibboleth::Scale>());
+		REQUIRE(archetype.finalize());
+
+		const Gaff::Hash64 archetype_hash = archetype.getHash();
+		ecs_mgr.addArchetype(std::move(archetype));
+
+		for (int32_t i = 0; i < num_entities; ++i) {
+			ecs_mgr.createEntity(archetype_hash);
+		}
+
+		Shibboleth::Vector<Shibboleth::ECSQueryResult> position_output;
+		Shibboleth::Vector<Shibboleth::ECSQueryResult> scale_output;
+		Shibboleth::ECSQuery query;
+
+		query.add<Shibboleth::Position>(position_output);
+		query.add<Shibboleth::Scale>(scale_output);
+
+		ecs_mgr.registerQuery(std::move(query));
+
+		const auto callback = [&ecs_mgr, &update_position](Shibboleth::EntityID id, Shibboleth::Position position, Shibboleth::Scale scale) -> void
+		{
+			update_position(ecs_mgr, id, position, scale);
+		};
+
+		const Shibboleth::U8String iterate_name(Shibboleth::U8String::CtorSprintf(), u8"iterate (%i entities)", num_entities);
+		const Shibboleth::U8String parallel_iterate_name(Shibboleth::U8String::CtorSprintf(), u8"parallelIterate (%i entities)", num_entities);
+
+		BENCHMARK(reinterpret_cast<const char*>(iterate_name.data()))
+		{
+			ecs_mgr.iterate<Shibboleth::Position, Shibboleth::Scale>(position_output[0], scale_output[0], callback);
+			return num_entities;
+		};
+
+		BENCHMARK(reinterpret_cast<const char*>(parallel_iterate_name.data()))
+		{
+			ecs_mgr.parallelIterate<Shibboleth::Position, Shibboleth::Scale>(position_output[0], scale_output[0], callback);
+			return num_entities;
+		};
+	}
+}
+
+TEST_CASE("shibboleth_ecs_create_destroy_entities_benchmark", "[.][benchmark]")
+{
+	Refl::InitEnumReflection();
+	Refl::InitAttributeReflection();
+	Refl::InitClassReflection();
+
+	static constexpr int32_t k_num_entities = 100000;
+
+	Shibboleth::ECSManager ecs_mgr;
+
+	Shibboleth::ECSArchetype archetype;
+	REQUIRE(archetype.add<Shibboleth::Position>());
+	REQUIRE(archetype.add<Shibboleth::Rotation>());
+	REQUIRE(archetype.add<Shibboleth::Scale>());
+	REQUIRE(archetype.finalize());
+
+	const Gaff::Hash64 archetype_hash = archetype.getHash();
+
+	Shibboleth::ArchetypeReferencePtr arch_ref;
+	ecs_mgr.addArchetype(std::move(archetype), arch_ref);
+
+	Shibboleth::Vector<Shibboleth::EntityID> ids(static_cast<size_t>(k_num_entities));
+
+	BENCHMARK("createEntity/destroyEntity (100000 entities)")
+	{
+		for (Shibboleth::EntityID& id : ids) {
+			id = ecs_mgr.createEntity(archetype_hash);
+		}
+
+		for (Shibboleth::EntityID id : ids) {
+			ecs_mgr.destroyEntity(id);
+		}
+
+		return k_num_entities;
+	};
+
+	BENCHMARK("createEntities/destroyEntities (100000 entities)")
+	{
+		ecs_mgr.createEntities(archetype_hash, k_num_entities, ids.data());
+		ecs_mgr.destroyEntities(ids.data(), k_num_entities);
+		return k_num_entities;
+	};
+}
+
+TEST_CASE("shibboleth_ecs_archetype_transitions_benchmark", "[.][benchmark]")
+{
+	Refl::InitEnumReflection();
+	Refl::InitAttributeReflection();
+	Refl::InitClassReflection();
+
+	static constexpr int32_t k_num_toggles = 10000;
+
+	Shibboleth::ECSManager ecs_mgr;
+
+	Shibboleth::ECSArchetype archetype;
+	REQUIRE(archetype.add<Shibboleth::Position>());
+	REQUIRE(archetype.finalize());
+
+	const Gaff::Hash64 archetype_hash = archetype.getHash();
+
+	Shibboleth::ArchetypeReferencePtr arch_ref;
+	ecs_mgr.addArchetype(std::move(archetype), arch_ref);
+
+	// Keeps the Scale archetype from being removed between toggles.
+	Shibboleth::ArchetypeReferencePtr scale_arch_ref;
+	const Shibboleth::EntityID anchor_id = ecs_mgr.createEntity(archetype_hash);
+	ecs_mgr.addComponents<Shibboleth::Scale>(anchor_id, scale_arch_ref);
+
+	const Shibboleth::EntityID id = ecs_mgr.createEntity(archetype_hash);
+
+	BENCHMARK("add/remove component (10000 toggles)")
+	{
+		for (int32_t i = 0; i < k_num_toggles; ++i) {
+			ecs_mgr.addComponents<Shibboleth::Scale>(id);
+			ecs_mgr.removeComponents<Shibboleth::Scale>(id);
+		}
+
+		return k_num_toggles;
+	};
+}
+
+TEST_CASE("shibboleth_ecs_calculate_transforms_benchmark", "[.][benchmark]")
+{
+	Refl::InitEnumReflection();
+	Refl::InitAttributeReflection();
+	Refl::InitClassReflection();
+
+	static constexpr int32_t k_num_entities = 100000;
+
+	Shibboleth::ECSManager ecs_mgr;
+
+	Shibboleth::ECSArchetype archetype;
+	REQUIRE(archetype.add<Shibboleth::Position>());
+	REQUIRE(archetype.add<Shibboleth::Rotation>());
+	REQUIRE(archetype.add<Shibboleth::Scale>());
+	REQUIRE(archetype.finalize());
+
+	const Gaff::Hash64 archetype_hash = archetype.getHash();
+
+	Shibboleth::ArchetypeReferencePtr arch_ref;
+	ecs_mgr.addArchetype(std::move(archetype), arch_ref);
+
+	Shibboleth::Vector<Shibboleth::EntityID> ids(static_cast<size_t>(k_num_entities));
+	ecs_mgr.createEntities(archetype_hash, k_num_entities, ids.data());
+
+	for (int32_t i = 0; i < k_num_entities; ++i) {
+		const float value = static_cast<float>(i % 360) / 360.0f;
+
+		Shibboleth::Position::Set(ecs_mgr, ids[i], Shibboleth::Position(Gleam::Vec3(value * 100.0f, 0.0f, value * -100.0f)));
+		Shibboleth::Rotation::Set(ecs_mgr, ids[i], Shibboleth::Rotation(Gleam::Vec3(value, value * 0.5f, 0.0f)));
+	}
+
+	Shibboleth::Vector<Shibboleth::ECSQueryResult> position_output;
+	Shibboleth::Vector<Shibboleth::ECSQueryResult> rotation_output;
+	Shibboleth::Vector<Shibboleth::ECSQueryResult> scale_output;
+	Shibboleth::ECSQuery query;
+
+	query.add<Shibboleth::Position>(position_output);
+	query.add<Shibboleth::Rotation>(rotation_output);
+	query.add<Shibboleth::Scale>(scale_output);
+
+	ecs_mgr.registerQuery(std::move(query));
+
+	const Gleam::Mat4x4 pre_transform = glm::perspectiveFovLH(1.5f, 1280.0f, 720.0f, 0.1f, 1000.0f);
+	const Gleam::Vec3 local_offset(0.0f, -0.5f, 0.0f);
+
+	Shibboleth::Vector<Gleam::Mat4x4> transforms(static_cast<size_t>(k_num_entities));
+
+	// Reported as matrices per run. Divide by the mean time to get matrices/sec.
+	BENCHMARK("scalar transforms (100000 matrices)")
+	{
+		int32_t object_index = 0;
+
+		ecs_mgr.iterate<Shibboleth::Position, Shibboleth::Rotation, Shibboleth::Scale>(
+			position_output[0], rotation_output[0], scale_output[0],
+			[&](Shibboleth::EntityID, const Shibboleth::Position& position, const Shibboleth::Rotation& rotation, const Shibboleth::Scale& scale) -> void
+			{
+				transforms[object_index++] = CalculateTransformScalar(position, rotation, scale, pre_transform, local_offset);
+			}
+		);
+
+		return transforms[0][0][0];
+	};
+
+	BENCHMARK("SIMD block transforms (100000 matrices)")
+	{
+		CalculateTransformsBatch(ecs_mgr, position_output[0], rotation_output[0], scale_output[0], pre_transform, local_offset, transforms.data());
+		return transforms[0][0][0];
+	};
+}
@@ -0,0 +1,213 @@
+/************************************************************************************
+Copyright (C) 2022 by Nicholas LaCroix
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+************************************************************************************/
+
+#include <Shibboleth_LooseFileSystem.h>
+#include <Shibboleth_Vector.h>
+#include <Gaff_IncludeEASTLAtomic.h>
+#include <catch_amalgamated.hpp>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+static constexpr const char8_t* const k_loose_fs_test_dir = u8"loose_fs_test";
+static constexpr int32_t k_num_files = 10000;
+
+static Shibboleth::U8String GetTestFileName(int32_t index)
+{
+	Shibboleth::U8String name;
+	name.append_sprintf(u8"%s/file_%i.txt", k_loose_fs_test_dir, index);
+
+	return name;
+}
+
+static Shibboleth::U8String GetTestFileContents(int32_t index)
+{
+	Shibboleth::U8String contents;
+	contents.append_sprintf(u8"Contents of file %i.", index);
+
+	return contents;
+}
+
+static void CreateTestFiles(int32_t num_files)
+{
+	std::filesystem::remove_all(k_loose_fs_test_dir);
+	std::filesystem::create_directories(k_loose_fs_test_dir);
+
+	for (int32_t i = 0; i < num_files; ++i) {
+		const Shibboleth::U8String contents = GetTestFileContents(i);
+		std::ofstream file(reinterpret_cast<const char*>(GetTestFileName(i).data()), std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+
+		file.write(reinterpret_cast<const char*>(contents.data()), static_cast<std::streamsize>(contents.size()));
+	}
+}
+
+static bool CheckTestFile(const Shibboleth::IFile* file, int32_t index)
+{
+	const Shibboleth::U8String contents = GetTestFileContents(index);
+
+	return file &&
+		file->size() == contents.size() &&
+		!memcmp(file->getBuffer(), contents.data(), contents.size()) &&
+		file->getBuffer()[file->size()] == 0;
+}
+
+TEST_CASE("shibboleth_loose_file_system_open_close")
+{
+	CreateTestFiles(2);
+
+	Shibboleth::LooseFileSystem fs;
+
+	const Shibboleth::U8String name_0 = GetTestFileName(0);
+	const Shibboleth::U8String name_1 = GetTestFileName(1);
+
+	Shibboleth::IFile* const file_0 = fs.openFile(name_0.data());
+	Shibboleth::IFile* const file_1 = fs.openFile(name_1.data());
+
+	REQUIRE(CheckTestFile(file_0, 0));
+	REQUIRE(CheckTestFile(file_1, 1));
+	REQUIRE(file_0 != file_1);
+
+	// Opening an already open file shares it.
+	REQUIRE(fs.openFile(name_0.data()) == file_0);
+
+	REQUIRE(!fs.openFile(u8"loose_fs_test/missing.txt"));
+
+	fs.closeFile(file_0);
+	fs.closeFile(file_0);
+	fs.closeFile(file_1);
+
+	// Fully closed files are read again.
+	Shibboleth::IFile* const file_0_again = fs.openFile(name_0.data());
+	REQUIRE(CheckTestFile(file_0_again, 0));
+	fs.closeFile(file_0_again);
+
+	std::filesystem::remove_all(k_loose_fs_test_dir);
+}
+
+TEST_CASE("shibboleth_loose_file_system_stress")
+{
+	CreateTestFiles(k_num_files);
+
+	Shibboleth::Vector<Shibboleth::U8String> names;
+
+	for (int32_t i = 0; i < k_num_files; ++i) {
+		names.emplace_back(GetTestFileName(i));
+	}
+
+	const int32_t num_threads = eastl::max(static_cast<int32_t>(std::thread::hardware_concurrency()), 4);
+
+	Shibboleth::LooseFileSystem fs;
+	eastl::atomic<int32_t> failures = 0;
+	Shibboleth::Vector<std::thread> threads;
+
+	// Every thread opens every file, starting at a different offset, so the same files are opened and closed concurrently.
+	for (int32_t i = 0; i < num_threads; ++i) {
+		threads.emplace_back([&, i]() -> void
+		{
+			const int32_t start = (k_num_files / num_threads) * i;
+			Shibboleth::Vector<Shibboleth::IFile*> files(k_num_files, nullptr);
+
+			for (int32_t j = 0; j < k_num_files; ++j) {
+				const int32_t index = (start + j) % k_num_files;
+				files[index] = fs.openFile(names[index].data());
+
+				if (!CheckTestFile(files[index], index)) {
+					++failures;
+				}
+			}
+
+			for (int32_t j = 0; j < k_num_files; ++j) {
+				if (files[j]) {
+					fs.closeFile(files[j]);
+				}
+			}
+		});
+	}
+
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+
+	REQUIRE(failures == 0);
+
+	// Everything was closed, so files are read fresh.
+	Shibboleth::IFile* const file = fs.openFile(names[0].data());
+	REQUIRE(CheckTestFile(file, 0));
+	fs.closeFile(file);
+
+	std::filesystem::remove_all(k_loose_fs_test_dir);
+}
+
+TEST_CASE("shibboleth_loose_file_system_open_async")
+{
+	CreateTestFiles(k_num_files);
+
+	Shibboleth::Vector<Shibboleth::U8String> names;
+
+	for (int32_t i = 0; i < k_num_files; ++i) {
+		names.emplace_back(GetTestFileName(i));
+	}
+
+	// No job pool, so this is io_uring on Linux and opening on this thread everywhere else.
+	Shibboleth::LooseFileSystem fs;
+	Shibboleth::Vector<Shibboleth::IFile*> files(k_num_files, nullptr);
+	eastl::atomic<int32_t> remaining = k_num_files + 1;
+	bool missing_failed = false;
+
+	// All of these are queued before any of them are waited on.
+	for (int32_t i = 0; i < k_num_files; ++i) {
+		fs.openFileAsync(names[i].data(), [&files, &remaining, i](Shibboleth::IFile* file) -> void
+		{
+			files[i] = file;
+			--remaining;
+		});
+	}
+
+	fs.openFileAsync(u8"loose_fs_test/missing.txt", [&missing_failed, &remaining](Shibboleth::IFile* file) -> void
+	{
+		missing_failed = !file;
+		--remaining;
+	});
+
+	while (remaining > 0) {
+		std::this_thread::yield();
+	}
+
+	REQUIRE(missing_failed);
+
+	for (int32_t i = 0; i < k_num_files; ++i) {
+		REQUIRE(CheckTestFile(files[i], i));
+	}
+
+	// Already open files complete right away and share the open file.
+	Shibboleth::IFile* shared_file = nullptr;
+	fs.openFileAsync(names[0].data(), [&shared_file](Shibboleth::IFile* file) -> void { shared_file = file; });
+
+	REQUIRE(shared_file == files[0]);
+	fs.closeFile(shared_file);
+
+	for (Shibboleth::IFile* file : files) {
+		fs.closeFile(file);
+	}
+
+	std::filesystem::remove_all(k_loose_fs_test_dir);
+}
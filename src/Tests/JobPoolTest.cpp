@@ -0,0 +1,260 @@
+/************************************************************************************
+Copyright (C) 2022 by Nicholas LaCroix
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+************************************************************************************/
+
+#include <Shibboleth_HashString.h>
+#include <Shibboleth_VectorMap.h>
+#include <Shibboleth_Vector.h>
+#include <Shibboleth_JobPool.h>
+#include <catch_amalgamated.hpp>
+#include <thread>
+
+static constexpr int32_t k_num_jobs = 4096;
+static constexpr int32_t k_num_fan_out_jobs = 64;
+
+static void IncrementJob(uintptr_t /*thread_id_int*/, void* data)
+{
+	++(*reinterpret_cast<Gaff::Counter*>(data));
+}
+
+struct FanOutData final
+{
+	Shibboleth::JobPool* job_pool;
+	Gaff::Counter* counter;
+	const Gaff::JobData* children;
+	int32_t num_children;
+};
+
+static void FanOutJob(uintptr_t /*thread_id_int*/, void* data)
+{
+	FanOutData& fan_out_data = *reinterpret_cast<FanOutData*>(data);
+	fan_out_data.job_pool->addJobs(fan_out_data.children, fan_out_data.num_children, *fan_out_data.counter);
+}
+
+static int32_t RunFlatJobs(Shibboleth::JobPool& job_pool, Shibboleth::Vector<Gaff::JobData>& jobs, Gaff::Counter& job_count)
+{
+	Gaff::Counter counter = 0;
+	job_count = 0;
+
+	job_pool.addJobs(jobs.data(), static_cast<int32_t>(jobs.size()), counter);
+	job_pool.helpWhileWaiting(counter);
+
+	return job_count;
+}
+
+static int32_t RunFanOutJobs(
+	Shibboleth::JobPool& job_pool,
+	Shibboleth::Vector<Gaff::JobData>& roots,
+	Gaff::Counter& counter,
+	Gaff::Counter& job_count)
+{
+	counter = 0;
+	job_count = 0;
+
+	job_pool.addJobs(roots.data(), static_cast<int32_t>(roots.size()), counter);
+	job_pool.helpWhileWaiting(counter);
+
+	return job_count;
+}
+
+static void JobPoolThroughputHelper(bool work_stealing)
+{
+	Shibboleth::JobPool job_pool(Shibboleth::ProxyAllocator("JobPoolTest"));
+	REQUIRE(job_pool.init(static_cast<int32_t>(Gaff::GetNumberOfCores()), nullptr, nullptr, work_stealing));
+	REQUIRE(job_pool.isWorkStealing() == work_stealing);
+
+	job_pool.run();
+
+	Gaff::Counter job_count = 0;
+	Gaff::Counter fan_out_counter = 0;
+
+	Shibboleth::Vector<Gaff::JobData> jobs(k_num_jobs, Gaff::JobData{ IncrementJob, &job_count });
+	Shibboleth::Vector<Gaff::JobData> children(k_num_fan_out_jobs, Gaff::JobData{ IncrementJob, &job_count });
+
+	FanOutData fan_out_data = { &job_pool, &fan_out_counter, children.data(), k_num_fan_out_jobs };
+	Shibboleth::Vector<Gaff::JobData> roots(k_num_jobs / k_num_fan_out_jobs, Gaff::JobData{ FanOutJob, &fan_out_data });
+
+	// Sanity check before timing anything.
+	REQUIRE(RunFlatJobs(job_pool, jobs, job_count) == k_num_jobs);
+	REQUIRE(RunFanOutJobs(job_pool, roots, fan_out_counter, job_count) == k_num_jobs);
+
+	BENCHMARK(work_stealing ? "Enqueue/Dequeue (Work Stealing)" : "Enqueue/Dequeue (Shared Queue)")
+	{
+		return RunFlatJobs(job_pool, jobs, job_count);
+	};
+
+	BENCHMARK(work_stealing ? "Nested Fan Out (Work Stealing)" : "Nested Fan Out (Shared Queue)")
+	{
+		return RunFanOutJobs(job_pool, roots, fan_out_counter, job_count);
+	};
+
+	job_pool.destroy();
+}
+
+TEST_CASE("shibboleth_job_pool_work_stealing")
+{
+	Shibboleth::JobPool job_pool(Shibboleth::ProxyAllocator("JobPoolTest"));
+	REQUIRE(job_pool.init(static_cast<int32_t>(Gaff::GetNumberOfCores()), nullptr, nullptr, true));
+
+	job_pool.run();
+
+	Gaff::Counter job_count = 0;
+	Gaff::Counter fan_out_counter = 0;
+
+	Shibboleth::Vector<Gaff::JobData> children(k_num_fan_out_jobs, Gaff::JobData{ IncrementJob, &job_count });
+
+	FanOutData fan_out_data = { &job_pool, &fan_out_counter, children.data(), k_num_fan_out_jobs };
+	Shibboleth::Vector<Gaff::JobData> roots(k_num_jobs / k_num_fan_out_jobs, Gaff::JobData{ FanOutJob, &fan_out_data });
+
+	REQUIRE(RunFanOutJobs(job_pool, roots, fan_out_counter, job_count) == k_num_jobs);
+	REQUIRE(fan_out_counter == 0);
+
+	job_pool.destroy();
+}
+
+TEST_CASE("shibboleth_job_pool_help_until")
+{
+	Shibboleth::JobPool job_pool(Shibboleth::ProxyAllocator("JobPoolTest"));
+	REQUIRE(job_pool.init(static_cast<int32_t>(Gaff::GetNumberOfCores())));
+
+	job_pool.run();
+
+	Gaff::Counter job_count = 0;
+	Gaff::Counter counter = 0;
+
+	Shibboleth::Vector<Gaff::JobData> jobs(k_num_fan_out_jobs, Gaff::JobData{ IncrementJob, &job_count });
+
+	// Main thread jobs only get run by the main thread, so helpUntil() has to pick them up itself.
+	job_pool.addMainThreadJobs(jobs.data(), k_num_fan_out_jobs, counter);
+	job_pool.addJobs(jobs.data(), k_num_fan_out_jobs, counter);
+	job_pool.helpUntil(job_pool.getMainThreadID(), [&counter]() -> bool { return counter <= 0; });
+
+	REQUIRE(job_count == k_num_fan_out_jobs * 2);
+
+	job_count = 0;
+	job_pool.addJobs(jobs.data(), k_num_fan_out_jobs, counter);
+	job_pool.waitForCounter(counter);
+
+	REQUIRE(job_count == k_num_fan_out_jobs);
+
+	job_pool.destroy();
+}
+
+TEST_CASE("shibboleth_job_pool_multiple_waiters")
+{
+	static constexpr int32_t k_num_waiters = 4;
+
+	Shibboleth::JobPool job_pool(Shibboleth::ProxyAllocator("JobPoolTest"));
+	REQUIRE(job_pool.init(static_cast<int32_t>(Gaff::GetNumberOfCores())));
+
+	job_pool.run();
+
+	Gaff::Counter job_counts[k_num_waiters];
+	Gaff::Counter counters[k_num_waiters];
+	std::thread threads[k_num_waiters];
+
+	// Finishing a counter only wakes one waiter. The others have to get it passed along if it wasn't for them.
+	for (int32_t i = 0; i < k_num_waiters; ++i) {
+		job_counts[i] = 0;
+		counters[i] = 0;
+
+		threads[i] = std::thread([&job_pool, &job_counts, &counters, i](void) -> void
+		{
+			Shibboleth::Vector<Gaff::JobData> jobs(k_num_fan_out_jobs * (i + 1), Gaff::JobData{ IncrementJob, &job_counts[i] });
+
+			job_pool.addJobs(jobs.data(), static_cast<int32_t>(jobs.size()), counters[i]);
+			job_pool.waitForCounter(counters[i]);
+		});
+	}
+
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+
+	for (int32_t i = 0; i < k_num_waiters; ++i) {
+		REQUIRE(counters[i] == 0);
+		REQUIRE(job_counts[i] == k_num_fan_out_jobs * (i + 1));
+	}
+
+	job_pool.waitForAllJobsToFinish(job_pool.getMainThreadID());
+	job_pool.destroy();
+}
+
+TEST_CASE("shibboleth_job_pool_stats")
+{
+	Shibboleth::JobPool job_pool(Shibboleth::ProxyAllocator("JobPoolTest"));
+	REQUIRE(job_pool.init(static_cast<int32_t>(Gaff::GetNumberOfCores())));
+
+	job_pool.addPool(Shibboleth::HashStringView32<>(u8"Test Pool"));
+
+	// Paused, so nothing gets picked up before we look at the queues.
+	Gaff::Counter job_count = 0;
+	Gaff::Counter counter = 0;
+
+	Shibboleth::Vector<Gaff::JobData> jobs(k_num_fan_out_jobs, Gaff::JobData{ IncrementJob, &job_count });
+	job_pool.addJobs(jobs.data(), k_num_fan_out_jobs, counter, Gaff::FNV1aHash32String(u8"Test Pool"));
+
+	Shibboleth::Vector<Gaff::JobQueueStats> stats(Shibboleth::ProxyAllocator("JobPoolTest"));
+	job_pool.getStats(stats);
+
+	const auto find_pool = [&stats](const char8_t* name) -> const Gaff::JobQueueStats*
+	{
+		for (const Gaff::JobQueueStats& queue_stats : stats) {
+			if (!strcmp(reinterpret_cast<const char*>(queue_stats.name), reinterpret_cast<const char*>(name))) {
+				return &queue_stats;
+			}
+		}
+
+		return nullptr;
+	};
+
+	const Gaff::JobQueueStats* test_pool = find_pool(u8"Test Pool");
+	REQUIRE(test_pool);
+	REQUIRE(test_pool->queue_depth == k_num_fan_out_jobs);
+	REQUIRE(test_pool->num_jobs_started == 0);
+
+	job_pool.run();
+	job_pool.helpWhileWaiting(counter);
+
+	job_pool.getStats(stats);
+	test_pool = find_pool(u8"Test Pool");
+
+	REQUIRE(job_count == k_num_fan_out_jobs);
+	REQUIRE(test_pool->queue_depth == 0);
+	REQUIRE(test_pool->peak_queue_depth == k_num_fan_out_jobs);
+	REQUIRE(test_pool->num_jobs_started == static_cast<uint64_t>(k_num_fan_out_jobs));
+	REQUIRE(test_pool->max_latency_ns <= test_pool->total_latency_ns);
+
+	job_pool.resetStats();
+	job_pool.getStats(stats);
+	test_pool = find_pool(u8"Test Pool");
+
+	REQUIRE(test_pool->peak_queue_depth == 0);
+	REQUIRE(test_pool->num_jobs_started == 0);
+
+	job_pool.destroy();
+}
+
+TEST_CASE("shibboleth_job_pool_throughput", "[.][benchmark]")
+{
+	JobPoolThroughputHelper(false);
+	JobPoolThroughputHelper(true);
+}
@@ -0,0 +1,185 @@
+/************************************************************************************
+Copyright (C) 2022 by Nicholas LaCroix
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+************************************************************************************/
+
+#include <Shibboleth_LogManager.h>
+#include <Gaff_IncludeEASTLAtomic.h>
+#include <Gaff_Utils.h>
+#include <catch_amalgamated.hpp>
+#include <EASTL/string.h>
+#include <EASTL/vector.h>
+#include <chrono>
+#include <thread>
+
+static constexpr const char8_t* const k_log_test_dir = u8"./logs_test";
+static constexpr int32_t k_num_messages_per_thread = 2000;
+static constexpr int32_t k_benchmark_num_messages = 20000;
+
+static void LogFromThreads(Shibboleth::LogManager& log_mgr, int32_t num_threads, int32_t num_messages_per_thread)
+{
+	eastl::vector<std::thread> threads;
+
+	for (int32_t i = 0; i < num_threads; ++i) {
+		threads.emplace_back([&log_mgr, i, num_messages_per_thread]() -> void
+		{
+			for (int32_t j = 0; j < num_messages_per_thread; ++j) {
+				log_mgr.logMessage(Shibboleth::LogType::Info, Shibboleth::k_log_channel_default, u8"Thread %i message %i", i, j);
+			}
+		});
+	}
+
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+}
+
+static void WaitForMessages(const eastl::atomic<int32_t>& count, int32_t expected)
+{
+	while (count < expected) {
+		std::this_thread::yield();
+	}
+}
+
+TEST_CASE("shibboleth_log_manager_multiple_producers")
+{
+	REQUIRE(Gaff::CreateDir(k_log_test_dir, 0777));
+
+	Shibboleth::LogManager log_mgr;
+	REQUIRE(log_mgr.init(k_log_test_dir));
+
+	eastl::atomic<int32_t> num_messages = 0;
+	eastl::atomic<int32_t> num_long_messages = 0;
+
+	log_mgr.addLogCallback([&](const char8_t* message, Shibboleth::LogType) -> void
+	{
+		if (eastl::CharStrlen(message) > 1000) {
+			++num_long_messages;
+		}
+
+		++num_messages;
+	});
+
+	constexpr int32_t k_num_threads = 4;
+	LogFromThreads(log_mgr, k_num_threads, k_num_messages_per_thread);
+
+	// Messages too big for a queue slot take a separate allocation.
+	const eastl::u8string long_string(2000, u8'a');
+	log_mgr.logMessage(Shibboleth::LogType::Info, Shibboleth::k_log_channel_default, u8"%s", long_string.data());
+
+	// Everything queued before destroy() is still written.
+	log_mgr.destroy();
+
+	REQUIRE(num_messages == k_num_threads * k_num_messages_per_thread + 1);
+	REQUIRE(num_long_messages == 1);
+}
+
+TEST_CASE("shibboleth_log_manager_channel_levels")
+{
+	REQUIRE(Gaff::CreateDir(k_log_test_dir, 0777));
+
+	static constexpr const char8_t* const k_test_channel_name = u8"LevelTest";
+	static constexpr Gaff::Hash32 k_test_channel = Gaff::FNV1aHash32StringConst(k_test_channel_name);
+
+	Shibboleth::LogManager log_mgr;
+	REQUIRE(log_mgr.init(k_log_test_dir));
+
+	// Levels can be set before the channel exists.
+	log_mgr.setChannelLogLevel(k_test_channel, Shibboleth::LogType::Warning);
+	log_mgr.addChannel(Shibboleth::HashStringView32<>(k_test_channel_name));
+
+	REQUIRE(log_mgr.getChannelLogLevel(k_test_channel) == Shibboleth::LogType::Warning);
+	REQUIRE(!log_mgr.isLogEnabled(Shibboleth::LogType::Info, k_test_channel));
+	REQUIRE(log_mgr.isLogEnabled(Shibboleth::LogType::Error, k_test_channel));
+
+	eastl::atomic<int32_t> num_filtered_messages = 0;
+	eastl::atomic<int32_t> num_messages = 0;
+
+	log_mgr.addLogCallback([&](const char8_t*, Shibboleth::LogType type) -> void
+	{
+		if (type < Shibboleth::LogType::Warning) {
+			++num_filtered_messages;
+		}
+
+		++num_messages;
+	});
+
+	log_mgr.logMessage(Shibboleth::LogType::Debug, k_test_channel, u8"Filtered");
+	log_mgr.logMessage(Shibboleth::LogType::Info, k_test_channel, u8"Filtered");
+	log_mgr.logMessage(Shibboleth::LogType::Warning, k_test_channel, u8"Logged");
+	log_mgr.logMessage(Shibboleth::LogType::Error, k_test_channel, u8"Logged");
+
+	WaitForMessages(num_messages, 2);
+
+	log_mgr.setChannelLogLevel(k_test_channel, Shibboleth::LogType::Error);
+	log_mgr.logMessage(Shibboleth::LogType::Warning, k_test_channel, u8"Filtered");
+	log_mgr.logMessage(Shibboleth::LogType::Error, k_test_channel, u8"Logged");
+
+	log_mgr.destroy();
+
+	REQUIRE(num_filtered_messages == 0);
+	REQUIRE(num_messages == 3);
+}
+
+TEST_CASE("shibboleth_log_manager_benchmark", "[.][benchmark]")
+{
+	REQUIRE(Gaff::CreateDir(k_log_test_dir, 0777));
+
+	const int32_t max_threads = eastl::max(static_cast<int32_t>(std::thread::hardware_concurrency()), 1);
+
+	for (int32_t num_threads = 1; num_threads <= max_threads; num_threads *= 2) {
+		Shibboleth::LogManager log_mgr;
+		REQUIRE(log_mgr.init(k_log_test_dir));
+
+		eastl::atomic<int32_t> num_messages = 0;
+		log_mgr.addLogCallback([&num_messages](const char8_t*, Shibboleth::LogType) -> void { ++num_messages; });
+
+		const int32_t messages_per_thread = k_benchmark_num_messages / num_threads;
+		const int32_t total_messages = messages_per_thread * num_threads;
+
+		// Time until the log thread has processed everything, not just until producers return.
+		const auto start = std::chrono::steady_clock::now();
+		LogFromThreads(log_mgr, num_threads, messages_per_thread);
+		WaitForMessages(num_messages, total_messages);
+		const auto end = std::chrono::steady_clock::now();
+
+		const double seconds = std::chrono::duration<double>(end - start).count();
+
+		WARN(
+			num_threads << " producer(s): " <<
+			static_cast<int64_t>(static_cast<double>(total_messages) / seconds) << " messages/sec"
+		);
+
+		const std::string name = std::to_string(num_threads) + " Producer(s), " + std::to_string(total_messages) + " Messages";
+		int32_t expected = total_messages;
+
+		BENCHMARK(name.c_str())
+		{
+			LogFromThreads(log_mgr, num_threads, messages_per_thread);
+
+			expected += total_messages;
+			WaitForMessages(num_messages, expected);
+
+			return expected;
+		};
+
+		log_mgr.destroy();
+	}
+}
@@ -0,0 +1,178 @@
+/************************************************************************************
+Copyright (C) 2022 by Nicholas LaCroix
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+************************************************************************************/
+
+#include <Shibboleth_MainLoopAttributes.h>
+#include <Shibboleth_SystemGraph.h>
+#include <catch_amalgamated.hpp>
+
+using Access = Shibboleth::SystemAccessAttribute::Access;
+
+static const Shibboleth::SystemAccessAttribute g_read_position(Gaff::Hash64(1), Access::Read);
+static const Shibboleth::SystemAccessAttribute g_write_position(Gaff::Hash64(1), Access::Write);
+static const Shibboleth::SystemAccessAttribute g_read_rotation(Gaff::Hash64(2), Access::Read);
+static const Shibboleth::SystemAccessAttribute g_write_rotation(Gaff::Hash64(2), Access::Write);
+
+static Shibboleth::SystemGraphNode& AddSystem(
+	Shibboleth::Vector<Shibboleth::SystemGraphNode>& nodes,
+	int32_t row,
+	std::initializer_list<const Shibboleth::SystemAccessAttribute*> accesses = {})
+{
+	Shibboleth::SystemGraphNode& node = nodes.emplace_back();
+	node.row = row;
+
+	for (const Shibboleth::SystemAccessAttribute* access : accesses) {
+		node.accesses.emplace_back(access);
+	}
+
+	return node;
+}
+
+static bool DependsOn(const Shibboleth::Vector<Shibboleth::SystemGraphNode>& nodes, int32_t dependent, int32_t dependency)
+{
+	return eastl::find(nodes[dependency].dependents.begin(), nodes[dependency].dependents.end(), dependent) != nodes[dependency].dependents.end();
+}
+
+TEST_CASE("shibboleth_system_graph_read_read")
+{
+	Shibboleth::Vector<Shibboleth::SystemGraphNode> nodes;
+
+	AddSystem(nodes, 0, { &g_read_position });
+	AddSystem(nodes, 1, { &g_read_position, &g_read_rotation });
+	AddSystem(nodes, 2, { &g_read_position });
+
+	Shibboleth::BuildSystemGraph(nodes);
+
+	// Readers never wait on each other, even across rows.
+	for (const Shibboleth::SystemGraphNode& node : nodes) {
+		REQUIRE(node.num_dependencies == 0);
+		REQUIRE(node.dependents.empty());
+	}
+}
+
+TEST_CASE("shibboleth_system_graph_write")
+{
+	Shibboleth::Vector<Shibboleth::SystemGraphNode> nodes;
+
+	AddSystem(nodes, 0, { &g_write_position });
+	AddSystem(nodes, 1, { &g_read_position });
+	AddSystem(nodes, 1, { &g_read_rotation });
+	AddSystem(nodes, 2, { &g_write_position, &g_write_rotation });
+
+	Shibboleth::BuildSystemGraph(nodes);
+
+	// The reader waits on the writer before it. The rotation reader doesn't touch position.
+	REQUIRE(DependsOn(nodes, 1, 0));
+	REQUIRE(nodes[2].num_dependencies == 0);
+
+	// The last writer waits on everything that touched what it writes.
+	REQUIRE(DependsOn(nodes, 3, 0));
+	REQUIRE(DependsOn(nodes, 3, 1));
+	REQUIRE(DependsOn(nodes, 3, 2));
+	REQUIRE(nodes[3].num_dependencies == 3);
+
+	// Writers in the same row were declared safe to run together.
+	Shibboleth::Vector<Shibboleth::SystemGraphNode> same_row;
+
+	AddSystem(same_row, 0, { &g_write_position });
+	AddSystem(same_row, 0, { &g_write_position });
+
+	Shibboleth::BuildSystemGraph(same_row);
+
+	REQUIRE(same_row[0].dependents.empty());
+	REQUIRE(same_row[1].num_dependencies == 0);
+}
+
+TEST_CASE("shibboleth_system_graph_unannotated")
+{
+	Shibboleth::Vector<Shibboleth::SystemGraphNode> nodes;
+
+	AddSystem(nodes, 0, { &g_read_position });
+	AddSystem(nodes, 1);
+	AddSystem(nodes, 2, { &g_read_rotation });
+	AddSystem(nodes, 2);
+
+	Shibboleth::BuildSystemGraph(nodes);
+
+	// A system without access attributes conflicts with everything in other rows, readers included.
+	REQUIRE(DependsOn(nodes, 1, 0));
+	REQUIRE(DependsOn(nodes, 2, 1));
+	REQUIRE(DependsOn(nodes, 3, 0));
+	REQUIRE(DependsOn(nodes, 3, 1));
+
+	// But never with its own row.
+	REQUIRE(!DependsOn(nodes, 3, 2));
+
+	REQUIRE(nodes[0].num_dependencies == 0);
+	REQUIRE(nodes[1].num_dependencies == 1);
+	REQUIRE(nodes[2].num_dependencies == 1);
+	REQUIRE(nodes[3].num_dependencies == 2);
+}
+
+TEST_CASE("shibboleth_system_graph_block_pipelining")
+{
+	// Steps three blocks the way MainLoop does, finishing every block that is allowed to run each tick.
+	int32_t frames[3] = { 0, 0, 0 };
+
+	const auto can_start = [&frames](int32_t index) -> bool
+	{
+		const int32_t prev_frame = (index > 0) ? frames[index - 1] : -1;
+		const int32_t next_frame = (index < 2) ? frames[index + 1] : -1;
+
+		return Shibboleth::CanStartBlock(frames[index], prev_frame, next_frame);
+	};
+
+	// Only the first block has anything to work on.
+	REQUIRE(can_start(0));
+	REQUIRE(!can_start(1));
+	REQUIRE(!can_start(2));
+
+	frames[0] = 1;
+
+	// The first block starts the next frame while the second works on the one it just finished.
+	REQUIRE(can_start(0));
+	REQUIRE(can_start(1));
+	REQUIRE(!can_start(2));
+
+	// The first block can't get two frames ahead of the second.
+	frames[0] = 2;
+	REQUIRE(!can_start(0));
+
+	frames[1] = 1;
+
+	// All three blocks are now working on different frames.
+	REQUIRE(can_start(0));
+	REQUIRE(can_start(1));
+	REQUIRE(can_start(2));
+
+	// Frames wrap. Block 0 on frame 0 is one ahead of block 1 on frame 2.
+	frames[0] = 0;
+	frames[1] = 2;
+	frames[2] = 1;
+
+	REQUIRE(can_start(0));
+	REQUIRE(can_start(1));
+	REQUIRE(can_start(2));
+
+	// The last block only waits on the one before it.
+	frames[2] = 2;
+	REQUIRE(!can_start(2));
+}
@@ -0,0 +1,301 @@
+/************************************************************************************
+Copyright (C) 2022 by Nicholas LaCroix
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+************************************************************************************/
+
+#include <Shibboleth_PackFileSystem.h>
+#include <Shibboleth_PackFileFormat.h>
+#include <Shibboleth_String.h>
+#include <Shibboleth_Vector.h>
+#include <Gaff_Hash.h>
+#include <catch_amalgamated.hpp>
+#include <filesystem>
+#include <fstream>
+#include <zstd.h>
+
+static constexpr const char8_t* const k_pack_test_file = u8"pack_fs_test.pack";
+
+// Shared by all compressed entries. Raw content dictionaries are used as is by zstd.
+static constexpr const char k_pack_test_dictionary[] = "Contents of a packed file. Contents of a compressed file.";
+
+struct TestPackEntry final
+{
+	const char8_t* name;
+	const char8_t* contents;
+	bool compressed;
+	const char8_t* hash_name = nullptr; // Use another entry's hash to force a collision. Only reachable through forEachFile().
+};
+
+static const TestPackEntry k_pack_test_entries[] =
+{
+	{ u8"dir/stored.txt", u8"Contents of a stored file.", false },
+	{ u8"dir/compressed.txt", u8"Contents of a compressed file. Contents of a compressed file. Contents of a compressed file.", true },
+	{ u8"dir/sub/nested.txt", u8"Contents of a packed file in a sub-directory.", true },
+	{ u8"dir/sub/nested.json", u8"{ \"contents\": \"Contents of a packed file.\" }", false },
+	{ u8"dir/collide_a.txt", u8"Contents of the file everyone collides with.", false },
+	{ u8"dir/a_decoy.txt", u8"Contents of a compressed file that collides.", true, u8"dir/collide_a.txt" },
+	{ u8"other.txt", u8"Contents of a file outside of the directory.", false }
+};
+
+static uint64_t GetNameHash(const char8_t* name)
+{
+	return Gaff::FNV1aHash64(reinterpret_cast<const char*>(name), eastl::CharStrlen(name)).getHash();
+}
+
+// Builds a pack the same way the packer does. The modifier can corrupt the table of contents before it is written.
+template <class Modifier>
+static void WriteTestPack(Modifier&& modifier)
+{
+	Shibboleth::Vector<const TestPackEntry*> sorted;
+
+	for (const TestPackEntry& entry : k_pack_test_entries) {
+		sorted.emplace_back(&entry);
+	}
+
+	eastl::sort(sorted.begin(), sorted.end(), [](const TestPackEntry* lhs, const TestPackEntry* rhs) -> bool
+	{
+		const uint64_t lhs_hash = GetNameHash(lhs->hash_name ? lhs->hash_name : lhs->name);
+		const uint64_t rhs_hash = GetNameHash(rhs->hash_name ? rhs->hash_name : rhs->name);
+
+		return (lhs_hash == rhs_hash) ? eastl::u8string_view(lhs->name) < eastl::u8string_view(rhs->name) : lhs_hash < rhs_hash;
+	});
+
+	Shibboleth::Vector<Shibboleth::PackEntry> entries(sorted.size());
+	Shibboleth::Vector<char8_t> names;
+	Shibboleth::Vector<int8_t> data;
+
+	ZSTD_CCtx* const context = ZSTD_createCCtx();
+
+	for (size_t i = 0; i < sorted.size(); ++i) {
+		const TestPackEntry& test_entry = *sorted[i];
+		const size_t size = eastl::CharStrlen(test_entry.contents);
+
+		Shibboleth::PackEntry& entry = entries[i];
+		entry.name_hash = GetNameHash(test_entry.hash_name ? test_entry.hash_name : test_entry.name);
+		entry.name_offset = static_cast<uint32_t>(names.size());
+		entry.offset = data.size();
+		entry.size = size;
+
+		names.insert(names.end(), test_entry.name, test_entry.name + eastl::CharStrlen(test_entry.name) + 1);
+
+		if (test_entry.compressed) {
+			Shibboleth::Vector<int8_t> compressed(ZSTD_compressBound(size));
+
+			const size_t compressed_size = ZSTD_compress_usingDict(
+				context,
+				compressed.data(), compressed.size(),
+				test_entry.contents, size,
+				k_pack_test_dictionary, sizeof(k_pack_test_dictionary) - 1,
+				ZSTD_CLEVEL_DEFAULT
+			);
+
+			REQUIRE(!ZSTD_isError(compressed_size));
+
+			entry.flags = static_cast<uint32_t>(Shibboleth::PackEntryFlag::Compressed);
+			entry.stored_size = compressed_size;
+			data.insert(data.end(), compressed.begin(), compressed.begin() + compressed_size);
+
+		} else {
+			entry.stored_size = size;
+			data.insert(data.end(), reinterpret_cast<const int8_t*>(test_entry.contents), reinterpret_cast<const int8_t*>(test_entry.contents) + size);
+			data.push_back(0);
+		}
+	}
+
+	ZSTD_freeCCtx(context);
+
+	Shibboleth::PackHeader header;
+	header.entry_count = static_cast<uint32_t>(entries.size());
+	header.names_offset = sizeof(Shibboleth::PackHeader) + sizeof(Shibboleth::PackEntry) * entries.size();
+	header.names_size = static_cast<uint32_t>(names.size());
+	header.dictionary_offset = header.names_offset + header.names_size;
+	header.dictionary_size = sizeof(k_pack_test_dictionary) - 1;
+
+	const uint64_t data_offset = header.dictionary_offset + header.dictionary_size;
+
+	for (Shibboleth::PackEntry& entry : entries) {
+		entry.offset += data_offset;
+	}
+
+	modifier(header, entries);
+
+	std::ofstream file(reinterpret_cast<const char*>(k_pack_test_file), std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(sizeof(Shibboleth::PackEntry) * entries.size()));
+	file.write(reinterpret_cast<const char*>(names.data()), static_cast<std::streamsize>(names.size()));
+	file.write(k_pack_test_dictionary, sizeof(k_pack_test_dictionary) - 1);
+	file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+}
+
+static void WriteTestPack(void)
+{
+	WriteTestPack([](Shibboleth::PackHeader&, Shibboleth::Vector<Shibboleth::PackEntry>&) -> void {});
+}
+
+static bool CheckTestFile(const Shibboleth::IFile* file, const TestPackEntry& entry)
+{
+	const size_t size = eastl::CharStrlen(entry.contents);
+
+	return file &&
+		file->size() == size &&
+		!memcmp(file->getBuffer(), entry.contents, size) &&
+		file->getBuffer()[file->size()] == 0;
+}
+
+TEST_CASE("shibboleth_pack_file_system_open_close")
+{
+	WriteTestPack();
+
+	Shibboleth::PackFileSystem fs;
+	REQUIRE(fs.init(k_pack_test_file));
+
+	for (const TestPackEntry& entry : k_pack_test_entries) {
+		if (entry.hash_name) {
+			continue;
+		}
+
+		Shibboleth::IFile* const file = fs.openFile(entry.name);
+		REQUIRE(CheckTestFile(file, entry));
+
+		// Opening an already open file shares it. Paths are normalized before lookup.
+		Shibboleth::U8String dot_name(u8"./");
+		dot_name += entry.name;
+
+		REQUIRE(fs.openFile(dot_name.data()) == file);
+
+		fs.closeFile(file);
+		fs.closeFile(file);
+
+		// Fully closed files are opened again.
+		Shibboleth::IFile* const file_again = fs.openFile(entry.name);
+		REQUIRE(CheckTestFile(file_again, entry));
+		fs.closeFile(file_again);
+	}
+
+	REQUIRE(!fs.openFile(u8"dir/missing.txt"));
+
+	// The decoy is filed under another name's hash, so looking it up by its own name fails.
+	REQUIRE(!fs.openFile(u8"dir/a_decoy.txt"));
+
+	std::filesystem::remove(k_pack_test_file);
+}
+
+TEST_CASE("shibboleth_pack_file_system_for_each_file")
+{
+	WriteTestPack();
+
+	Shibboleth::PackFileSystem fs;
+	REQUIRE(fs.init(k_pack_test_file));
+
+	Shibboleth::Vector<Shibboleth::U8String> names;
+
+	eastl::function<bool(const char8_t*, Shibboleth::IFile*)> callback = [&](const char8_t* name, Shibboleth::IFile* file) -> bool
+	{
+		const auto it = eastl::find_if(eastl::begin(k_pack_test_entries), eastl::end(k_pack_test_entries), [name](const TestPackEntry& entry) -> bool
+		{
+			return eastl::u8string_view(entry.name) == name;
+		});
+
+		REQUIRE(it != eastl::end(k_pack_test_entries));
+		REQUIRE(CheckTestFile(file, *it));
+
+		names.emplace_back(name);
+		fs.closeFile(file);
+
+		return false;
+	};
+
+	REQUIRE(!fs.forEachFile(u8"dir", callback, false));
+	REQUIRE(names.size() == 4);
+
+	names.clear();
+	REQUIRE(!fs.forEachFile(u8"./dir/", callback, true));
+	REQUIRE(names.size() == 6);
+
+	names.clear();
+	REQUIRE(!fs.forEachFile(u8"dir", callback, u8".json", true));
+	REQUIRE(names.size() == 1);
+	REQUIRE(names[0] == u8"dir/sub/nested.json");
+
+	names.clear();
+	REQUIRE(!fs.forEachFile(u8".", callback, true));
+	REQUIRE(names.size() == eastl::size(k_pack_test_entries));
+
+	// Returning true stops the walk.
+	int32_t count = 0;
+
+	eastl::function<bool(const char8_t*, Shibboleth::IFile*)> stop_callback = [&](const char8_t*, Shibboleth::IFile* file) -> bool
+	{
+		fs.closeFile(file);
+		return ++count == 2;
+	};
+
+	REQUIRE(fs.forEachFile(u8"dir", stop_callback, true));
+	REQUIRE(count == 2);
+
+	std::filesystem::remove(k_pack_test_file);
+}
+
+TEST_CASE("shibboleth_pack_file_system_bad_pack")
+{
+	// Each file system is scoped so the pack is unmapped before it is written again.
+	{
+		WriteTestPack([](Shibboleth::PackHeader& header, Shibboleth::Vector<Shibboleth::PackEntry>& entries) -> void
+		{
+			entries.back().name_offset = header.names_size;
+		});
+
+		Shibboleth::PackFileSystem fs;
+		REQUIRE(!fs.init(k_pack_test_file));
+	}
+
+	{
+		WriteTestPack([](Shibboleth::PackHeader&, Shibboleth::Vector<Shibboleth::PackEntry>& entries) -> void
+		{
+			// offset + stored_size wraps around to something small.
+			entries.front().offset = UINT64_MAX - 2;
+			entries.front().stored_size = 4;
+			entries.front().size = 4;
+		});
+
+		Shibboleth::PackFileSystem fs;
+		REQUIRE(!fs.init(k_pack_test_file));
+	}
+
+	{
+		WriteTestPack([](Shibboleth::PackHeader& header, Shibboleth::Vector<Shibboleth::PackEntry>&) -> void
+		{
+			header.names_offset = UINT64_MAX - 2;
+		});
+
+		Shibboleth::PackFileSystem fs;
+		REQUIRE(!fs.init(k_pack_test_file));
+	}
+
+	// Make sure the good pack still works after all of that.
+	{
+		WriteTestPack();
+
+		Shibboleth::PackFileSystem fs;
+		REQUIRE(fs.init(k_pack_test_file));
+	}
+
+	std::filesystem::remove(k_pack_test_file);
+}
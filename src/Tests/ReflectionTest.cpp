@@ -24,7 +24,9 @@ THE SOFTWARE.
 #include <Shibboleth_App.h>
 #include <Shibboleth_MessagePackSerializeWriter.h>
 #include <Shibboleth_JSONSerializeWriter.h>
+#include <Shibboleth_EngineAttributesCommon.h>
 #include <Shibboleth_SerializeReader.h>
+#include <Shibboleth_BinarySerialize.h>
 #include <Gaff_DynamicModule.h>
 #include <catch_amalgamated.hpp>
 #include <filesystem>
@@ -650,6 +652,309 @@ SHIB_TEMPLATE_REFLECTION_DEFINE_END(SerializeTestTemplate, T, TT)
 
 
 
+class SerializeVarTest final
+{
+public:
+	int32_t a = 0;
+	float b = 0.0f;
+	int32_t c = 0;
+};
+
+SHIB_REFLECTION_DECLARE(SerializeVarTest)
+
+SHIB_REFLECTION_DEFINE_BEGIN(SerializeVarTest)
+	.var("a", &SerializeVarTest::a)
+	.var("b", &SerializeVarTest::b)
+	.var("c", &SerializeVarTest::c, Shibboleth::OptionalAttribute())
+SHIB_REFLECTION_DEFINE_END(SerializeVarTest)
+
+class SerializeEmptyTest final
+{
+};
+
+SHIB_REFLECTION_DECLARE(SerializeEmptyTest)
+
+SHIB_REFLECTION_DEFINE_BEGIN(SerializeEmptyTest)
+SHIB_REFLECTION_DEFINE_END(SerializeEmptyTest)
+
+TEST_CASE("reflection serialize vars test", "[shibboleth_serialize]")
+{
+	Refl::Reflection<SerializeVarTest>::Init();
+
+	const auto& ref_def = Refl::Reflection<SerializeVarTest>::GetReflectionDefinition();
+
+	// Round trip through MessagePack.
+	{
+		// MessagePack writes non-negative integers as unsigned, which don't read back as int32_t.
+		SerializeVarTest svt;
+		svt.a = -5;
+		svt.b = 2.5f;
+		svt.c = -7;
+
+		Shibboleth::MessagePackSerializeWriter mpack_writer;
+		char buffer[256] = { 0 };
+
+		REQUIRE(mpack_writer.init(buffer, sizeof(buffer)));
+		ref_def.save(mpack_writer, svt);
+		mpack_writer.finish();
+
+		Gaff::MessagePackReader reader;
+		REQUIRE(reader.parse(buffer, sizeof(buffer)));
+
+		SerializeVarTest result;
+		Shibboleth::SerializeReader<Gaff::MessagePackNode> mpack_reader(reader.getRoot());
+		REQUIRE(ref_def.load(mpack_reader, result));
+		REQUIRE(result.a == -5);
+		REQUIRE(result.b == 2.5f);
+		REQUIRE(result.c == -7);
+	}
+
+	// Keys are matched regardless of order, unknown keys are ignored and optional vars can be missing.
+	{
+		Gaff::JSON json;
+		REQUIRE(json.parse(u8"{ \"b\": 1.5, \"unknown\": 3, \"a\": 2 }"));
+
+		SerializeVarTest result;
+		Shibboleth::SerializeReader<Gaff::JSON> json_reader(json);
+		REQUIRE(ref_def.load(json_reader, result));
+		REQUIRE(result.a == 2);
+		REQUIRE(result.b == 1.5f);
+		REQUIRE(result.c == 0);
+	}
+
+	// Missing a required var fails.
+	{
+		Gaff::JSON json;
+		REQUIRE(json.parse(u8"{ \"a\": 2, \"c\": 3 }"));
+
+		SerializeVarTest result;
+		Shibboleth::SerializeReader<Gaff::JSON> json_reader(json);
+		REQUIRE(!ref_def.load(json_reader, result));
+	}
+
+	// Anything that isn't an object is missing every var. Types without required vars still load.
+	{
+		Refl::Reflection<SerializeEmptyTest>::Init();
+
+		Gaff::JSON json;
+		REQUIRE(json.parse(u8"5"));
+
+		SerializeVarTest result;
+		Shibboleth::SerializeReader<Gaff::JSON> json_reader(json);
+		REQUIRE(!ref_def.load(json_reader, result));
+
+		SerializeEmptyTest empty_result;
+		REQUIRE(Refl::Reflection<SerializeEmptyTest>::GetReflectionDefinition().load(json_reader, empty_result));
+	}
+}
+
+class SerializeStringTest final
+{
+public:
+	Shibboleth::U8String str;
+	Shibboleth::HashString32<> hash_str;
+};
+
+SHIB_REFLECTION_DECLARE(SerializeStringTest)
+
+SHIB_REFLECTION_DEFINE_BEGIN(SerializeStringTest)
+	.var("str", &SerializeStringTest::str)
+	.var("hash_str", &SerializeStringTest::hash_str)
+SHIB_REFLECTION_DEFINE_END(SerializeStringTest)
+
+TEST_CASE("reflection serialize string view test", "[shibboleth_serialize]")
+{
+	Refl::Reflection<Shibboleth::U8String>::Init();
+	Refl::Reflection< Shibboleth::HashString32<> >::Init();
+	Refl::Reflection<SerializeStringTest>::Init();
+
+	const auto& ref_def = Refl::Reflection<SerializeStringTest>::GetReflectionDefinition();
+
+	// MessagePack strings are not null terminated, so views must respect their size.
+	{
+		SerializeStringTest sst;
+		sst.str = u8"hello";
+		sst.hash_str = u8"world";
+
+		Shibboleth::MessagePackSerializeWriter mpack_writer;
+		char buffer[256] = { 0 };
+
+		REQUIRE(mpack_writer.init(buffer, sizeof(buffer)));
+		ref_def.save(mpack_writer, sst);
+		mpack_writer.finish();
+
+		Gaff::MessagePackReader reader;
+		REQUIRE(reader.parse(buffer, sizeof(buffer)));
+
+		Shibboleth::SerializeReader<Gaff::MessagePackNode> mpack_reader(reader.getRoot());
+
+		{
+			const auto guard = mpack_reader.enterElementGuard(u8"str");
+			REQUIRE(mpack_reader.readStringView() == u8"hello");
+		}
+
+		{
+			const auto guard = mpack_reader.enterElementGuard(u8"missing");
+			REQUIRE(mpack_reader.readStringView(u8"default") == u8"default");
+		}
+
+		SerializeStringTest result;
+		REQUIRE(ref_def.load(mpack_reader, result));
+		REQUIRE(result.str == u8"hello");
+		REQUIRE(result.hash_str == sst.hash_str);
+		REQUIRE(result.hash_str.getString() == u8"world");
+	}
+
+	{
+		Gaff::JSON json;
+		REQUIRE(json.parse(u8"{ \"str\": \"foo\", \"hash_str\": \"bar\" }"));
+
+		SerializeStringTest result;
+		Shibboleth::SerializeReader<Gaff::JSON> json_reader(json);
+		REQUIRE(ref_def.load(json_reader, result));
+		REQUIRE(result.str == u8"foo");
+		REQUIRE(result.hash_str.getHash() == Gaff::FNV1aHash32String(u8"bar"));
+	}
+}
+
+class SerializeBinaryTest final
+{
+public:
+	int32_t a = 0;
+	float b = 0.0f;
+	double c = 0.0;
+	Shibboleth::U8String str;
+	SerializeVarTest nested;
+};
+
+SHIB_REFLECTION_DECLARE(SerializeBinaryTest)
+
+SHIB_REFLECTION_DEFINE_BEGIN(SerializeBinaryTest)
+	.var("a", &SerializeBinaryTest::a)
+	.var("b", &SerializeBinaryTest::b)
+	.var("c", &SerializeBinaryTest::c, Shibboleth::OptionalAttribute())
+	.var("str", &SerializeBinaryTest::str)
+	.var("nested", &SerializeBinaryTest::nested)
+SHIB_REFLECTION_DEFINE_END(SerializeBinaryTest)
+
+static SerializeBinaryTest MakeSerializeBinaryTest(void)
+{
+	SerializeBinaryTest sbt;
+	sbt.a = -12;
+	sbt.b = 3.5f;
+	sbt.c = -0.25;
+	sbt.str = u8"binary";
+	sbt.nested.a = -1;
+	sbt.nested.b = 0.5f;
+	sbt.nested.c = -3;
+
+	return sbt;
+}
+
+static void CheckSerializeBinaryTest(const SerializeBinaryTest& sbt)
+{
+	REQUIRE(sbt.a == -12);
+	REQUIRE(sbt.b == 3.5f);
+	REQUIRE(sbt.c == -0.25);
+	REQUIRE(sbt.str == u8"binary");
+	REQUIRE(sbt.nested.a == -1);
+	REQUIRE(sbt.nested.b == 0.5f);
+	REQUIRE(sbt.nested.c == -3);
+}
+
+TEST_CASE("reflection binary serialize test", "[shibboleth_serialize]")
+{
+	Refl::Reflection<Shibboleth::U8String>::Init();
+	Refl::Reflection<SerializeVarTest>::Init();
+	Refl::Reflection<SerializeBinaryTest>::Init();
+
+	const auto& ref_def = Refl::Reflection<SerializeBinaryTest>::GetReflectionDefinition();
+	const SerializeBinaryTest sbt = MakeSerializeBinaryTest();
+
+	Shibboleth::BinarySerializeWriter writer;
+	Shibboleth::SaveBinaryFile(writer, ref_def, &sbt);
+
+	// Layout matches, so the copy block is loaded directly.
+	{
+		SerializeBinaryTest result;
+		REQUIRE(Shibboleth::LoadBinaryFile(writer.getBuffer(), writer.size(), ref_def, &result));
+		CheckSerializeBinaryTest(result);
+	}
+
+	// Layout doesn't match, so copied vars are matched up by name.
+	{
+		Shibboleth::Vector<uint8_t> buffer(writer.getBuffer(), writer.getBuffer() + writer.size());
+
+		Shibboleth::BinaryObjectHeader header;
+		memcpy(&header, buffer.data() + sizeof(Shibboleth::BinaryFileHeader), sizeof(header));
+		++header.layout_hash;
+		memcpy(buffer.data() + sizeof(Shibboleth::BinaryFileHeader), &header, sizeof(header));
+
+		SerializeBinaryTest result;
+		REQUIRE(Shibboleth::LoadBinaryFile(buffer.data(), buffer.size(), ref_def, &result));
+		CheckSerializeBinaryTest(result);
+	}
+
+	// Truncated data and the wrong type both fail.
+	{
+		SerializeBinaryTest result;
+		REQUIRE(!Shibboleth::LoadBinaryFile(writer.getBuffer(), writer.size() - 1, ref_def, &result));
+
+		SerializeVarTest svt;
+		REQUIRE(!Shibboleth::LoadBinaryFile(writer.getBuffer(), writer.size(), Refl::Reflection<SerializeVarTest>::GetReflectionDefinition(), &svt));
+	}
+}
+
+TEST_CASE("reflection binary load benchmark", "[.][benchmark]")
+{
+	Refl::Reflection<Shibboleth::U8String>::Init();
+	Refl::Reflection<SerializeVarTest>::Init();
+	Refl::Reflection<SerializeBinaryTest>::Init();
+
+	const auto& ref_def = Refl::Reflection<SerializeBinaryTest>::GetReflectionDefinition();
+	const SerializeBinaryTest sbt = MakeSerializeBinaryTest();
+
+	const char8_t* const json_string =
+		u8"{ \"a\": -12, \"b\": 3.5, \"c\": -0.25, \"str\": \"binary\", "
+		u8"\"nested\": { \"a\": -1, \"b\": 0.5, \"c\": -3 } }";
+
+	Shibboleth::MessagePackSerializeWriter mpack_writer;
+	char mpack_buffer[256] = { 0 };
+
+	REQUIRE(mpack_writer.init(mpack_buffer, sizeof(mpack_buffer)));
+	ref_def.save(mpack_writer, sbt);
+	mpack_writer.finish();
+
+	Shibboleth::BinarySerializeWriter binary_writer;
+	Shibboleth::SaveBinaryFile(binary_writer, ref_def, &sbt);
+
+	BENCHMARK("json")
+	{
+		Gaff::JSON json;
+		json.parse(json_string);
+
+		SerializeBinaryTest result;
+		Shibboleth::SerializeReader<Gaff::JSON> json_reader(json);
+		return ref_def.load(json_reader, result);
+	};
+
+	BENCHMARK("messagepack")
+	{
+		Gaff::MessagePackReader reader;
+		reader.parse(mpack_buffer, mpack_writer.size());
+
+		SerializeBinaryTest result;
+		Shibboleth::SerializeReader<Gaff::MessagePackNode> mpack_reader(reader.getRoot());
+		return ref_def.load(mpack_reader, result);
+	};
+
+	BENCHMARK("binary")
+	{
+		SerializeBinaryTest result;
+		return Shibboleth::LoadBinaryFile(binary_writer.getBuffer(), binary_writer.size(), ref_def, &result);
+	};
+}
+
 TEST_CASE("reflection serialize test", "[shibboleth_serialize]")
 {
 	Refl::Reflection< SerializeTestTemplate<int32_t, double> >::Init();
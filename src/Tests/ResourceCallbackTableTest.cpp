@@ -0,0 +1,187 @@
+/************************************************************************************
+Copyright (C) 2022 by Nicholas LaCroix
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+************************************************************************************/
+
+#include <Shibboleth_ResourceCallbackTable.h>
+#include <catch_amalgamated.hpp>
+
+namespace
+{
+	struct TestResource final
+	{
+		bool isPending(void) const { return pending; }
+
+		mutable Shibboleth::Vector<Gaff::Hash64> _callback_groups{ Shibboleth::ProxyAllocator("Resource") };
+		bool pending = true;
+	};
+
+	using TestTable = Shibboleth::ResourceCallbackTable<TestResource>;
+
+	void Finish(TestTable& table, TestResource& resource)
+	{
+		resource.pending = false;
+		table.finished(resource);
+	}
+
+	void Fire(TestTable& table)
+	{
+		table.collectReady();
+		table.fireCollected();
+	}
+}
+
+TEST_CASE("shibboleth_resource_callback_table_register_complete")
+{
+	TestResource resources[3];
+	resources[2].pending = false;
+
+	const Shibboleth::Vector<TestResource*> group{ &resources[0], &resources[1], &resources[2] };
+	Shibboleth::Vector<TestResource*> fired_with;
+	int32_t fired = 0;
+
+	TestTable table;
+
+	const Shibboleth::ResourceCallbackID id = table.add(group, [&](const Shibboleth::Vector<TestResource*>& res) -> void
+	{
+		fired_with = res;
+		++fired;
+	});
+
+	REQUIRE(id.cb_id != -1);
+	REQUIRE(table.getNumGroups() == 1);
+
+	// Only pending resources wait on the group.
+	REQUIRE(resources[0]._callback_groups.size() == 1);
+	REQUIRE(resources[1]._callback_groups.size() == 1);
+	REQUIRE(resources[2]._callback_groups.empty());
+
+	// The same resources share a group.
+	const Shibboleth::ResourceCallbackID id_shared = table.add(group, [&](const Shibboleth::Vector<TestResource*>&) -> void { ++fired; });
+
+	REQUIRE(id_shared.res_id == id.res_id);
+	REQUIRE(id_shared.cb_id != id.cb_id);
+	REQUIRE(table.getNumGroups() == 1);
+	REQUIRE(resources[0]._callback_groups.size() == 1);
+
+	Finish(table, resources[0]);
+	Fire(table);
+	REQUIRE(fired == 0);
+
+	Finish(table, resources[1]);
+	REQUIRE(fired == 0);
+
+	Fire(table);
+	REQUIRE(fired == 2);
+	REQUIRE(fired_with == group);
+	REQUIRE(table.getNumGroups() == 0);
+
+	// Groups only fire once.
+	Fire(table);
+	REQUIRE(fired == 2);
+
+	// Nothing left pending, so the caller is told to call the callback itself.
+	REQUIRE(table.add(group, [](const Shibboleth::Vector<TestResource*>&) -> void {}).cb_id == -1);
+	REQUIRE(table.getNumGroups() == 0);
+}
+
+TEST_CASE("shibboleth_resource_callback_table_cancel")
+{
+	TestResource resources[3];
+
+	const Shibboleth::Vector<TestResource*> group{ &resources[0], &resources[1], &resources[2] };
+	Shibboleth::Vector<TestResource*> fired_with;
+	int32_t fired = 0;
+
+	TestTable table;
+
+	table.add(group, [&](const Shibboleth::Vector<TestResource*>& res) -> void
+	{
+		fired_with = res;
+		++fired;
+	});
+
+	Finish(table, resources[0]);
+
+	// Cancelled loads count as done, and are taken out of the group before they are freed.
+	table.cancelled(resources[1]);
+	REQUIRE(resources[1]._callback_groups.empty());
+
+	Fire(table);
+	REQUIRE(fired == 0);
+
+	table.cancelled(resources[2]);
+
+	Fire(table);
+	REQUIRE(fired == 1);
+	REQUIRE(fired_with.size() == 1);
+	REQUIRE(fired_with[0] == &resources[0]);
+	REQUIRE(table.getNumGroups() == 0);
+}
+
+TEST_CASE("shibboleth_resource_callback_table_remove")
+{
+	TestResource resources[2];
+
+	const Shibboleth::Vector<TestResource*> group{ &resources[0], &resources[1] };
+	int32_t fired_removed = 0;
+	int32_t fired_kept = 0;
+
+	TestTable table;
+
+	const Shibboleth::ResourceCallbackID id_removed = table.add(group, [&](const Shibboleth::Vector<TestResource*>&) -> void { ++fired_removed; });
+	table.remove(id_removed);
+
+	// The emptied group is kept, so the pending resources still have something to count down.
+	REQUIRE(table.getNumGroups() == 1);
+	REQUIRE(resources[0]._callback_groups.size() == 1);
+
+	Finish(table, resources[0]);
+
+	// Adding the same resources again picks the group back up, with the right count.
+	table.add(group, [&](const Shibboleth::Vector<TestResource*>&) -> void { ++fired_kept; });
+	REQUIRE(table.getNumGroups() == 1);
+
+	Fire(table);
+	REQUIRE(fired_kept == 0);
+
+	Finish(table, resources[1]);
+	Fire(table);
+
+	REQUIRE(fired_removed == 0);
+	REQUIRE(fired_kept == 1);
+	REQUIRE(table.getNumGroups() == 0);
+
+	// A group with every callback removed goes away without firing once its resources finish.
+	TestResource more_resources[2];
+	const Shibboleth::Vector<TestResource*> other_group{ &more_resources[0], &more_resources[1] };
+
+	table.remove(table.add(other_group, [&](const Shibboleth::Vector<TestResource*>&) -> void { ++fired_removed; }));
+
+	Finish(table, more_resources[0]);
+	table.cancelled(more_resources[1]);
+	Fire(table);
+
+	REQUIRE(fired_removed == 0);
+	REQUIRE(table.getNumGroups() == 0);
+
+	// Removing something that isn't there is fine.
+	table.remove(id_removed);
+}
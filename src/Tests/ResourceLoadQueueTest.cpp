@@ -0,0 +1,181 @@
+/************************************************************************************
+Copyright (C) 2022 by Nicholas LaCroix
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+************************************************************************************/
+
+#include <Shibboleth_ResourceLoadQueue.h>
+#include <catch_amalgamated.hpp>
+#include <iterator>
+
+namespace
+{
+	struct TestResource final
+	{
+		int32_t _load_queue_index = -1;
+		int32_t id = 0;
+	};
+
+	using TestQueue = Shibboleth::ResourceLoadQueue<TestResource>;
+}
+
+TEST_CASE("shibboleth_resource_load_queue_ordering")
+{
+	TestResource resources[6];
+	TestQueue queue(static_cast<int32_t>(std::size(resources)));
+
+	for (int32_t i = 0; i < static_cast<int32_t>(std::size(resources)); ++i) {
+		resources[i].id = i;
+	}
+
+	queue.push(resources[0], 0);
+	queue.push(resources[1], 5);
+	queue.push(resources[2], 0);
+	queue.push(resources[3], 5);
+	queue.push(resources[4], -1);
+	queue.push(resources[5], 0);
+
+	REQUIRE(queue.getNumQueued() == 6);
+
+	// Highest priority first. Equal priorities in the order they were pushed.
+	const int32_t expected[] = { 1, 3, 0, 2, 5, 4 };
+
+	for (int32_t id : expected) {
+		TestResource* const resource = queue.startNext();
+
+		REQUIRE(resource);
+		REQUIRE(resource->id == id);
+		REQUIRE(queue.isInFlight(*resource));
+	}
+
+	REQUIRE(!queue.startNext());
+	REQUIRE(queue.getNumQueued() == 0);
+	REQUIRE(queue.getNumInFlight() == 6);
+
+	for (TestResource& resource : resources) {
+		REQUIRE(queue.finish(resource));
+		REQUIRE(!queue.finish(resource));
+		REQUIRE(resource._load_queue_index == -1);
+	}
+
+	REQUIRE(queue.getNumInFlight() == 0);
+}
+
+TEST_CASE("shibboleth_resource_load_queue_raise_priority")
+{
+	TestResource resources[5];
+	TestQueue queue(static_cast<int32_t>(std::size(resources)));
+
+	for (int32_t i = 0; i < static_cast<int32_t>(std::size(resources)); ++i) {
+		resources[i].id = i;
+		queue.push(resources[i], 0);
+	}
+
+	// Lowering or matching the current priority does nothing.
+	REQUIRE(!queue.raisePriority(resources[3], 0));
+	REQUIRE(!queue.raisePriority(resources[3], -5));
+
+	REQUIRE(queue.raisePriority(resources[3], 1));
+	REQUIRE(queue.raisePriority(resources[4], 2));
+	REQUIRE(queue.raisePriority(resources[2], 1));
+
+	// 2 and 3 tie, so the one pushed first wins.
+	const int32_t expected[] = { 4, 2, 3, 0, 1 };
+
+	for (int32_t id : expected) {
+		TestResource* const resource = queue.startNext();
+
+		REQUIRE(resource);
+		REQUIRE(resource->id == id);
+
+		// Too late once it has started.
+		REQUIRE(!queue.raisePriority(*resource, 10));
+	}
+}
+
+TEST_CASE("shibboleth_resource_load_queue_cancel")
+{
+	TestResource resources[64];
+	TestQueue queue(static_cast<int32_t>(std::size(resources)));
+
+	for (int32_t i = 0; i < static_cast<int32_t>(std::size(resources)); ++i) {
+		resources[i].id = i;
+		queue.push(resources[i], i % 7);
+	}
+
+	// Cancel every third load before it is started. They must never come out of the queue.
+	for (int32_t i = 0; i < static_cast<int32_t>(std::size(resources)); i += 3) {
+		REQUIRE(queue.remove(resources[i]));
+		REQUIRE(!queue.isQueued(resources[i]));
+		REQUIRE(!queue.remove(resources[i]));
+	}
+
+	int32_t last_priority = INT32_MAX;
+	int32_t last_id = -1;
+	int32_t count = 0;
+
+	while (TestResource* const resource = queue.startNext()) {
+		const int32_t priority = resource->id % 7;
+
+		REQUIRE(resource->id % 3 != 0);
+		REQUIRE((priority < last_priority || (priority == last_priority && resource->id > last_id)));
+
+		last_priority = priority;
+		last_id = resource->id;
+		++count;
+
+		// Started loads can't be cancelled through the queue.
+		REQUIRE(!queue.remove(*resource));
+	}
+
+	REQUIRE(count == 42);
+}
+
+TEST_CASE("shibboleth_resource_load_queue_in_flight_cap")
+{
+	TestResource resources[4];
+	TestQueue queue(2);
+
+	for (int32_t i = 0; i < static_cast<int32_t>(std::size(resources)); ++i) {
+		resources[i].id = i;
+		queue.push(resources[i], 0);
+	}
+
+	TestResource* const first = queue.startNext();
+	TestResource* const second = queue.startNext();
+
+	REQUIRE(first == &resources[0]);
+	REQUIRE(second == &resources[1]);
+
+	// At the cap. Nothing else starts until a slot is given back.
+	REQUIRE(!queue.startNext());
+
+	// Unless something is blocked on it.
+	REQUIRE(queue.raisePriority(resources[3], TestQueue::k_priority_uncapped));
+	REQUIRE(queue.startNext() == &resources[3]);
+	REQUIRE(queue.getNumInFlight() == 3);
+	REQUIRE(!queue.startNext());
+
+	REQUIRE(queue.finish(*first));
+	REQUIRE(!queue.startNext());
+
+	REQUIRE(queue.finish(*second));
+	REQUIRE(queue.startNext() == &resources[2]);
+	REQUIRE(queue.getNumQueued() == 0);
+}
@@ -0,0 +1,300 @@
+/************************************************************************************
+Copyright (C) 2022 by Nicholas LaCroix
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+************************************************************************************/
+
+#include <Shibboleth_ResourceTable.h>
+#include <Gaff_IncludeEASTLAtomic.h>
+#include <catch_amalgamated.hpp>
+#include <EASTL/algorithm.h>
+#include <thread>
+#include <random>
+
+namespace
+{
+	struct TestResource final
+	{
+		TestResource(Gaff::Hash64 hash): hash(hash) {}
+
+		bool tryAddRef(void) const
+		{
+			int32_t curr = count.load(eastl::memory_order_relaxed);
+
+			while (curr > 0) {
+				if (count.compare_exchange_weak(curr, curr + 1)) {
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		mutable eastl::atomic<int32_t> count = 1;
+		Gaff::Hash64 hash;
+	};
+
+	using TestTable = Shibboleth::ResourceTable<TestResource>;
+
+	// What ResourceManager used to do. Kept around to compare against in the benchmark.
+	class SortedVectorTable final
+	{
+	public:
+		~SortedVectorTable(void)
+		{
+			for (TestResource* resource : _resources) {
+				SHIB_FREET(resource, Shibboleth::GetAllocator());
+			}
+		}
+
+		template <class Factory>
+		TestResource* acquireOrInsert(Gaff::Hash64 hash, Factory&& factory)
+		{
+			const EA::Thread::AutoMutex lock(_lock);
+			const auto it = Gaff::LowerBound(_resources, hash, ResourceHashCompare);
+
+			if (it != _resources.end() && (*it)->hash == hash) {
+				++(*it)->count;
+				return *it;
+			}
+
+			TestResource* const resource = factory();
+			_resources.insert(it, resource);
+
+			return resource;
+		}
+
+		void remove(Gaff::Hash64 hash, const TestResource& resource)
+		{
+			const EA::Thread::AutoMutex lock(_lock);
+			const auto it = Gaff::LowerBound(_resources, hash, ResourceHashCompare);
+
+			if (it != _resources.end() && *it == &resource) {
+				_resources.erase(it);
+				SHIB_FREET(&resource, Shibboleth::GetAllocator());
+			}
+		}
+
+	private:
+		EA::Thread::Mutex _lock;
+		Shibboleth::Vector<TestResource*> _resources;
+
+		static bool ResourceHashCompare(const TestResource* lhs, Gaff::Hash64 rhs)
+		{
+			return lhs->hash < rhs;
+		}
+	};
+}
+
+static constexpr int32_t k_num_resources = 100000;
+static constexpr int32_t k_num_stress_resources = 1000;
+static constexpr int32_t k_num_iterations = 100000;
+
+static Gaff::Hash64 GetTestHash(int32_t index)
+{
+	return Gaff::FNV1aHash64T(index);
+}
+
+template <class Table>
+static TestResource* Request(Table& table, Gaff::Hash64 hash)
+{
+	return table.acquireOrInsert(hash, [hash]() -> TestResource*
+	{
+		return SHIB_ALLOCT(TestResource, Shibboleth::GetAllocator(), hash);
+	});
+}
+
+template <class Table>
+static void Release(Table& table, TestResource* resource)
+{
+	if (!--resource->count) {
+		table.remove(resource->hash, *resource);
+	}
+}
+
+// Every thread requests and releases random resources out of num_resources, returns the number of requests that got the wrong resource.
+template <class Table>
+static int32_t RunRequestRelease(Table& table, int32_t num_threads, int32_t num_resources, int32_t num_iterations)
+{
+	eastl::atomic<int32_t> failures = 0;
+	Shibboleth::Vector<std::thread> threads;
+
+	for (int32_t i = 0; i < num_threads; ++i) {
+		threads.emplace_back([&, i]() -> void
+		{
+			std::mt19937 rng(static_cast<uint32_t>(i));
+			std::uniform_int_distribution<int32_t> dist(0, num_resources - 1);
+
+			for (int32_t j = 0; j < num_iterations; ++j) {
+				const Gaff::Hash64 hash = GetTestHash(dist(rng));
+				TestResource* const resource = Request(table, hash);
+
+				if (!resource || resource->hash != hash) {
+					++failures;
+					continue;
+				}
+
+				Release(table, resource);
+			}
+		});
+	}
+
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+
+	return failures;
+}
+
+static int32_t CountLive(const TestTable& table)
+{
+	int32_t count = 0;
+	table.forEach([&count](const TestResource&) -> void { ++count; });
+
+	return count;
+}
+
+TEST_CASE("shibboleth_resource_table_insert_remove")
+{
+	TestTable table;
+	Shibboleth::Vector<TestResource*> resources;
+
+	// Enough to grow every shard a few times.
+	for (int32_t i = 0; i < k_num_stress_resources * 10; ++i) {
+		resources.emplace_back(Request(table, GetTestHash(i)));
+		REQUIRE(resources.back());
+	}
+
+	REQUIRE(CountLive(table) == k_num_stress_resources * 10);
+
+	for (int32_t i = 0; i < k_num_stress_resources * 10; ++i) {
+		TestResource* const resource = table.acquire(GetTestHash(i));
+
+		REQUIRE(resource == resources[i]);
+		REQUIRE(resource->count == 2);
+
+		// Already in the table, so the factory shouldn't run.
+		REQUIRE(table.acquireOrInsert(GetTestHash(i), []() -> TestResource* { return nullptr; }) == resource);
+
+		Release(table, resource);
+		Release(table, resource);
+	}
+
+	for (int32_t i = 0; i < k_num_stress_resources * 10; i += 2) {
+		Release(table, resources[i]);
+		REQUIRE(!table.acquire(GetTestHash(i)));
+	}
+
+	REQUIRE(CountLive(table) == k_num_stress_resources * 5);
+
+	// Removed entries can be filled again.
+	TestResource* const resource = Request(table, GetTestHash(0));
+	REQUIRE(resource);
+	REQUIRE(table.acquire(GetTestHash(0)) == resource);
+
+	Release(table, resource);
+	Release(table, resource);
+
+	for (int32_t i = 1; i < k_num_stress_resources * 10; i += 2) {
+		Release(table, resources[i]);
+	}
+
+	REQUIRE(CountLive(table) == 0);
+}
+
+TEST_CASE("shibboleth_resource_table_replace_released")
+{
+	TestTable table;
+
+	TestResource* const resource = Request(table, GetTestHash(0));
+	REQUIRE(resource);
+
+	// Simulate a resource whose count hit zero, but hasn't been removed yet.
+	--resource->count;
+	REQUIRE(!table.acquire(GetTestHash(0)));
+
+	TestResource* const new_resource = Request(table, GetTestHash(0));
+	REQUIRE(new_resource);
+	REQUIRE(new_resource != resource);
+
+	// The late removal must not unmap its replacement.
+	table.remove(GetTestHash(0), *resource);
+	REQUIRE(table.acquire(GetTestHash(0)) == new_resource);
+
+	Release(table, new_resource);
+	Release(table, new_resource);
+
+	REQUIRE(CountLive(table) == 0);
+}
+
+TEST_CASE("shibboleth_resource_table_stress")
+{
+	const int32_t num_threads = eastl::max(static_cast<int32_t>(std::thread::hardware_concurrency()), 4);
+
+	TestTable table;
+
+	// A small set of resources, so the same ones are constantly being created and destroyed on different threads.
+	REQUIRE(RunRequestRelease(table, num_threads, k_num_stress_resources, k_num_iterations) == 0);
+	REQUIRE(CountLive(table) == 0);
+
+	table.reclaim();
+}
+
+TEST_CASE("shibboleth_resource_table_throughput", "[.][benchmark]")
+{
+	const int32_t num_threads = eastl::max(static_cast<int32_t>(std::thread::hardware_concurrency()), 4);
+
+	TestTable table;
+	SortedVectorTable sorted_table;
+	Shibboleth::Vector<TestResource*> held;
+
+	// Keep everything loaded, like a level full of resources, so requests are mostly lookups.
+	for (int32_t i = 0; i < k_num_resources; ++i) {
+		held.emplace_back(Request(table, GetTestHash(i)));
+		Request(sorted_table, GetTestHash(i));
+	}
+
+	BENCHMARK("Request/Release Loaded (Sharded Table)")
+	{
+		return RunRequestRelease(table, num_threads, k_num_resources, k_num_iterations / 10);
+	};
+
+	BENCHMARK("Request/Release Loaded (Sorted Vector)")
+	{
+		return RunRequestRelease(sorted_table, num_threads, k_num_resources, k_num_iterations / 10);
+	};
+
+	TestTable churn_table;
+	SortedVectorTable churn_sorted_table;
+
+	// Nothing held, so every request creates and every release destroys.
+	BENCHMARK("Request/Release Churn (Sharded Table)")
+	{
+		return RunRequestRelease(churn_table, num_threads, k_num_resources, k_num_iterations / 10);
+	};
+
+	BENCHMARK("Request/Release Churn (Sorted Vector)")
+	{
+		return RunRequestRelease(churn_sorted_table, num_threads, k_num_resources, k_num_iterations / 10);
+	};
+
+	for (TestResource* resource : held) {
+		Release(table, resource);
+	}
+}
@@ -31,6 +31,290 @@ local tests = {
 			filter {}
 		end
 	},
+	{
+		name = "JobPoolTest",
+
+		includedirs =
+		{
+			"../Dependencies/EASTL/include",
+
+			"../Frameworks/Gaff/include",
+			"../Engine/Engine/include",
+			"../Engine/Memory/include"
+		},
+
+		links =
+		{
+			"Engine",
+			"EASTL",
+			"Memory",
+			"Gaff",
+			"Gleam",
+			"mpack"
+		},
+
+		extra = function ()
+			filter { "system:windows" }
+				links { "DbgHelp" }
+
+			filter { "system:linux" }
+				links { "pthread", "dl" }
+
+			filter {}
+		end
+	},
+	{
+		name = "LogManagerTest",
+
+		includedirs =
+		{
+			"../Dependencies/EASTL/include",
+
+			"../Frameworks/Gaff/include",
+			"../Engine/Engine/include",
+			"../Engine/Memory/include"
+		},
+
+		links =
+		{
+			"Engine",
+			"EASTL",
+			"Memory",
+			"Gaff",
+			"Gleam",
+			"mpack"
+		},
+
+		extra = function ()
+			filter { "system:windows" }
+				links { "DbgHelp" }
+
+			filter { "system:linux" }
+				links { "pthread", "dl" }
+
+			filter {}
+		end
+	},
+	{
+		name = "FileSystemTest",
+
+		includedirs =
+		{
+			"../Dependencies/EASTL/include",
+
+			"../Frameworks/Gaff/include",
+			"../Engine/Engine/include",
+			"../Engine/Memory/include"
+		},
+
+		links =
+		{
+			"Engine",
+			"EASTL",
+			"Memory",
+			"Gaff",
+			"Gleam",
+			"mpack"
+		},
+
+		extra = function ()
+			filter { "system:windows" }
+				links { "DbgHelp" }
+
+			filter { "system:linux" }
+				links { "pthread", "dl" }
+
+			filter {}
+		end
+	},
+	{
+		name = "PackFileSystemTest",
+
+		files =
+		{
+			"PackFileSystemTest.cpp",
+			"../Engine/PackFileSystem/Shibboleth_PackFileSystem.cpp"
+		},
+
+		includedirs =
+		{
+			"../Dependencies/EASTL/include",
+			"../Dependencies/zstd",
+
+			"../Frameworks/Gaff/include",
+			"../Engine/Engine/include",
+			"../Engine/Memory/include",
+
+			"../Engine/PackFileSystem/include"
+		},
+
+		links =
+		{
+			"Engine",
+			"EASTL",
+			"Memory",
+			"Gaff",
+			"Gleam",
+			"mpack",
+			"zstd"
+		},
+
+		extra = function ()
+			filter { "system:windows" }
+				links { "DbgHelp" }
+
+			filter { "system:linux" }
+				links { "pthread", "dl" }
+
+			filter {}
+		end
+	},
+	{
+		name = "BakedMeshTest",
+
+		files =
+		{
+			"BakedMeshTest.cpp",
+			"../Modules/Graphics/Shibboleth_BakedMesh.cpp"
+		},
+
+		includedirs =
+		{
+			"../Dependencies/EASTL/include",
+			"../Dependencies/assimp/include",
+			"../Dependencies/glm",
+
+			"../Frameworks/Gaff/include",
+			"../Frameworks/Gleam/include",
+			"../Engine/Engine/include",
+			"../Engine/Memory/include",
+
+			"../Modules/Graphics/include"
+		},
+
+		links =
+		{
+			"Engine",
+			"EASTL",
+			"Memory",
+			"Gaff",
+			"Gleam",
+			"mpack",
+			"assimp"
+		},
+
+		extra = function ()
+			filter { "system:windows" }
+				links { "DbgHelp" }
+
+			filter { "system:linux" }
+				links { "pthread", "dl" }
+
+			filter {}
+		end
+	},
+	{
+		name = "ResourceTableTest",
+
+		includedirs =
+		{
+			"../Dependencies/EASTL/include",
+
+			"../Frameworks/Gaff/include",
+			"../Engine/Engine/include",
+			"../Engine/Memory/include",
+
+			"../Modules/Resource/include"
+		},
+
+		links =
+		{
+			"Engine",
+			"EASTL",
+			"Memory",
+			"Gaff",
+			"Gleam",
+			"mpack"
+		},
+
+		extra = function ()
+			filter { "system:windows" }
+				links { "DbgHelp" }
+
+			filter { "system:linux" }
+				links { "pthread", "dl" }
+
+			filter {}
+		end
+	},
+	{
+		name = "ResourceLoadQueueTest",
+
+		includedirs =
+		{
+			"../Dependencies/EASTL/include",
+
+			"../Frameworks/Gaff/include",
+			"../Engine/Engine/include",
+			"../Engine/Memory/include",
+
+			"../Modules/Resource/include"
+		},
+
+		links =
+		{
+			"Engine",
+			"EASTL",
+			"Memory",
+			"Gaff",
+			"Gleam",
+			"mpack"
+		},
+
+		extra = function ()
+			filter { "system:windows" }
+				links { "DbgHelp" }
+
+			filter { "system:linux" }
+				links { "pthread", "dl" }
+
+			filter {}
+		end
+	},
+	{
+		name = "ResourceCallbackTableTest",
+
+		includedirs =
+		{
+			"../Dependencies/EASTL/include",
+
+			"../Frameworks/Gaff/include",
+			"../Engine/Engine/include",
+			"../Engine/Memory/include",
+
+			"../Modules/Resource/include"
+		},
+
+		links =
+		{
+			"Engine",
+			"EASTL",
+			"Memory",
+			"Gaff",
+			"Gleam",
+			"mpack"
+		},
+
+		extra = function ()
+			filter { "system:windows" }
+				links { "DbgHelp" }
+
+			filter { "system:linux" }
+				links { "pthread", "dl" }
+
+			filter {}
+		end
+	},
 	{
 		name = "ReflectionTest",
 
@@ -65,6 +349,44 @@ local tests = {
 			filter {}
 		end
 	},
+	{
+		name = "MainLoopTest",
+
+		includedirs =
+		{
+			"../Dependencies/EASTL/include",
+			"../Dependencies/rapidjson",
+			"../Dependencies/mpack",
+
+			"../Frameworks/Gaff/include",
+			"../Engine/Engine/include",
+			"../Engine/Memory/include",
+
+			"../Modules/MainLoop/include"
+		},
+
+		links =
+		{
+			"Engine",
+			"EASTL",
+			"Memory",
+			"Gaff",
+			"Gleam",
+			"mpack",
+
+			"MainLoop"
+		},
+
+		extra = function ()
+			filter { "system:windows" }
+				links { "DbgHelp" }
+
+			filter { "system:linux" }
+				links { "pthread", "dl" }
+
+			filter {}
+		end
+	},
 	{
 		name = "ECSTest",
 
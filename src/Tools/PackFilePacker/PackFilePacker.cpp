@@ -0,0 +1,295 @@
+/************************************************************************************
+Copyright (C) 2022 by Nicholas LaCroix
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+************************************************************************************/
+
+#include <Shibboleth_PackFileFormat.h>
+#include <Gaff_String.h>
+#include <Gaff_Hash.h>
+#include <Gaff_File.h>
+#include <argparse.hpp>
+#include <zdict.h>
+#include <zstd.h>
+#include <filesystem>
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+struct FileData final
+{
+	std::u8string name;
+	std::vector<char> data;
+	std::vector<char> compressed;
+	Shibboleth::PackEntry entry;
+};
+
+static bool ReadFile(const std::filesystem::path& path, std::vector<char>& out)
+{
+	Gaff::File file;
+
+	if (!file.open(path.u8string().c_str(), Gaff::File::OpenMode::ReadBinary)) {
+		return false;
+	}
+
+	out.resize(static_cast<size_t>(file.getFileSize()));
+	return out.empty() || file.readEntireFile(out.data());
+}
+
+static bool GatherFiles(const std::string& directory, std::vector<FileData>& files)
+{
+	if (!std::filesystem::is_directory(directory)) {
+		std::cerr << "'" << directory << "' is not a directory." << std::endl;
+		return false;
+	}
+
+	for (const auto& dir_entry : std::filesystem::recursive_directory_iterator(directory)) {
+		if (!dir_entry.is_regular_file()) {
+			continue;
+		}
+
+		FileData file;
+		file.name = dir_entry.path().lexically_normal().generic_u8string();
+		Shibboleth::NormalizePackPath(file.name);
+
+		if (!ReadFile(dir_entry.path(), file.data)) {
+			std::cerr << "Failed to read '" << dir_entry.path().string() << "'." << std::endl;
+			return false;
+		}
+
+		files.emplace_back(std::move(file));
+	}
+
+	return true;
+}
+
+static void TrainDictionary(const std::vector<FileData>& files, size_t dictionary_size, std::vector<char>& dictionary)
+{
+	std::vector<char> samples;
+	std::vector<size_t> sample_sizes;
+
+	for (const FileData& file : files) {
+		samples.insert(samples.end(), file.data.begin(), file.data.end());
+		sample_sizes.emplace_back(file.data.size());
+	}
+
+	dictionary.resize(dictionary_size);
+
+	const size_t result = ZDICT_trainFromBuffer(
+		dictionary.data(), dictionary.size(),
+		samples.data(), sample_sizes.data(),
+		static_cast<unsigned int>(sample_sizes.size())
+	);
+
+	if (ZDICT_isError(result)) {
+		std::cerr << "Failed to train dictionary with error '" << ZDICT_getErrorName(result) << "'. Packing without one." << std::endl;
+		dictionary.clear();
+		return;
+	}
+
+	dictionary.resize(result);
+}
+
+static bool CompressFiles(std::vector<FileData>& files, const std::vector<char>& dictionary, int level)
+{
+	ZSTD_CCtx* const context = ZSTD_createCCtx();
+	ZSTD_CDict* const cdict = (dictionary.empty()) ? nullptr : ZSTD_createCDict(dictionary.data(), dictionary.size(), level);
+
+	for (FileData& file : files) {
+		file.entry.size = file.data.size();
+		file.compressed.resize(ZSTD_compressBound(file.data.size()));
+
+		const size_t result = (cdict) ?
+			ZSTD_compress_usingCDict(context, file.compressed.data(), file.compressed.size(), file.data.data(), file.data.size(), cdict) :
+			ZSTD_compressCCtx(context, file.compressed.data(), file.compressed.size(), file.data.data(), file.data.size(), level);
+
+		if (ZSTD_isError(result)) {
+			std::cerr << "Failed to compress '" << reinterpret_cast<const char*>(file.name.c_str()) << "' with error '" << ZSTD_getErrorName(result) << "'." << std::endl;
+			ZSTD_freeCDict(cdict);
+			ZSTD_freeCCtx(context);
+			return false;
+		}
+
+		// Only keep compressed data when it saves enough to be worth decompressing. Otherwise the file can be used in place.
+		if (result < file.data.size() - file.data.size() / 8) {
+			file.compressed.resize(result);
+			file.entry.stored_size = result;
+			file.entry.flags |= static_cast<uint32_t>(Shibboleth::PackEntryFlag::Compressed);
+
+		} else {
+			file.compressed.clear();
+			file.entry.stored_size = file.data.size();
+		}
+	}
+
+	ZSTD_freeCDict(cdict);
+	ZSTD_freeCCtx(context);
+	return true;
+}
+
+static uint64_t Align(uint64_t offset)
+{
+	constexpr uint64_t k_alignment = 16;
+	return (offset + k_alignment - 1) & ~(k_alignment - 1);
+}
+
+static bool WritePack(const std::string& output, std::vector<FileData>& files, const std::vector<char>& dictionary)
+{
+	Shibboleth::PackHeader header;
+	header.entry_count = static_cast<uint32_t>(files.size());
+
+	std::vector<char8_t> names;
+
+	for (FileData& file : files) {
+		file.entry.name_offset = static_cast<uint32_t>(names.size());
+		names.insert(names.end(), file.name.begin(), file.name.end());
+		names.emplace_back(0);
+	}
+
+	header.names_size = static_cast<uint32_t>(names.size());
+	header.names_offset = sizeof(Shibboleth::PackHeader) + sizeof(Shibboleth::PackEntry) * files.size();
+	header.dictionary_offset = header.names_offset + header.names_size;
+	header.dictionary_size = dictionary.size();
+
+	uint64_t offset = header.dictionary_offset + header.dictionary_size;
+
+	for (FileData& file : files) {
+		const bool compressed = (file.entry.flags & static_cast<uint32_t>(Shibboleth::PackEntryFlag::Compressed)) != 0;
+
+		offset = Align(offset);
+		file.entry.offset = offset;
+		offset += file.entry.stored_size + ((compressed) ? 0 : 1);
+	}
+
+	Gaff::File pack;
+
+	if (!pack.open(output.c_str(), Gaff::File::OpenMode::WriteBinary)) {
+		std::cerr << "Failed to open '" << output << "' for write." << std::endl;
+		return false;
+	}
+
+	pack.write(&header, sizeof(Shibboleth::PackHeader), 1);
+
+	for (FileData& file : files) {
+		pack.write(&file.entry, sizeof(Shibboleth::PackEntry), 1);
+	}
+
+	pack.write(names.data(), 1, names.size());
+
+	if (!dictionary.empty()) {
+		pack.write(const_cast<char*>(dictionary.data()), 1, dictionary.size());
+	}
+
+	offset = header.dictionary_offset + header.dictionary_size;
+
+	for (FileData& file : files) {
+		const bool compressed = (file.entry.flags & static_cast<uint32_t>(Shibboleth::PackEntryFlag::Compressed)) != 0;
+		char padding[16] = { 0 };
+		char terminator = 0;
+
+		pack.write(padding, 1, static_cast<size_t>(file.entry.offset - offset));
+
+		if (compressed) {
+			pack.write(file.compressed.data(), 1, file.compressed.size());
+		} else {
+			pack.write(file.data.data(), 1, file.data.size());
+			pack.write(&terminator, 1, 1);
+		}
+
+		offset = file.entry.offset + file.entry.stored_size + ((compressed) ? 0 : 1);
+	}
+
+	return true;
+}
+
+int main(int argc, const char** argv)
+{
+	argparse::ArgumentParser program("PackFilePacker");
+
+	program.add_argument("--output", "-o")
+		.help("(Optional) The pack file to write.")
+		.default_value<std::string>("Resources.pack");
+
+	program.add_argument("--level", "-l")
+		.help("(Optional) The zstd compression level.")
+		.default_value(19)
+		.action([](const std::string& value) -> int { return std::stoi(value); });
+
+	program.add_argument("--dictionary_size", "-ds")
+		.help("(Optional) Size of a zstd dictionary to train on the packed files. Helps with lots of small, similar files. 0 disables it.")
+		.default_value(0)
+		.action([](const std::string& value) -> int { return std::stoi(value); });
+
+	program.add_argument("directories")
+		.help("Directories to pack. File names are stored relative to the working directory, the same way they are opened.")
+		.default_value(std::vector<std::string>{ "Resources" })
+		.remaining();
+
+	try {
+		program.parse_args(argc, argv);
+
+	} catch(const std::runtime_error& err) {
+		std::cerr << err.what() << std::endl;
+		std::cerr << program;
+		return -1;
+	}
+
+	std::vector<FileData> files;
+
+	for (const std::string& directory : program.get< std::vector<std::string> >("directories")) {
+		if (!GatherFiles(directory, files)) {
+			return -1;
+		}
+	}
+
+	for (FileData& file : files) {
+		file.entry.name_hash = Gaff::FNV1aHash64(reinterpret_cast<const char*>(file.name.data()), file.name.size()).getHash();
+	}
+
+	// The file system binary searches by hash, then compares names.
+	std::sort(files.begin(), files.end(), [](const FileData& lhs, const FileData& rhs) -> bool
+	{
+		return (lhs.entry.name_hash == rhs.entry.name_hash) ? lhs.name < rhs.name : lhs.entry.name_hash < rhs.entry.name_hash;
+	});
+
+	files.erase(std::unique(files.begin(), files.end(), [](const FileData& lhs, const FileData& rhs) -> bool
+	{
+		return lhs.name == rhs.name;
+	}), files.end());
+
+	std::vector<char> dictionary;
+	const int dictionary_size = program.get<int>("--dictionary_size");
+
+	if (dictionary_size > 0) {
+		TrainDictionary(files, static_cast<size_t>(dictionary_size), dictionary);
+	}
+
+	if (!CompressFiles(files, dictionary, program.get<int>("--level"))) {
+		return -1;
+	}
+
+	const std::string output = program.get("--output");
+
+	if (!WritePack(output, files, dictionary)) {
+		return -1;
+	}
+
+	std::cout << "Packed " << files.size() << " files into '" << output << "'." << std::endl;
+	return 0;
+}
@@ -0,0 +1,43 @@
+project "PackFilePacker"
+	location(GetToolsLocation())
+
+	kind "ConsoleApp"
+	debugdir "../../../workingdir/tools"
+	language "C++"
+
+	files { "**.h", "**.cpp", "**.inl" }
+
+	includedirs
+	{
+		"../../Engine/Engine/include",
+		"../../Engine/PackFileSystem/include",
+		"../../Frameworks/Gaff/include",
+		"../../Dependencies/EASTL/include",
+		"../../Dependencies/argparse",
+		"../../Dependencies/zstd"
+	}
+
+	local deps =
+	{
+		"Gaff",
+		"EASTL",
+		"zstd"
+	}
+
+	dependson(deps)
+	links(deps)
+
+	flags { "FatalWarnings" }
+
+	filter { "system:linux" }
+		links { "pthread" }
+
+	filter {}
+
+	SetupConfigMap()
+
+	postbuildcommands
+	{
+		"{MKDIR} ../../../../../workingdir/tools",
+		"{COPYFILE} %{cfg.targetdir}/%{cfg.buildtarget.name} ../../../../../workingdir/tools"
+	}
@@ -0,0 +1,132 @@
+/************************************************************************************
+Copyright (C) 2022 by Nicholas LaCroix
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+************************************************************************************/
+
+#include <Shibboleth_MessagePackSerializeWriter.h>
+#include <Shibboleth_BinarySerialize.h>
+#include <Shibboleth_SerializeReader.h>
+#include <Shibboleth_AppConfigs.h>
+#include <Shibboleth_App.h>
+#include <Gaff_MessagePack.h>
+#include <Gaff_JSON.h>
+#include <Gaff_File.h>
+#include <filesystem>
+#include <cstdio>
+
+static bool LoadObject(const char8_t* file, const Refl::IReflectionDefinition& ref_def, void* object)
+{
+	if (Gaff::EndsWith(file, u8".json")) {
+		Gaff::JSON json;
+
+		if (!json.parseFile(file)) {
+			printf("Failed to parse '%s' with error '%s'.\n", reinterpret_cast<const char*>(file), reinterpret_cast<const char*>(json.getErrorText()));
+			return false;
+		}
+
+		const Shibboleth::SerializeReader<Gaff::JSON> reader(json);
+		return ref_def.load(reader, object);
+	}
+
+	Gaff::MessagePackReader mpack;
+
+	if (!mpack.openFile(file)) {
+		printf("Failed to parse '%s'.\n", reinterpret_cast<const char*>(file));
+		return false;
+	}
+
+	const Shibboleth::SerializeReader<Gaff::MessagePackNode> reader(mpack.getRoot());
+	return ref_def.load(reader, object);
+}
+
+int main(int argc, const char** argv)
+{
+	if (argc <= 2) {
+		printf("Usage: ReflectionBinaryConverter <type name> <file>...\n");
+		return 0;
+	}
+
+	// The app changes the working directory, so resolve the input files first.
+	Shibboleth::Vector<Shibboleth::U8String> files;
+
+	for (int32_t i = 2; i < argc; ++i) {
+		files.emplace_back(std::filesystem::absolute(argv[i]).u8string().c_str());
+	}
+
+	Shibboleth::App app;
+
+	app.getConfigs().setObject(Shibboleth::k_config_app_working_dir, Gaff::JSON::CreateString(u8".."));
+	app.getConfigs().setObject(Shibboleth::k_config_app_no_main_loop, Gaff::JSON::CreateTrue());
+	app.getConfigs().setObject(Shibboleth::k_config_app_no_managers, Gaff::JSON::CreateTrue());
+
+	if (!app.init(argc, argv)) {
+		app.destroy();
+		return -1;
+	}
+
+	CONVERT_STRING(char8_t, type_name, argv[1]);
+
+	const Shibboleth::ReflectionManager& refl_mgr = app.getReflectionManager();
+	const Refl::IReflectionDefinition* const ref_def = refl_mgr.getReflection(Gaff::FNV1aHash64String(type_name));
+
+	if (!ref_def) {
+		printf("'%s' is not a reflected type.\n", argv[1]);
+		app.destroy();
+		return -1;
+	}
+
+	Shibboleth::ProxyAllocator allocator("Reflection");
+	int ret = 0;
+
+	for (const Shibboleth::U8String& file : files) {
+		void* const object = ref_def->create(allocator);
+
+		if (!object) {
+			printf("Failed to create an instance of '%s'.\n", argv[1]);
+			ret = -1;
+			break;
+		}
+
+		if (LoadObject(file.data(), *ref_def, object)) {
+			Shibboleth::BinarySerializeWriter writer;
+			Shibboleth::SaveBinaryFile(writer, *ref_def, object);
+
+			const Shibboleth::U8String out_file = file + u8".sbr";
+			Gaff::File out;
+
+			if (out.open(out_file.data(), Gaff::File::OpenMode::WriteBinary)) {
+				out.write(const_cast<uint8_t*>(writer.getBuffer()), 1, writer.size());
+			} else {
+				printf("Failed to open output file '%s'.\n", reinterpret_cast<const char*>(out_file.data()));
+				ret = -1;
+			}
+
+		} else {
+			printf("Failed to load '%s' as '%s'.\n", reinterpret_cast<const char*>(file.data()), argv[1]);
+			ret = -1;
+		}
+
+		ref_def->destroyInstance(object);
+		SHIB_FREE(object, allocator);
+	}
+
+	app.destroy();
+	return ret;
+}
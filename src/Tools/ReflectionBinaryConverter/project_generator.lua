@@ -0,0 +1,49 @@
+project "ReflectionBinaryConverter"
+	location(GetToolsLocation())
+
+	kind "ConsoleApp"
+	debugdir "../../../workingdir/tools"
+	language "C++"
+
+	files { "**.h", "**.cpp", "**.inl" }
+
+	includedirs
+	{
+		"../../Engine/Engine/include",
+		"../../Engine/Memory/include",
+		"../../Frameworks/Gaff/include",
+		"../../Dependencies/rapidjson",
+		"../../Dependencies/mpack",
+		"../../Dependencies/EASTL/include"
+	}
+
+	local deps =
+	{
+		"Engine",
+		"Gaff",
+		"Gleam",
+		"Memory",
+
+		"EASTL",
+		"mpack"
+	}
+
+	dependson(deps)
+	links(deps)
+
+	flags { "FatalWarnings" }
+
+	filter { "system:windows" }
+		-- links { "iphlpapi.lib", "psapi.lib", "userenv.lib" }
+		links { "Dbghelp" }
+
+	filter { "system:linux" }
+		links { "dl", "pthread" }
+
+	filter {}
+
+	postbuildcommands
+	{
+		"{MKDIR} ../../../../../workingdir/tools",
+		"{COPYFILE} %{cfg.targetdir}/%{cfg.buildtarget.name} ../../../../../workingdir/tools"
+	}